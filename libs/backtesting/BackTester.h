@@ -7,6 +7,7 @@
 #ifndef __BACKTESTER_H
 #define __BACKTESTER_H 1
 
+#include <algorithm>
 #include <exception>
 #include <list>
 #include <vector>
@@ -56,6 +57,17 @@ namespace mkc_timeseries
    * - BacktesterStrategy: defines trading logic for entry and exit conditions.
    * - StrategyBroker: handles order routing, position tracking, and fill notifications.
    *
+   * Memory:
+   * - Each BackTester (and so each clone) owns a BacktestArena. The strategies added to it
+   *   allocate their orders, positions and transactions from that arena, which is released
+   *   in one shot when the BackTester and the strategies are gone.
+   * - Each BackTester also owns a BacktestIdDomain shared by its strategies, so order and
+   *   position IDs are unique within the BackTester and do not depend on other threads.
+   *
+   * Cached results:
+   * - The search caches backtest matrices built with this class (BacktestMatrixCache). Changes to how
+   *   bars are stepped or orders are filled must bump BacktestMatrixCache::SimulationVersion.
+   *
    * Thread Safety:
    * - This class is **not thread-safe** and must not be shared across threads.
    * - Each `BackTester` instance must be used exclusively within the context of a single thread.
@@ -82,7 +94,10 @@ namespace mkc_timeseries
       : mStrategyList(),
 	mStrategyRawList(),
 	mBackTestDates(),
-	mDates()
+	mDates(),
+	mBarCursors(),
+	mArena(std::make_shared<BacktestArena>()),
+	mIdDomain(std::make_shared<BacktestIdDomain>())
     {}
 
     virtual ~BackTester()
@@ -95,7 +110,10 @@ namespace mkc_timeseries
     BackTester(const BackTester& rhs)
       : mStrategyList(rhs.mStrategyList),
 	mBackTestDates(rhs.mBackTestDates),
-	mDates(rhs.mDates)
+	mDates(rhs.mDates),
+	mBarCursors(),
+	mArena(std::make_shared<BacktestArena>()),
+	mIdDomain(std::make_shared<BacktestIdDomain>())
     {
       rebuildStrategyRawList();
     }
@@ -126,14 +144,34 @@ namespace mkc_timeseries
 
     /**
      * @brief Add a strategy to be included in backtesting.
+     *
+     * From now on the strategy allocates its orders, positions and transactions from this
+     * BackTester's arena and takes order and position IDs from its ID domain.
      * @param aStrategy Shared pointer to the strategy instance.
      */
     void addStrategy(const std::shared_ptr<BacktesterStrategy<Decimal>>& aStrategy)
     {
+      aStrategy->setBacktestArena(mArena);
+      aStrategy->setBacktestIdDomain(mIdDomain);
       mStrategyList.push_back(aStrategy);
       mStrategyRawList.push_back(aStrategy.get());
     }
 
+    /**
+     * @brief Replace the arena handed to strategies added from now on.
+     * @param arena Arena to allocate from, e.g. one with a different upstream resource,
+     *              or nullptr to allocate from the global heap.
+     */
+    void setBacktestArena(const std::shared_ptr<BacktestArena>& arena)
+    {
+      mArena = arena;
+    }
+
+    const std::shared_ptr<BacktestArena>& getBacktestArena() const
+    {
+      return mArena;
+    }
+
     /**
      * @brief Add a date-range over which to run the backtest.
      * @param range DateRange specifying start and end dates.
@@ -268,19 +306,7 @@ namespace mkc_timeseries
 	  for (uint32_t u = 1; u <= instrPos.getNumPositionUnits(); ++u)
 	    {
 	      auto posPtr = *instrPos.getInstrumentPosition(u);
-	      auto begin  = posPtr->beginPositionBarHistory();
-	      auto end    = posPtr->endPositionBarHistory();
-	      if (std::distance(begin, end) < 2) 
-                continue;
-
-	      auto prev = begin;
-	      for (auto curr = std::next(begin); curr != end; ++curr)
-		{
-		  Decimal c0 = prev->second.getCloseValue();
-		  Decimal c1 = curr->second.getCloseValue();
-		  allReturns.push_back((c1 - c0) / c0);
-		  prev = curr;
-		}
+	      posPtr->getPositionBarHistory().appendBarReturns(allReturns);
 	    }
 	}
 
@@ -340,13 +366,16 @@ namespace mkc_timeseries
      * processes entry/exit logic per strategy, records per-bar P&L via getLatestBarReturn(),
      * and handles multi-range rollovers by closing positions at range boundaries.
      *
+     * Each portfolio security is walked with a cursor into its own series, positioned once per
+     * range and advanced bar by bar, so no date lookup is needed to find a security's bar.
+     * Strategies receive that bar with their entry/exit events, and pending orders are only
+     * processed on dates where at least one of the strategy's securities has a bar (on any
+     * other date, such as a holiday, they could neither fill nor mark open positions).
+     *
      * @throws BackTesterException if no strategies are registered.
      */
     virtual void backtest()
     {
-      typename BackTester<Decimal>::StrategyRawIterator itStrategy;
-      typename BacktesterStrategy<Decimal>::PortfolioIterator iteratorPortfolio;
-
       if (mStrategyRawList.empty())
 	{
 	  throw BackTesterException("No strategies have been added to backtest");
@@ -376,39 +405,13 @@ namespace mkc_timeseries
 	  auto barBeforeBackTesterEndDate = previous_period(rangeEnd);
 	  ++backtestNumber;
 
-	  // ─── Inner loop over days via index ───────────────────────────
-	  for (size_t idx = 1; idx < mDates.size(); ++idx)
-	    {
-	      const date& current   = mDates[idx];
-	      const date& orderDate = mDates[idx - 1];
+	  // 3) Position every security's cursor at its first bar of the range
+	  initBarCursors(rangeStart);
 
-	      for (itStrategy = beginStrategiesRaw();
-		   itStrategy != endStrategiesRaw();
-		   ++itStrategy)
-		{
-		  StrategyPtr strat = *itStrategy;
-
-		  for (iteratorPortfolio = strat->beginPortfolio();
-		       iteratorPortfolio != strat->endPortfolio();
-		       ++iteratorPortfolio)
-		    {
-		      const auto& secPtr = iteratorPortfolio->second;
-
-		      if (multipleRanges
-			  && current == barBeforeBackTesterEndDate
-			  && backtestNumber < numBackTestRanges())
-			{
-			  closeAllPositions(orderDate);
-			}
-		      else
-			{
-			  processStrategyBar(secPtr.get(), strat, orderDate);
-			}
-
-		      strat->eventProcessPendingOrders(current);
-		    }
-		}
-	    }
+	  // ─── Inner loop over days via index ───────────────────────────
+	  backtestRange(mDates,
+			barBeforeBackTesterEndDate,
+			multipleRanges && backtestNumber < numBackTestRanges());
 	}
     }
 
@@ -429,7 +432,163 @@ namespace mkc_timeseries
      */
     virtual TimeSeriesDate next_period(const TimeSeriesDate& d) const = 0;
 
+    /**
+     * @brief Step through one date range, one bar time at a time.
+     *
+     * For each time after the first, runs every strategy's exit/entry logic on the bar at the
+     * previous time (the order bar) and then processes pending orders at the current time. When
+     * closeBeforeRangeEnd is set, positions are instead exited once the current time reaches
+     * closeOnBar, so no position carries over into the next range.
+     *
+     * @tparam TBarTime  date for daily and longer time frames, ptime for intraday time frames.
+     * @param barTimes   Bar times of the range, sorted and without duplicates.
+     * @pre initBarCursors() was called with the first date of the range.
+     */
+    template <class TBarTime>
+    void backtestRange(const std::vector<TBarTime>& barTimes,
+		       const TBarTime& closeOnBar,
+		       bool closeBeforeRangeEnd)
+    {
+      for (size_t idx = 1; idx < barTimes.size(); ++idx)
+	{
+	  const TBarTime& current   = barTimes[idx];
+	  const TBarTime& orderTime = barTimes[idx - 1];
+
+	  for (size_t strategyIndex = 0; strategyIndex < mStrategyRawList.size(); ++strategyIndex)
+	    {
+	      StrategyPtr strat = mStrategyRawList[strategyIndex];
+	      std::vector<SecurityBarCursor>& cursors = mBarCursors[strategyIndex];
+
+	      bool hasBarsOnCurrent = false;
+	      for (SecurityBarCursor& cursor : cursors)
+		hasBarsOnCurrent = cursor.hasBarOn(current) || hasBarsOnCurrent;
+
+	      for (SecurityBarCursor& cursor : cursors)
+		{
+		  if (closeBeforeRangeEnd && current == closeOnBar)
+		    {
+		      closeAllPositions(orderTime);
+		    }
+		  else if (cursor.advanceTo(orderTime))
+		    {
+		      processStrategyBar(cursor.mSecurity, strat, barDate(orderTime), cursor.mBar);
+		    }
+
+		  if (hasBarsOnCurrent)
+		    strat->eventProcessPendingOrders(current);
+		}
+	    }
+	}
+    }
+
+    /**
+     * @brief Build one cursor per (strategy, portfolio security), at the security's
+     *        first bar on or after rangeStart (a single binary search per security).
+     */
+    void initBarCursors(const date& rangeStart)
+    {
+      mBarCursors.clear();
+      mBarCursors.resize(mStrategyRawList.size());
+      for (size_t strategyIndex = 0; strategyIndex < mStrategyRawList.size(); ++strategyIndex)
+	{
+	  StrategyPtr strat = mStrategyRawList[strategyIndex];
+	  for (auto itPort = strat->beginPortfolio(); itPort != strat->endPortfolio(); ++itPort)
+	    {
+	      Security<Decimal>* security = itPort->second.get();
+	      auto first = std::lower_bound(security->getRandomAccessIteratorBegin(),
+					    security->getRandomAccessIteratorEnd(),
+					    rangeStart,
+					    [](const OHLCTimeSeriesEntry<Decimal>& entry, const date& d)
+					    { return entry.getDateValue() < d; });
+	      mBarCursors[strategyIndex].push_back(SecurityBarCursor{security, first, security->getRandomAccessIteratorEnd()});
+	    }
+	}
+    }
+
+    /**
+     * @brief Sorted, distinct timestamps of the bars, dated up to rangeEnd, that the strategies'
+     *        securities have from their cursors on (the bar times of an intraday range).
+     * @pre initBarCursors() was called with the first date of the range.
+     */
+    std::vector<ptime> collectBarDateTimes(const date& rangeEnd) const
+    {
+      std::vector<ptime> barDateTimes;
+      for (const auto& cursors : mBarCursors)
+	for (const SecurityBarCursor& cursor : cursors)
+	  for (auto bar = cursor.mBar; bar != cursor.mEnd && bar->getDateValue() <= rangeEnd; ++bar)
+	    barDateTimes.push_back(bar->getDateTime());
+
+      std::sort(barDateTimes.begin(), barDateTimes.end());
+      barDateTimes.erase(std::unique(barDateTimes.begin(), barDateTimes.end()), barDateTimes.end());
+      return barDateTimes;
+    }
+
   private:
+    /**
+     * @brief Position of one portfolio security in its series, only ever moved forward
+     *        as the backtest advances through a date range.
+     */
+    struct SecurityBarCursor
+    {
+      Security<Decimal>* mSecurity;
+      typename Security<Decimal>::ConstRandomAccessIterator mBar;
+      typename Security<Decimal>::ConstRandomAccessIterator mEnd;
+
+      /**
+       * @brief Move to the first bar dated on or after d.
+       * @return True if the security has a bar on d (mBar then points to it).
+       */
+      bool advanceTo(const date& d)
+      {
+	while (mBar != mEnd && mBar->getDateValue() < d)
+	  ++mBar;
+	return mBar != mEnd && mBar->getDateValue() == d;
+      }
+
+      /**
+       * @brief Whether the security has a bar on d, without moving the cursor.
+       */
+      bool hasBarOn(const date& d) const
+      {
+	auto bar = mBar;
+	while (bar != mEnd && bar->getDateValue() < d)
+	  ++bar;
+	return bar != mEnd && bar->getDateValue() == d;
+      }
+
+      /**
+       * @brief Move to the first bar at or after dt.
+       * @return True if the security has a bar at exactly dt (mBar then points to it).
+       */
+      bool advanceTo(const ptime& dt)
+      {
+	while (mBar != mEnd && mBar->getDateTime() < dt)
+	  ++mBar;
+	return mBar != mEnd && mBar->getDateTime() == dt;
+      }
+
+      /**
+       * @brief Whether the security has a bar at exactly dt, without moving the cursor.
+       */
+      bool hasBarOn(const ptime& dt) const
+      {
+	auto bar = mBar;
+	while (bar != mEnd && bar->getDateTime() < dt)
+	  ++bar;
+	return bar != mEnd && bar->getDateTime() == dt;
+      }
+    };
+
+    static const date& barDate(const date& d)
+    {
+      return d;
+    }
+
+    static date barDate(const ptime& dt)
+    {
+      return dt.date();
+    }
+
     StrategyRawIterator beginStrategiesRaw() const
     {
       return mStrategyRawList.begin();
@@ -450,16 +609,16 @@ namespace mkc_timeseries
 	}
     }
     
+    /**
+     * @brief Run the strategy's exit and entry logic for the security's bar on processingDate.
+     * @param bar The security's series entry for processingDate.
+     */
     inline void processStrategyBar(Security<Decimal>* security,
 			    StrategyPtr strategy,
-			    const date& processingDate)
+			    const date& processingDate,
+			    const typename Security<Decimal>::ConstRandomAccessIterator& bar)
     {
-      if (!strategy->doesSecurityHaveTradingData(*security, processingDate))
-	{
-	  return;
-	}
-
-      const auto symbol = security->getSymbol();
+      const auto& symbol = security->getSymbol();
       strategy->eventUpdateSecurityBarNumber(symbol);
 
       if (!strategy->isFlatPosition(symbol))
@@ -467,15 +626,18 @@ namespace mkc_timeseries
 	  strategy->eventExitOrders(
 				    security,
 				    strategy->getInstrumentPosition(symbol),
-				    processingDate);
+				    processingDate,
+				    bar);
 	}
       strategy->eventEntryOrders(
 				 security,
 				 strategy->getInstrumentPosition(symbol),
-				 processingDate);
+				 processingDate,
+				 bar);
     }
 
-    void closeAllPositions(const TimeSeriesDate& orderDate)
+    template <class TBarTime>
+    void closeAllPositions(const TBarTime& orderDate)
     {
       for (auto itStrat = beginStrategiesRaw(); itStrat != endStrategiesRaw(); ++itStrat)
 	{
@@ -495,6 +657,9 @@ namespace mkc_timeseries
     std::vector<StrategyPtr> mStrategyRawList;
     DateRangeContainer mBackTestDates;
     std::vector<boost::gregorian::date> mDates;
+    std::vector<std::vector<SecurityBarCursor>> mBarCursors;   // per strategy (raw list order), per portfolio security
+    std::shared_ptr<BacktestArena> mArena;
+    std::shared_ptr<BacktestIdDomain> mIdDomain;
   };
 
   //
@@ -813,6 +978,139 @@ namespace mkc_timeseries
       }
   };
 
+  //
+  // class IntradayBackTester
+  //
+
+  /**
+   * @class IntradayBackTester
+   * @brief BackTester for intraday time frames that steps through every bar timestamp.
+   *
+   * The date ranges are still calendar dates, but instead of one step per day the backtest
+   * takes one step per distinct bar timestamp (ptime) of the strategies' securities within
+   * the range. Orders are placed at the timestamp of the bar they were generated on and are
+   * filled on the next bar, which may be later on the same day, and open positions record
+   * one bar per timestamp.
+   *
+   * Strategies must place their orders at the bar timestamp they are given, as the PAL
+   * strategies do; an order placed with a date only gets the default bar time of that day.
+   */
+  template <class Decimal> class IntradayBackTester : public BackTester<Decimal>
+  {
+  public:
+    explicit IntradayBackTester(boost::gregorian::date startDate,
+				boost::gregorian::date endDate)
+      : BackTester<Decimal>()
+    {
+      DateRange r(startDate, endDate);
+      this->addDateRange(r);
+    }
+
+    IntradayBackTester() :
+      BackTester<Decimal>()
+    {}
+
+    ~IntradayBackTester()
+    {}
+
+    IntradayBackTester(const IntradayBackTester<Decimal> &rhs)
+      :  BackTester<Decimal>(rhs)
+    {}
+
+    IntradayBackTester<Decimal>&
+    operator=(const IntradayBackTester<Decimal> &rhs)
+    {
+      if (this == &rhs)
+	return *this;
+
+      BackTester<Decimal>::operator=(rhs);
+      return *this;
+    }
+
+    /**
+     * @brief Clone the IntradayBackTester with date ranges, but without strategies.
+     */
+    std::shared_ptr<BackTester<Decimal>> clone() const
+    {
+      auto back = std::make_shared<IntradayBackTester<Decimal>>();
+      auto it = this->beginBacktestDateRange();
+      for (; it != this->endBacktestDateRange(); it++)
+	back->addDateRange(it->second);
+
+      return back;
+    }
+
+    bool isDailyBackTester() const
+    {
+      return false;
+    }
+
+    bool isWeeklyBackTester() const
+    {
+      return false;
+    }
+
+    bool isMonthlyBackTester() const
+    {
+      return false;
+    }
+
+    /**
+     * @brief Determines whether this is a backtester that operates
+     * on intraday time frames.
+     * @return `true`.
+     */
+    bool isIntradayBackTester() const
+    {
+      return true;
+    }
+
+    /**
+     * @brief Execute the backtest across all configured date ranges, one step per bar timestamp.
+     *
+     * For each range the step times are the distinct timestamps of the strategies' bars dated
+     * within the range. With several ranges, positions are exited on the second to last step
+     * of every range but the last, as DailyBackTester does on the second to last day.
+     *
+     * @throws BackTesterException if no strategies are registered.
+     */
+    void backtest()
+    {
+      if (this->getNumStrategies() == 0)
+	throw BackTesterException("No strategies have been added to backtest");
+
+      bool multipleRanges = this->numBackTestRanges() > 1;
+      unsigned int backtestNumber = 0;
+
+      for (auto itRange = this->beginBacktestDateRange();
+	   itRange != this->endBacktestDateRange();
+	   ++itRange)
+	{
+	  ++backtestNumber;
+	  this->initBarCursors(itRange->second.getFirstDate());
+
+	  std::vector<ptime> barDateTimes = this->collectBarDateTimes(itRange->second.getLastDate());
+	  if (barDateTimes.size() < 2)
+	    continue;
+
+	  this->backtestRange(barDateTimes,
+			      barDateTimes[barDateTimes.size() - 2],
+			      multipleRanges && backtestNumber < this->numBackTestRanges());
+	}
+    }
+
+  protected:
+    TimeSeriesDate previous_period(const TimeSeriesDate& d) const
+      {
+	return boost_previous_weekday(d);
+      }
+
+    TimeSeriesDate next_period(const TimeSeriesDate& d) const
+      {
+	return boost_next_weekday(d);
+      }
+  };
+
   template <class Decimal>
   class BackTesterFactory
     {
@@ -829,8 +1127,11 @@ namespace mkc_timeseries
 	else if (theTimeFrame == TimeFrame::MONTHLY)
 	  return std::make_shared<MonthlyBackTester<Decimal>>(backtestingDates.getFirstDate(),
 						    backtestingDates.getLastDate());
+	else if (theTimeFrame == TimeFrame::INTRADAY)
+	  return std::make_shared<IntradayBackTester<Decimal>>(backtestingDates.getFirstDate(),
+						     backtestingDates.getLastDate());
 	else
-	  throw BackTesterException("BackTesterFactory::getBacktester - cannot create backtester for time frame other than daily, weekly or monthly");
+	  throw BackTesterException("BackTesterFactory::getBacktester - cannot create backtester for time frame other than daily, weekly, monthly or intraday");
       }
 
       static std::shared_ptr<BackTester<Decimal>> getBackTester(TimeFrame::Duration theTimeFrame,
@@ -0,0 +1,117 @@
+// Copyright (C) MKC Associates, LLC - All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+//
+
+#ifndef __BACKTEST_ID_DOMAIN_H
+#define __BACKTEST_ID_DOMAIN_H 1
+
+#include <algorithm>
+#include <cstdint>
+
+namespace mkc_timeseries
+{
+  /**
+   * @class BacktestIdDomain
+   * @brief Source of order and position IDs for one backtest.
+   *
+   * TradingOrder and TradingPosition take their ID from the domain current on the constructing
+   * thread. A StrategyBroker makes its domain current (see Scope) while it creates orders and
+   * positions, and a BackTester shares one domain between the strategies added to it, so IDs are
+   * unique within a BackTester, independent of what other threads are doing, and start from 1
+   * in every clone. Objects created outside any scope draw from a per-thread default domain.
+   *
+   * The counters are plain integers: a domain is only ever used by the thread running its backtest.
+   */
+  class BacktestIdDomain
+  {
+  public:
+    BacktestIdDomain()
+      : mLastOrderID(0),
+	mLastPositionID(0)
+    {}
+
+    uint32_t nextOrderID()
+    {
+      return ++mLastOrderID;
+    }
+
+    uint32_t nextPositionID()
+    {
+      return ++mLastPositionID;
+    }
+
+    uint32_t getLastOrderID() const
+    {
+      return mLastOrderID;
+    }
+
+    uint32_t getLastPositionID() const
+    {
+      return mLastPositionID;
+    }
+
+    /**
+     * @brief Skip past every ID handed out by other, so IDs from this domain never repeat one
+     *        already held by objects created under other (used when a broker changes domain).
+     */
+    void advancePast(const BacktestIdDomain& other)
+    {
+      mLastOrderID = std::max(mLastOrderID, other.mLastOrderID);
+      mLastPositionID = std::max(mLastPositionID, other.mLastPositionID);
+    }
+
+    /**
+     * @brief The domain new orders and positions on this thread take their IDs from.
+     */
+    static BacktestIdDomain& current()
+    {
+      BacktestIdDomain* installed = installedDomain();
+      return installed ? *installed : threadDefaultDomain();
+    }
+
+    /**
+     * @class Scope
+     * @brief Makes a domain current on this thread for the lifetime of the scope.
+     */
+    class Scope
+    {
+    public:
+      explicit Scope(BacktestIdDomain& domain)
+	: mPrevious(installedDomain())
+      {
+	installedDomain() = &domain;
+      }
+
+      ~Scope()
+      {
+	installedDomain() = mPrevious;
+      }
+
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+
+    private:
+      BacktestIdDomain* mPrevious;
+    };
+
+  private:
+    static BacktestIdDomain*& installedDomain()
+    {
+      thread_local BacktestIdDomain* domain = nullptr;
+      return domain;
+    }
+
+    static BacktestIdDomain& threadDefaultDomain()
+    {
+      thread_local BacktestIdDomain domain;
+      return domain;
+    }
+
+  private:
+    uint32_t mLastOrderID;
+    uint32_t mLastPositionID;
+  };
+}
+
+#endif
@@ -156,6 +156,37 @@ namespace mkc_timeseries
 				     const InstrumentPosition<Decimal>& instrPos,
 				     const date& processingDate) = 0;
 
+      /**
+       * @brief Exit order event with the security's bar for processingDate already resolved.
+       *
+       * @details
+       * BackTester walks each security's series with a cursor and calls this overload,
+       * passing the bar it is on. Strategies that read the bar override it to skip the
+       * date lookup; the default forwards to the date-only overload.
+       *
+       * @param bar  The security's series entry for processingDate.
+       */
+      virtual void eventExitOrders (Security<Decimal>* aSecurity,
+				    const InstrumentPosition<Decimal>& instrPos,
+				    const date& processingDate,
+				    const typename Security<Decimal>::ConstRandomAccessIterator& bar)
+      {
+	eventExitOrders (aSecurity, instrPos, processingDate);
+      }
+
+      /**
+       * @brief Entry order event with the security's bar for processingDate already resolved.
+       * @see eventExitOrders(Security<Decimal>*, const InstrumentPosition<Decimal>&, const date&, const typename Security<Decimal>::ConstRandomAccessIterator&)
+       * @param bar  The security's series entry for processingDate.
+       */
+      virtual void eventEntryOrders (Security<Decimal>* aSecurity,
+				     const InstrumentPosition<Decimal>& instrPos,
+				     const date& processingDate,
+				     const typename Security<Decimal>::ConstRandomAccessIterator& bar)
+      {
+	eventEntryOrders (aSecurity, instrPos, processingDate);
+      }
+
        /**
 	* @brief Determine the order size (shares/contracts) for aSecurity.
 	* @param aSecurity  Security whose order size is requested.
@@ -258,10 +289,12 @@ namespace mkc_timeseries
        /**
 	* @brief Exit all units (long or short) at open price on orderDate.
 	* @param tradingSymbol  Ticker to exit.
-	* @param orderDate      Date when the exit is placed.
+	* @param orderDate      Timestamp of the bar the exit is placed on. This and the
+	*                       order methods below each have a date overload, which
+	*                       places the order at the default bar time of that date.
 	*/
       void ExitAllPositions(const std::string& tradingSymbol,
-			    const date& orderDate)
+			    const ptime& orderDate)
       {
 	if (isLongPosition(tradingSymbol))
 	  ExitLongAllUnitsAtOpen(tradingSymbol, orderDate);
@@ -269,6 +302,12 @@ namespace mkc_timeseries
 	  ExitShortAllUnitsAtOpen(tradingSymbol, orderDate);
       }
 
+      void ExitAllPositions(const std::string& tradingSymbol,
+			    const date& orderDate)
+      {
+	ExitAllPositions (tradingSymbol, ptime (orderDate, getDefaultBarTime()));
+      }
+
       /**
        * @brief Submit a market‐on‐open entry order (long side).
        * @param tradingSymbol  Ticker to enter.
@@ -277,7 +316,7 @@ namespace mkc_timeseries
        * @param profitTarget   Optional profit‐target price.
        */
       void EnterLongOnOpen(const std::string& tradingSymbol, 	
-			   const date& orderDate,
+			   const ptime& orderDate,
 			   const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
 			   const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
       {
@@ -288,6 +327,14 @@ namespace mkc_timeseries
 				 profitTarget); 
       }
 
+      void EnterLongOnOpen(const std::string& tradingSymbol, 	
+			   const date& orderDate,
+			   const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
+			   const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
+      {
+	EnterLongOnOpen (tradingSymbol, ptime (orderDate, getDefaultBarTime()), stopLoss, profitTarget);
+      }
+
       /**
        * @brief Submit a market‐on‐open entry order (short side).
        * @param tradingSymbol  Ticker to enter short.
@@ -296,7 +343,7 @@ namespace mkc_timeseries
        * @param profitTarget   Optional profit‐target price.
        */
       void EnterShortOnOpen(const std::string& tradingSymbol,	
-			    const date& orderDate,
+			    const ptime& orderDate,
 			    const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
 			    const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
       {
@@ -307,17 +354,31 @@ namespace mkc_timeseries
 				  profitTarget); 
       }
 
+      void EnterShortOnOpen(const std::string& tradingSymbol,	
+			    const date& orderDate,
+			    const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
+			    const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
+      {
+	EnterShortOnOpen (tradingSymbol, ptime (orderDate, getDefaultBarTime()), stopLoss, profitTarget);
+      }
+
       /**
        * @brief Exit all long units at the open of orderDate.
        * @param tradingSymbol  Ticker to exit.
        * @param orderDate      Date when the exit is placed.
        */
       void ExitLongAllUnitsAtOpen(const std::string& tradingSymbol,
-				  const date& orderDate)
+				  const ptime& orderDate)
       {
 	mBroker.ExitLongAllUnitsOnOpen(tradingSymbol, orderDate);
       }
 
+      void ExitLongAllUnitsAtOpen(const std::string& tradingSymbol,
+				  const date& orderDate)
+      {
+	ExitLongAllUnitsAtOpen (tradingSymbol, ptime (orderDate, getDefaultBarTime()));
+      }
+
       /**
        * @brief Exit all long units at a hard limit price.
        * @overload
@@ -326,7 +387,7 @@ namespace mkc_timeseries
        * @param percentNum     PercentNumber to compute the limit from base.
        */
       void ExitLongAllUnitsAtLimit(const std::string& tradingSymbol,
-				 const date& orderDate,
+				 const ptime& orderDate,
 				 const Decimal& limitPrice)
       {
 	mBroker.ExitLongAllUnitsAtLimit (tradingSymbol, orderDate, limitPrice);
@@ -334,6 +395,13 @@ namespace mkc_timeseries
 
       void ExitLongAllUnitsAtLimit(const std::string& tradingSymbol,
 				 const date& orderDate,
+				 const Decimal& limitPrice)
+      {
+	ExitLongAllUnitsAtLimit (tradingSymbol, ptime (orderDate, getDefaultBarTime()), limitPrice);
+      }
+
+      void ExitLongAllUnitsAtLimit(const std::string& tradingSymbol,
+				 const ptime& orderDate,
 				 const Decimal& limitBasePrice,
 				 const PercentNumber<Decimal>& percentNum)
       {
@@ -342,29 +410,50 @@ namespace mkc_timeseries
 					 limitBasePrice, percentNum);
       }
 
+      void ExitLongAllUnitsAtLimit(const std::string& tradingSymbol,
+				 const date& orderDate,
+				 const Decimal& limitBasePrice,
+				 const PercentNumber<Decimal>& percentNum)
+      {
+	ExitLongAllUnitsAtLimit (tradingSymbol, ptime (orderDate, getDefaultBarTime()), limitBasePrice, percentNum);
+      }
+
       /**
        * @brief Exit all short units at a hard limit price.
        * @overload
        */
       void ExitShortAllUnitsAtOpen(const std::string& tradingSymbol,
-				   const date& orderDate)
+				   const ptime& orderDate)
       {
 	mBroker.ExitShortAllUnitsOnOpen(tradingSymbol, orderDate);
       }
 
+      void ExitShortAllUnitsAtOpen(const std::string& tradingSymbol,
+				   const date& orderDate)
+      {
+	ExitShortAllUnitsAtOpen (tradingSymbol, ptime (orderDate, getDefaultBarTime()));
+      }
+
       /**
        * @brief Exit all short units at a hard limit price.
        * @overload
        */
       void ExitShortAllUnitsAtLimit(const std::string& tradingSymbol,
-				  const date& orderDate,
+				  const ptime& orderDate,
 				  const Decimal& limitPrice)
       {
 	mBroker.ExitShortAllUnitsAtLimit (tradingSymbol, orderDate, limitPrice);
       }
 
       void ExitShortAllUnitsAtLimit(const std::string& tradingSymbol,
-				 const date& orderDate,
+				  const date& orderDate,
+				  const Decimal& limitPrice)
+      {
+	ExitShortAllUnitsAtLimit (tradingSymbol, ptime (orderDate, getDefaultBarTime()), limitPrice);
+      }
+
+      void ExitShortAllUnitsAtLimit(const std::string& tradingSymbol,
+				 const ptime& orderDate,
 				 const Decimal& limitBasePrice,
 				 const PercentNumber<Decimal>& percentNum)
       {
@@ -372,23 +461,38 @@ namespace mkc_timeseries
 					 limitBasePrice, percentNum);
       }
 
+      void ExitShortAllUnitsAtLimit(const std::string& tradingSymbol,
+				 const date& orderDate,
+				 const Decimal& limitBasePrice,
+				 const PercentNumber<Decimal>& percentNum)
+      {
+	ExitShortAllUnitsAtLimit (tradingSymbol, ptime (orderDate, getDefaultBarTime()), limitBasePrice, percentNum);
+      }
+
       /**
        * @brief Exit long positions at a stop‐loss price.
        * @overload
        */
       void ExitLongAllUnitsAtStop(const std::string& tradingSymbol,
-				const date& orderDate,
+				const ptime& orderDate,
 				const Decimal& stopPrice)
       {
 	mBroker.ExitLongAllUnitsAtStop (tradingSymbol, orderDate, stopPrice);
       }
 
+      void ExitLongAllUnitsAtStop(const std::string& tradingSymbol,
+				const date& orderDate,
+				const Decimal& stopPrice)
+      {
+	ExitLongAllUnitsAtStop (tradingSymbol, ptime (orderDate, getDefaultBarTime()), stopPrice);
+      }
+
       /**
        * @brief Exit long positions at a stop‐loss price.
        * @overload
        */
       void ExitLongAllUnitsAtStop(const std::string& tradingSymbol,
-				const date& orderDate,
+				const ptime& orderDate,
 				const Decimal& stopBasePrice,
 				const PercentNumber<Decimal>& percentNum)
       {
@@ -396,12 +500,20 @@ namespace mkc_timeseries
 					 stopBasePrice, percentNum);
       }
 
+      void ExitLongAllUnitsAtStop(const std::string& tradingSymbol,
+				const date& orderDate,
+				const Decimal& stopBasePrice,
+				const PercentNumber<Decimal>& percentNum)
+      {
+	ExitLongAllUnitsAtStop (tradingSymbol, ptime (orderDate, getDefaultBarTime()), stopBasePrice, percentNum);
+      }
+
       /**
        * @brief Exit short positions at a stop‐loss price.
        * @overload
        */
       void ExitShortAllUnitsAtStop(const std::string& tradingSymbol,
-				 const date& orderDate,
+				 const ptime& orderDate,
 				 const Decimal& stopPrice)
       {
 	mBroker.ExitShortAllUnitsAtStop (tradingSymbol, orderDate, stopPrice);
@@ -409,6 +521,13 @@ namespace mkc_timeseries
 
       void ExitShortAllUnitsAtStop(const std::string& tradingSymbol,
 				 const date& orderDate,
+				 const Decimal& stopPrice)
+      {
+	ExitShortAllUnitsAtStop (tradingSymbol, ptime (orderDate, getDefaultBarTime()), stopPrice);
+      }
+
+      void ExitShortAllUnitsAtStop(const std::string& tradingSymbol,
+				 const ptime& orderDate,
 				 const Decimal& stopBasePrice,
 				 const PercentNumber<Decimal>& percentNum)
       {
@@ -416,6 +535,14 @@ namespace mkc_timeseries
 					 stopBasePrice, percentNum);
       }
 
+      void ExitShortAllUnitsAtStop(const std::string& tradingSymbol,
+				 const date& orderDate,
+				 const Decimal& stopBasePrice,
+				 const PercentNumber<Decimal>& percentNum)
+      {
+	ExitShortAllUnitsAtStop (tradingSymbol, ptime (orderDate, getDefaultBarTime()), stopBasePrice, percentNum);
+      }
+
        /**
 	* @brief Drive the broker’s mark‐to‐market and fill logic for this bar.
 	* @param processingDate  Current bar date.
@@ -426,6 +553,14 @@ namespace mkc_timeseries
 	mBroker.ProcessPendingOrders (processingDate);
       }
 
+      /**
+       * @brief Same as above for the bar with timestamp processingDateTime (intraday series).
+       */
+      void eventProcessPendingOrders(const ptime& processingDateTime)
+      {
+	mBroker.ProcessPendingOrders (processingDateTime);
+      }
+
       /**
        * @brief Increment the per‐security bar count (used for lookback logic).
        * @param tradingSymbol  Ticker whose bar counter to advance.
@@ -486,12 +621,62 @@ namespace mkc_timeseries
 	return mBroker;
       }
 
+      /**
+       * @brief Have the broker allocate this strategy's orders, positions and transactions
+       *        from arena (the arena of the BackTester the strategy is added to).
+       */
+      void setBacktestArena(const std::shared_ptr<BacktestArena>& arena)
+      {
+	mBroker.setBacktestArena (arena);
+      }
+
+      /**
+       * @brief Have the broker take order and position IDs from domain (the ID domain of the
+       *        BackTester the strategy is added to).
+       */
+      void setBacktestIdDomain(const std::shared_ptr<BacktestIdDomain>& domain)
+      {
+	mBroker.setBacktestIdDomain (domain);
+      }
+
       std::shared_ptr<Portfolio<Decimal>> getPortfolio() const
       {
 	return mPortfolio;
       }
 
     protected:
+      /**
+       * @brief The bar passed with an order event, looked up by date when the caller did not resolve it.
+       * @param aSecurity       Security the bar belongs to.
+       * @param processingDate  Date of the bar.
+       * @param bar             The resolved bar, or aSecurity's end iterator when unresolved.
+       * @throws SecurityException if the bar has to be looked up and processingDate has no entry.
+       */
+      static typename Security<Decimal>::ConstRandomAccessIterator
+      resolveBar (const Security<Decimal>& aSecurity,
+		  const date& processingDate,
+		  const typename Security<Decimal>::ConstRandomAccessIterator& bar)
+      {
+	if (bar != aSecurity.getRandomAccessIteratorEnd())
+	  return bar;
+	return aSecurity.getRandomAccessIterator (processingDate);
+      }
+
+      /**
+       * @brief Timestamp to place orders at for the bar passed with an order event: the bar's
+       *        own timestamp when resolved (so intraday orders are placed on their bar), otherwise
+       *        processingDate at the default bar time. Never looks the bar up.
+       */
+      static ptime
+      resolveOrderDateTime (const Security<Decimal>& aSecurity,
+			    const date& processingDate,
+			    const typename Security<Decimal>::ConstRandomAccessIterator& bar)
+      {
+	if (bar != aSecurity.getRandomAccessIteratorEnd())
+	  return bar->getDateTime();
+	return ptime (processingDate, getDefaultBarTime());
+      }
+
       /**
        * @brief Construct a base strategy with portfolio and options.
        * @param strategyName     Name to assign.
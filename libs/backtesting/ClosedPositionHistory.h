@@ -17,6 +17,7 @@
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/sum.hpp>
 #include "TradingPosition.h"
+#include "BacktestArena.h"
 
 namespace mkc_timeseries
 {
@@ -45,8 +46,8 @@ namespace mkc_timeseries
   template <class Decimal> class ClosedPositionHistory
   {
   public:
-    typedef typename std::multimap<TimeSeriesDate,std::shared_ptr<TradingPosition<Decimal>>>::iterator PositionIterator;
-    typedef typename std::multimap<TimeSeriesDate,std::shared_ptr<TradingPosition<Decimal>>>::const_iterator ConstPositionIterator;
+    typedef typename ArenaMultimap<TimeSeriesDate,std::shared_ptr<TradingPosition<Decimal>>>::iterator PositionIterator;
+    typedef typename ArenaMultimap<TimeSeriesDate,std::shared_ptr<TradingPosition<Decimal>>>::const_iterator ConstPositionIterator;
     typedef std::vector<unsigned int>::const_iterator ConstBarsInPositionIterator;
     typedef std::vector<double>::const_iterator ConstTradeReturnIterator;
 
@@ -154,6 +155,14 @@ namespace mkc_timeseries
         throw std::logic_error(std::string("ClosedPositionHistory:addClosedPosition - position not winner or lsoer"));
     }
 
+    /**
+     * @brief Allocate the position map nodes from arena from now on (existing positions are kept).
+     */
+    void setBacktestArena(const std::shared_ptr<BacktestArena>& arena)
+    {
+      rebindToArena (mPositions, arena);
+    }
+
     void addClosedPosition (const TradingPositionLong<Decimal>& position)
     {
       addClosedPosition (std::make_shared<TradingPositionLong<Decimal>>(position));
@@ -216,31 +225,13 @@ namespace mkc_timeseries
     std::vector<Decimal> getHighResBarReturns() const
     {
         std::vector<Decimal> allReturns;
+        allReturns.reserve(mNumBarsInMarket);
         for (auto it = mPositions.begin(); it != mPositions.end(); ++it)
 	  {
-            const auto& posPtr = it->second;
-
-	    // Grab the TradingPositon's  full bar history (entry→exit)
-            auto begin = posPtr->beginPositionBarHistory();
-            auto end   = posPtr->endPositionBarHistory();
-
-            if (std::distance(begin, end) < 2)
-	      continue;		// need at least two bars to compute one P&L
-
-            auto prev = begin;
-
-	    // Compute bar‐by‐bar return for this trade
-            for (auto curr = std::next(begin); curr != end; ++curr)
-	      {
-                // Each iterator points to pair<TimeSeriesDate, OpenPositionBar>
-                Decimal closePrev = prev->second.getCloseValue();
-                Decimal closeCurr = curr->second.getCloseValue();
-                Decimal barReturn = (closeCurr - closePrev) / closePrev;
-
-                allReturns.push_back(barReturn);
-                prev = curr;
-            }
-        }
+	    // Bar-by-bar returns for this trade (entry→exit), read from the
+	    // position's bars; needs at least two bars to compute one P&L
+	    it->second->getPositionBarHistory().appendBarReturns (allReturns);
+	  }
         return allReturns;
     }
 
@@ -590,7 +581,7 @@ namespace mkc_timeseries
     }
 
   private:
-    std::multimap<TimeSeriesDate,std::shared_ptr<TradingPosition<Decimal>>> mPositions;
+    ArenaMultimap<TimeSeriesDate,std::shared_ptr<TradingPosition<Decimal>>> mPositions;
     Decimal mSumWinners;
     Decimal mSumLosers;
     Decimal mLogSumWinners;
@@ -12,6 +12,7 @@
 #include "ThrowAssert.hpp"
 #include "TradingPosition.h"
 #include "DecimalConstants.h"
+#include "BacktestArena.h"
 
 namespace mkc_timeseries
 {
@@ -107,6 +108,12 @@ namespace mkc_timeseries
      */
     virtual void addBar (const OHLCTimeSeriesEntry<Decimal>& entryBar) = 0;
 
+    /**
+     * @brief Updates all trading units in the position with the bar at barIndex of series.
+     * @throw InstrumentPositionException if called on a state that cannot process bars (e.g., flat).
+     */
+    virtual void addBar (const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex) = 0;
+
     /**
      * @brief Adds a new trading position unit to the instrument's overall position.
      * This method handles the logic for transitioning state if necessary (e.g., from flat to long).
@@ -135,25 +142,25 @@ namespace mkc_timeseries
      * @brief Closes a specific trading position unit.
      * @param iPosition Pointer to the owning InstrumentPosition object (to allow state
      * changes if all units are closed).
-     * @param exitDate The date of the exit.
+     * @param exitDateTime The timestamp of the exit bar.
      * @param exitPrice The price at which the unit is exited.
      * @param unitNumber The 1-based index of the trading unit to close.
      * @throw InstrumentPositionException if the unit cannot be closed or is not found.
      */
     virtual void closeUnitPosition(InstrumentPosition<Decimal>* iPosition,
-				   const boost::gregorian::date exitDate,
+				   const ptime& exitDateTime,
 				   const Decimal& exitPrice,
 				   uint32_t unitNumber) = 0;
 
     /**
      * @brief Closes all open trading position units.
      * @param iPosition Pointer to the owning InstrumentPosition object (to allow state changes to flat).
-     * @param exitDate The date of the exit.
+     * @param exitDateTime The timestamp of the exit bar.
      * @param exitPrice The price at which all units are exited.
      * @throw InstrumentPositionException if called on a state with no positions to close.
      */
     virtual void closeAllPositions(InstrumentPosition<Decimal>* iPosition,
-				   const boost::gregorian::date exitDate,
+				   const ptime& exitDateTime,
 				   const Decimal& exitPrice) = 0;
  
   
@@ -218,6 +225,11 @@ namespace mkc_timeseries
       throw InstrumentPositionException("FlatInstrumentPositionState: addBar - no positions available in flat state");
     }
 
+    void addBar (const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex)
+    {
+      throw InstrumentPositionException("FlatInstrumentPositionState: addBar - no positions available in flat state");
+    }
+
 
     ConstInstrumentPositionIterator getInstrumentPosition (uint32_t unitNumber) const
     {
@@ -240,7 +252,7 @@ namespace mkc_timeseries
     }
 
     void closeUnitPosition(InstrumentPosition<Decimal>* iPosition,
-			   const boost::gregorian::date exitDate,
+			   const ptime& exitDateTime,
 			   const Decimal& exitPrice,
 			   uint32_t unitNumber)
     {
@@ -248,7 +260,7 @@ namespace mkc_timeseries
     }
 
     void closeAllPositions(InstrumentPosition<Decimal>* iPosition,
-			   const boost::gregorian::date exitDate,
+			   const ptime& exitDateTime,
 			   const Decimal& exitPrice)
     {
       throw InstrumentPositionException("FlatInstrumentPositionState: closeAllPositions - no positions avaialble in flat state");
@@ -358,7 +370,7 @@ namespace mkc_timeseries
 
     /**
      * @brief Updates all open trading units with a new market data bar.
-     * Only adds the bar if its date is after the entry date of a unit.
+     * Only adds the bar if its timestamp is after the entry bar of a unit.
      * @param entryBar The OHLCTimeSeriesEntry representing the new bar data.
      */
     void addBar (const OHLCTimeSeriesEntry<Decimal>& entryBar)
@@ -367,14 +379,30 @@ namespace mkc_timeseries
 
       for (; it != this->endInstrumentPosition(); it++)
 	{
-	  // Only add a date that is after the entry date. We
+	  // Only add a bar that is after the entry bar. We
 	  // already added the first bar when we created the position
 
-	  if (entryBar.getDateValue() > (*it)->getEntryDate())
+	  if (entryBar.getDateTime() > (*it)->getEntryDateTime())
 	    (*it)->addBar(entryBar);
 	}
     }
 
+    /**
+     * @brief Same as above for the bar at barIndex of series; units record the bar index
+     * rather than a copy of the bar.
+     */
+    void addBar (const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex)
+    {
+      const ptime& barDateTime = series->getDateTimeColumn()[barIndex];
+      ConstInstrumentPositionIterator it = this->beginInstrumentPosition();
+
+      for (; it != this->endInstrumentPosition(); it++)
+	{
+	  if (barDateTime > (*it)->getEntryDateTime())
+	    (*it)->addBar(series, barIndex);
+	}
+    }
+
     /**
      * @brief Gets a constant iterator to the beginning of the trading position units.
      * @return ConstInstrumentPositionIterator pointing to the first unit.
@@ -397,13 +425,13 @@ namespace mkc_timeseries
      * @brief Closes a specific trading position unit.
      * If closing this unit results in no open units, transitions the InstrumentPosition to Flat state.
      * @param iPosition Pointer to the owning InstrumentPosition for state transition.
-     * @param exitDate The date of the exit.
+     * @param exitDateTime The timestamp of the exit bar.
      * @param exitPrice The price at which the unit is exited.
      * @param unitNumber The 1-based index of the trading unit to close.
      * @throw InstrumentPositionException if the unit number is invalid, unit not found, or unit already closed.
      */
     void closeUnitPosition(InstrumentPosition<Decimal>* iPosition,
-			   const boost::gregorian::date exitDate,
+			   const ptime& exitDateTime,
 			   const Decimal& exitPrice,
 			   uint32_t unitNumber)
     {
@@ -413,7 +441,7 @@ namespace mkc_timeseries
 
       if ((*it)->isPositionOpen())
 	{
-	  (*it)->ClosePosition (exitDate, exitPrice);
+	  (*it)->ClosePosition (exitDateTime, exitPrice);
 	  mTradingPositionUnits.erase (it);
 	}
       else
@@ -428,18 +456,18 @@ namespace mkc_timeseries
      * @brief Closes all open trading position units.
      * Transitions the InstrumentPosition to Flat state.
      * @param iPosition Pointer to the owning InstrumentPosition for state transition.
-     * @param exitDate The date of the exit.
+     * @param exitDateTime The timestamp of the exit bar.
      * @param exitPrice The price at which all units are exited.
      */
     void closeAllPositions(InstrumentPosition<Decimal>* iPosition,
-			   const boost::gregorian::date exitDate,
+			   const ptime& exitDateTime,
 			   const Decimal& exitPrice)
     {
       ConstInstrumentPositionIterator it = beginInstrumentPosition();
       for (; it != this->endInstrumentPosition(); it++)
 	{
 	  if ((*it)->isPositionOpen())
-	    (*it)->ClosePosition (exitDate, exitPrice);
+	    (*it)->ClosePosition (exitDateTime, exitPrice);
 	}
 
       mTradingPositionUnits.clear();
@@ -622,12 +650,14 @@ namespace mkc_timeseries
   public:
     InstrumentPosition (const std::string& instrumentSymbol)
       : mInstrumentSymbol(instrumentSymbol),
-	mInstrumentPositionState(FlatInstrumentPositionState<Decimal>::getInstance())
+	mInstrumentPositionState(FlatInstrumentPositionState<Decimal>::getInstance()),
+	mArena()
     {}
 
     InstrumentPosition (const InstrumentPosition<Decimal>& rhs)
       : mInstrumentSymbol(rhs.mInstrumentSymbol),
-	mInstrumentPositionState(rhs.mInstrumentPositionState)
+	mInstrumentPositionState(rhs.mInstrumentPositionState),
+	mArena(rhs.mArena)
     {}
 
     InstrumentPosition<Decimal>& 
@@ -638,6 +668,7 @@ namespace mkc_timeseries
 
       mInstrumentSymbol = rhs.mInstrumentSymbol;
       mInstrumentPositionState = rhs.mInstrumentPositionState;
+      mArena = rhs.mArena;
 
       return *this;
     }
@@ -650,6 +681,14 @@ namespace mkc_timeseries
       return mInstrumentSymbol;
     }
 
+    /**
+     * @brief Allocate the long/short state created when the next position is entered from arena.
+     */
+    void setBacktestArena (const std::shared_ptr<BacktestArena>& arena)
+    {
+      mArena = arena;
+    }
+
     bool isLongPosition() const
     {
       return mInstrumentPositionState->isLongPosition();
@@ -703,6 +742,11 @@ namespace mkc_timeseries
       mInstrumentPositionState->addBar(entryBar);
     }
 
+    void addBar (const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex)
+    {
+      mInstrumentPositionState->addBar(series, barIndex);
+    }
+
     void addPosition(std::shared_ptr<TradingPosition<Decimal>> position)
     {
       if (position->isPositionClosed())
@@ -754,13 +798,26 @@ namespace mkc_timeseries
 			   const Decimal& exitPrice,
 			   uint32_t unitNumber)
     {
-      mInstrumentPositionState->closeUnitPosition(this, exitDate, exitPrice, unitNumber);
+      closeUnitPosition(ptime(exitDate, getDefaultBarTime()), exitPrice, unitNumber);
+    }
+
+    void closeUnitPosition(const ptime& exitDateTime,
+			   const Decimal& exitPrice,
+			   uint32_t unitNumber)
+    {
+      mInstrumentPositionState->closeUnitPosition(this, exitDateTime, exitPrice, unitNumber);
     }
 
     void closeAllPositions(const boost::gregorian::date exitDate,
 			   const Decimal& exitPrice)
     {
-      mInstrumentPositionState->closeAllPositions(this, exitDate, exitPrice);
+      closeAllPositions(ptime(exitDate, getDefaultBarTime()), exitPrice);
+    }
+
+    void closeAllPositions(const ptime& exitDateTime,
+			   const Decimal& exitPrice)
+    {
+      mInstrumentPositionState->closeAllPositions(this, exitDateTime, exitPrice);
     }
 
   private:
@@ -777,6 +834,7 @@ namespace mkc_timeseries
   private:
     std::string mInstrumentSymbol;
     std::shared_ptr<InstrumentPositionState<Decimal>> mInstrumentPositionState;
+    std::shared_ptr<BacktestArena> mArena;
   };
 
   template <class Decimal>
@@ -784,9 +842,9 @@ namespace mkc_timeseries
 							     std::shared_ptr<TradingPosition<Decimal>> position)
     {
       if (position->isLongPosition())
-	iPosition->ChangeState (std::make_shared<LongInstrumentPositionState<Decimal>>(position));
+	iPosition->ChangeState (makeArenaShared<LongInstrumentPositionState<Decimal>>(iPosition->mArena, position));
       else if (position->isShortPosition())
-	iPosition->ChangeState (std::make_shared<ShortInstrumentPositionState<Decimal>>(position));
+	iPosition->ChangeState (makeArenaShared<ShortInstrumentPositionState<Decimal>>(iPosition->mArena, position));
       else
 	throw InstrumentPositionException ("FlatInstrumentPositionState<Decimal>::addPosition: position is neither long or short");
       
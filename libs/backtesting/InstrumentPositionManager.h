@@ -74,7 +74,7 @@ namespace mkc_timeseries
     /**
      * @brief Copy constructor.
      * @param rhs The InstrumentPositionManager to copy.
-     */
+     */
     InstrumentPositionManager (const InstrumentPositionManager<Decimal>& rhs)
       : mInstrumentPositions(rhs.mInstrumentPositions),
 	mBindings(rhs.mBindings)
@@ -219,6 +219,15 @@ namespace mkc_timeseries
 	throw InstrumentPositionManagerException("InstrumentPositionManager::addInstrument - trading symbol already exists");
     }
 
+    /**
+     * @brief Create the per-trade position state of every instrument from arena from now on.
+     */
+    void setBacktestArena (const std::shared_ptr<BacktestArena>& arena)
+    {
+      for (auto& instrument : mInstrumentPositions)
+	instrument.second->setBacktestArena (arena);
+    }
+
     /**
      * @brief Adds a new trading position unit to the corresponding instrument.
      * This is typically called when an entry order for an instrument is filled.
@@ -259,6 +268,16 @@ namespace mkc_timeseries
      */
     void addBarForOpenPosition (const boost::gregorian::date openPositionDate,
 				Portfolio<Decimal>* portfolioOfSecurities)
+    {
+      addBarForOpenPosition (ptime (openPositionDate, getDefaultBarTime()), portfolioOfSecurities);
+    }
+
+    /**
+     * @brief Same as above for the bar with timestamp openPositionDateTime (intraday series
+     * have several bars per day).
+     */
+    void addBarForOpenPosition (const ptime& openPositionDateTime,
+				Portfolio<Decimal>* portfolioOfSecurities)
     {
       // bind once on first bar
       if (mBindings.empty())
@@ -266,18 +285,18 @@ namespace mkc_timeseries
       
       for (auto& binding : mBindings)
         {
-	  auto* position = binding.first;
-	  auto* security = binding.second;
+	  auto* position = binding.position;
+	  const auto& series = binding.series;
 	  
 	  // only add if the position is currently open
 	  if (position->isFlatPosition())
 	    continue;
 	  
-	  // pull the bar from the OHLCTimeSeries
-	  auto it = security->findTimeSeriesEntry(openPositionDate);
-	  if (it != security->getRandomAccessIteratorEnd())
+	  // positions record the bar's index in the OHLCTimeSeries, not a copy of it
+	  auto it = series->getTimeSeriesEntry(openPositionDateTime);
+	  if (it != series->endRandomAccess())
             {
-	      position->addBar(*it);
+	      position->addBar(series, series->getIndex(it));
             }
         }
     }
@@ -299,6 +318,17 @@ namespace mkc_timeseries
       pos->closeAllPositions(exitDate, exitPrice);
     }
 
+    /**
+     * @brief Same as above, exiting on the bar with timestamp exitDateTime.
+     */
+    void closeAllPositions(const std::string& tradingSymbol,
+			   const ptime& exitDateTime,
+			   const Decimal& exitPrice)
+    {
+      std::shared_ptr<InstrumentPosition<Decimal>> pos = findExistingInstrumentPosition (tradingSymbol);
+      pos->closeAllPositions(exitDateTime, exitPrice);
+    }
+
     /**
      * @brief Closes a specific trading position unit for an instrument.
      * This is used when pyramiding and exiting only a part of the total position.
@@ -365,8 +395,9 @@ namespace mkc_timeseries
 	    ->findSecurity(position->getInstrumentSymbol());
 	  if (secIt != portfolioOfSecurities->endPortfolio())
             {
-	      // capture raw pointers—no shared_ptr copies
-	      mBindings.emplace_back(position, secIt->second.get());
+	      // raw position pointer; the series is shared once per binding so positions
+	      // can keep bar indices into it
+	      mBindings.push_back(PositionBinding{position, secIt->second->getTimeSeries()});
             }
         }
     }
@@ -415,8 +446,14 @@ namespace mkc_timeseries
     }
 
   private:
+    struct PositionBinding
+    {
+      InstrumentPosition<Decimal>* position;
+      std::shared_ptr<const OHLCTimeSeries<Decimal>> series;
+    };
+
     std::map<std::string, std::shared_ptr<InstrumentPosition<Decimal>>> mInstrumentPositions;
-    std::vector<std::pair<InstrumentPosition<Decimal>*, Security<Decimal>*>> mBindings;
+    std::vector<PositionBinding> mBindings;
   };
 }
 
@@ -11,6 +11,8 @@
 #include <memory>
 #include <stdexcept>
 #include <algorithm>
+#include <vector>
+#include <cstdint>
 #include "PalAst.h"
 #include "Security.h"
 #include "DecimalConstants.h"
@@ -29,12 +31,131 @@ namespace mkc_timeseries
       {}
   };
 
+  /**
+   * @brief One "bar field > bar field" condition of a compiled pattern.
+   *
+   * Fields are column numbers (see CompiledPalPattern::Field); offsets are
+   * bars back from the bar being evaluated.
+   */
+  struct PalPatternComparison
+  {
+    uint8_t lhsField;
+    uint8_t rhsField;
+    uint32_t lhsOffset;
+    uint32_t rhsOffset;
+  };
+
+  /**
+   * @brief A pattern expression flattened into a list of comparisons.
+   *
+   * A PAL pattern is a conjunction of GreaterThanExpr nodes. Instead of a
+   * tree of std::function objects (one per AndExpr, GreaterThanExpr and
+   * PriceBarReference) the conditions are stored in a flat array, in the
+   * same left-to-right order the tree evaluated them, and checked by a
+   * single loop over the OHLC columns of the series with early exit on the
+   * first failing condition.
+   *
+   * A default constructed CompiledPalPattern has no expression and never matches.
+   */
+  template <class Decimal> class CompiledPalPattern
+  {
+  public:
+    enum Field : uint8_t { OpenField = 0, HighField, LowField, CloseField, VolumeField, NumFields };
+
+    CompiledPalPattern()
+      : mComparisons(),
+	mMaxOffset(0),
+	mHasExpression(false)
+    {}
+
+    explicit CompiledPalPattern(std::vector<PalPatternComparison> comparisons)
+      : mComparisons(std::move(comparisons)),
+	mMaxOffset(0),
+	mHasExpression(true)
+    {
+      for (const auto& c : mComparisons)
+	mMaxOffset = std::max(mMaxOffset, std::max(c.lhsOffset, c.rhsOffset));
+    }
+
+    /**
+     * @brief Evaluate the pattern on the bar an iterator refers to.
+     *
+     * Same signature as PALPatternInterpreter::PatternEvaluator, so a
+     * CompiledPalPattern can be stored wherever a PatternEvaluator is used.
+     */
+    bool operator()(Security<Decimal>* aSecurity,
+		    typename Security<Decimal>::ConstRandomAccessIterator it) const
+    {
+      const OHLCTimeSeries<Decimal>& series = aSecurity->getTimeSeriesReference();
+      return evaluate(series, series.getIndex(it));
+    }
+
+    /**
+     * @brief Evaluate the pattern on bar @p index of @p series.
+     * @throws TimeSeriesException if @p index is past the last bar, or if a
+     *         condition that is reached refers to a bar before the first one.
+     */
+    bool evaluate(const OHLCTimeSeries<Decimal>& series, size_t index) const
+    {
+      if (!mHasExpression)
+	return false;
+
+      if (index >= series.getNumEntries())
+	throw TimeSeriesException("Iterator at end");
+
+      const Decimal* columns[NumFields] = { series.getOpenColumn().data(),
+					     series.getHighColumn().data(),
+					     series.getLowColumn().data(),
+					     series.getCloseColumn().data(),
+					     series.getVolumeColumn().data() };
+
+      if (index >= mMaxOffset)
+	{
+	  for (const auto& c : mComparisons)
+	    if (!(columns[c.lhsField][index - c.lhsOffset] > columns[c.rhsField][index - c.rhsOffset]))
+	      return false;
+
+	  return true;
+	}
+
+      // Near the start of the series: check bounds per condition so that the
+      // result matches short-circuit evaluation of the expression tree
+      for (const auto& c : mComparisons)
+	{
+	  if (index < c.lhsOffset || index < c.rhsOffset)
+	    throw TimeSeriesException("Offset out of bounds");
+
+	  if (!(columns[c.lhsField][index - c.lhsOffset] > columns[c.rhsField][index - c.rhsOffset]))
+	    return false;
+	}
+
+      return true;
+    }
+
+    const std::vector<PalPatternComparison>& getComparisons() const
+    {
+      return mComparisons;
+    }
+
+    /** @brief Largest bar offset referenced by any condition. */
+    uint32_t getMaxOffset() const
+    {
+      return mMaxOffset;
+    }
+
+  private:
+    std::vector<PalPatternComparison> mComparisons;
+    uint32_t mMaxOffset;
+    bool mHasExpression;
+  };
+
   /**
    * @brief Compiles and evaluates PAL pattern expressions efficiently.
    *
-   * This class provides a way to compile a PatternExpression AST into
-   * a fast, reusable lambda (PatternEvaluator) and also retains
-   * backward-compatible evaluateExpression for existing tests.
+   * This class compiles a PatternExpression AST into a flat
+   * CompiledPalPattern (see compilePattern), which compileEvaluator wraps
+   * as a PatternEvaluator. The original lambda tree compiler is retained as
+   * compileLambdaTree, and evaluateExpression is kept for existing tests.
    */
   template <class Decimal> class PALPatternInterpreter
   {
@@ -62,16 +183,42 @@ namespace mkc_timeseries
     }
 
     /**
-     * @brief Compile a PatternExpression into a fast lambda.
+     * @brief Compile a PatternExpression into a PatternEvaluator.
      *
-     * Recursively traverses the AST and builds a boolean predicate.
+     * The evaluator is a CompiledPalPattern, so each call is one indirect
+     * call followed by a flat loop over the pattern's conditions.
      */
     static PatternEvaluator compileEvaluator(PatternExpression* expr)
+    {
+      return PatternEvaluator(compilePattern(expr));
+    }
+
+    /**
+     * @brief Flatten a PatternExpression into a list of comparisons.
+     *
+     * @throws PalPatternInterpreterException for expression or price bar
+     *         reference types that compileEvaluator does not support.
+     */
+    static CompiledPalPattern<Decimal> compilePattern(PatternExpression* expr)
+    {
+      std::vector<PalPatternComparison> comparisons;
+      appendComparisons(expr, comparisons);
+      return CompiledPalPattern<Decimal>(std::move(comparisons));
+    }
+
+    /**
+     * @brief Compile a PatternExpression into a tree of lambdas.
+     *
+     * Recursively traverses the AST and builds a boolean predicate. This was
+     * the evaluator used before compilePattern; it is kept as a reference
+     * implementation for tests and benchmarks.
+     */
+    static PatternEvaluator compileLambdaTree(PatternExpression* expr)
     {
       if (auto pAnd = dynamic_cast<AndExpr*>(expr))
 	{
-	  auto L = compileEvaluator(pAnd->getLHS());
-	  auto R = compileEvaluator(pAnd->getRHS());
+	  auto L = compileLambdaTree(pAnd->getLHS());
+	  auto R = compileLambdaTree(pAnd->getRHS());
 	  
 	  return [L,R](Security<Decimal>* s, auto it) {
 	    return L(s,it) && R(s,it);
@@ -93,6 +240,48 @@ namespace mkc_timeseries
     }
 
   private:
+    static void appendComparisons(PatternExpression* expr,
+				  std::vector<PalPatternComparison>& comparisons)
+    {
+      if (auto pAnd = dynamic_cast<AndExpr*>(expr))
+	{
+	  appendComparisons(pAnd->getLHS(), comparisons);
+	  appendComparisons(pAnd->getRHS(), comparisons);
+	}
+      else if (auto pGt = dynamic_cast<GreaterThanExpr*>(expr))
+	{
+	  PalPatternComparison comparison;
+	  comparison.lhsField = getPriceBarField(pGt->getLHS());
+	  comparison.lhsOffset = pGt->getLHS()->getBarOffset();
+	  comparison.rhsField = getPriceBarField(pGt->getRHS());
+	  comparison.rhsOffset = pGt->getRHS()->getBarOffset();
+	  comparisons.push_back(comparison);
+	}
+      else {
+        throw PalPatternInterpreterException(
+          "compileEvaluator: unsupported PatternExpression type");
+      }
+    }
+
+    static uint8_t getPriceBarField(PriceBarReference* barRef)
+    {
+      switch (barRef->getReferenceType()) {
+        case PriceBarReference::OPEN:
+          return CompiledPalPattern<Decimal>::OpenField;
+        case PriceBarReference::HIGH:
+          return CompiledPalPattern<Decimal>::HighField;
+        case PriceBarReference::LOW:
+          return CompiledPalPattern<Decimal>::LowField;
+        case PriceBarReference::CLOSE:
+          return CompiledPalPattern<Decimal>::CloseField;
+        case PriceBarReference::VOLUME:
+          return CompiledPalPattern<Decimal>::VolumeField;
+        default:
+          throw PalPatternInterpreterException(
+            "compilePriceBar: unknown PriceBarReference type");
+      }
+    }
+
     /**
      * @brief Compile a PriceBarReference into a fast evaluator lambda.
      */
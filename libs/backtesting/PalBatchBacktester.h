@@ -0,0 +1,455 @@
+// Copyright (C) MKC Associates, LLC - All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+// Written by Michael K. Collison <collison956@gmail.com>, July 2016
+//
+
+#ifndef __PAL_BATCH_BACKTESTER_H
+#define __PAL_BATCH_BACKTESTER_H 1
+
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include "number.h"
+#include "DecimalConstants.h"
+#include "Security.h"
+#include "BackTester.h"
+#include "PalStrategy.h"
+#include "PALPatternInterpreter.h"
+#include "PercentNumber.h"
+#include "ProfitTarget.h"
+#include "StopLoss.h"
+#include "TradingPosition.h"
+
+namespace mkc_timeseries
+{
+  using boost::gregorian::date;
+
+  class PalBatchBacktesterException : public std::runtime_error
+  {
+  public:
+    PalBatchBacktesterException(const std::string msg)
+      : std::runtime_error(msg)
+    {}
+
+    ~PalBatchBacktesterException()
+    {}
+  };
+
+  /**
+   * @class BatchStrategyResult
+   * @brief Flat per-strategy trade summary produced by PalBatchBacktester.
+   *
+   * Holds exactly the quantities the permutation test statistics read from a
+   * ClosedPositionHistory (winner/loser sums, log sums, the cumulative trade
+   * multiplier and the bar-by-bar close-to-close returns), without keeping
+   * any TradingPosition objects around.
+   */
+  template <class Decimal> class BatchStrategyResult
+  {
+  public:
+    BatchStrategyResult()
+      : mNumClosedTrades(0),
+	mNumWinners(0),
+	mNumLosers(0),
+	mSumWinners(DecimalConstants<Decimal>::DecimalZero),
+	mSumLosers(DecimalConstants<Decimal>::DecimalZero),
+	mLogSumWinners(DecimalConstants<Decimal>::DecimalZero),
+	mLogSumLosers(DecimalConstants<Decimal>::DecimalZero),
+	mReturnMultiplier(DecimalConstants<Decimal>::DecimalOne),
+	mHighResReturns()
+    {}
+
+    void clear()
+    {
+      mNumClosedTrades = 0;
+      mNumWinners = 0;
+      mNumLosers = 0;
+      mSumWinners = DecimalConstants<Decimal>::DecimalZero;
+      mSumLosers = DecimalConstants<Decimal>::DecimalZero;
+      mLogSumWinners = DecimalConstants<Decimal>::DecimalZero;
+      mLogSumLosers = DecimalConstants<Decimal>::DecimalZero;
+      mReturnMultiplier = DecimalConstants<Decimal>::DecimalOne;
+      mHighResReturns.clear();
+    }
+
+    /**
+     * @brief Record a closed trade.
+     * @param tradeReturn Signed trade return (positive is a winner).
+     * @param percentReturn Signed trade return in percent.
+     * @param logTradeReturn Signed natural log trade return.
+     */
+    void addClosedTrade(const Decimal& tradeReturn,
+			const Decimal& percentReturn,
+			const Decimal& logTradeReturn)
+    {
+      mNumClosedTrades++;
+
+      if (tradeReturn > DecimalConstants<Decimal>::DecimalZero)
+	{
+	  mNumWinners++;
+	  mSumWinners += percentReturn;
+	  mLogSumWinners += logTradeReturn;
+	}
+      else
+	{
+	  mNumLosers++;
+	  mSumLosers += percentReturn;
+	  mLogSumLosers += logTradeReturn;
+	}
+
+      mReturnMultiplier = mReturnMultiplier * (DecimalConstants<Decimal>::DecimalOne + tradeReturn);
+    }
+
+    void addHighResReturn(const Decimal& barReturn)
+    {
+      mHighResReturns.push_back(barReturn);
+    }
+
+    uint32_t getNumClosedTrades() const
+    {
+      return mNumClosedTrades;
+    }
+
+    uint32_t getNumWinningTrades() const
+    {
+      return mNumWinners;
+    }
+
+    uint32_t getNumLosingTrades() const
+    {
+      return mNumLosers;
+    }
+
+    /**
+     * @brief Bar-by-bar returns of closed trades followed by any still open trade,
+     *        in the same order as BackTester::getAllHighResReturns.
+     */
+    const std::vector<Decimal>& getHighResReturns() const
+    {
+      return mHighResReturns;
+    }
+
+    /// Same definition as ClosedPositionHistory::getProfitFactor
+    Decimal getProfitFactor() const
+    {
+      return getProfitFactorCommon(mSumWinners, mSumLosers);
+    }
+
+    /// Same definition as ClosedPositionHistory::getLogProfitFactor
+    Decimal getLogProfitFactor() const
+    {
+      return getProfitFactorCommon(mLogSumWinners, mLogSumLosers);
+    }
+
+    /// Same definition as ClosedPositionHistory::getCumulativeReturn
+    Decimal getCumulativeReturn() const
+    {
+      if (mNumClosedTrades == 0)
+	return DecimalConstants<Decimal>::DecimalZero;
+
+      return mReturnMultiplier - DecimalConstants<Decimal>::DecimalOne;
+    }
+
+  private:
+    Decimal getProfitFactorCommon(const Decimal& winnersSum, const Decimal& losersSum) const
+    {
+      if (mNumClosedTrades == 0)
+	return DecimalConstants<Decimal>::DecimalZero;
+
+      if ((mNumWinners >= 1) && (mNumLosers >= 1))
+	return (winnersSum / num::abs(losersSum));
+      else if (mNumWinners == 0)
+	return DecimalConstants<Decimal>::DecimalZero;
+      else
+	return DecimalConstants<Decimal>::DecimalOneHundred;
+    }
+
+  private:
+    uint32_t mNumClosedTrades;
+    uint32_t mNumWinners;
+    uint32_t mNumLosers;
+    Decimal mSumWinners;
+    Decimal mSumLosers;
+    Decimal mLogSumWinners;
+    Decimal mLogSumLosers;
+    Decimal mReturnMultiplier;
+    std::vector<Decimal> mHighResReturns;
+  };
+
+  /**
+   * @class PalBatchBacktester
+   * @brief Backtests many PAL patterns against one security in a single pass over its bars.
+   *
+   * The permutation test policies clone a strategy and a BackTester for every
+   * pattern on every synthetic series. This class replaces that with one walk
+   * over the bars of the series: on each bar every pattern predicate is evaluated
+   * and the per-pattern position state lives in flat arrays.
+   *
+   * The trading rules reproduce DailyBackTester driving a non-pyramiding
+   * PalLongStrategy / PalShortStrategy:
+   *  - A pattern is evaluated on a bar only when flat and when the bar number
+   *    (counted from the start of the date range) exceeds the pattern's max bars back.
+   *  - An entry fills at the open of the next bar.
+   *  - Profit target and stop are computed from the fill price and rounded to
+   *    the security's tick, and are first active on the bar after entry.
+   *  - The stop is checked before the profit target; gaps through either fill at the open.
+   *  - Orders are not placed on the last date of the range.
+   *
+   * The backtester is immutable after construction, so one instance can be
+   * shared by all worker threads of a permutation test.
+   */
+  template <class Decimal> class PalBatchBacktester
+  {
+  public:
+
+    /**
+     * @brief Compile the patterns of a set of strategies.
+     * @param strategies Strategies to evaluate; results are returned in the same order.
+     * @param startDate First date of the backtest range.
+     * @param endDate Last date of the backtest range.
+     * @throws PalBatchBacktesterException if a strategy cannot be emulated (see supportsStrategy).
+     */
+    PalBatchBacktester(const std::vector<std::shared_ptr<PalStrategy<Decimal>>>& strategies,
+		       const date& startDate,
+		       const date& endDate)
+      : mStartDate(startDate),
+	mEndDate(endDate),
+	mEvaluators(),
+	mIsLong(),
+	mMaxBarsBack(),
+	mTargetPercent(),
+	mStopPercent()
+    {
+      if (startDate > endDate)
+	throw PalBatchBacktesterException("PalBatchBacktester: start date is after end date");
+
+      const size_t numStrategies = strategies.size();
+      mEvaluators.reserve(numStrategies);
+      mIsLong.reserve(numStrategies);
+      mMaxBarsBack.reserve(numStrategies);
+      mTargetPercent.reserve(numStrategies);
+      mStopPercent.reserve(numStrategies);
+
+      for (const auto& strategy : strategies)
+	{
+	  if (!supportsStrategy(strategy))
+	    throw PalBatchBacktesterException("PalBatchBacktester: strategy " +
+					      (strategy ? strategy->getStrategyName() : std::string("<null>")) +
+					      " cannot be batch evaluated");
+
+	  auto pattern = strategy->getPalPattern();
+	  mEvaluators.push_back(PALPatternInterpreter<Decimal>::compilePattern(pattern->getPatternExpression().get()));
+	  mIsLong.push_back(pattern->isLongPattern());
+	  mMaxBarsBack.push_back(pattern->getMaxBarsBack());
+
+	  Decimal target = pattern->getProfitTargetAsDecimal();
+	  Decimal stop = pattern->getStopLossAsDecimal();
+	  mTargetPercent.push_back(PercentNumber<Decimal>::createPercentNumber(target));
+	  mStopPercent.push_back(PercentNumber<Decimal>::createPercentNumber(stop));
+	}
+    }
+
+    /**
+     * @brief True if the strategy is a non-pyramiding PalLongStrategy or PalShortStrategy
+     *        whose side matches its pattern.
+     */
+    static bool supportsStrategy(const std::shared_ptr<PalStrategy<Decimal>>& strategy)
+    {
+      if (!strategy || !strategy->getPalPattern())
+	return false;
+
+      if (strategy->isPyramidingEnabled())
+	return false;
+
+      auto pattern = strategy->getPalPattern();
+      if (pattern->isLongPattern())
+	return std::dynamic_pointer_cast<PalLongStrategy<Decimal>>(strategy) != nullptr;
+      else if (pattern->isShortPattern())
+	return std::dynamic_pointer_cast<PalShortStrategy<Decimal>>(strategy) != nullptr;
+
+      return false;
+    }
+
+    /**
+     * @brief True if running the strategies through this backtester gives the same
+     *        trades as running them through a clone of the given BackTester.
+     *
+     * Only a single date range DailyBackTester is emulated; weekly and monthly
+     * backtesters step a calendar that does not always land on the series bars.
+     */
+    static bool supportsBackTester(const std::shared_ptr<BackTester<Decimal>>& backTester)
+    {
+      if (!backTester)
+	return false;
+
+      if (!std::dynamic_pointer_cast<DailyBackTester<Decimal>>(backTester))
+	return false;
+
+      return backTester->numBackTestRanges() == 1;
+    }
+
+    size_t getNumStrategies() const
+    {
+      return mEvaluators.size();
+    }
+
+    /**
+     * @brief Backtest every strategy against a security.
+     * @param aSecurity Security (typically synthetic) to trade.
+     * @param results Resized to getNumStrategies(); results[i] belongs to the i-th strategy.
+     */
+    void backtest(Security<Decimal>* aSecurity,
+		  std::vector<BatchStrategyResult<Decimal>>& results) const
+    {
+      if (!aSecurity)
+	throw PalBatchBacktesterException("PalBatchBacktester::backtest - null security");
+
+      const size_t numStrategies = getNumStrategies();
+      results.resize(numStrategies);
+      for (auto& result : results)
+	result.clear();
+
+      std::vector<uint8_t> positionState(numStrategies, FlatState);
+      std::vector<Decimal> entryPrice(numStrategies, DecimalConstants<Decimal>::DecimalZero);
+      std::vector<Decimal> targetPrice(numStrategies, DecimalConstants<Decimal>::DecimalZero);
+      std::vector<Decimal> stopPrice(numStrategies, DecimalConstants<Decimal>::DecimalZero);
+
+      const Decimal& tick = aSecurity->getTick();
+      const Decimal& tickDiv2 = aSecurity->getTickDiv2();
+
+      const OHLCTimeSeries<Decimal>& series = aSecurity->getTimeSeriesReference();
+      auto beginIt = aSecurity->getRandomAccessIteratorBegin();
+      auto endIt = aSecurity->getRandomAccessIteratorEnd();
+      auto it = std::lower_bound(beginIt, endIt, mStartDate,
+				 [](const OHLCTimeSeriesEntry<Decimal>& entry, const date& d)
+				 { return entry.getDateValue() < d; });
+
+      uint32_t barNumber = 0;
+      auto prevIt = it;
+
+      for (; it != endIt && it->getDateValue() <= mEndDate; prevIt = it, ++it)
+	{
+	  const OHLCTimeSeriesEntry<Decimal>& bar = *it;
+
+	  // 1) Orders placed on the previous bar are processed against this bar
+	  if (bar.getDateValue() != mStartDate)
+	    {
+	      for (size_t i = 0; i < numStrategies; ++i)
+		{
+		  if (positionState[i] == OpenState)
+		    {
+		      const Decimal& prevClose = prevIt->getCloseValue();
+		      results[i].addHighResReturn((bar.getCloseValue() - prevClose) / prevClose);
+
+		      if (mIsLong[i])
+			processLongExit(bar, i, positionState, entryPrice, targetPrice, stopPrice, results[i]);
+		      else
+			processShortExit(bar, i, positionState, entryPrice, targetPrice, stopPrice, results[i]);
+		    }
+		  else if (positionState[i] == PendingEntryState)
+		    {
+		      entryPrice[i] = bar.getOpenValue();
+		      if (mIsLong[i])
+			{
+			  LongProfitTarget<Decimal> profitTarget(entryPrice[i], mTargetPercent[i]);
+			  LongStopLoss<Decimal> stopLoss(entryPrice[i], mStopPercent[i]);
+			  targetPrice[i] = num::Round2Tick(profitTarget.getProfitTarget(), tick, tickDiv2);
+			  stopPrice[i] = num::Round2Tick(stopLoss.getStopLoss(), tick, tickDiv2);
+			}
+		      else
+			{
+			  ShortProfitTarget<Decimal> profitTarget(entryPrice[i], mTargetPercent[i]);
+			  ShortStopLoss<Decimal> stopLoss(entryPrice[i], mStopPercent[i]);
+			  targetPrice[i] = num::Round2Tick(profitTarget.getProfitTarget(), tick, tickDiv2);
+			  stopPrice[i] = num::Round2Tick(stopLoss.getStopLoss(), tick, tickDiv2);
+			}
+
+		      positionState[i] = OpenState;
+		    }
+		}
+	    }
+
+	  // 2) Place new entry orders; nothing placed on the last date is ever filled
+	  if (bar.getDateValue() == mEndDate)
+	    continue;
+
+	  barNumber++;
+	  const size_t barIndex = series.getIndex(it);
+	  for (size_t i = 0; i < numStrategies; ++i)
+	    {
+	      if (positionState[i] != FlatState)
+		continue;
+
+	      if ((barNumber > mMaxBarsBack[i]) && mEvaluators[i].evaluate(series, barIndex))
+		positionState[i] = PendingEntryState;
+	    }
+	}
+    }
+
+  private:
+    static void processLongExit(const OHLCTimeSeriesEntry<Decimal>& bar,
+				size_t i,
+				std::vector<uint8_t>& positionState,
+				const std::vector<Decimal>& entryPrice,
+				const std::vector<Decimal>& targetPrice,
+				const std::vector<Decimal>& stopPrice,
+				BatchStrategyResult<Decimal>& result)
+    {
+      Decimal exitPrice;
+
+      // Same precedence as TradingOrderManager: stop orders before limit orders
+      if (bar.getLowValue() < stopPrice[i])
+	exitPrice = (bar.getOpenValue() < stopPrice[i]) ? bar.getOpenValue() : stopPrice[i];
+      else if (bar.getHighValue() > targetPrice[i])
+	exitPrice = (bar.getOpenValue() > targetPrice[i]) ? bar.getOpenValue() : targetPrice[i];
+      else
+	return;
+
+      result.addClosedTrade(calculateTradeReturn<Decimal>(entryPrice[i], exitPrice),
+			    calculatePercentReturn<Decimal>(entryPrice[i], exitPrice),
+			    calculateLogTradeReturn<Decimal>(entryPrice[i], exitPrice));
+      positionState[i] = FlatState;
+    }
+
+    static void processShortExit(const OHLCTimeSeriesEntry<Decimal>& bar,
+				 size_t i,
+				 std::vector<uint8_t>& positionState,
+				 const std::vector<Decimal>& entryPrice,
+				 const std::vector<Decimal>& targetPrice,
+				 const std::vector<Decimal>& stopPrice,
+				 BatchStrategyResult<Decimal>& result)
+    {
+      Decimal exitPrice;
+
+      if (bar.getHighValue() > stopPrice[i])
+	exitPrice = (bar.getOpenValue() > stopPrice[i]) ? bar.getOpenValue() : stopPrice[i];
+      else if (bar.getLowValue() < targetPrice[i])
+	exitPrice = (bar.getOpenValue() < targetPrice[i]) ? bar.getOpenValue() : targetPrice[i];
+      else
+	return;
+
+      result.addClosedTrade(-calculateTradeReturn<Decimal>(entryPrice[i], exitPrice),
+			    -calculatePercentReturn<Decimal>(entryPrice[i], exitPrice),
+			    -calculateLogTradeReturn<Decimal>(entryPrice[i], exitPrice));
+      positionState[i] = FlatState;
+    }
+
+  private:
+    static constexpr uint8_t FlatState = 0;
+    static constexpr uint8_t PendingEntryState = 1;
+    static constexpr uint8_t OpenState = 2;
+
+    date mStartDate;
+    date mEndDate;
+    std::vector<CompiledPalPattern<Decimal>> mEvaluators;
+    std::vector<bool> mIsLong;
+    std::vector<uint32_t> mMaxBarsBack;
+    std::vector<PercentNumber<Decimal>> mTargetPercent;
+    std::vector<PercentNumber<Decimal>> mStopPercent;
+  };
+}
+
+#endif
@@ -49,7 +49,7 @@ namespace mkc_timeseries
       virtual void createEntryOrders(BacktesterStrategy<Decimal> *strategy,
 				     std::shared_ptr<PriceActionLabPattern> pattern, 
 				     Security<Decimal>* aSecurity,
-				     const date& processingDate) const = 0;
+				     const ptime& orderDateTime) const = 0;
     };
 
  template <class Decimal> class FlatEntryOrderConditions : public  EntryOrderConditions<Decimal>
@@ -70,15 +70,15 @@ namespace mkc_timeseries
       void createEntryOrders(BacktesterStrategy<Decimal> *strategy,
 			     std::shared_ptr<PriceActionLabPattern> pattern, 
 			     Security<Decimal>* aSecurity,
-			     const date& processingDate) const
+			     const ptime& orderDateTime) const
 	{
 	  Decimal target = pattern->getProfitTargetAsDecimal();
 	  Decimal stop = pattern->getStopLossAsDecimal();
 
 	  if (pattern->isLongPattern())
-	    strategy->EnterLongOnOpen (aSecurity->getSymbol(), processingDate, stop, target);
+	    strategy->EnterLongOnOpen (aSecurity->getSymbol(), orderDateTime, stop, target);
 	  else
-	    strategy->EnterShortOnOpen (aSecurity->getSymbol(), processingDate, stop, target);
+	    strategy->EnterShortOnOpen (aSecurity->getSymbol(), orderDateTime, stop, target);
 	}
 	
     };
@@ -103,12 +103,12 @@ namespace mkc_timeseries
       void createEntryOrders(BacktesterStrategy<Decimal> *strategy,
 			     std::shared_ptr<PriceActionLabPattern> pattern, 
 			     Security<Decimal>* aSecurity,
-			     const date& processingDate) const
+			     const ptime& orderDateTime) const
 	{
 	  Decimal target = pattern->getProfitTargetAsDecimal();
 	  Decimal stop = pattern->getStopLossAsDecimal();
 
-	  strategy->EnterLongOnOpen (aSecurity->getSymbol(), processingDate, stop, target);
+	  strategy->EnterLongOnOpen (aSecurity->getSymbol(), orderDateTime, stop, target);
 	}
 	
     };
@@ -133,12 +133,12 @@ namespace mkc_timeseries
       void createEntryOrders(BacktesterStrategy<Decimal> *strategy,
 			     std::shared_ptr<PriceActionLabPattern> pattern, 
 			     Security<Decimal>* aSecurity,
-			     const date& processingDate) const
+			     const ptime& orderDateTime) const
 	{
 	  Decimal target = pattern->getProfitTargetAsDecimal();
 	  Decimal stop = pattern->getStopLossAsDecimal();
 
-	  strategy->EnterShortOnOpen (aSecurity->getSymbol(), processingDate, stop, target);
+	  strategy->EnterShortOnOpen (aSecurity->getSymbol(), orderDateTime, stop, target);
 	}
 	
     };
@@ -194,8 +194,7 @@ namespace mkc_timeseries
 	mPalPatterns.push_back(pattern);
 
 	// compile & cache
-	auto eval = PALPatternInterpreter<Decimal>::compileEvaluator(pattern->getPatternExpression().get());
-	mPatternEvaluators.push_back(eval);
+	mPatternEvaluators.push_back(PALPatternInterpreter<Decimal>::compilePattern(pattern->getPatternExpression().get()));
       }
 
     uint32_t getPatternMaxBarsBack() const
@@ -261,13 +260,21 @@ namespace mkc_timeseries
     void eventEntryOrders (Security<Decimal>* aSecurity,
 			   const InstrumentPosition<Decimal>& instrPos,
 			   const date& processingDate)
+    {
+      eventEntryOrders (aSecurity, instrPos, processingDate, aSecurity->getRandomAccessIteratorEnd());
+    }
+
+    void eventEntryOrders (Security<Decimal>* aSecurity,
+			   const InstrumentPosition<Decimal>& instrPos,
+			   const date& processingDate,
+			   const typename Security<Decimal>::ConstRandomAccessIterator& bar)
     {
       if (this->isFlatPosition (aSecurity->getSymbol()))
-	entryOrdersCommon(aSecurity, instrPos, processingDate, FlatEntryOrderConditions<Decimal>());
+	entryOrdersCommon(aSecurity, instrPos, processingDate, bar, FlatEntryOrderConditions<Decimal>());
       else if (this->isLongPosition (aSecurity->getSymbol()))
-	entryOrdersCommon(aSecurity, instrPos, processingDate, LongEntryOrderConditions<Decimal>());
+	entryOrdersCommon(aSecurity, instrPos, processingDate, bar, LongEntryOrderConditions<Decimal>());
       else if (this->isShortPosition (aSecurity->getSymbol()))
-	entryOrdersCommon(aSecurity, instrPos, processingDate, ShortEntryOrderConditions<Decimal>());
+	entryOrdersCommon(aSecurity, instrPos, processingDate, bar, ShortEntryOrderConditions<Decimal>());
       else
 	throw PalStrategyException(std::string("PalMetaStrategy::eventEntryOrders - Unknow position state"));
     }
@@ -275,6 +282,22 @@ namespace mkc_timeseries
     void eventExitOrders (Security<Decimal>* aSecurity,
 			  const InstrumentPosition<Decimal>& instrPos,
 			  const date& processingDate)
+    {
+      exitOrdersCommon (aSecurity, instrPos, ptime (processingDate, getDefaultBarTime()));
+    }
+
+    void eventExitOrders (Security<Decimal>* aSecurity,
+			  const InstrumentPosition<Decimal>& instrPos,
+			  const date& processingDate,
+			  const typename Security<Decimal>::ConstRandomAccessIterator& bar)
+    {
+      exitOrdersCommon (aSecurity, instrPos, this->resolveOrderDateTime (*aSecurity, processingDate, bar));
+    }
+
+  private:
+    void exitOrdersCommon (Security<Decimal>* aSecurity,
+			   const InstrumentPosition<Decimal>& instrPos,
+			   const ptime& orderDateTime)
     {
       // We could be pyramiding or not, either way get the latest position
       uint32_t numUnits = instrPos.getNumPositionUnits();
@@ -292,20 +315,20 @@ namespace mkc_timeseries
       Decimal fillPrice = instrPos.getFillPrice(numUnits);
 
       if (this->isLongPosition (aSecurity->getSymbol()))
-	eventExitLongOrders (aSecurity, instrPos, processingDate, fillPrice, stopAsPercent, targetAsPercent);
+	eventExitLongOrders (aSecurity, instrPos, orderDateTime, fillPrice, stopAsPercent, targetAsPercent);
       else if (this->isShortPosition (aSecurity->getSymbol()))
-	eventExitShortOrders (aSecurity, instrPos, processingDate, fillPrice, stopAsPercent, targetAsPercent);
+	eventExitShortOrders (aSecurity, instrPos, orderDateTime, fillPrice, stopAsPercent, targetAsPercent);
       else
 	throw PalStrategyException(std::string("PalMetaStrategy::eventExitOrders - Expecting long or short positon"));
     }
 
-  private:
     void entryOrdersCommon (Security<Decimal>* aSecurity,
 			    const InstrumentPosition<Decimal>& instrPos,
 			    const date& processingDate,
+			    const typename Security<Decimal>::ConstRandomAccessIterator& bar,
 			    const EntryOrderConditions<Decimal>& entryConditions)
       {
-	auto it = aSecurity->getRandomAccessIterator(processingDate);
+	auto it = this->resolveBar(*aSecurity, processingDate, bar);
 	
 	if (entryConditions.canEnterMarket(this, aSecurity))
 	  {
@@ -321,7 +344,7 @@ namespace mkc_timeseries
 
 		if ((*evalIt)(aSecurity, it))
 		  {
-		    entryConditions.createEntryOrders(this, pricePattern, aSecurity, processingDate);
+		    entryConditions.createEntryOrders(this, pricePattern, aSecurity, it->getDateTime());
 		    break;
 		  }
 	      }
@@ -330,29 +353,29 @@ namespace mkc_timeseries
 
     void eventExitLongOrders (Security<Decimal>* aSecurity,
 			      const InstrumentPosition<Decimal>& instrPos,
-			      const date& processingDate,
+			      const ptime& orderDateTime,
 			      const Decimal& positionEntryPrice,
 			      const PercentNumber<Decimal>& stopAsPercent,
 			      const PercentNumber<Decimal>& targetAsPercent)
       {
 	//std::cout << "PalLongStrategy::eventExitOrders, fill Price =  " << positionEntryPrice << std::endl;
-	this->ExitLongAllUnitsAtLimit(aSecurity->getSymbol(), processingDate,
+	this->ExitLongAllUnitsAtLimit(aSecurity->getSymbol(), orderDateTime,
 				      positionEntryPrice, targetAsPercent);
-	this->ExitLongAllUnitsAtStop(aSecurity->getSymbol(), processingDate,
+	this->ExitLongAllUnitsAtStop(aSecurity->getSymbol(), orderDateTime,
 				     positionEntryPrice, stopAsPercent);
 	instrPos.setRMultipleStop (LongStopLoss<Decimal> (positionEntryPrice, stopAsPercent).getStopLoss());
       }
 
     void eventExitShortOrders (Security<Decimal>* aSecurity,
 			       const InstrumentPosition<Decimal>& instrPos,
-			       const date& processingDate,
+			       const ptime& orderDateTime,
 			       const Decimal& positionEntryPrice,
 			       const PercentNumber<Decimal>& stopAsPercent,
 			       const PercentNumber<Decimal>& targetAsPercent) 
       {
-	this->ExitShortAllUnitsAtLimit(aSecurity->getSymbol(), processingDate,
+	this->ExitShortAllUnitsAtLimit(aSecurity->getSymbol(), orderDateTime,
 				       positionEntryPrice, targetAsPercent);
-	this->ExitShortAllUnitsAtStop(aSecurity->getSymbol(), processingDate,
+	this->ExitShortAllUnitsAtStop(aSecurity->getSymbol(), orderDateTime,
 				      positionEntryPrice, stopAsPercent);
 	instrPos.setRMultipleStop (ShortStopLoss<Decimal> (positionEntryPrice, stopAsPercent).getStopLoss());
       }
@@ -380,7 +403,7 @@ namespace mkc_timeseries
     
   private:
     PalPatterns mPalPatterns;
-    std::vector<typename PALPatternInterpreter<Decimal>::PatternEvaluator> mPatternEvaluators;
+    std::vector<CompiledPalPattern<Decimal>> mPatternEvaluators;
     MCPTStrategyAttributes<Decimal> mMCPTAttributes;
     unsigned int mStrategyMaxBarsBack;
   };
@@ -396,7 +419,7 @@ namespace mkc_timeseries
   template <class Decimal> class PalStrategy : public BacktesterStrategy<Decimal>
     {
     public:
-      using PatternEvaluator = typename PALPatternInterpreter<Decimal>::PatternEvaluator;
+      using PatternEvaluator = CompiledPalPattern<Decimal>;
 
       /**
      * @brief Construct a PalStrategy with a given pattern and portfolio.
@@ -411,19 +434,14 @@ namespace mkc_timeseries
 		const StrategyOptions& strategyOptions)
       : BacktesterStrategy<Decimal>(strategyName, portfolio, strategyOptions),
 	mPalPattern(pattern),
-	mMCPTAttributes()
+	mMCPTAttributes(),
+	mPatternEvaluator()
 	{
+	  // compile the real expression once; with no pattern the default
+	  // constructed evaluator never matches
 	  if (mPalPattern)
-	    {
-	      // compile the real expression once
-	      mPatternEvaluator =
-		PALPatternInterpreter<Decimal>::compileEvaluator(mPalPattern->getPatternExpression().get());
-	    }
-	  else
-	    {
-	      // no pattern ⇒ never match
-	      mPatternEvaluator = [](Security<Decimal>*, auto){ return false; };
-	    }
+	    mPatternEvaluator =
+	      PALPatternInterpreter<Decimal>::compilePattern(mPalPattern->getPatternExpression().get());
 	}
 
       PalStrategy(const PalStrategy<Decimal>& rhs)
@@ -628,6 +646,25 @@ namespace mkc_timeseries
       void eventExitOrders (Security<Decimal>* aSecurity,
 			    const InstrumentPosition<Decimal>& instrPos,
 			    const date& processingDate)
+      {
+	exitOrdersCommon (aSecurity, instrPos, ptime (processingDate, getDefaultBarTime()));
+      }
+
+      /**
+       * @brief Same as above, placing the exit orders on bar (the security's entry for processingDate).
+       */
+      void eventExitOrders (Security<Decimal>* aSecurity,
+			    const InstrumentPosition<Decimal>& instrPos,
+			    const date& processingDate,
+			    const typename Security<Decimal>::ConstRandomAccessIterator& bar)
+      {
+	exitOrdersCommon (aSecurity, instrPos, this->resolveOrderDateTime (*aSecurity, processingDate, bar));
+      }
+
+    private:
+      void exitOrdersCommon (Security<Decimal>* aSecurity,
+			     const InstrumentPosition<Decimal>& instrPos,
+			     const ptime& orderDateTime)
       {
 	if (this->isLongPosition (aSecurity->getSymbol()))
 	  {
@@ -640,9 +677,9 @@ namespace mkc_timeseries
 
 	    Decimal fillPrice = instrPos.getFillPrice();
 
-	    this->ExitLongAllUnitsAtLimit(aSecurity->getSymbol(), processingDate,
+	    this->ExitLongAllUnitsAtLimit(aSecurity->getSymbol(), orderDateTime,
 					  fillPrice, targetAsPercent);
-	    this->ExitLongAllUnitsAtStop(aSecurity->getSymbol(), processingDate,
+	    this->ExitLongAllUnitsAtStop(aSecurity->getSymbol(), orderDateTime,
 					  fillPrice, stopAsPercent);
 	    instrPos.setRMultipleStop (LongStopLoss<Decimal> (fillPrice, stopAsPercent).getStopLoss());
 
@@ -650,6 +687,8 @@ namespace mkc_timeseries
 	  }
       }
 
+    public:
+
       /**
        * @brief Evaluate and submit new long‐entry orders based on the pattern.
        *
@@ -672,6 +711,17 @@ namespace mkc_timeseries
       void eventEntryOrders (Security<Decimal>* aSecurity,
 			     const InstrumentPosition<Decimal>& instrPos,
 			     const date& processingDate)
+      {
+	eventEntryOrders (aSecurity, instrPos, processingDate, aSecurity->getRandomAccessIteratorEnd());
+      }
+
+      /**
+       * @brief Same as above, evaluating the pattern on bar (the security's entry for processingDate).
+       */
+      void eventEntryOrders (Security<Decimal>* aSecurity,
+			     const InstrumentPosition<Decimal>& instrPos,
+			     const date& processingDate,
+			     const typename Security<Decimal>::ConstRandomAccessIterator& bar)
       {
 	auto sym = aSecurity->getSymbol();
 
@@ -681,11 +731,11 @@ namespace mkc_timeseries
 		this->getPalPattern()->getMaxBarsBack())
 	      {
 		typename Security<Decimal>::ConstRandomAccessIterator it = 
-		  aSecurity->getRandomAccessIterator (processingDate);
+		  this->resolveBar (*aSecurity, processingDate, bar);
 
 		if (this->getPatternEvaluator()(aSecurity, it))
 		  {
-		    this->EnterLongOnOpen (sym, processingDate);
+		    this->EnterLongOnOpen (sym, it->getDateTime());
 		  }
 		//this->addFlatPositionBar (aSecurity, processingDate);
 	      }
@@ -784,6 +834,25 @@ namespace mkc_timeseries
       void eventExitOrders (Security<Decimal>* aSecurity,
 			    const InstrumentPosition<Decimal>& instrPos,
 			    const date& processingDate)
+      {
+	exitOrdersCommon (aSecurity, instrPos, ptime (processingDate, getDefaultBarTime()));
+      }
+
+      /**
+       * @brief Same as above, placing the exit orders on bar (the security's entry for processingDate).
+       */
+      void eventExitOrders (Security<Decimal>* aSecurity,
+			    const InstrumentPosition<Decimal>& instrPos,
+			    const date& processingDate,
+			    const typename Security<Decimal>::ConstRandomAccessIterator& bar)
+      {
+	exitOrdersCommon (aSecurity, instrPos, this->resolveOrderDateTime (*aSecurity, processingDate, bar));
+      }
+
+    private:
+      void exitOrdersCommon (Security<Decimal>* aSecurity,
+			     const InstrumentPosition<Decimal>& instrPos,
+			     const ptime& orderDateTime)
       {
 	if (this->isShortPosition (aSecurity->getSymbol()))
 	  {
@@ -798,15 +867,17 @@ namespace mkc_timeseries
 
 	    Decimal fillPrice = instrPos.getFillPrice();
 
-	    this->ExitShortAllUnitsAtLimit(aSecurity->getSymbol(), processingDate,
+	    this->ExitShortAllUnitsAtLimit(aSecurity->getSymbol(), orderDateTime,
 					  fillPrice, targetAsPercent);
-	    this->ExitShortAllUnitsAtStop(aSecurity->getSymbol(), processingDate,
+	    this->ExitShortAllUnitsAtStop(aSecurity->getSymbol(), orderDateTime,
 					  fillPrice, stopAsPercent);
 	    instrPos.setRMultipleStop (ShortStopLoss<Decimal> (fillPrice, stopAsPercent).getStopLoss());
 	    //this->addShortPositionBar (aSecurity, processingDate);
 	  }
       }
 
+    public:
+
       /**
        * @brief Evaluate and submit new short‐entry orders based on the pattern.
        *
@@ -821,6 +892,17 @@ namespace mkc_timeseries
       void eventEntryOrders (Security<Decimal>* aSecurity,
 			     const InstrumentPosition<Decimal>& instrPos,
 			     const date& processingDate)
+      {
+	eventEntryOrders (aSecurity, instrPos, processingDate, aSecurity->getRandomAccessIteratorEnd());
+      }
+
+      /**
+       * @brief Same as above, evaluating the pattern on bar (the security's entry for processingDate).
+       */
+      void eventEntryOrders (Security<Decimal>* aSecurity,
+			     const InstrumentPosition<Decimal>& instrPos,
+			     const date& processingDate,
+			     const typename Security<Decimal>::ConstRandomAccessIterator& bar)
       {
 	auto sym = aSecurity->getSymbol();
 	if (this->isFlatPosition (sym) || this->strategyCanPyramid(sym))
@@ -829,11 +911,11 @@ namespace mkc_timeseries
 		this->getPalPattern()->getMaxBarsBack())
 	      {
 		typename Security<Decimal>::ConstRandomAccessIterator it = 
-		  aSecurity->getRandomAccessIterator (processingDate);
+		  this->resolveBar (*aSecurity, processingDate, bar);
 
 		if (this->getPatternEvaluator()(aSecurity, it))
 		  {
-		    this->EnterShortOnOpen (sym, processingDate);
+		    this->EnterShortOnOpen (sym, it->getDateTime());
 		  }
 		//this->addFlatPositionBar (aSecurity, processingDate);
 	      }
@@ -150,6 +150,17 @@ namespace mkc_timeseries
 	  return mSecurityTimeSeries->getRandomAccessIterator(d);
 	}
 
+      /**
+       * @brief Finds an iterator pointing to the time series entry with an exact timestamp.
+       * @param dt The bar timestamp to find (used for intraday series).
+       * @return A `ConstRandomAccessIterator` pointing to the entry if found,
+       * or `getRandomAccessIteratorEnd()` if there is no bar at `dt`.
+       */
+      Security::ConstRandomAccessIterator findTimeSeriesEntry (const boost::posix_time::ptime& dt) const
+	{
+	  return mSecurityTimeSeries->getTimeSeriesEntry(dt);
+	}
+
       /**
        * @brief Gets a random access iterator pointing to the time series entry for a specific date.
        * @param d The date to retrieve the iterator for.
@@ -166,6 +177,20 @@ namespace mkc_timeseries
 	    throw SecurityException ("No time series entry for date: " +boost::gregorian::to_simple_string (d));
 	}
 
+      /**
+       * @brief Gets a random access iterator pointing to the time series entry with an exact timestamp.
+       * @param dt The bar timestamp to retrieve the iterator for.
+       * @throws SecurityException if there is no bar at `dt`.
+       */
+      Security::ConstRandomAccessIterator getRandomAccessIterator (const boost::posix_time::ptime& dt) const
+	{
+	  Security::ConstRandomAccessIterator it = findTimeSeriesEntry(dt);
+	  if (it != getRandomAccessIteratorEnd())
+	    return it;
+	  else
+	    throw SecurityException ("No time series entry for date: " +boost::posix_time::to_simple_string (dt));
+	}
+
       /**
        * @brief Gets the time series entry (OHLC + Volume) for a specific date.
        * @param d The date to retrieve the entry for.
@@ -310,6 +335,12 @@ namespace mkc_timeseries
 	return mSecurityTimeSeries;
       }
 
+      /** @brief Gets the underlying time series without copying the shared pointer (for per-bar loops). */
+      const OHLCTimeSeries<Decimal>& getTimeSeriesReference() const
+      {
+	return *mSecurityTimeSeries;
+      }
+
       /**
        * @brief Pure virtual method to create a clone of this Security object, potentially with a different time series.
        * @param securityTimeSeries A shared pointer to the constant OHLC time series data for the new cloned security.
@@ -13,6 +13,8 @@
 #include "InstrumentPositionManager.h"
 #include "ClosedPositionHistory.h"
 #include "StrategyTransactionManager.h"
+#include "BacktestArena.h"
+#include "BacktestIdDomain.h"
 #include "ProfitTarget.h"
 #include "StopLoss.h"
 #include "SecurityAttributes.h"
@@ -139,7 +141,9 @@ namespace mkc_timeseries
 	mInstrumentPositionManager(),
 	mStrategyTrades(),
 	mClosedTradeHistory(),
-	mPortfolio(portfolio)
+	mPortfolio(portfolio),
+	mArena(),
+	mIdDomain(std::make_shared<BacktestIdDomain>())
     {
       mOrderManager.addObserver (*this);
       typename Portfolio<Decimal>::ConstPortfolioIterator symbolIterator = mPortfolio->beginPortfolio();
@@ -158,8 +162,12 @@ namespace mkc_timeseries
 	mInstrumentPositionManager(rhs.mInstrumentPositionManager),
 	mStrategyTrades(rhs.mStrategyTrades),
 	mClosedTradeHistory(rhs.mClosedTradeHistory),
-	mPortfolio(rhs.mPortfolio)
-    {}
+	mPortfolio(rhs.mPortfolio),
+	mArena(),
+	mIdDomain(std::make_shared<BacktestIdDomain>())
+    {
+      mIdDomain->advancePast (*rhs.mIdDomain);
+    }
 
     StrategyBroker<Decimal>& 
     operator=(const StrategyBroker<Decimal> &rhs)
@@ -175,10 +183,37 @@ namespace mkc_timeseries
       mStrategyTrades = rhs.mStrategyTrades;
       mClosedTradeHistory = rhs.mClosedTradeHistory;
       mPortfolio = rhs.mPortfolio;
+      mIdDomain->advancePast (*rhs.mIdDomain);
 
       return *this;
     }
 
+    /**
+     * @brief Allocate the orders, positions and transactions of this broker from arena.
+     *
+     * Called by BackTester::addStrategy with the BackTester's arena. Copies of the broker
+     * allocate from the heap again. A null arena also goes back to the heap.
+     */
+    void setBacktestArena(const std::shared_ptr<BacktestArena>& arena)
+    {
+      mArena = arena;
+      mInstrumentPositionManager.setBacktestArena (arena);
+      mStrategyTrades.setBacktestArena (arena);
+      mClosedTradeHistory.setBacktestArena (arena);
+    }
+
+    /**
+     * @brief Take order and position IDs from domain from now on.
+     *
+     * Called by BackTester::addStrategy with the BackTester's domain. The domain first skips
+     * past the IDs this broker has already handed out, so its positions keep unique IDs.
+     */
+    void setBacktestIdDomain(const std::shared_ptr<BacktestIdDomain>& domain)
+    {
+      domain->advancePast (*mIdDomain);
+      mIdDomain = domain;
+    }
+
      /**
      * @brief Returns a constant iterator to the beginning of sorted strategy transactions.
      *
@@ -310,18 +345,19 @@ namespace mkc_timeseries
      * @brief Submit a market-on-open long order.
      *
      * @param tradingSymbol Ticker symbol to trade.
-     * @param orderDate Date of the order.
+     * @param orderDate Timestamp of the bar the order is placed on. Every order method
+     * also has a date overload, which places the order at the default bar time of that date.
      * @param unitsInOrder Number of units to enter.
      * @param stopLoss Optional stop-loss price.
      * @param profitTarget Optional profit-target price.
      */
     void EnterLongOnOpen(const std::string& tradingSymbol, 	
-			 const date& orderDate,
+			 const ptime& orderDate,
 			 const TradingVolume& unitsInOrder,
 			 const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
 			 const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
     {
-      auto order = std::make_shared<MarketOnOpenLongOrder<Decimal>>(tradingSymbol,
+      auto order = makeTradingObject<MarketOnOpenLongOrder<Decimal>>(tradingSymbol,
 								    unitsInOrder,
 								    orderDate,
 								    stopLoss,
@@ -330,6 +366,15 @@ namespace mkc_timeseries
       mOrderManager.addTradingOrder (order);
     }
 
+    void EnterLongOnOpen(const std::string& tradingSymbol, 	
+			 const date& orderDate,
+			 const TradingVolume& unitsInOrder,
+			 const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
+			 const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
+    {
+      EnterLongOnOpen (tradingSymbol, ptime (orderDate, getDefaultBarTime()), unitsInOrder, stopLoss, profitTarget);
+    }
+
     /**
      * @brief Submit a market-on-open short order.
      *
@@ -340,12 +385,12 @@ namespace mkc_timeseries
      * @param profitTarget Optional profit-target price.
      */
     void EnterShortOnOpen(const std::string& tradingSymbol,	
-			  const date& orderDate,
+			  const ptime& orderDate,
 			  const TradingVolume& unitsInOrder,
 			  const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
 			  const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
     {
-      auto order = std::make_shared<MarketOnOpenShortOrder<Decimal>>(tradingSymbol,
+      auto order = makeTradingObject<MarketOnOpenShortOrder<Decimal>>(tradingSymbol,
 								     unitsInOrder,
 								     orderDate,
 								     stopLoss,
@@ -354,18 +399,27 @@ namespace mkc_timeseries
       mOrderManager.addTradingOrder (order);
     }
 
+    void EnterShortOnOpen(const std::string& tradingSymbol,	
+			  const date& orderDate,
+			  const TradingVolume& unitsInOrder,
+			  const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
+			  const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
+    {
+      EnterShortOnOpen (tradingSymbol, ptime (orderDate, getDefaultBarTime()), unitsInOrder, stopLoss, profitTarget);
+    }
+
     /**
      * @brief Exit all long units at market-open.
      * @param tradingSymbol Ticker symbol to exit.
      * @param orderDate Date of the exit order.
      */
     void ExitLongAllUnitsOnOpen(const std::string& tradingSymbol,
-				const date& orderDate,
+				const ptime& orderDate,
 				const TradingVolume& unitsInOrder)
     {
      if (mInstrumentPositionManager.isLongPosition (tradingSymbol))
 	{
-	  auto order = std::make_shared<MarketOnOpenSellOrder<Decimal>>(tradingSymbol,
+	  auto order = makeTradingObject<MarketOnOpenSellOrder<Decimal>>(tradingSymbol,
 								     unitsInOrder,
 								     orderDate);
 
@@ -373,10 +427,17 @@ namespace mkc_timeseries
 	}
       else
 	{
-	  throw StrategyBrokerException("StrategyBroker::ExitLongAllUnitsAtOpen - no long position for " +tradingSymbol +" with order date: " +boost::gregorian::to_simple_string (orderDate));
+	  throw StrategyBrokerException("StrategyBroker::ExitLongAllUnitsAtOpen - no long position for " +tradingSymbol +" with order date: " +boost::posix_time::to_simple_string (orderDate));
 	}
     }
 
+    void ExitLongAllUnitsOnOpen(const std::string& tradingSymbol,
+				const date& orderDate,
+				const TradingVolume& unitsInOrder)
+    {
+      ExitLongAllUnitsOnOpen (tradingSymbol, ptime (orderDate, getDefaultBarTime()), unitsInOrder);
+    }
+
      /**
       * @brief Submits a market-on-open order to exit all units of an existing long position.
       * The volume is determined automatically from the current position.
@@ -385,7 +446,7 @@ namespace mkc_timeseries
       * @throws StrategyBrokerException if no long position exists for the symbol.
       */
     void ExitLongAllUnitsOnOpen(const std::string& tradingSymbol,
-				const date& orderDate)
+				const ptime& orderDate)
     {
      if (mInstrumentPositionManager.isLongPosition (tradingSymbol))
 	{
@@ -394,21 +455,27 @@ namespace mkc_timeseries
 	}
            else
 	{
-	  throw StrategyBrokerException("StrategyBroker::ExitLongAllUnitsAtOpen - no long position for " +tradingSymbol +" with order date: " +boost::gregorian::to_simple_string (orderDate));
+	  throw StrategyBrokerException("StrategyBroker::ExitLongAllUnitsAtOpen - no long position for " +tradingSymbol +" with order date: " +boost::posix_time::to_simple_string (orderDate));
 	}
     }
 
+    void ExitLongAllUnitsOnOpen(const std::string& tradingSymbol,
+				const date& orderDate)
+    {
+      ExitLongAllUnitsOnOpen (tradingSymbol, ptime (orderDate, getDefaultBarTime()));
+    }
+
     /**
      * @brief Exit all short units at market-open.
      * @param tradingSymbol Ticker symbol to exit.
      * @param orderDate Date of the exit order.
      */
     void ExitShortAllUnitsOnOpen(const std::string& tradingSymbol,
-				 const date& orderDate)
+				 const ptime& orderDate)
     {
       if (mInstrumentPositionManager.isShortPosition (tradingSymbol))
 	{
-	  auto order = std::make_shared<MarketOnOpenCoverOrder<Decimal>>(tradingSymbol,
+	  auto order = makeTradingObject<MarketOnOpenCoverOrder<Decimal>>(tradingSymbol,
 								       mInstrumentPositionManager.getVolumeInAllUnits(tradingSymbol),
 								      orderDate);
 
@@ -416,10 +483,16 @@ namespace mkc_timeseries
 	}
       else
 	{
-	  StrategyBrokerException("StrategyBroker::ExitShortAllUnitsAtOpen - no short position for " +tradingSymbol +" with order date: " +boost::gregorian::to_simple_string (orderDate));
+	  StrategyBrokerException("StrategyBroker::ExitShortAllUnitsAtOpen - no short position for " +tradingSymbol +" with order date: " +boost::posix_time::to_simple_string (orderDate));
 	}
     }
 
+    void ExitShortAllUnitsOnOpen(const std::string& tradingSymbol,
+				 const date& orderDate)
+    {
+      ExitShortAllUnitsOnOpen (tradingSymbol, ptime (orderDate, getDefaultBarTime()));
+    }
+
     /**
      * @brief Submits a limit order to sell (exit) all units of an existing long position at a specified limit price.
      * @param tradingSymbol The symbol of the instrument.
@@ -428,14 +501,14 @@ namespace mkc_timeseries
      * @throws StrategyBrokerException if no long position exists for the symbol.
      */
     void ExitLongAllUnitsAtLimit(const std::string& tradingSymbol,
-				 const date& orderDate,
+				 const ptime& orderDate,
 				 const Decimal& limitPrice)
     {
       //std::cout << "Entering long profit target at: " << limitPrice << " on date: " << orderDate << std::endl;
 
       if (mInstrumentPositionManager.isLongPosition (tradingSymbol))
 	{
-	  auto order = std::make_shared<SellAtLimitOrder<Decimal>>(tradingSymbol,
+	  auto order = makeTradingObject<SellAtLimitOrder<Decimal>>(tradingSymbol,
 								mInstrumentPositionManager.getVolumeInAllUnits(tradingSymbol),
 								orderDate,
 								limitPrice);
@@ -444,10 +517,17 @@ namespace mkc_timeseries
 	}
       else
 	{
-	  throw StrategyBrokerException("StrategyBroker::ExitLongAllUnitsAtLimit - no long position for " +tradingSymbol +" with order date: " +boost::gregorian::to_simple_string (orderDate));
+	  throw StrategyBrokerException("StrategyBroker::ExitLongAllUnitsAtLimit - no long position for " +tradingSymbol +" with order date: " +boost::posix_time::to_simple_string (orderDate));
 	}
     }
 
+    void ExitLongAllUnitsAtLimit(const std::string& tradingSymbol,
+				 const date& orderDate,
+				 const Decimal& limitPrice)
+    {
+      ExitLongAllUnitsAtLimit (tradingSymbol, ptime (orderDate, getDefaultBarTime()), limitPrice);
+    }
+
     /**
      * @brief Submits a limit order to sell (exit) all units of an existing long position,
      * with the limit price calculated as a percentage above a base price.
@@ -458,7 +538,7 @@ namespace mkc_timeseries
      * @throws StrategyBrokerException if no long position exists for the symbol or if tick data is unavailable.
      */
     void ExitLongAllUnitsAtLimit(const std::string& tradingSymbol,
-				 const date& orderDate,
+				 const ptime& orderDate,
 				 const Decimal& limitBasePrice,
 				 const PercentNumber<Decimal>& percentNum)
     {
@@ -470,6 +550,14 @@ namespace mkc_timeseries
       this->ExitLongAllUnitsAtLimit (tradingSymbol, orderDate, orderPrice);
     }
 
+    void ExitLongAllUnitsAtLimit(const std::string& tradingSymbol,
+				 const date& orderDate,
+				 const Decimal& limitBasePrice,
+				 const PercentNumber<Decimal>& percentNum)
+    {
+      ExitLongAllUnitsAtLimit (tradingSymbol, ptime (orderDate, getDefaultBarTime()), limitBasePrice, percentNum);
+    }
+
     /**
      * @brief Submits a limit order to cover (exit) all units of an existing short position at a specified limit price.
      * @param tradingSymbol The symbol of the instrument.
@@ -478,12 +566,12 @@ namespace mkc_timeseries
      * @throws StrategyBrokerException if no short position exists for the symbol.
      */
     void ExitShortAllUnitsAtLimit(const std::string& tradingSymbol,
-				  const date& orderDate,
+				  const ptime& orderDate,
 				  const Decimal& limitPrice)
     {
       if (mInstrumentPositionManager.isShortPosition (tradingSymbol))
 	{
-	  auto order = std::make_shared<CoverAtLimitOrder<Decimal>>(tradingSymbol,
+	  auto order = makeTradingObject<CoverAtLimitOrder<Decimal>>(tradingSymbol,
 								 mInstrumentPositionManager.getVolumeInAllUnits(tradingSymbol),
 								 orderDate,
 								 limitPrice);
@@ -492,10 +580,17 @@ namespace mkc_timeseries
 	}
       else
 	{
-	  throw StrategyBrokerException("StrategyBroker::ExitShortAllUnitsAtLimit - no short position for " +tradingSymbol +" with order date: " +boost::gregorian::to_simple_string (orderDate));
+	  throw StrategyBrokerException("StrategyBroker::ExitShortAllUnitsAtLimit - no short position for " +tradingSymbol +" with order date: " +boost::posix_time::to_simple_string (orderDate));
 	}
     }
 
+    void ExitShortAllUnitsAtLimit(const std::string& tradingSymbol,
+				  const date& orderDate,
+				  const Decimal& limitPrice)
+    {
+      ExitShortAllUnitsAtLimit (tradingSymbol, ptime (orderDate, getDefaultBarTime()), limitPrice);
+    }
+
     /**
      * @brief Submits a limit order to cover (exit) all units of an existing short position,
      * with the limit price calculated as a percentage below a base price.
@@ -506,7 +601,7 @@ namespace mkc_timeseries
      * @throws StrategyBrokerException if no short position exists for the symbol or if tick data is unavailable.
      */
     void ExitShortAllUnitsAtLimit(const std::string& tradingSymbol,
-				 const date& orderDate,
+				 const ptime& orderDate,
 				 const Decimal& limitBasePrice,
 				 const PercentNumber<Decimal>& percentNum)
     {
@@ -520,6 +615,14 @@ namespace mkc_timeseries
       this->ExitShortAllUnitsAtLimit (tradingSymbol,orderDate,orderPrice);
     }
 
+    void ExitShortAllUnitsAtLimit(const std::string& tradingSymbol,
+				 const date& orderDate,
+				 const Decimal& limitBasePrice,
+				 const PercentNumber<Decimal>& percentNum)
+    {
+      ExitShortAllUnitsAtLimit (tradingSymbol, ptime (orderDate, getDefaultBarTime()), limitBasePrice, percentNum);
+    }
+
     /**
      * @brief Submits a stop order to sell (exit) all units of an existing long position at a specified stop price.
      * @param tradingSymbol The symbol of the instrument.
@@ -528,12 +631,12 @@ namespace mkc_timeseries
      * @throws StrategyBrokerException if no long position exists for the symbol.
      */
     void ExitLongAllUnitsAtStop(const std::string& tradingSymbol,
-				const date& orderDate,
+				const ptime& orderDate,
 				const Decimal& stopPrice)
     {
       if (mInstrumentPositionManager.isLongPosition (tradingSymbol))
 	{
-	  auto order = std::make_shared<SellAtStopOrder<Decimal>>(tradingSymbol,
+	  auto order = makeTradingObject<SellAtStopOrder<Decimal>>(tradingSymbol,
 							       mInstrumentPositionManager.getVolumeInAllUnits(tradingSymbol),
 							       orderDate,
 							       stopPrice);
@@ -542,10 +645,17 @@ namespace mkc_timeseries
 	}
       else
 	{
-	  throw StrategyBrokerException("StrategyBroker::ExitLongAllUnitsAtStop - no long position for " +tradingSymbol +" with order date: " +boost::gregorian::to_simple_string (orderDate));
+	  throw StrategyBrokerException("StrategyBroker::ExitLongAllUnitsAtStop - no long position for " +tradingSymbol +" with order date: " +boost::posix_time::to_simple_string (orderDate));
 	}
     }
 
+    void ExitLongAllUnitsAtStop(const std::string& tradingSymbol,
+				const date& orderDate,
+				const Decimal& stopPrice)
+    {
+      ExitLongAllUnitsAtStop (tradingSymbol, ptime (orderDate, getDefaultBarTime()), stopPrice);
+    }
+
     /**
      * @brief Submits a stop order to sell (exit) all units of an existing long position,
      * with the stop price calculated as a percentage below a base price.
@@ -557,7 +667,7 @@ namespace mkc_timeseries
      * @throws StrategyBrokerException if no long position exists for the symbol or if tick data is unavailable.
      */
     void ExitLongAllUnitsAtStop(const std::string& tradingSymbol,
-				const date& orderDate,
+				const ptime& orderDate,
 				const Decimal& stopBasePrice,
 				const PercentNumber<Decimal>& percentNum)
     {
@@ -569,6 +679,14 @@ namespace mkc_timeseries
       this->ExitLongAllUnitsAtStop(tradingSymbol, orderDate, orderPrice);
     }
 
+    void ExitLongAllUnitsAtStop(const std::string& tradingSymbol,
+				const date& orderDate,
+				const Decimal& stopBasePrice,
+				const PercentNumber<Decimal>& percentNum)
+    {
+      ExitLongAllUnitsAtStop (tradingSymbol, ptime (orderDate, getDefaultBarTime()), stopBasePrice, percentNum);
+    }
+
     /**
      * @brief Submits a stop order to cover (exit) all units of an existing short position at a specified stop price.
      * @param tradingSymbol The symbol of the instrument.
@@ -577,12 +695,12 @@ namespace mkc_timeseries
      * @throws StrategyBrokerException if no short position exists for the symbol.
      */
     void ExitShortAllUnitsAtStop(const std::string& tradingSymbol,
-				 const date& orderDate,
+				 const ptime& orderDate,
 				 const Decimal& stopPrice)
     {
       if (mInstrumentPositionManager.isShortPosition (tradingSymbol))
 	{
-	  auto order = std::make_shared<CoverAtStopOrder<Decimal>>(tradingSymbol,
+	  auto order = makeTradingObject<CoverAtStopOrder<Decimal>>(tradingSymbol,
 							       	mInstrumentPositionManager.getVolumeInAllUnits(tradingSymbol),
 							       orderDate,
 							       stopPrice);
@@ -591,10 +709,17 @@ namespace mkc_timeseries
 	}
       else
 	{
-	  throw StrategyBrokerException("StrategyBroker::ExitShortAllUnitsAtStop - no short position for " +tradingSymbol +" with order date: " +boost::gregorian::to_simple_string (orderDate));
+	  throw StrategyBrokerException("StrategyBroker::ExitShortAllUnitsAtStop - no short position for " +tradingSymbol +" with order date: " +boost::posix_time::to_simple_string (orderDate));
 	}
     }
 
+    void ExitShortAllUnitsAtStop(const std::string& tradingSymbol,
+				 const date& orderDate,
+				 const Decimal& stopPrice)
+    {
+      ExitShortAllUnitsAtStop (tradingSymbol, ptime (orderDate, getDefaultBarTime()), stopPrice);
+    }
+
     /**
      * @brief Submits a stop order to cover (exit) all units of an existing short position,
      * with the stop price calculated as a percentage above a base price.
@@ -605,7 +730,7 @@ namespace mkc_timeseries
      * @throws StrategyBrokerException if no short position exists for the symbol or if tick data is unavailable.
      */
     void ExitShortAllUnitsAtStop(const std::string& tradingSymbol,
-				 const date& orderDate,
+				 const ptime& orderDate,
 				 const Decimal& stopBasePrice,
 				 const PercentNumber<Decimal>& percentNum)
     {
@@ -616,6 +741,14 @@ namespace mkc_timeseries
       this->ExitShortAllUnitsAtStop(tradingSymbol, orderDate, orderPrice);
     }
 
+    void ExitShortAllUnitsAtStop(const std::string& tradingSymbol,
+				 const date& orderDate,
+				 const Decimal& stopBasePrice,
+				 const PercentNumber<Decimal>& percentNum)
+    {
+      ExitShortAllUnitsAtStop (tradingSymbol, ptime (orderDate, getDefaultBarTime()), stopBasePrice, percentNum);
+    }
+
     /**
      * @brief Returns a constant iterator to the beginning of pending orders in the `TradingOrderManager`.
      * @return A PendingOrderIterator pointing to the first pending order.
@@ -641,6 +774,14 @@ namespace mkc_timeseries
      * @param orderProcessingDate The date for which orders are to be processed.
      */
     void ProcessPendingOrders(const date& orderProcessingDate)
+    {
+      ProcessPendingOrders (ptime (orderProcessingDate, getDefaultBarTime()));
+    }
+
+    /**
+     * @brief Same as above for the bar with timestamp orderProcessingDate (intraday series).
+     */
+    void ProcessPendingOrders(const ptime& orderProcessingDate)
     {
       // Add historical bar for this date before possibly closing any open
       // positions
@@ -660,7 +801,7 @@ namespace mkc_timeseries
       auto position = createLongTradingPosition (order,
 						 order->getStopLoss(),
 						 order->getProfitTarget());
-      auto pOrder = std::make_shared<MarketOnOpenLongOrder<Decimal>>(*order);
+      auto pOrder = makeArenaShared<MarketOnOpenLongOrder<Decimal>>(mArena, *order);
 
       mInstrumentPositionManager.addPosition (position);
       mStrategyTrades.addStrategyTransaction (createStrategyTransaction (pOrder, position));
@@ -676,7 +817,7 @@ namespace mkc_timeseries
       auto position = createShortTradingPosition (order,
 						  order->getStopLoss(),
 						  order->getProfitTarget());
-      auto pOrder = std::make_shared<MarketOnOpenShortOrder<Decimal>>(*order);
+      auto pOrder = makeArenaShared<MarketOnOpenShortOrder<Decimal>>(mArena, *order);
 
       mInstrumentPositionManager.addPosition (position);
       mStrategyTrades.addStrategyTransaction (createStrategyTransaction (pOrder, position));
@@ -841,7 +982,7 @@ namespace mkc_timeseries
      * `TradingPosition` to the `mClosedTradeHistory`.
      * @param aPosition Pointer to the TradingPosition that has been closed.
      * @throws StrategyBrokerException if the strategy transaction for the closed position cannot be found.
-     */
+     */
     void PositionClosed (TradingPosition<Decimal> *aPosition)
     {
       typename StrategyTransactionManager<Decimal>::StrategyTransactionIterator it =
@@ -881,15 +1022,15 @@ namespace mkc_timeseries
     }
 
     /**
-     * @brief Retrieves the OHLC time series entry (bar data) for a given symbol and date from the `Portfolio`.
+     * @brief Retrieves the OHLC time series entry (bar data) for a given symbol and bar timestamp from the `Portfolio`.
      * This data is used, for example, as the entry bar for a new `TradingPosition`.
      * @param tradingSymbol The trading symbol.
-     * @param d The date for which to retrieve the bar data.
+     * @param d The timestamp of the bar to retrieve.
      * @return The OHLCTimeSeriesEntry for the specified symbol and date.
      * @throws StrategyBrokerException if the symbol is not found in the portfolio or if data for the date is missing.
-     */
+     */
     OHLCTimeSeriesEntry<Decimal> getEntryBar (const std::string& tradingSymbol,
-							const boost::gregorian::date& d)
+							const ptime& d)
     {
       typename Portfolio<Decimal>::ConstPortfolioIterator symbolIterator = mPortfolio->findSecurity (tradingSymbol);
       if (symbolIterator != mPortfolio->endPortfolio())
@@ -916,10 +1057,10 @@ namespace mkc_timeseries
 			       const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
 			       const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
     {
-      auto position = std::make_shared<TradingPositionLong<Decimal>> (order->getTradingSymbol(), 
+      auto position = makeTradingObject<TradingPositionLong<Decimal>>(order->getTradingSymbol(), 
 								      order->getFillPrice(),
 								      getEntryBar (order->getTradingSymbol(), 
-										   order->getFillDate()),
+										   order->getFillDateTime()),
 								      order->getUnitsInOrder());
       position->setStopLoss(stopLoss);
       position->setProfitTarget(profitTarget);
@@ -941,10 +1082,10 @@ namespace mkc_timeseries
 				const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
     {
       auto position = 
-	std::make_shared<TradingPositionShort<Decimal>> (order->getTradingSymbol(), 
+	makeTradingObject<TradingPositionShort<Decimal>>(order->getTradingSymbol(), 
 						      order->getFillPrice(),
 						      getEntryBar (order->getTradingSymbol(), 
-								   order->getFillDate()),
+								   order->getFillDateTime()),
 						      order->getUnitsInOrder());
 
       position->setStopLoss(stopLoss);
@@ -954,6 +1095,18 @@ namespace mkc_timeseries
       return position;
     }
 
+    /**
+     * @brief Creates a new order or position in this broker's arena, taking its ID from
+     * this broker's ID domain.
+     * @return A shared pointer to the newly created object.
+     */
+    template <class T, class... Args>
+    std::shared_ptr<T> makeTradingObject (Args&&... args)
+    {
+      BacktestIdDomain::Scope idScope (*mIdDomain);
+      return makeArenaShared<T>(mArena, std::forward<Args>(args)...);
+    }
+
     /**
      * @brief Creates a new `StrategyTransaction` linking an entry order with its resulting trading position.
      * This transaction represents the start of a trade's lifecycle.
@@ -965,7 +1118,7 @@ namespace mkc_timeseries
     createStrategyTransaction (std::shared_ptr<TradingOrder<Decimal>> order,
 			       std::shared_ptr<TradingPosition<Decimal>> position)
     {
-      return std::make_shared<StrategyTransaction<Decimal>>(order, position);
+      return makeArenaShared<StrategyTransaction<Decimal>>(mArena, order, position);
     }
 
      /**
@@ -988,7 +1141,7 @@ namespace mkc_timeseries
       shared_ptr<StrategyTransaction<Decimal>> aTransaction;
       std::shared_ptr<TradingPosition<Decimal>> pos;
       //std::shared_ptr<T> exitOrder(*order);
-      auto exitOrder = std::make_shared<T>(*order);
+      auto exitOrder = makeArenaShared<T>(mArena, *order);
 
       for (; positionIterator != instrumentPosition.endInstrumentPosition(); positionIterator++)
 	{
@@ -1006,7 +1159,7 @@ namespace mkc_timeseries
 	}
 
       mInstrumentPositionManager.closeAllPositions (order->getTradingSymbol(),
-						    order->getFillDate(),
+						    order->getFillDateTime(),
 						    order->getFillPrice()); 
       
     }
@@ -1018,6 +1171,8 @@ namespace mkc_timeseries
     StrategyTransactionManager<Decimal> mStrategyTrades;
     ClosedPositionHistory<Decimal> mClosedTradeHistory;
     std::shared_ptr<Portfolio<Decimal>> mPortfolio;
+    std::shared_ptr<BacktestArena> mArena;
+    std::shared_ptr<BacktestIdDomain> mIdDomain;
   };
 
 
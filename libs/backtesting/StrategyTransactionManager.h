@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <map>
 #include "StrategyTransaction.h"
+#include "BacktestArena.h"
 
 using std::shared_ptr;
 using boost::gregorian::date;
@@ -86,9 +87,9 @@ namespace mkc_timeseries
   template <class Decimal> class StrategyTransactionManager : public StrategyTransactionObserver<Decimal>
   {
   public:
-    typedef typename std::map<uint32_t, shared_ptr<StrategyTransaction<Decimal>>>::const_iterator 
+    typedef typename ArenaMap<uint32_t, shared_ptr<StrategyTransaction<Decimal>>>::const_iterator 
       StrategyTransactionIterator;
-    typedef typename multimap<date, shared_ptr<StrategyTransaction<Decimal>>>::const_iterator 
+    typedef typename ArenaMultimap<date, shared_ptr<StrategyTransaction<Decimal>>>::const_iterator 
       SortedStrategyTransactionIterator;
 
   public:
@@ -181,6 +182,15 @@ namespace mkc_timeseries
 	}
     }
 
+    /**
+     * @brief Allocate the transaction map nodes from arena from now on (existing entries are kept).
+     */
+    void setBacktestArena (const std::shared_ptr<BacktestArena>& arena)
+    {
+      rebindToArena (mTransactionByPositionId, arena);
+      rebindToArena (mSortedTransactions, arena);
+    }
+
     /**
      * @brief Gets the total number of transactions added (both open and closed).
      * @return The total transaction count.
@@ -260,11 +270,11 @@ namespace mkc_timeseries
     uint32_t mCompletedTransactions;
     uint32_t mOpenTransactions;
 
-    std::map<uint32_t, shared_ptr<StrategyTransaction<Decimal>>> mTransactionByPositionId;
+    ArenaMap<uint32_t, shared_ptr<StrategyTransaction<Decimal>>> mTransactionByPositionId;
  
     // Sorted transactions; sorted by position entry date. Need multimap, because we can have multiple
     // positions entered on the same date
-    std::multimap< boost::gregorian::date, shared_ptr<StrategyTransaction<Decimal>>> mSortedTransactions;
+    ArenaMultimap<boost::gregorian::date, shared_ptr<StrategyTransaction<Decimal>>> mSortedTransactions;
   };
 }
 #endif
@@ -1,4 +1,9 @@
+#ifndef __SYNTHETIC_SECURITY_HELPERS_H
+#define __SYNTHETIC_SECURITY_HELPERS_H 1
+
 #include <memory>
+#include <mutex>
+#include <vector>
 #include "number.h"
 #include "Security.h"
 #include "Portfolio.h"
@@ -28,4 +33,115 @@ namespace mkc_timeseries
 
     return syntheticPortfolio;
   }
+
+  /**
+   * @brief A synthetic security whose price series is regenerated in place.
+   *
+   * Wraps a ReusableSyntheticTimeSeries and one clone of the real security
+   * that refers to it. createSyntheticSecurity() reshuffles the series and
+   * returns that same clone, so a permutation worker pays for the relative
+   * factors, the series and the Security once instead of once per permutation.
+   * The returned security is only valid until the next call.
+   */
+  template <class Decimal>
+  class ReusableSyntheticSecurity
+  {
+  public:
+    explicit ReusableSyntheticSecurity(const std::shared_ptr<Security<Decimal>>& realSecurity)
+      : mSyntheticSeries(*realSecurity->getTimeSeries(), realSecurity->getTick(), realSecurity->getTickDiv2()),
+	mSyntheticSecurity(realSecurity->clone(mSyntheticSeries.getSyntheticTimeSeries()))
+    {}
+
+    ReusableSyntheticSecurity(const ReusableSyntheticSecurity&) = delete;
+    ReusableSyntheticSecurity& operator=(const ReusableSyntheticSecurity&) = delete;
+
+    std::shared_ptr<Security<Decimal>> createSyntheticSecurity()
+    {
+      mSyntheticSeries.createSyntheticSeries();
+      return mSyntheticSecurity;
+    }
+
+    std::shared_ptr<Portfolio<Decimal>>
+    createSyntheticPortfolio(const std::shared_ptr<Portfolio<Decimal>>& realPortfolio)
+    {
+      std::shared_ptr<Portfolio<Decimal>> syntheticPortfolio = realPortfolio->clone();
+      syntheticPortfolio->addSecurity (createSyntheticSecurity());
+
+      return syntheticPortfolio;
+    }
+
+  private:
+    ReusableSyntheticTimeSeries<Decimal> mSyntheticSeries;
+    std::shared_ptr<Security<Decimal>> mSyntheticSecurity;
+  };
+
+  /**
+   * @brief Hands out ReusableSyntheticSecurity instances to permutation workers.
+   *
+   * Tasks call acquire() at the start of a permutation and release() when
+   * the backtests on the synthetic security are finished. An instance is
+   * created only when none is idle, so a run creates at most as many as it
+   * has concurrently running tasks. This works with any executor.
+   * If a task throws before calling release(), its instance is simply
+   * destroyed.
+   */
+  template <class Decimal>
+  class SyntheticSecurityPool
+  {
+  public:
+    using Generator = ReusableSyntheticSecurity<Decimal>;
+
+    explicit SyntheticSecurityPool(const std::shared_ptr<Security<Decimal>>& realSecurity)
+      : mRealSecurity(realSecurity),
+	mIdle(),
+	mMutex()
+    {}
+
+    SyntheticSecurityPool(const SyntheticSecurityPool&) = delete;
+    SyntheticSecurityPool& operator=(const SyntheticSecurityPool&) = delete;
+
+    std::unique_ptr<Generator> acquire()
+    {
+      {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!mIdle.empty())
+	  {
+	    std::unique_ptr<Generator> generator = std::move(mIdle.back());
+	    mIdle.pop_back();
+	    return generator;
+	  }
+      }
+
+      return std::make_unique<Generator>(mRealSecurity);
+    }
+
+    void release(std::unique_ptr<Generator> generator)
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mIdle.push_back(std::move(generator));
+    }
+
+    /**
+     * @brief Calls fn with a freshly permuted synthetic portfolio, then releases its generator.
+     *
+     * Every call draws a new permutation; permIndex is accepted so the pool and a
+     * pre-generated permutation bank can be used interchangeably.
+     */
+    template <class Fn>
+    void withSyntheticPortfolio(uint32_t /* permIndex */,
+				const std::shared_ptr<Portfolio<Decimal>>& realPortfolio,
+				Fn&& fn)
+    {
+      auto generator = acquire();
+      fn(generator->createSyntheticPortfolio(realPortfolio));
+      release(std::move(generator));
+    }
+
+  private:
+    std::shared_ptr<Security<Decimal>> mRealSecurity;
+    std::vector<std::unique_ptr<Generator>> mIdle;
+    std::mutex mMutex;
+  };
 }
+
+#endif
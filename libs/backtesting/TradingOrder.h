@@ -23,7 +23,7 @@
 #include "TradingOrderException.h"
 #include "TimeSeriesEntry.h"
 #include "DecimalConstants.h"
-#include <atomic>
+#include "BacktestIdDomain.h"
 
 using namespace boost::gregorian;
 
@@ -142,9 +142,9 @@ namespace mkc_timeseries
   *   - Contract: Must notify all registered observers that this order has been canceled.
   *   - May also trigger cleanup of any associated strategy state.
   *
-  * - `void ValidateOrderExecution(const TimeSeriesDate& fillDate, const Decimal& fillPrice) const`
+  * - `void ValidateOrderExecution(const ptime& fillDateTime, const Decimal& fillPrice) const`
   *   - Purpose: Validates that the provided fill data is consistent with this order’s contract.
-  *   - Contract: Must throw an exception if fillDate is before the order date, or if the price violates limit/stop conditions.
+  *   - Contract: Must throw an exception if fillDateTime is before the order date, or if the price violates limit/stop conditions.
   *   - Used to enforce correctness in order processing and simulation integrity.
   */ 
   template <class Decimal> class TradingOrder
@@ -155,7 +155,13 @@ namespace mkc_timeseries
   public:
     TradingOrder(const std::string& tradingSymbol, 
 		 const TradingVolume& unitsInOrder,
-		 const TimeSeriesDate& orderDate);
+		 const ptime& orderDateTime);
+
+    TradingOrder(const std::string& tradingSymbol, 
+		 const TradingVolume& unitsInOrder,
+		 const TimeSeriesDate& orderDate)
+      : TradingOrder(tradingSymbol, unitsInOrder, ptime(orderDate, getDefaultBarTime()))
+    {}
 
     virtual ~TradingOrder()
     {}
@@ -163,6 +169,7 @@ namespace mkc_timeseries
     TradingOrder (const TradingOrder<Decimal>& rhs)
       : mTradingSymbol(rhs.mTradingSymbol),
 	mUnitsInOrder(rhs.mUnitsInOrder),
+	mOrderDateTime (rhs.mOrderDateTime),
 	mOrderDate (rhs.mOrderDate),
 	mOrderState (rhs.mOrderState),
 	mOrderID(rhs.mOrderID),
@@ -177,6 +184,7 @@ namespace mkc_timeseries
 
       mTradingSymbol = rhs.mTradingSymbol;
       mUnitsInOrder = rhs.mUnitsInOrder;
+      mOrderDateTime = rhs.mOrderDateTime;
       mOrderDate = rhs.mOrderDate;
       mOrderState = rhs.mOrderState;
       mOrderID = rhs.mOrderID;
@@ -200,6 +208,13 @@ namespace mkc_timeseries
       return mOrderDate;
     }
 
+    // Timestamp of the bar the order was placed on; for daily and longer time frames
+    // this is the order date at the default bar time
+    const ptime& getOrderDateTime() const
+    {
+      return mOrderDateTime;
+    }
+
     uint32_t getOrderID() const
     {
       return mOrderID;
@@ -219,10 +234,13 @@ namespace mkc_timeseries
     bool isOrderCanceled() const;
     void MarkOrderExecuted(const TimeSeriesDate& fillDate, 
 			   const Decimal& fillPrice);
+    void MarkOrderExecuted(const ptime& fillDateTime, 
+			   const Decimal& fillPrice);
     void MarkOrderCanceled();
     
     const Decimal& getFillPrice() const;
     const TimeSeriesDate& getFillDate() const;
+    const ptime& getFillDateTime() const;
     virtual void accept (TradingOrderVisitor<Decimal> &visitor) = 0;
 
     void addObserver (std::shared_ptr<TradingOrderObserver<Decimal>> observer)
@@ -243,7 +261,7 @@ namespace mkc_timeseries
 
     virtual void notifyOrderExecuted() = 0;
     virtual void notifyOrderCanceled() = 0;
-    virtual void ValidateOrderExecution(const TimeSeriesDate& fillDate, 
+    virtual void ValidateOrderExecution(const ptime& fillDateTime, 
 					const Decimal& fillPrice) const = 0;
 
   private:
@@ -258,15 +276,13 @@ namespace mkc_timeseries
   private:
     std::string mTradingSymbol;
     TradingVolume mUnitsInOrder;
+    ptime mOrderDateTime;
     TimeSeriesDate mOrderDate;
     std::shared_ptr<TradingOrderState<Decimal>> mOrderState;
     uint32_t mOrderID;
-    static std::atomic<uint32_t> mOrderIDCount;
     std::list<std::shared_ptr<TradingOrderObserver<Decimal>>> mObservers;
   };
 
-  template <class Decimal> std::atomic<uint32_t> TradingOrder<Decimal>::mOrderIDCount{0};
-
   /**
    * @class MarketOrder
    * @brief Represents an unconditional order to be filled immediately at market price.
@@ -280,8 +296,8 @@ namespace mkc_timeseries
     public:
       MarketOrder(const std::string& tradingSymbol, 
 			  const TradingVolume& unitsInOrder,
-			  const TimeSeriesDate& orderDate)
-      : TradingOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate)
+			  const ptime& orderDateTime)
+      : TradingOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime)
     {}
 
       virtual ~MarketOrder()
@@ -322,7 +338,7 @@ namespace mkc_timeseries
 	return 1;
       }
       
-      void ValidateOrderExecution(const TimeSeriesDate& fillDate, 
+      void ValidateOrderExecution(const ptime& fillDateTime, 
 				  const Decimal& fillPrice) const
       {}
   };
@@ -341,10 +357,10 @@ namespace mkc_timeseries
   public:
       MarketEntryOrder(const std::string& tradingSymbol, 
 		       const TradingVolume& unitsInOrder,
-		       const TimeSeriesDate& orderDate,
+		       const ptime& orderDateTime,
 		       const Decimal& stopLoss,
 		       const Decimal& profitTarget)
-      : MarketOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate),
+      : MarketOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime),
 	mStopLoss (stopLoss),
 	mProfitTarget(profitTarget)
       {}
@@ -410,12 +426,20 @@ namespace mkc_timeseries
   {
   public:
 
+    MarketOnOpenLongOrder(const std::string& tradingSymbol, 
+			  const TradingVolume& unitsInOrder,
+			  const ptime& orderDateTime,
+			  const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
+			  const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
+      : MarketEntryOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime, stopLoss, profitTarget)
+    {}
+
     MarketOnOpenLongOrder(const std::string& tradingSymbol, 
 			  const TradingVolume& unitsInOrder,
 			  const TimeSeriesDate& orderDate,
 			  const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
 			  const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
-      : MarketEntryOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate, stopLoss, profitTarget)
+      : MarketOnOpenLongOrder (tradingSymbol, unitsInOrder, ptime (orderDate, getDefaultBarTime()), stopLoss, profitTarget)
     {}
 
     MarketOnOpenLongOrder (const MarketOnOpenLongOrder<Decimal>& rhs)
@@ -478,12 +502,20 @@ namespace mkc_timeseries
   template <class Decimal> class MarketOnOpenShortOrder : public MarketEntryOrder<Decimal>
   {
   public:
+    MarketOnOpenShortOrder(const std::string& tradingSymbol,
+			   const TradingVolume& unitsInOrder,
+			   const ptime& orderDateTime,
+			   const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
+			   const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
+      : MarketEntryOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime, stopLoss, profitTarget)
+    {}
+
     MarketOnOpenShortOrder(const std::string& tradingSymbol,
 			   const TradingVolume& unitsInOrder,
 			   const TimeSeriesDate& orderDate,
 			   const Decimal& stopLoss = DecimalConstants<Decimal>::DecimalZero,
 			   const Decimal& profitTarget = DecimalConstants<Decimal>::DecimalZero)
-      : MarketEntryOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate, stopLoss, profitTarget)
+      : MarketOnOpenShortOrder (tradingSymbol, unitsInOrder, ptime (orderDate, getDefaultBarTime()), stopLoss, profitTarget)
     {}
 
     MarketOnOpenShortOrder (const MarketOnOpenShortOrder<Decimal>& rhs)
@@ -549,8 +581,8 @@ namespace mkc_timeseries
   public:
       MarketExitOrder(const std::string& tradingSymbol, 
 			  const TradingVolume& unitsInOrder,
-			  const TimeSeriesDate& orderDate)
-      : MarketOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate)
+			  const ptime& orderDateTime)
+      : MarketOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime)
       {}
 
       virtual ~MarketExitOrder()
@@ -590,10 +622,16 @@ namespace mkc_timeseries
   {
   public:
 
+    MarketOnOpenSellOrder(const std::string& tradingSymbol, 
+			  const TradingVolume& unitsInOrder,
+			  const ptime& orderDateTime)
+      : MarketExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime)
+    {}
+
     MarketOnOpenSellOrder(const std::string& tradingSymbol, 
 			  const TradingVolume& unitsInOrder,
 			  const TimeSeriesDate& orderDate)
-      : MarketExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate)
+      : MarketOnOpenSellOrder (tradingSymbol, unitsInOrder, ptime (orderDate, getDefaultBarTime()))
     {}
 
     MarketOnOpenSellOrder (const MarketOnOpenSellOrder<Decimal>& rhs)
@@ -655,10 +693,16 @@ namespace mkc_timeseries
   {
   public:
 
+    MarketOnOpenCoverOrder(const std::string& tradingSymbol, 
+			  const TradingVolume& unitsInOrder,
+			  const ptime& orderDateTime)
+      : MarketExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime)
+    {}
+
     MarketOnOpenCoverOrder(const std::string& tradingSymbol, 
 			  const TradingVolume& unitsInOrder,
 			  const TimeSeriesDate& orderDate)
-      : MarketExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate)
+      : MarketOnOpenCoverOrder (tradingSymbol, unitsInOrder, ptime (orderDate, getDefaultBarTime()))
     {}
 
     MarketOnOpenCoverOrder (const MarketOnOpenCoverOrder<Decimal>& rhs)
@@ -722,9 +766,9 @@ namespace mkc_timeseries
     public:
       LimitOrder(const std::string& tradingSymbol, 
 		 const TradingVolume& unitsInOrder,
-		 const TimeSeriesDate& orderDate,
+		 const ptime& orderDateTime,
 		 const Decimal& limitPrice)
-	: TradingOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate),
+	: TradingOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime),
 	  mLimitPrice(limitPrice)
       {}
 
@@ -780,9 +824,9 @@ namespace mkc_timeseries
     public:
       LimitExitOrder(const std::string& tradingSymbol, 
 		 const TradingVolume& unitsInOrder,
-		 const TimeSeriesDate& orderDate,
+		 const ptime& orderDateTime,
 		 const Decimal& limitPrice)
-	: LimitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate, limitPrice)
+	: LimitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime, limitPrice)
       {}
 
       virtual ~LimitExitOrder()
@@ -825,11 +869,18 @@ namespace mkc_timeseries
   template <class Decimal> class SellAtLimitOrder : public LimitExitOrder<Decimal>
   {
   public:
+    SellAtLimitOrder(const std::string& tradingSymbol, 
+		     const TradingVolume& unitsInOrder,
+		     const ptime& orderDateTime,
+		     const Decimal& limitPrice)
+      : LimitExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime, limitPrice)
+    {}
+
     SellAtLimitOrder(const std::string& tradingSymbol, 
 		     const TradingVolume& unitsInOrder,
 		     const TimeSeriesDate& orderDate,
 		     const Decimal& limitPrice)
-      : LimitExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate, limitPrice)
+      : SellAtLimitOrder (tradingSymbol, unitsInOrder, ptime (orderDate, getDefaultBarTime()), limitPrice)
     {}
 
     ~SellAtLimitOrder()
@@ -854,7 +905,7 @@ namespace mkc_timeseries
       v.visit(this);
     }
 
-    void ValidateOrderExecution(const TimeSeriesDate& fillDate, 
+    void ValidateOrderExecution(const ptime& fillDateTime, 
 				const Decimal& fillPrice) const
     {
       if (fillPrice < this->getLimitPrice())
@@ -898,11 +949,18 @@ namespace mkc_timeseries
   template <class Decimal> class CoverAtLimitOrder : public LimitExitOrder<Decimal>
   {
   public:
+    CoverAtLimitOrder(const std::string& tradingSymbol, 
+		      const TradingVolume& unitsInOrder,
+		      const ptime& orderDateTime,
+		      const Decimal& limitPrice)
+      : LimitExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime, limitPrice)
+    {}
+
     CoverAtLimitOrder(const std::string& tradingSymbol, 
 		      const TradingVolume& unitsInOrder,
 		      const TimeSeriesDate& orderDate,
 		      const Decimal& limitPrice)
-      : LimitExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate, limitPrice)
+      : CoverAtLimitOrder (tradingSymbol, unitsInOrder, ptime (orderDate, getDefaultBarTime()), limitPrice)
     {}
 
     ~CoverAtLimitOrder()
@@ -922,7 +980,7 @@ namespace mkc_timeseries
       return *this;
     }
 
-    void ValidateOrderExecution(const TimeSeriesDate& fillDate, 
+    void ValidateOrderExecution(const ptime& fillDateTime, 
 				const Decimal& fillPrice) const
     {
       if (fillPrice > this->getLimitPrice())
@@ -976,9 +1034,9 @@ namespace mkc_timeseries
     public:
       StopOrder(const std::string& tradingSymbol, 
 		const TradingVolume& unitsInOrder,
-		const TimeSeriesDate& orderDate,
+		const ptime& orderDateTime,
 		const Decimal& stopPrice)
-	: TradingOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate),
+	: TradingOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime),
 	  mStopPrice(stopPrice)
       {}
 
@@ -1035,9 +1093,9 @@ namespace mkc_timeseries
     public:
       StopExitOrder(const std::string& tradingSymbol, 
 		 const TradingVolume& unitsInOrder,
-		 const TimeSeriesDate& orderDate,
+		 const ptime& orderDateTime,
 		 const Decimal& stopPrice)
-	: StopOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate, stopPrice)
+	: StopOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime, stopPrice)
       {}
 
       virtual ~StopExitOrder()
@@ -1080,11 +1138,18 @@ namespace mkc_timeseries
   template <class Decimal> class SellAtStopOrder : public StopExitOrder<Decimal>
   {
   public:
+    SellAtStopOrder(const std::string& tradingSymbol, 
+		     const TradingVolume& unitsInOrder,
+		     const ptime& orderDateTime,
+		     const Decimal& stopPrice)
+      : StopExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime, stopPrice)
+    {}
+
     SellAtStopOrder(const std::string& tradingSymbol, 
 		     const TradingVolume& unitsInOrder,
 		     const TimeSeriesDate& orderDate,
 		     const Decimal& stopPrice)
-      : StopExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate, stopPrice)
+      : SellAtStopOrder (tradingSymbol, unitsInOrder, ptime (orderDate, getDefaultBarTime()), stopPrice)
     {}
 
     ~SellAtStopOrder()
@@ -1109,7 +1174,7 @@ namespace mkc_timeseries
       v.visit(this);
     }
 
-    void ValidateOrderExecution(const TimeSeriesDate& fillDate, 
+    void ValidateOrderExecution(const ptime& fillDateTime, 
 				const Decimal& fillPrice) const
     {
       if (fillPrice > this->getStopPrice())
@@ -1152,11 +1217,18 @@ namespace mkc_timeseries
   template <class Decimal> class CoverAtStopOrder : public StopExitOrder<Decimal>
   {
   public:
+    CoverAtStopOrder(const std::string& tradingSymbol, 
+		     const TradingVolume& unitsInOrder,
+		     const ptime& orderDateTime,
+		     const Decimal& stopPrice)
+      : StopExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDateTime, stopPrice)
+    {}
+
     CoverAtStopOrder(const std::string& tradingSymbol, 
 		     const TradingVolume& unitsInOrder,
 		     const TimeSeriesDate& orderDate,
 		     const Decimal& stopPrice)
-      : StopExitOrder<Decimal> (tradingSymbol, unitsInOrder, orderDate, stopPrice)
+      : CoverAtStopOrder (tradingSymbol, unitsInOrder, ptime (orderDate, getDefaultBarTime()), stopPrice)
     {}
 
     ~CoverAtStopOrder()
@@ -1181,7 +1253,7 @@ namespace mkc_timeseries
       v.visit(this);
     }
 
-    void ValidateOrderExecution(const TimeSeriesDate& fillDate, 
+    void ValidateOrderExecution(const ptime& fillDateTime, 
 				const Decimal& fillPrice) const
     {
       if (fillPrice < this->getStopPrice())
@@ -1239,11 +1311,12 @@ namespace mkc_timeseries
     virtual bool isOrderExecuted() const = 0;
     virtual bool isOrderCanceled() const = 0;
     virtual void MarkOrderExecuted(TradingOrder<Decimal>* order,
-				   const TimeSeriesDate& fillDate, 
+				   const ptime& fillDateTime, 
 				   const Decimal& fillPrice) = 0;
     virtual void MarkOrderCanceled(TradingOrder<Decimal>* order) = 0;
     virtual const Decimal& getFillPrice() const = 0;
     virtual const TimeSeriesDate& getFillDate() const = 0;
+    virtual const ptime& getFillDateTime() const = 0;
   };
 
   /**
@@ -1285,11 +1358,16 @@ namespace mkc_timeseries
       throw TradingOrderNotExecutedException("No fill date in pending state");
     }
 
+    const ptime& getFillDateTime() const
+    {
+      throw TradingOrderNotExecutedException("No fill date in pending state");
+    }
+
     void MarkOrderExecuted(TradingOrder<Decimal>* order,
-			   const TimeSeriesDate& fillDate, 
+			   const ptime& fillDateTime, 
 			   const Decimal& fillPrice)
     {
-      order->ChangeState (std::make_shared<ExecutedOrderState<Decimal>>(fillDate, fillPrice));
+      order->ChangeState (std::make_shared<ExecutedOrderState<Decimal>>(fillDateTime, fillPrice));
     }
 
     void MarkOrderCanceled(TradingOrder<Decimal>* order)
@@ -1305,10 +1383,11 @@ namespace mkc_timeseries
   template <class Decimal> class ExecutedOrderState : public TradingOrderState<Decimal>
   {
   public:
-    ExecutedOrderState(const TimeSeriesDate& fillDate, 
+    ExecutedOrderState(const ptime& fillDateTime, 
 			    const Decimal& fillPrice)
       : TradingOrderState<Decimal>(),
-	mEntryDate(fillDate),
+	mEntryDateTime(fillDateTime),
+	mEntryDate(fillDateTime.date()),
 	mEntryPrice(fillPrice)
       {}
 
@@ -1340,8 +1419,13 @@ namespace mkc_timeseries
       return mEntryDate;
     }
 
+    const ptime& getFillDateTime() const
+    {
+      return mEntryDateTime;
+    }
+
     void MarkOrderExecuted(TradingOrder<Decimal>* order,
-			   const TimeSeriesDate& fillDate, 
+			   const ptime& fillDateTime, 
 			   const Decimal& fillPrice)
     {
       throw TradingOrderExecutedException("Trading order has already been executed");
@@ -1353,6 +1437,7 @@ namespace mkc_timeseries
     }
 
   private:
+    ptime mEntryDateTime;
     TimeSeriesDate mEntryDate;
     Decimal mEntryPrice;
   };
@@ -1396,8 +1481,13 @@ namespace mkc_timeseries
       throw TradingOrderNotExecutedException("No fill date in canceled state");
     }
 
+    const ptime& getFillDateTime() const
+    {
+      throw TradingOrderNotExecutedException("No fill date in canceled state");
+    }
+
     void MarkOrderExecuted(TradingOrder<Decimal>* order,
-			   const TimeSeriesDate& fillDate, 
+			   const ptime& fillDateTime, 
 			   const Decimal& fillPrice)
     {
       throw TradingOrderNotExecutedException("Cannot execute a cancelled order");
@@ -1412,16 +1502,17 @@ namespace mkc_timeseries
   template <class Decimal>
   inline TradingOrder<Decimal>::TradingOrder(const std::string& tradingSymbol, 
 					  const TradingVolume& unitsInOrder,
-					  const TimeSeriesDate& orderDate)
+					  const ptime& orderDateTime)
     : mTradingSymbol(tradingSymbol),
       mUnitsInOrder(unitsInOrder),
-      mOrderDate (orderDate),
+      mOrderDateTime (orderDateTime),
+      mOrderDate (orderDateTime.date()),
       mOrderState(new PendingOrderState<Decimal>()),
-      mOrderID(++TradingOrder<Decimal>::mOrderIDCount),
+      mOrderID(BacktestIdDomain::current().nextOrderID()),
       mObservers()
     {
       if (mUnitsInOrder.getTradingVolume() == 0)
-	throw TradingOrderException ("TradingOrder constructor - order cannot have zero units for: " +tradingSymbol +" with order date: " +boost::gregorian::to_simple_string (orderDate));
+	throw TradingOrderException ("TradingOrder constructor - order cannot have zero units for: " +tradingSymbol +" with order date: " +boost::posix_time::to_simple_string (orderDateTime));
     }
 
   template <class Decimal>
@@ -1446,11 +1537,18 @@ namespace mkc_timeseries
   inline void TradingOrder<Decimal>::MarkOrderExecuted(const TimeSeriesDate& fillDate, 
 						    const Decimal& fillPrice)
   {
-    ValidateOrderExecution (fillDate, fillPrice);
+    MarkOrderExecuted (ptime (fillDate, getDefaultBarTime()), fillPrice);
+  }
 
-    if (fillDate >= getOrderDate())
+  template <class Decimal>
+  inline void TradingOrder<Decimal>::MarkOrderExecuted(const ptime& fillDateTime, 
+						    const Decimal& fillPrice)
+  {
+    ValidateOrderExecution (fillDateTime, fillPrice);
+
+    if (fillDateTime >= getOrderDateTime())
       {
-	mOrderState->MarkOrderExecuted (this, fillDate, fillPrice);
+	mOrderState->MarkOrderExecuted (this, fillDateTime, fillPrice);
 	this->notifyOrderExecuted();
       }
     else
@@ -1475,6 +1573,12 @@ namespace mkc_timeseries
   {
     return  mOrderState->getFillDate();
   }
+
+  template <class Decimal>
+  inline const ptime& TradingOrder<Decimal>::getFillDateTime() const
+  {
+    return  mOrderState->getFillDateTime();
+  }
 }
 
 
@@ -99,7 +99,7 @@ namespace mkc_timeseries
       ValidateOrder (order);
       // Market orders are unconditional
 
-      order->MarkOrderExecuted (mTradingBar.getDateValue(), mTradingBar.getOpenValue());
+      order->MarkOrderExecuted (mTradingBar.getDateTime(), mTradingBar.getOpenValue());
     }
 
     /**
@@ -113,7 +113,7 @@ namespace mkc_timeseries
       ValidateOrder (order);
       // Market orders are unconditional
 
-      order->MarkOrderExecuted (mTradingBar.getDateValue(), mTradingBar.getOpenValue());
+      order->MarkOrderExecuted (mTradingBar.getDateTime(), mTradingBar.getOpenValue());
     }
 
     /**
@@ -127,7 +127,7 @@ namespace mkc_timeseries
       ValidateOrder (order);
       // Market orders are unconditional
 
-      order->MarkOrderExecuted (mTradingBar.getDateValue(), mTradingBar.getOpenValue());
+      order->MarkOrderExecuted (mTradingBar.getDateTime(), mTradingBar.getOpenValue());
     }
 
     /**
@@ -141,7 +141,7 @@ namespace mkc_timeseries
       ValidateOrder (order);
 
       // Market orders are unconditional
-      order->MarkOrderExecuted (mTradingBar.getDateValue(), mTradingBar.getOpenValue());
+      order->MarkOrderExecuted (mTradingBar.getDateTime(), mTradingBar.getOpenValue());
     }
 
     /**
@@ -158,9 +158,9 @@ namespace mkc_timeseries
 	{
 	  // If we gapped up we assume we get the open price
 	  if (mTradingBar.getOpenValue() > order->getLimitPrice())
-	    order->MarkOrderExecuted (mTradingBar.getDateValue(), mTradingBar.getOpenValue());
+	    order->MarkOrderExecuted (mTradingBar.getDateTime(), mTradingBar.getOpenValue());
 	  else
-	    order->MarkOrderExecuted (mTradingBar.getDateValue(), order->getLimitPrice());
+	    order->MarkOrderExecuted (mTradingBar.getDateTime(), order->getLimitPrice());
 	}
     }
 
@@ -178,9 +178,9 @@ namespace mkc_timeseries
       if (mTradingBar.getLowValue() < order->getLimitPrice())	{
 	  // If we gapped down we assume we get the open price
 	  if (mTradingBar.getOpenValue() < order->getLimitPrice())
-	    order->MarkOrderExecuted (mTradingBar.getDateValue(), mTradingBar.getOpenValue());
+	    order->MarkOrderExecuted (mTradingBar.getDateTime(), mTradingBar.getOpenValue());
 	  else
-	    order->MarkOrderExecuted (mTradingBar.getDateValue(), order->getLimitPrice());
+	    order->MarkOrderExecuted (mTradingBar.getDateTime(), order->getLimitPrice());
 	}
     }
 
@@ -198,9 +198,9 @@ namespace mkc_timeseries
 	{
 	  // If we gapped up we assume we get the open price
 	  if (mTradingBar.getOpenValue() > order->getStopPrice())
-	    order->MarkOrderExecuted (mTradingBar.getDateValue(), mTradingBar.getOpenValue());
+	    order->MarkOrderExecuted (mTradingBar.getDateTime(), mTradingBar.getOpenValue());
 	  else
-	    order->MarkOrderExecuted (mTradingBar.getDateValue(), order->getStopPrice());
+	    order->MarkOrderExecuted (mTradingBar.getDateTime(), order->getStopPrice());
 	}
     }
 
@@ -218,9 +218,9 @@ namespace mkc_timeseries
 	{
 	  // If we gapped down we assume we get the open price
 	  if (mTradingBar.getOpenValue() < order->getStopPrice())
-	    order->MarkOrderExecuted (mTradingBar.getDateValue(), mTradingBar.getOpenValue());
+	    order->MarkOrderExecuted (mTradingBar.getDateTime(), mTradingBar.getOpenValue());
 	  else
-	    order->MarkOrderExecuted (mTradingBar.getDateValue(), order->getStopPrice());
+	    order->MarkOrderExecuted (mTradingBar.getDateTime(), order->getStopPrice());
 	}
     }
 
@@ -243,8 +243,8 @@ namespace mkc_timeseries
      */
     void ValidateOrder (TradingOrder<Decimal>* order)
     {
-      if (mTradingBar.getDateValue() <= order->getOrderDate())
-	throw TradingOrderException ("Bar date " +to_simple_string (mTradingBar.getDateValue()) +" must be greater than order date " +to_simple_string (order->getOrderDate()));
+      if (mTradingBar.getDateTime() <= order->getOrderDateTime())
+	throw TradingOrderException ("Bar date " +boost::posix_time::to_simple_string (mTradingBar.getDateTime()) +" must be greater than order date " +boost::posix_time::to_simple_string (order->getOrderDateTime()));
 
       if (!order->isOrderPending())
 	{
@@ -652,9 +652,20 @@ namespace mkc_timeseries
      * @param processingDate The current date in the backtest for which orders are being processed.
      * @param positions A const reference to the InstrumentPositionManager, used to check current
      * position status (e.g., to cancel an exit order if the position is already flat).
-     */
+     */
     void processPendingOrders (const boost::gregorian::date& processingDate,
 			       const InstrumentPositionManager<Decimal>& positions)
+    {
+      processPendingOrders (ptime (processingDate, getDefaultBarTime()), positions);
+    }
+
+    /**
+     * @brief Same as above for the bar with timestamp processingDate.
+     * Orders are only considered once the processing bar is later than the bar they were placed on,
+     * so on intraday series an order placed on one bar is filled on the next bar of the same day.
+     */
+    void processPendingOrders (const ptime& processingDate,
+			       const InstrumentPositionManager<Decimal>& positions)
     {
       ProcessPendingMarketExitOrders(processingDate, positions);
       ProcessPendingMarketEntryOrders(processingDate, positions);
@@ -686,7 +697,7 @@ namespace mkc_timeseries
      * @param positions Const reference to InstrumentPositionManager for position status checks.
      */
     template <typename T>
-    void ProcessingPendingOrders(const boost::gregorian::date& processingDate, 
+    void ProcessingPendingOrders(const ptime& processingDate, 
 				 std::vector<std::shared_ptr<T>>& vectorContainer,
 				 const InstrumentPositionManager<Decimal>& positions)
     {
@@ -702,7 +713,7 @@ namespace mkc_timeseries
 	{
 	  order = (*it);
 	  
-	  if (order->isOrderPending() && (processingDate > order->getOrderDate()))
+	  if (order->isOrderPending() && (processingDate > order->getOrderDateTime()))
 	    {
 	      symbolIt = mPortfolio->findSecurity (order->getTradingSymbol());
 	      if (symbolIt != mPortfolio->endPortfolio())
@@ -751,12 +762,19 @@ namespace mkc_timeseries
 		      ++it;
 		    }
 		}
+	      else
+		++it;
+	    }
+	  else
+	    {
+	      // Not due yet, the order is only filled on a bar after its order bar
+	      ++it;
 	    }
 	}
     }
 
      /** @brief Processes pending MarketOnOpenSellOrders and MarketOnOpenCoverOrders. */
-    void ProcessPendingMarketExitOrders(const boost::gregorian::date& processingDate,
+    void ProcessPendingMarketExitOrders(const ptime& processingDate,
 					const InstrumentPositionManager<Decimal>& positions)
     {
       this->ProcessingPendingOrders<MarketOnOpenSellOrder<Decimal>> (processingDate, mMarketSellOrders, 
@@ -766,7 +784,7 @@ namespace mkc_timeseries
     }
 
      /** @brief Processes pending MarketOnOpenLongOrders and MarketOnOpenShortOrders. */
-    void ProcessPendingMarketEntryOrders(const boost::gregorian::date& processingDate,
+    void ProcessPendingMarketEntryOrders(const ptime& processingDate,
 					 const InstrumentPositionManager<Decimal>& positions)
     {
       this->ProcessingPendingOrders<MarketOnOpenLongOrder<Decimal>> (processingDate, mMarketLongOrders,
@@ -776,7 +794,7 @@ namespace mkc_timeseries
     }
 
     /** @brief Processes pending SellAtStopOrders and CoverAtStopOrders. */
-    void ProcessPendingStopExitOrders(const boost::gregorian::date& processingDate,
+    void ProcessPendingStopExitOrders(const ptime& processingDate,
 				      const InstrumentPositionManager<Decimal>& positions)
     {
       this->ProcessingPendingOrders<SellAtStopOrder<Decimal>> (processingDate, mStopSellOrders,
@@ -786,7 +804,7 @@ namespace mkc_timeseries
     }
 
     /** @brief Processes pending SellAtLimitOrder and CoverAtLimitOrder. */
-    void ProcessPendingLimitExitOrders(const boost::gregorian::date& processingDate,
+    void ProcessPendingLimitExitOrders(const ptime& processingDate,
 				       const InstrumentPositionManager<Decimal>& positions)
     {
       this->ProcessingPendingOrders<SellAtLimitOrder<Decimal>> (processingDate, mLimitSellOrders,
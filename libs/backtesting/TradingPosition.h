@@ -26,20 +26,24 @@
 #ifndef __TRADING_POSITION_H
 #define __TRADING_POSITION_H 1
 
+#include <algorithm>
 #include <exception>
+#include <iterator>
 #include <memory>
 #include <functional>
 #include <map>
 #include <list>
+#include <vector>
 #include <cstdint>
 #include <cmath>
 #include "TradingPositionException.h"
 #include "TimeSeriesEntry.h"
+#include "TimeSeries.h"
 #include "PercentNumber.h"
 #include "ProfitTarget.h"
 #include "StopLoss.h"
 #include "DecimalConstants.h"
-#include <atomic>
+#include "BacktestIdDomain.h"
 
 using namespace boost::gregorian;
 
@@ -120,6 +124,11 @@ namespace mkc_timeseries
       return mEntry.getDateValue();
     }
 
+    const ptime& getDateTime() const
+    {
+      return mEntry.getDateTime();
+    }
+
     const Decimal& getOpenValue() const
     {
       return mEntry.getOpenValue();
@@ -170,20 +179,129 @@ namespace mkc_timeseries
 
 
   // class OpenPositionHistory
+  //
+  // Bars are kept in time order, one per bar timestamp, so a position held across several
+  // intraday bars of the same day keeps one entry per bar.
+  //
+  // Bars a backtest adds from a security's series (addBar(series, barIndex)) are recorded as a
+  // run of bar indices: the history keeps the series, the index of the first bar and the number
+  // of bars, and reads prices from the series' columns when asked. Bars that do not continue
+  // such a run (e.g. built by hand in tests) are copied into a sorted vector instead.
   template <class Decimal> class OpenPositionHistory
   {
   public:
-    typedef typename std::map<TimeSeriesDate, OpenPositionBar<Decimal>>::iterator PositionBarIterator;
-    typedef typename std::map<TimeSeriesDate, OpenPositionBar<Decimal>>::const_iterator ConstPositionBarIterator;
+    /**
+     * @class ConstPositionBarIterator
+     * @brief Walks the bars of the history in time order.
+     *
+     * Dereferencing yields a (bar timestamp, OpenPositionBar) pair built on the fly, so this
+     * is meant for inspecting a position. Per-bar return calculations should use
+     * getCloseValue / appendBarReturns, which read the series directly.
+     */
+    class ConstPositionBarIterator
+    {
+    public:
+      typedef std::bidirectional_iterator_tag iterator_category;
+      typedef std::pair<ptime, OpenPositionBar<Decimal>> value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef value_type reference;
+
+      class ArrowProxy
+      {
+      public:
+	explicit ArrowProxy(value_type value)
+	  : mValue(std::move(value))
+	{}
+
+	const value_type* operator->() const
+	{
+	  return &mValue;
+	}
+
+      private:
+	value_type mValue;
+      };
+
+      typedef ArrowProxy pointer;
+
+      ConstPositionBarIterator()
+	: mHistory(nullptr),
+	  mBarOffset(0)
+      {}
+
+      ConstPositionBarIterator(const OpenPositionHistory<Decimal>* history, size_t barOffset)
+	: mHistory(history),
+	  mBarOffset(barOffset)
+      {}
+
+      reference operator*() const
+      {
+	return value_type(mHistory->getDateTime(mBarOffset),
+			  OpenPositionBar<Decimal>(mHistory->getBar(mBarOffset)));
+      }
+
+      pointer operator->() const
+      {
+	return ArrowProxy(**this);
+      }
+
+      ConstPositionBarIterator& operator++()
+      {
+	++mBarOffset;
+	return *this;
+      }
+
+      ConstPositionBarIterator operator++(int)
+      {
+	ConstPositionBarIterator previous(*this);
+	++mBarOffset;
+	return previous;
+      }
+
+      ConstPositionBarIterator& operator--()
+      {
+	--mBarOffset;
+	return *this;
+      }
+
+      ConstPositionBarIterator operator--(int)
+      {
+	ConstPositionBarIterator previous(*this);
+	--mBarOffset;
+	return previous;
+      }
+
+      bool operator==(const ConstPositionBarIterator& rhs) const
+      {
+	return mHistory == rhs.mHistory && mBarOffset == rhs.mBarOffset;
+      }
+
+      bool operator!=(const ConstPositionBarIterator& rhs) const
+      {
+	return !(*this == rhs);
+      }
+
+    private:
+      const OpenPositionHistory<Decimal>* mHistory;
+      size_t mBarOffset;
+    };
+
+    typedef ConstPositionBarIterator PositionBarIterator;
 
     explicit OpenPositionHistory(OHLCTimeSeriesEntry<Decimal> entryBar) :
-      mPositionBarHistory()
+      mSeries(),
+      mFirstBarIndex(0),
+      mNumSeriesBars(0),
+      mBars()
     {
       addFirstBar(entryBar);
     }
 
     OpenPositionHistory(const OpenPositionHistory<Decimal>& rhs) 
-      : mPositionBarHistory(rhs.mPositionBarHistory)
+      : mSeries(rhs.mSeries),
+	mFirstBarIndex(rhs.mFirstBarIndex),
+	mNumSeriesBars(rhs.mNumSeriesBars),
+	mBars(rhs.mBars)
     {}
 
     OpenPositionHistory<Decimal>& 
@@ -192,7 +310,10 @@ namespace mkc_timeseries
       if (this == &rhs)
 	return *this;
 
-      mPositionBarHistory = rhs.mPositionBarHistory;
+      mSeries = rhs.mSeries;
+      mFirstBarIndex = rhs.mFirstBarIndex;
+      mNumSeriesBars = rhs.mNumSeriesBars;
+      mBars = rhs.mBars;
       return *this;
     }
 
@@ -201,73 +322,162 @@ namespace mkc_timeseries
 
     void addBar(const OpenPositionBar<Decimal>& entry)
     {
-      boost::gregorian::date d = entry.getDate();
-      PositionBarIterator pos = mPositionBarHistory.find (d);
+      const ptime& dt = entry.getDateTime();
+      const size_t barOffset = lowerBoundOffset(dt);
+      if ((barOffset < numBarsInPosition()) && (getDateTime(barOffset) == dt))
+	throw std::domain_error(std::string("OpenPositionHistory:" +boost::posix_time::to_simple_string(dt) + std::string(" date already exists")));
+
+      // Only leave index mode once the bar is known to be inserted
+      if (mSeries)
+	copySeriesBars();
+
+      mBars.insert(mBars.begin() + barOffset, entry);
+    }
 
-      if (pos ==  mPositionBarHistory.end())
+    /**
+     * @brief Add the bar at barIndex of series.
+     *
+     * When the bar directly follows the bars already held (the usual case while a backtest
+     * walks a series) only the bar count changes; nothing is copied.
+     */
+    void addBar(const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex)
+    {
+      if (!mSeries && continuesCopiedBars(*series, barIndex))
 	{
-	   mPositionBarHistory.insert(std::make_pair(d, entry));
+	  mSeries = series;
+	  mFirstBarIndex = barIndex - mBars.size();
+	  mNumSeriesBars = mBars.size();
+	  std::vector<OpenPositionBar<Decimal>>().swap(mBars);
 	}
-      else
-	throw std::domain_error(std::string("OpenPositionHistory:" +boost::gregorian::to_simple_string(d) + std::string(" date already exists")));
+
+      if (mSeries && (mSeries.get() == series.get()) && (barIndex == mFirstBarIndex + mNumSeriesBars))
+	{
+	  ++mNumSeriesBars;
+	  return;
+	}
+
+      addBar(OpenPositionBar<Decimal>(*(series->beginRandomAccess() + barIndex)));
     }
 
     unsigned int numBarsInPosition() const
     {
-      return mPositionBarHistory.size();
+      return mSeries ? mNumSeriesBars : mBars.size();
+    }
+
+    /**
+     * @brief True while the bars are held as a run of indices into a series (nothing copied).
+     */
+    bool isSeriesBacked() const
+    {
+      return static_cast<bool>(mSeries);
     }
 
     OpenPositionHistory::PositionBarIterator beginPositionBarHistory()
     {
-      return mPositionBarHistory.begin();
+      return PositionBarIterator(this, 0);
     }
 
     OpenPositionHistory::PositionBarIterator endPositionBarHistory()
     {
-      return mPositionBarHistory.end();
+      return PositionBarIterator(this, numBarsInPosition());
     }
 
     OpenPositionHistory::ConstPositionBarIterator beginPositionBarHistory() const
     {
-      return mPositionBarHistory.begin();
+      return ConstPositionBarIterator(this, 0);
     }
 
     OpenPositionHistory::ConstPositionBarIterator endPositionBarHistory() const
     {
-      return mPositionBarHistory.end();
+      return ConstPositionBarIterator(this, numBarsInPosition());
     }
 
-    const TimeSeriesDate& getFirstDate() const
+    /**
+     * @brief The bar barOffset bars after the first bar of the position.
+     */
+    const OHLCTimeSeriesEntry<Decimal>& getBar(size_t barOffset) const
     {
-      if (numBarsInPosition() > 0)
+      if (mSeries)
+	return *(mSeries->beginRandomAccess() + (mFirstBarIndex + barOffset));
+
+      return mBars[barOffset].getTimeSeriesEntry();
+    }
+
+    const ptime& getDateTime(size_t barOffset) const
+    {
+      if (mSeries)
+	return mSeries->getDateTimeColumn()[mFirstBarIndex + barOffset];
+
+      return mBars[barOffset].getDateTime();
+    }
+
+    const Decimal& getCloseValue(size_t barOffset) const
+    {
+      if (mSeries)
+	return mSeries->getCloseColumn()[mFirstBarIndex + barOffset];
+
+      return mBars[barOffset].getCloseValue();
+    }
+
+    /**
+     * @brief Append the close-to-close return of every bar after the first to returns.
+     */
+    void appendBarReturns(std::vector<Decimal>& returns) const
+    {
+      const unsigned int numBars = numBarsInPosition();
+      if (numBars < 2)
+	return;
+
+      if (mSeries)
 	{
-	  OpenPositionHistory::ConstPositionBarIterator it = beginPositionBarHistory();
-	  return it->first;
+	  auto close = mSeries->getCloseColumn().begin() + mFirstBarIndex;
+	  for (unsigned int i = 1; i < numBars; ++i)
+	    returns.push_back((close[i] - close[i - 1]) / close[i - 1]);
 	}
+      else
+	{
+	  for (unsigned int i = 1; i < numBars; ++i)
+	    returns.push_back((mBars[i].getCloseValue() - mBars[i - 1].getCloseValue()) /
+			      mBars[i - 1].getCloseValue());
+	}
+    }
+
+    const TimeSeriesDate& getFirstDate() const
+    {
+      if (numBarsInPosition() > 0)
+	return getBar(0).getDateValue();
       else
 	throw std::domain_error(std::string("OpenPositionHistory:getPositionFirstDate: no bars in position "));
     }
 
+    const ptime& getFirstDateTime() const
+    {
+      if (numBarsInPosition() > 0)
+	return getDateTime(0);
+      else
+	throw std::domain_error(std::string("OpenPositionHistory:getFirstDateTime: no bars in position "));
+    }
+
     const TimeSeriesDate& getLastDate() const
     {
       if (numBarsInPosition() > 0)
-	{
-	  OpenPositionHistory::ConstPositionBarIterator it = endPositionBarHistory();
-	  it--;
-	  return it->first;
-	}
+	return getBar(numBarsInPosition() - 1).getDateValue();
       else
 	throw std::domain_error(std::string("OpenPositionHistory:getPositionLastDate: no bars in position "));
     }
 
+    const ptime& getLastDateTime() const
+    {
+      if (numBarsInPosition() > 0)
+	return getDateTime(numBarsInPosition() - 1);
+      else
+	throw std::domain_error(std::string("OpenPositionHistory:getLastDateTime: no bars in position "));
+    }
+
     const Decimal& getLastClose() const
     {
       if (numBarsInPosition() > 0)
-	{
-	  OpenPositionHistory::ConstPositionBarIterator it = endPositionBarHistory();
-	  it--;
-	  return it->second.getCloseValue();
-	}
+	return getCloseValue(numBarsInPosition() - 1);
       else
 	throw std::domain_error(std::string("OpenPositionHistory:getLastClose: no bars in position "));
     }
@@ -278,8 +488,61 @@ namespace mkc_timeseries
       addBar(OpenPositionBar<Decimal>(entry));
     }
 
+    // True when the copied bars are the bars immediately before barIndex in series
+    // (typically the entry bar, taken from the same series).
+    bool continuesCopiedBars(const OHLCTimeSeries<Decimal>& series, size_t barIndex) const
+    {
+      if (mBars.empty() || (barIndex < mBars.size()) || (barIndex >= series.getNumEntries()))
+	return false;
+
+      const auto& barTimes = series.getDateTimeColumn();
+      const size_t firstIndex = barIndex - mBars.size();
+      for (size_t i = 0; i < mBars.size(); ++i)
+	if (mBars[i].getDateTime() != barTimes[firstIndex + i])
+	  return false;
+
+      return true;
+    }
+
+    // Offset of the first bar whose timestamp is not before dt.
+    size_t lowerBoundOffset(const ptime& dt) const
+    {
+      size_t first = 0;
+      size_t count = numBarsInPosition();
+      while (count > 0)
+	{
+	  const size_t half = count / 2;
+	  if (getDateTime(first + half) < dt)
+	    {
+	      first += half + 1;
+	      count -= half + 1;
+	    }
+	  else
+	    count = half;
+	}
+
+      return first;
+    }
+
+    // Leave index mode: copy the series bars so bars from elsewhere can be merged in.
+    void copySeriesBars()
+    {
+      std::vector<OpenPositionBar<Decimal>> bars;
+      bars.reserve(mNumSeriesBars + 1);
+      for (size_t i = 0; i < mNumSeriesBars; ++i)
+	bars.emplace_back(getBar(i));
+
+      mBars.swap(bars);
+      mSeries.reset();
+      mFirstBarIndex = 0;
+      mNumSeriesBars = 0;
+    }
+
   private:
-    std::map<TimeSeriesDate, OpenPositionBar<Decimal>> mPositionBarHistory;
+    std::shared_ptr<const OHLCTimeSeries<Decimal>> mSeries;   // set while the bars are a run of mSeries
+    size_t mFirstBarIndex;
+    size_t mNumSeriesBars;
+    std::vector<OpenPositionBar<Decimal>> mBars;              // otherwise, copies sorted by time
   };
 
   /**
@@ -316,10 +579,13 @@ namespace mkc_timeseries
     virtual bool isPositionOpen() const = 0;
     virtual bool isPositionClosed() const = 0;
     virtual const TimeSeriesDate& getEntryDate() const = 0;
+    virtual const ptime& getEntryDateTime() const = 0;
     virtual const Decimal& getEntryPrice() const = 0;
     virtual const Decimal& getExitPrice() const = 0;
     virtual const boost::gregorian::date& getExitDate() const = 0;
+    virtual const ptime& getExitDateTime() const = 0;
     virtual void addBar (const OHLCTimeSeriesEntry<Decimal>& entryBar) = 0;
+    virtual void addBar (const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex) = 0;
     virtual const TradingVolume& getTradingUnits() const = 0;
     virtual unsigned int getNumBarsInPosition() const = 0;
     virtual unsigned int getNumBarsSinceEntry() const = 0;
@@ -339,9 +605,10 @@ namespace mkc_timeseries
     // position at creation time
     virtual TradingPositionState::ConstPositionBarIterator beginPositionBarHistory() const = 0;
     virtual TradingPositionState::ConstPositionBarIterator endPositionBarHistory() const = 0;
+    virtual const OpenPositionHistory<Decimal>& getPositionBarHistory() const = 0;
     virtual void ClosePosition (TradingPosition<Decimal>* position,
 				std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-				const boost::gregorian::date exitDate,
+				const ptime& exitDateTime,
 				const Decimal& exitPrice) = 0;
   };
   
@@ -358,6 +625,7 @@ namespace mkc_timeseries
       : TradingPositionState<Decimal>(),
       mEntryPrice(entryPrice),
       mEntryDate (entryBar.getDateValue()),
+      mEntryDateTime (entryBar.getDateTime()),
       mUnitsInPosition(unitsInPosition),
       mPositionBarHistory (entryBar),
       mBarsInPosition(1),
@@ -373,6 +641,7 @@ namespace mkc_timeseries
       : TradingPositionState<Decimal>(rhs),
       mEntryPrice(rhs.mEntryPrice),
       mEntryDate (rhs.mEntryDate),
+      mEntryDateTime (rhs.mEntryDateTime),
       mUnitsInPosition(rhs.mUnitsInPosition),
       mPositionBarHistory (rhs.mPositionBarHistory),
       mBarsInPosition (rhs.mBarsInPosition),
@@ -391,6 +660,7 @@ namespace mkc_timeseries
 
       mEntryPrice = rhs.mEntryPrice;
       mEntryDate  = rhs.mEntryDate;
+      mEntryDateTime = rhs.mEntryDateTime;
       mUnitsInPosition = rhs.mUnitsInPosition;
       mPositionBarHistory  = rhs.mPositionBarHistory;
       mBarsInPosition  = rhs.mBarsInPosition;
@@ -434,6 +704,13 @@ namespace mkc_timeseries
       addBar(OpenPositionBar<Decimal>(entryBar));
     }
 
+    virtual void addBar(const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex)
+    {
+      mPositionBarHistory.addBar(series, barIndex);
+      mBarsInPosition++;
+      mNumBarsSinceEntry++;
+    }
+
     const Decimal& getEntryPrice() const
     {
       return mEntryPrice;
@@ -444,6 +721,11 @@ namespace mkc_timeseries
       return mEntryDate;
     }
 
+    const ptime& getEntryDateTime() const
+    {
+      return mEntryDateTime;
+    }
+
     const Decimal& getExitPrice() const
     {
       throw TradingPositionException ("No exit price for open position");
@@ -454,6 +736,11 @@ namespace mkc_timeseries
       throw TradingPositionException ("No exit date for open position");
     }
 
+    const ptime& getExitDateTime() const
+    {
+      throw TradingPositionException ("No exit date for open position");
+    }
+
     const TradingVolume& getTradingUnits() const
     {
       return mUnitsInPosition;
@@ -494,6 +781,11 @@ namespace mkc_timeseries
       return mPositionBarHistory.endPositionBarHistory();
     }
 
+    const OpenPositionHistory<Decimal>& getPositionBarHistory() const
+    {
+      return mPositionBarHistory;
+    }
+
     const Decimal& getProfitTarget() const
       {
 	return mProfitTarget;
@@ -515,6 +807,7 @@ namespace mkc_timeseries
   private:
     Decimal mEntryPrice;
     TimeSeriesDate mEntryDate;
+    ptime mEntryDateTime;
     TradingVolume mUnitsInPosition;
     OpenPositionHistory<Decimal> mPositionBarHistory;
     unsigned int mBarsInPosition;
@@ -561,6 +854,11 @@ namespace mkc_timeseries
       OpenPosition<Decimal>::addBar(entryBar);
     }
 
+    void addBar (const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex)
+    {
+      OpenPosition<Decimal>::addBar(series, barIndex);
+    }
+
     Decimal getPercentReturn() const
     {
       return (calculatePercentReturn (OpenPosition<Decimal>::getEntryPrice(), 
@@ -597,7 +895,7 @@ namespace mkc_timeseries
 
     void ClosePosition (TradingPosition<Decimal>* position,
 			std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-			const boost::gregorian::date exitDate,
+			const ptime& exitDateTime,
 			const Decimal& exitPrice);
   };
 
@@ -639,6 +937,11 @@ namespace mkc_timeseries
       OpenPosition<Decimal>::addBar(entryBar);
     }
 
+    void addBar(const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex)
+    {
+      OpenPosition<Decimal>::addBar(series, barIndex);
+    }
+
     Decimal getTradeReturn() const
     {
       return -(calculateTradeReturn (OpenPosition<Decimal>::getEntryPrice(), 
@@ -676,7 +979,7 @@ namespace mkc_timeseries
 
     void ClosePosition (TradingPosition<Decimal>* position,
 			std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-			const boost::gregorian::date exitDate,
+			const ptime& exitDateTime,
 			const Decimal& exitPrice);
   };
 
@@ -684,20 +987,22 @@ namespace mkc_timeseries
   {
   public:
     ClosedPosition (std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-		    const boost::gregorian::date exitDate,
+		    const ptime& exitDateTime,
 		    const Decimal& exitPrice) 
       : TradingPositionState<Decimal>(),
 	mOpenPosition (openPosition),
-	mExitDate(exitDate),
+	mExitDateTime(exitDateTime),
+	mExitDate(exitDateTime.date()),
 	mExitPrice(exitPrice)
     {
-      if (exitDate < openPosition->getEntryDate())
-	throw std::domain_error (std::string("ClosedPosition: exit Date" +to_simple_string (exitDate) +" cannot occur before entry date " +to_simple_string (openPosition->getEntryDate())));
+      if (exitDateTime < openPosition->getEntryDateTime())
+	throw std::domain_error (std::string("ClosedPosition: exit Date" +boost::posix_time::to_simple_string (exitDateTime) +" cannot occur before entry date " +boost::posix_time::to_simple_string (openPosition->getEntryDateTime())));
     }
 
     ClosedPosition(const ClosedPosition<Decimal>& rhs) 
       : TradingPositionState<Decimal>(rhs),
 	mOpenPosition (rhs.mOpenPosition),
+	mExitDateTime(rhs.mExitDateTime),
 	mExitDate(rhs.mExitDate),
 	mExitPrice(rhs.mExitPrice)
     {}
@@ -710,6 +1015,7 @@ namespace mkc_timeseries
 
       TradingPositionState<Decimal>::operator=(rhs);
       mOpenPosition = rhs.mOpenPosition;
+      mExitDateTime = rhs.mExitDateTime;
       mExitDate = rhs.mExitDate;
       mExitPrice = rhs.mExitPrice;
       return *this;
@@ -733,6 +1039,11 @@ namespace mkc_timeseries
       return mOpenPosition->getEntryDate();
     }
 
+    const ptime& getEntryDateTime() const
+    {
+      return mOpenPosition->getEntryDateTime();
+    }
+
     const Decimal& getEntryPrice() const
     {
       return mOpenPosition->getEntryPrice();
@@ -743,6 +1054,11 @@ namespace mkc_timeseries
       return mExitDate;
     }
 
+    const ptime& getExitDateTime() const
+    {
+      return mExitDateTime;
+    }
+
     const Decimal& getExitPrice() const
     {
       return mExitPrice;
@@ -793,6 +1109,11 @@ namespace mkc_timeseries
       throw TradingPositionException ("Cannot add bar to a closed position");
     }
 
+    void addBar (const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex)
+    {
+      throw TradingPositionException ("Cannot add bar to a closed position");
+    }
+
     typename TradingPositionState<Decimal>::ConstPositionBarIterator beginPositionBarHistory() const
     {
       return mOpenPosition->beginPositionBarHistory();
@@ -803,8 +1124,14 @@ namespace mkc_timeseries
       return mOpenPosition->endPositionBarHistory();
     }
 
+    const OpenPositionHistory<Decimal>& getPositionBarHistory() const
+    {
+      return mOpenPosition->getPositionBarHistory();
+    }
+
   private:
     std::shared_ptr<TradingPositionState<Decimal>> mOpenPosition;
+    ptime mExitDateTime;
     boost::gregorian::date mExitDate;
     Decimal mExitPrice;
   };
@@ -842,9 +1169,9 @@ namespace mkc_timeseries
   {
   public:
     ClosedLongPosition (std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-			const boost::gregorian::date exitDate,
+			const ptime& exitDateTime,
 			const Decimal& exitPrice)
-      : ClosedPosition<Decimal>(openPosition, exitDate, exitPrice)
+      : ClosedPosition<Decimal>(openPosition, exitDateTime, exitPrice)
     {}
 
     ClosedLongPosition(const ClosedLongPosition<Decimal>& rhs) 
@@ -899,7 +1226,7 @@ namespace mkc_timeseries
 
     void ClosePosition (TradingPosition<Decimal>* position,
 			std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-			const boost::gregorian::date exitDate,
+			const ptime& exitDateTime,
 			const Decimal& exitPrice);
   };
 
@@ -917,9 +1244,9 @@ namespace mkc_timeseries
   {
   public:
     ClosedShortPosition (std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-			const boost::gregorian::date exitDate,
+			const ptime& exitDateTime,
 			const Decimal& exitPrice)
-      : ClosedPosition<Decimal>(openPosition, exitDate, exitPrice)
+      : ClosedPosition<Decimal>(openPosition, exitDateTime, exitPrice)
     {}
 
     ClosedShortPosition(const ClosedShortPosition<Decimal>& rhs) 
@@ -974,7 +1301,7 @@ namespace mkc_timeseries
 
     void ClosePosition (TradingPosition<Decimal>* position,
 			std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-			const boost::gregorian::date exitDate,
+			const ptime& exitDateTime,
 			const Decimal& exitPrice);
   };
 
@@ -1067,6 +1394,11 @@ namespace mkc_timeseries
       return mPositionState->getEntryDate();
     }
 
+    const ptime& getEntryDateTime() const
+    {
+      return mPositionState->getEntryDateTime();
+    }
+
     const Decimal& getEntryPrice() const
     {
       return mPositionState->getEntryPrice();
@@ -1082,11 +1414,25 @@ namespace mkc_timeseries
       return mPositionState->getExitDate();
     }
 
+    const ptime& getExitDateTime() const
+    {
+      return mPositionState->getExitDateTime();
+    }
+
     void addBar (const OHLCTimeSeriesEntry<Decimal>& entryBar)
     {
       mPositionState->addBar(entryBar);
     }
 
+    /**
+     * @brief Add the bar at barIndex of series (the series of this position's security).
+     * Consecutive bars of one series are recorded as bar indices instead of copies.
+     */
+    void addBar (const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, size_t barIndex)
+    {
+      mPositionState->addBar(series, barIndex);
+    }
+
     const TradingVolume& getTradingUnits() const
     {
       return mPositionState->getTradingUnits();
@@ -1169,10 +1515,25 @@ namespace mkc_timeseries
       return mPositionState->endPositionBarHistory();
     }
 
+    /**
+     * @brief The bars the position was held for (entry bar through last or exit bar).
+     * Use its appendBarReturns / getCloseValue for per-bar returns.
+     */
+    const OpenPositionHistory<Decimal>& getPositionBarHistory() const
+    {
+      return mPositionState->getPositionBarHistory();
+    }
+
     void ClosePosition (const boost::gregorian::date exitDate,
 			const Decimal& exitPrice)
     {
-      mPositionState->ClosePosition (this, mPositionState, exitDate, exitPrice);
+      ClosePosition (ptime (exitDate, getDefaultBarTime()), exitPrice);
+    }
+
+    void ClosePosition (const ptime& exitDateTime,
+			const Decimal& exitPrice)
+    {
+      mPositionState->ClosePosition (this, mPositionState, exitDateTime, exitPrice);
       NotifyPositionClosed (this);
     }
 
@@ -1205,7 +1566,7 @@ namespace mkc_timeseries
 		    std::shared_ptr<TradingPositionState<Decimal>> positionState)
       : mTradingSymbol (tradingSymbol),
 	mPositionState (positionState),
-	mPositionID(++mPositionIDCount),
+	mPositionID(BacktestIdDomain::current().nextPositionID()),
 	mObservers(),
 	mRMultipleStop(DecimalConstants<Decimal>::DecimalZero),
 	mRMultipleStopSet(false)
@@ -1244,14 +1605,11 @@ namespace mkc_timeseries
     std::string mTradingSymbol;
     std::shared_ptr<TradingPositionState<Decimal>> mPositionState;
     uint32_t mPositionID;
-    static std::atomic<uint32_t> mPositionIDCount;
     std::list<std::reference_wrapper<TradingPositionObserver<Decimal>>> mObservers;
     Decimal mRMultipleStop;
     bool mRMultipleStopSet;
   };
 
-  template <class Decimal> std::atomic<uint32_t>  TradingPosition<Decimal>::mPositionIDCount{0};
-
   template <class Decimal> 
   class TradingPositionLong : public TradingPosition<Decimal>
   {
@@ -1378,25 +1736,25 @@ namespace mkc_timeseries
   template <class Decimal>
   inline void OpenLongPosition<Decimal>::ClosePosition (TradingPosition<Decimal>* position,
 						     std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-						     const boost::gregorian::date exitDate,
+						     const ptime& exitDateTime,
 						     const Decimal& exitPrice)
     {
-      position->ChangeState (std::make_shared<ClosedLongPosition<Decimal>>(openPosition, exitDate, exitPrice));
+      position->ChangeState (std::make_shared<ClosedLongPosition<Decimal>>(openPosition, exitDateTime, exitPrice));
     }
 
   template <class Decimal>
   inline void OpenShortPosition<Decimal>::ClosePosition (TradingPosition<Decimal>* position,
 						     std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-						     const boost::gregorian::date exitDate,
+						     const ptime& exitDateTime,
 						     const Decimal& exitPrice)
     {
-      position->ChangeState (std::make_shared<ClosedShortPosition<Decimal>>(openPosition, exitDate, exitPrice));
+      position->ChangeState (std::make_shared<ClosedShortPosition<Decimal>>(openPosition, exitDateTime, exitPrice));
     }
 
   template <class Decimal>
   inline void ClosedLongPosition<Decimal>::ClosePosition (TradingPosition<Decimal>* position,
 						       std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-						       const boost::gregorian::date exitDate,
+						       const ptime& exitDateTime,
 						       const Decimal& exitPrice)
     {
       throw TradingPositionException("ClosedLongPosition: Cannot close an already closed position");
@@ -1405,7 +1763,7 @@ namespace mkc_timeseries
   template <class Decimal>
   inline void ClosedShortPosition<Decimal>::ClosePosition (TradingPosition<Decimal>* position,
 						       std::shared_ptr<TradingPositionState<Decimal>> openPosition,
-						       const boost::gregorian::date exitDate,
+						       const ptime& exitDateTime,
 						       const Decimal& exitPrice)
     {
       throw TradingPositionException("ClosedShortPosition: Cannot close an already closed position");
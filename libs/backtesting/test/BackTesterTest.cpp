@@ -304,6 +304,61 @@ SECTION ("PalStrategy testing for all long trades - pattern 2")
     std::cout << "RMultiple for longStrategy1 = " << rMultiple << std::endl << std::endl;;
   }
 
+SECTION ("Arena-allocated and heap-allocated backtests agree")
+  {
+    TimeSeriesDate backTesterDate(TimeSeriesDate (1985, Mar, 19));
+    TimeSeriesDate backtestEndDate(TimeSeriesDate (2011, Oct, 27));
+
+    DailyBackTester<DecimalType> arenaBacktester(backTesterDate, backtestEndDate);
+    REQUIRE (arenaBacktester.getBacktestArena() != nullptr);
+    arenaBacktester.addStrategy(longStrategy1->clone(aPortfolio));
+    arenaBacktester.backtest();
+
+    DailyBackTester<DecimalType> heapBacktester(backTesterDate, backtestEndDate);
+    heapBacktester.setBacktestArena(nullptr);
+    heapBacktester.addStrategy(longStrategy1->clone(aPortfolio));
+    heapBacktester.backtest();
+
+    auto arenaHistory = (*arenaBacktester.beginStrategies())->getStrategyBroker().getClosedPositionHistory();
+    auto heapHistory  = (*heapBacktester.beginStrategies())->getStrategyBroker().getClosedPositionHistory();
+
+    REQUIRE (arenaHistory.getNumPositions() == 24);
+    REQUIRE (arenaHistory.getNumPositions() == heapHistory.getNumPositions());
+    REQUIRE (arenaHistory.getNumWinningPositions() == heapHistory.getNumWinningPositions());
+    REQUIRE (arenaHistory.getRMultipleExpectancy() == heapHistory.getRMultipleExpectancy());
+    REQUIRE (arenaHistory.getPercentWinners() == heapHistory.getPercentWinners());
+
+    // A cloned BackTester gets an arena of its own
+    auto clonedBacktester = arenaBacktester.clone();
+    REQUIRE (clonedBacktester->getBacktestArena() != arenaBacktester.getBacktestArena());
+  }
+
+SECTION ("Position IDs are numbered per BackTester")
+  {
+    TimeSeriesDate backTesterDate(TimeSeriesDate (1985, Mar, 19));
+    TimeSeriesDate backtestEndDate(TimeSeriesDate (2011, Oct, 27));
+
+    auto collectPositionIds = [&]() {
+      DailyBackTester<DecimalType> backtester(backTesterDate, backtestEndDate);
+      backtester.addStrategy(longStrategy1->clone(aPortfolio));
+      backtester.backtest();
+
+      auto history = (*backtester.beginStrategies())->getStrategyBroker().getClosedPositionHistory();
+      std::vector<uint32_t> ids;
+      for (auto it = history.beginTradingPositions(); it != history.endTradingPositions(); ++it)
+	ids.push_back(it->second->getPositionID());
+      return ids;
+    };
+
+    std::vector<uint32_t> firstRunIds = collectPositionIds();
+    std::vector<uint32_t> secondRunIds = collectPositionIds();
+
+    REQUIRE (firstRunIds.size() == 24);
+    REQUIRE (firstRunIds.front() == 1);
+    REQUIRE (firstRunIds.back() == 24);
+    REQUIRE (firstRunIds == secondRunIds);
+  }
+
  SECTION("BackTester::getAllHighResReturns with PalLongStrategy") {
     using DT = DecimalType;
     const std::string sym = "@C";
@@ -613,3 +668,69 @@ SECTION ("PalStrategy testing for all long trades - pattern 2")
  }
 }
 
+
+TEST_CASE ("IntradayBackTester operations", "[BackTester]")
+{
+  // Hourly bars over two days. Pattern: CLOSE OF 0 BARS AGO > OPEN OF 0 BARS AGO
+  auto bar1 = createTimeSeriesEntry ("20240102", "09:00:00", "100.00", "101.00", "99.50", "100.50", "1000");
+  auto bar2 = createTimeSeriesEntry ("20240102", "10:00:00", "100.60", "100.90", "100.40", "100.70", "1000");
+  auto bar3 = createTimeSeriesEntry ("20240102", "11:00:00", "100.80", "101.80", "100.70", "101.70", "1000");
+  auto bar4 = createTimeSeriesEntry ("20240102", "12:00:00", "101.60", "101.90", "101.00", "101.20", "1000");
+  auto bar5 = createTimeSeriesEntry ("20240103", "09:00:00", "101.30", "101.50", "101.10", "101.25", "1000");
+  auto bar6 = createTimeSeriesEntry ("20240103", "10:00:00", "101.20", "101.40", "101.00", "101.10", "1000");
+
+  auto hourlySeries = std::make_shared<OHLCTimeSeries<DecimalType>>(TimeFrame::INTRADAY, TradingVolume::SHARES);
+  for (const auto& bar : {bar1, bar2, bar3, bar4, bar5, bar6})
+    hourlySeries->addEntry (*bar);
+
+  std::string equitySymbol("MSFT");
+  auto msft = std::make_shared<EquitySecurity<DecimalType>>(equitySymbol, "Microsoft", hourlySeries);
+
+  auto aPortfolio = std::make_shared<Portfolio<DecimalType>>("Intraday Portfolio");
+  aPortfolio->addSecurity (msft);
+
+  PatternDescription *desc = createDescription(std::string("MSFT_RAD_Hourly.txt"), 1,
+					       20240102, std::string("60.00"),
+					       std::string("40.00"), 10, 2);
+  auto upBar = new GreaterThanExpr (new PriceBarClose(0), new PriceBarOpen(0));
+  auto pattern = std::make_shared<PriceActionLabPattern>(desc, upBar, createLongOnOpen(),
+							 createLongProfitTarget("1.00"),
+							 createLongStopLoss("1.00"));
+
+  auto longStrategy = std::make_shared<PalLongStrategy<DecimalType>>("PAL Intraday Long Strategy",
+								     pattern, aPortfolio);
+
+  SECTION ("BackTesterFactory creates an IntradayBackTester for intraday time frames")
+  {
+    DateRange range(TimeSeriesDate (2024, Jan, 2), TimeSeriesDate (2024, Jan, 3));
+    auto backTester = BackTesterFactory<DecimalType>::getBackTester(TimeFrame::INTRADAY, range);
+
+    REQUIRE (backTester->isIntradayBackTester());
+    REQUIRE_FALSE (backTester->isDailyBackTester());
+  }
+
+  SECTION ("IntradayBackTester fills orders on the next bar of the same day")
+  {
+    IntradayBackTester<DecimalType> backTester(TimeSeriesDate (2024, Jan, 2),
+					       TimeSeriesDate (2024, Jan, 3));
+    backTester.addStrategy (longStrategy);
+    backTester.backtest();
+
+    const StrategyBroker<DecimalType>& broker = longStrategy->getStrategyBroker();
+    REQUIRE (broker.getClosedTrades() == 1);
+    REQUIRE (broker.getOpenTrades() == 1);
+
+    // Entered on the 10:00 open after the 09:00 up bar, exited at the
+    // profit target on the 11:00 bar
+    auto closedPosition = broker.getClosedPositionHistory().beginTradingPositions()->second;
+    REQUIRE (closedPosition->getEntryDateTime() == bar2->getDateTime());
+    REQUIRE (closedPosition->getEntryPrice() == bar2->getOpenValue());
+    REQUIRE (closedPosition->getExitDateTime() == bar3->getDateTime());
+    REQUIRE (closedPosition->isWinningPosition());
+
+    // Re-entered on the 12:00 open after the 11:00 up bar and held overnight
+    const InstrumentPosition<DecimalType>& openPosition = broker.getInstrumentPosition(equitySymbol);
+    REQUIRE (openPosition.isLongPosition());
+    REQUIRE (openPosition.getFillPrice() == bar4->getOpenValue());
+  }
+}
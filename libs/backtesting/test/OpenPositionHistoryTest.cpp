@@ -91,21 +91,21 @@ TEST_CASE ("OpenPositionHistory operations", "[OpenPositionHistory]")
   {
     OpenPositionHistory<DecimalType>::PositionBarIterator it = positionHistory.beginPositionBarHistory();
 
-    REQUIRE (it->first == TimeSeriesDate (2015, Dec, 28));
+    REQUIRE (it->first.date() == TimeSeriesDate (2015, Dec, 28));
     REQUIRE (it->second == *bar1);
     it++;
 
-    REQUIRE (it->first == TimeSeriesDate (2015, Dec, 29));
+    REQUIRE (it->first.date() == TimeSeriesDate (2015, Dec, 29));
     REQUIRE (it->second == *bar2);
     it++;
 
-    REQUIRE (it->first == TimeSeriesDate (2015, Dec, 30));
+    REQUIRE (it->first.date() == TimeSeriesDate (2015, Dec, 30));
     REQUIRE (it->second == *bar3);
 
     it = positionHistory.endPositionBarHistory();
     it--;
 
-    REQUIRE (it->first == TimeSeriesDate (2016, Jan, 6));
+    REQUIRE (it->first.date() == TimeSeriesDate (2016, Jan, 6));
     REQUIRE (it->second == *bar7);
 
   }
@@ -114,23 +114,99 @@ SECTION ("OpenPositionHistory ConstIterator operations");
   {
     OpenPositionHistory<DecimalType>::ConstPositionBarIterator it = positionHistory.beginPositionBarHistory();
 
-    REQUIRE (it->first == TimeSeriesDate (2015, Dec, 28));
+    REQUIRE (it->first.date() == TimeSeriesDate (2015, Dec, 28));
     REQUIRE (it->second == *bar1);
     it++;
 
-    REQUIRE (it->first == TimeSeriesDate (2015, Dec, 29));
+    REQUIRE (it->first.date() == TimeSeriesDate (2015, Dec, 29));
     REQUIRE (it->second == *bar2);
     it++;
 
-    REQUIRE (it->first == TimeSeriesDate (2015, Dec, 30));
+    REQUIRE (it->first.date() == TimeSeriesDate (2015, Dec, 30));
     REQUIRE (it->second == *bar3);
 
     it = positionHistory.endPositionBarHistory();
     it--;
 
-    REQUIRE (it->first == TimeSeriesDate (2016, Jan, 6));
+    REQUIRE (it->first.date() == TimeSeriesDate (2016, Jan, 6));
     REQUIRE (it->second == *bar7);
 
   }
 }
 
+
+TEST_CASE ("OpenPositionHistory bars from a series", "[OpenPositionHistory]")
+{
+  auto series = std::make_shared<OHLCTimeSeries<DecimalType>>(TimeFrame::DAILY, TradingVolume::SHARES);
+  series->addEntry (*createTimeSeriesEntry ("20151228", "204.86", "205.26", "203.94","205.21", 65899900));
+  series->addEntry (*createTimeSeriesEntry ("20151229", "206.51", "207.79", "206.47","207.40", 92640700));
+  series->addEntry (*createTimeSeriesEntry ("20151230", "207.11", "207.21", "205.76","205.93", 63317700));
+  series->addEntry (*createTimeSeriesEntry ("20151231", "205.13", "205.89", "203.87","203.87", 114877900));
+  series->addEntry (*createTimeSeriesEntry ("20160104", "200.49", "201.03", "198.59","201.02", 222353400));
+
+  std::shared_ptr<const OHLCTimeSeries<DecimalType>> constSeries = series;
+
+  // Entry bar is a copy of bar 1 of the series, later bars are added by index
+  OpenPositionHistory<DecimalType> history (*(series->beginRandomAccess() + 1));
+  history.addBar (constSeries, 2);
+  history.addBar (constSeries, 3);
+
+  REQUIRE (history.isSeriesBacked());
+  REQUIRE (history.numBarsInPosition() == 3);
+  REQUIRE (history.getFirstDate() == TimeSeriesDate (2015, Dec, 29));
+  REQUIRE (history.getLastDate() == TimeSeriesDate (2015, Dec, 31));
+  REQUIRE (history.getLastClose() == createDecimal ("203.87"));
+
+  SECTION ("Bar returns are read from the series")
+  {
+    std::vector<DecimalType> returns;
+    history.appendBarReturns (returns);
+
+    REQUIRE (history.isSeriesBacked());
+    REQUIRE (returns.size() == 2);
+    REQUIRE (returns[0] == (createDecimal ("205.93") - createDecimal ("207.40")) / createDecimal ("207.40"));
+    REQUIRE (returns[1] == (createDecimal ("203.87") - createDecimal ("205.93")) / createDecimal ("205.93"));
+  }
+
+  SECTION ("Iterators see the series bars")
+  {
+    REQUIRE (history.isSeriesBacked());
+
+    auto it = history.beginPositionBarHistory();
+    REQUIRE (it->first.date() == TimeSeriesDate (2015, Dec, 29));
+    it++;
+    REQUIRE (it->second.getTimeSeriesEntry() == *(series->beginRandomAccess() + 2));
+
+    it = history.endPositionBarHistory();
+    it--;
+    REQUIRE (it->first.date() == TimeSeriesDate (2015, Dec, 31));
+  }
+
+  SECTION ("A duplicate bar is rejected without leaving the series")
+  {
+    REQUIRE_THROWS (history.addBar (constSeries, 3));
+    REQUIRE_THROWS (history.addBar (OpenPositionBar<DecimalType>(*(series->beginRandomAccess() + 2))));
+
+    REQUIRE (history.isSeriesBacked());
+    REQUIRE (history.numBarsInPosition() == 3);
+
+    // The run still continues
+    history.addBar (constSeries, 4);
+    REQUIRE (history.isSeriesBacked());
+    REQUIRE (history.getLastDate() == TimeSeriesDate (2016, Jan, 4));
+  }
+
+  SECTION ("A bar that does not continue the run is copied in order")
+  {
+    auto entry = createTimeSeriesEntry ("20160105", "201.40", "201.90", "200.05","201.36", 105999900);
+    history.addBar (OpenPositionBar<DecimalType>(*entry));
+
+    REQUIRE_FALSE (history.isSeriesBacked());
+    REQUIRE (history.numBarsInPosition() == 4);
+    REQUIRE (history.getFirstDate() == TimeSeriesDate (2015, Dec, 29));
+    REQUIRE (history.getLastClose() == createDecimal ("201.36"));
+
+    OpenPositionHistory<DecimalType> copy (history);
+    REQUIRE (copy.getLastDate() == TimeSeriesDate (2016, Jan, 5));
+  }
+}
@@ -99,13 +99,13 @@ TEST_CASE ("OpenPosition operations", "[OpenPosition]")
   {
     OpenPosition<DecimalType>::PositionBarIterator it = longPosition1.beginPositionBarHistory();
     it++;
-    REQUIRE (it->first ==  TimeSeriesDate (2015, Dec, 30));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (2015, Dec, 30));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry4);
 
     it = longPosition1.endPositionBarHistory();
     it--;
 
-    REQUIRE (it->first ==  TimeSeriesDate (2016, Jan, 4));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (2016, Jan, 4));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry2);
   }
 
@@ -113,13 +113,13 @@ TEST_CASE ("OpenPosition operations", "[OpenPosition]")
   {
     OpenPosition<DecimalType>::ConstPositionBarIterator it = longPosition1.beginPositionBarHistory();
     it++;
-    REQUIRE (it->first ==  TimeSeriesDate (2015, Dec, 30));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (2015, Dec, 30));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry4);
 
     it = longPosition1.endPositionBarHistory();
     it--;
 
-    REQUIRE (it->first ==  TimeSeriesDate (2016, Jan, 4));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (2016, Jan, 4));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry2);
   }
 
@@ -127,13 +127,13 @@ TEST_CASE ("OpenPosition operations", "[OpenPosition]")
   {
     OpenPosition<DecimalType>::PositionBarIterator it = shortPosition1.beginPositionBarHistory();
     it++;
-    REQUIRE (it->first ==  TimeSeriesDate (2015, Dec, 30));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (2015, Dec, 30));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry4);
 
     it = longPosition1.endPositionBarHistory();
     it--;
 
-    REQUIRE (it->first ==  TimeSeriesDate (2016, Jan, 4));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (2016, Jan, 4));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry2);
   }
 
@@ -141,13 +141,13 @@ TEST_CASE ("OpenPosition operations", "[OpenPosition]")
   {
     OpenPosition<DecimalType>::ConstPositionBarIterator it = shortPosition1.beginPositionBarHistory();
     it++;
-    REQUIRE (it->first ==  TimeSeriesDate (2015, Dec, 30));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (2015, Dec, 30));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry4);
 
     it = longPosition1.endPositionBarHistory();
     it--;
 
-    REQUIRE (it->first ==  TimeSeriesDate (2016, Jan, 4));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (2016, Jan, 4));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry2);
   }
   
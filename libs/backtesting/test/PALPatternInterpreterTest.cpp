@@ -1,4 +1,5 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include "TimeSeriesCsvReader.h"
 #include "PALPatternInterpreter.h"
 #include "BoostDateHelper.h"
@@ -148,6 +149,70 @@ SECTION ("PALPatternInterpreter testing for short pattern not matched")
 
   }
 
+SECTION ("PALPatternInterpreter compiled pattern matches lambda tree") 
+  {
+    auto longTree = PALPatternInterpreter<DecimalType>::compileLambdaTree (and4);
+    auto shortTree = PALPatternInterpreter<DecimalType>::compileLambdaTree (shortand4);
+    auto longCompiled = PALPatternInterpreter<DecimalType>::compilePattern (and4);
+    auto shortCompiled = PALPatternInterpreter<DecimalType>::compilePattern (shortand4);
+
+    REQUIRE (longCompiled.getComparisons().size() == 5);
+    REQUIRE (longCompiled.getMaxOffset() == 8);
+    REQUIRE (shortCompiled.getComparisons().size() == 5);
+    REQUIRE (shortCompiled.getMaxOffset() == 5);
+
+    unsigned int longMatches = 0;
+    auto it = corn->getRandomAccessIteratorBegin() + 8;
+    for (; it != corn->getRandomAccessIteratorEnd(); it++)
+      {
+	bool matched = longCompiled (corn.get(), it);
+	REQUIRE (matched == longTree (corn.get(), it));
+	REQUIRE (shortCompiled (corn.get(), it) == shortTree (corn.get(), it));
+	if (matched)
+	  longMatches++;
+      }
 
+    REQUIRE (longMatches > 0);
+    REQUIRE_THROWS (longCompiled (corn.get(), corn->getRandomAccessIteratorEnd()));
+    REQUIRE_FALSE (CompiledPalPattern<DecimalType>() (corn.get(), corn->getRandomAccessIteratorBegin()));
+  }
 }
 
+TEST_CASE ("PALPatternInterpreter evaluator benchmark", "[.][benchmark][PALPatternInterpreter]")
+{
+  DecimalType cornTickValue(createDecimal("0.25"));
+  PALFormatCsvReader<DecimalType> csvFile ("C2_122AR.txt", TimeFrame::DAILY, TradingVolume::CONTRACTS, cornTickValue);
+  csvFile.readFile();
+
+  auto corn = std::make_shared<FuturesSecurity<DecimalType>>("C2", "Corn futures",
+							     createDecimal("50.0"),
+							     cornTickValue,
+							     csvFile.getTimeSeries());
+
+  // Ten conditions: CLOSE OF i BARS AGO > CLOSE OF i + 1 BARS AGO for i = 0..9
+  PatternExpression* expr = new GreaterThanExpr (new PriceBarClose(0), new PriceBarClose(1));
+  for (unsigned int i = 1; i < 10; i++)
+    expr = new AndExpr (expr, new GreaterThanExpr (new PriceBarClose(i), new PriceBarClose(i + 1)));
+
+  auto lambdaTree = PALPatternInterpreter<DecimalType>::compileLambdaTree (expr);
+  auto compiled = PALPatternInterpreter<DecimalType>::compilePattern (expr);
+  auto first = corn->getRandomAccessIteratorBegin() + 10;
+  auto last = corn->getRandomAccessIteratorEnd();
+
+  // Each run evaluates every bar of the series once; bars/sec = bars / mean time
+  BENCHMARK ("lambda tree, all bars")
+    {
+      unsigned int matches = 0;
+      for (auto it = first; it != last; it++)
+	matches += lambdaTree (corn.get(), it);
+      return matches;
+    };
+
+  BENCHMARK ("compiled pattern, all bars")
+    {
+      unsigned int matches = 0;
+      for (auto it = first; it != last; it++)
+	matches += compiled (corn.get(), it);
+      return matches;
+    };
+}
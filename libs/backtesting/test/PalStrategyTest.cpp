@@ -354,6 +354,35 @@ TEST_CASE ("PalStrategy operations", "[PalStrategy]")
     REQUIRE (aBroker.getClosedTrades() == 0);
   }
 
+  SECTION ("PalStrategy testing for long pattern with resolved bars")
+  {
+    TimeSeriesDate orderDate(TimeSeriesDate (1985, Mar, 1));
+    TimeSeriesDate endDate(TimeSeriesDate (1985, Nov, 15));
+
+    for (; (orderDate <= endDate); orderDate = boost_next_weekday(orderDate))
+      {
+	auto bar = corn->findTimeSeriesEntry (orderDate);
+	if (bar != corn->getRandomAccessIteratorEnd())
+	  {
+	    REQUIRE (bar->getDateValue() == orderDate);
+	    longStrategy1.eventUpdateSecurityBarNumber(futuresSymbol);
+	    longStrategy1.eventEntryOrders(corn.get(),
+					   longStrategy1.getInstrumentPosition(futuresSymbol),
+					   orderDate,
+					   bar);
+	    REQUIRE ( longStrategy1.isFlatPosition (futuresSymbol));
+	  }
+      }
+
+    // same entry as with the date-only event: signal on 1985-11-15, filled on the next bar
+    longStrategy1.eventProcessPendingOrders(orderDate);
+    REQUIRE ( longStrategy1.isLongPosition (futuresSymbol));
+
+    StrategyBroker<DecimalType> aBroker = longStrategy1.getStrategyBroker();
+    REQUIRE (aBroker.getTotalTrades() == 1);
+    REQUIRE (aBroker.getOpenTrades() == 1);
+  }
+
   SECTION ("PalStrategy testing for short pattern not matched") 
   {
     TimeSeriesDate orderDate(TimeSeriesDate (1985, Mar, 1));
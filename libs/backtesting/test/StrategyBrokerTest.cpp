@@ -406,3 +406,55 @@ TEST_CASE ("StrategyBroker operations", "[StrategyBroker]")
 
 }
 
+
+TEST_CASE ("StrategyBroker intraday operations", "[StrategyBroker]")
+{
+  auto bar1 = createTimeSeriesEntry ("20240102", "09:00:00", "100.00", "101.00", "99.50", "100.50", "1000");
+  auto bar2 = createTimeSeriesEntry ("20240102", "10:00:00", "100.60", "102.00", "100.40", "101.80", "1000");
+  auto bar3 = createTimeSeriesEntry ("20240102", "11:00:00", "101.90", "103.00", "101.50", "102.70", "1000");
+  auto bar4 = createTimeSeriesEntry ("20240102", "12:00:00", "102.80", "103.20", "102.10", "102.40", "1000");
+
+  auto hourlySeries = std::make_shared<OHLCTimeSeries<DecimalType>>(TimeFrame::INTRADAY, TradingVolume::SHARES);
+  hourlySeries->addEntry (*bar1);
+  hourlySeries->addEntry (*bar2);
+  hourlySeries->addEntry (*bar3);
+  hourlySeries->addEntry (*bar4);
+
+  std::string equitySymbol("MSFT");
+  auto msft = std::make_shared<EquitySecurity<DecimalType>>(equitySymbol, "Microsoft", hourlySeries);
+
+  auto aPortfolio = std::make_shared<Portfolio<DecimalType>>("Intraday Portfolio");
+  aPortfolio->addSecurity (msft);
+
+  StrategyBroker<DecimalType> aBroker(aPortfolio);
+  TradingVolume oneShare(1, TradingVolume::SHARES);
+
+  SECTION ("StrategyBroker fills intraday orders on the next bar of the same day")
+  {
+    aBroker.EnterLongOnOpen (equitySymbol, bar1->getDateTime(), oneShare);
+
+    // An order is never filled on the bar it was placed on
+    aBroker.ProcessPendingOrders (bar1->getDateTime());
+    REQUIRE (aBroker.getTotalTrades() == 0);
+
+    aBroker.ProcessPendingOrders (bar2->getDateTime());
+    REQUIRE (aBroker.getOpenTrades() == 1);
+    REQUIRE (aBroker.getInstrumentPosition(equitySymbol).isLongPosition());
+    REQUIRE (aBroker.getInstrumentPosition(equitySymbol).getFillPrice() == bar2->getOpenValue());
+
+    aBroker.ExitLongAllUnitsOnOpen (equitySymbol, bar3->getDateTime());
+    aBroker.ProcessPendingOrders (bar3->getDateTime());
+    REQUIRE (aBroker.getOpenTrades() == 1);
+
+    aBroker.ProcessPendingOrders (bar4->getDateTime());
+    REQUIRE (aBroker.getInstrumentPosition(equitySymbol).isFlatPosition());
+    REQUIRE (aBroker.getClosedTrades() == 1);
+
+    ClosedPositionHistory<DecimalType> positions (aBroker.getClosedPositionHistory());
+    auto position = positions.beginTradingPositions()->second;
+    REQUIRE (position->getEntryDateTime() == bar2->getDateTime());
+    REQUIRE (position->getExitDateTime() == bar4->getDateTime());
+    REQUIRE (position->getExitPrice() == bar4->getOpenValue());
+    REQUIRE (position->getNumBarsInPosition() == 3);
+  }
+}
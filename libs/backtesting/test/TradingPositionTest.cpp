@@ -431,13 +431,13 @@ SECTION ("TradingPositionShort close position test 2 with R multiple")
   {
     TradingPosition<DecimalType>::ConstPositionBarIterator it = longPosition1.beginPositionBarHistory();
     it++;
-    REQUIRE (it->first ==  TimeSeriesDate (1985, Nov, 19));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (1985, Nov, 19));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry1);
 
     it = longPosition1.endPositionBarHistory();
     it--;
 
-    REQUIRE (it->first ==  TimeSeriesDate (1985, Dec, 4));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (1985, Dec, 4));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry11);
   }
 
@@ -453,13 +453,13 @@ SECTION ("TradingPositionShort close position test 2 with R multiple")
 
     TradingPosition<DecimalType>::ConstPositionBarIterator it = longPosition1.beginPositionBarHistory();
     it++;
-    REQUIRE (it->first ==  TimeSeriesDate (1985, Nov, 19));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (1985, Nov, 19));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry1);
 
     it = longPosition1.endPositionBarHistory();
     it--;
 
-    REQUIRE (it->first ==  TimeSeriesDate (1985, Dec, 4));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (1985, Dec, 4));
     REQUIRE (it->second.getTimeSeriesEntry() == *entry11);
   }
 
@@ -475,13 +475,13 @@ SECTION ("TradingPositionShort close position test 2 with R multiple")
 
     TradingPosition<DecimalType>::ConstPositionBarIterator it = shortPosition1.beginPositionBarHistory();
     it++;
-    REQUIRE (it->first ==  TimeSeriesDate (1986, May, 30));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (1986, May, 30));
     REQUIRE (it->second.getTimeSeriesEntry() == *shortEntry1);
 
     it = shortPosition1.endPositionBarHistory();
     it--;
 
-    REQUIRE (it->first ==  TimeSeriesDate (1986, Jun, 11));
+    REQUIRE (it->first.date() ==  TimeSeriesDate (1986, Jun, 11));
     REQUIRE (it->second.getTimeSeriesEntry() == *shortEntry9);
   }
   
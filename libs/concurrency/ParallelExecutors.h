@@ -7,6 +7,11 @@
 #include <vector>
 #include <functional>
 #include <queue>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
 #include <mutex>
 #include <condition_variable>
 #include "runner.hpp"  // for BoostRunnerExecutor
@@ -20,20 +25,24 @@
  *  - StdAsyncExecutor: uses std::async(std::launch::async) to spawn tasks (portable but may oversubscribe).
  *  - BoostRunnerExecutor: delegates tasks to a Boost-based thread pool (requires Boost runner).
  *  - ThreadPoolExecutor<N>: a fixed-size thread pool with N worker threads (lowest overhead for many small tasks).
+ *  - WorkStealingExecutor<N>: a fixed-size pool with one task deque per worker; idle workers steal queued tasks.
  *
  * @section usage Guidance on choosing an executor policy
  * - SingleThreadExecutor: Use in unit tests or when debugging, or when concurrency must be disabled.
  * - StdAsyncExecutor: Easy and dependency-free; good for a small number of long-running tasks.
  * - BoostRunnerExecutor: Integrates with an existing Boost-based runner thread-pool; good if already using Boost runner.
  * - ThreadPoolExecutor<N>: Best for high-throughput scenarios with many small tasks; amortizes thread creation cost.
+ * - WorkStealingExecutor<N>: Best when task costs vary (e.g. permutation backtests) or tasks submit further tasks.
  *
  * @section tradeoffs
- * - Thread creation overhead: std::async and BoostRunnerExecutor may create/destroy threads per task, which can dominate
+ * - Thread creation overhead: std::async may create/destroy threads per task, which can dominate
  *   execution time when tasks are short or numerous.
  * - Resource contention: unbounded task submission to std::async can oversubscribe CPU and lead to contention.
  * - Determinism: SingleThreadExecutor yields deterministic, reproducible execution, useful for tests.
  * - Integration: BoostRunnerExecutor fits existing Boost-based task systems, avoiding new thread pools.
  * - Control: ThreadPoolExecutor gives fine-grained control over number of threads and queue behavior.
+ * - Contention: ThreadPoolExecutor pushes and pops every task through one mutex; WorkStealingExecutor
+ *   gives each worker its own deque, so workers contend only when they steal.
  */
 namespace concurrency
 {
@@ -96,7 +105,8 @@ namespace concurrency
 
   /**
    * @brief Submits tasks to the existing Boost-based runner thread pool.
-   * Wraps boost::unique_future<void> into std::future<void>.
+   * Each task completes a std::promise<void> from inside the pool thread that runs it,
+   * so a submit is a single queue push and no threads are created besides the pool's.
    */
   class BoostRunnerExecutor : public IParallelExecutor {
   public:
@@ -104,21 +114,17 @@ namespace concurrency
     {
       runner::ensure_initialized(getNCpus());
 
-      // post to the Boost runner
-      auto boostFut = runner::instance().post(std::move(task));
+      auto prom = std::make_shared<std::promise<void>>();
+      auto stdFut = prom->get_future();
 
-      // Wrap boost::unique_future into a std::future via std::promise + watcher thread
-      std::promise<void> prom;
-      auto stdFut = prom.get_future();
-
-      std::thread([bf = std::move(boostFut), p = std::move(prom)]() mutable {
+      runner::instance().execute([p = std::move(prom), t = std::move(task)]() {
 	try {
-	  bf.get();  // propagate exceptions from the task
-	  p.set_value();
+	  t();
+	  p->set_value();
 	} catch (...) {
-	  p.set_exception(std::current_exception());
+	  p->set_exception(std::current_exception());  // propagate exceptions from the task
 	}
-      }).detach();
+      });
 
       return stdFut;
     }
@@ -200,4 +206,205 @@ namespace concurrency
     std::condition_variable           condition_;
     bool                              stop_;
   };
+
+  /**
+   * @brief Fixed-size thread pool where each worker owns a task deque and idle workers steal.
+   *
+   * - A task submitted from outside the pool is pushed to the back of one worker's deque,
+   *   with workers chosen round robin.
+   * - A task submitted by a worker is pushed to the back of that worker's own deque.
+   * - A worker pops its own deque from the back. When that is empty, it steals from the
+   *   front of the other workers' deques. Expensive tasks therefore do not hold up cheap
+   *   ones queued behind them; another worker picks those up.
+   * - waitAll() called from a worker runs queued tasks while it waits, so tasks may wait
+   *   on tasks they submitted without deadlocking the pool.
+   *
+   * Template parameter N specifies the number of threads in the pool.
+   * If N == 0, at runtime we pick std::thread::hardware_concurrency()
+   * (falling back to 2 if that returns 0).
+   */
+  template <std::size_t N = 0>
+  class WorkStealingExecutor : public IParallelExecutor {
+  public:
+    WorkStealingExecutor()
+      : queues_(),
+	workers_(),
+	nextQueue_(0),
+	pendingTasks_(0),
+	stop_(false)
+    {
+      const std::size_t threads =
+	N > 0
+	? N
+	: (std::thread::hardware_concurrency() > 0
+	   ? std::thread::hardware_concurrency()
+	   : 2);
+
+      for (std::size_t i = 0; i < threads; ++i)
+	queues_.emplace_back(std::make_unique<WorkerQueue>());
+
+      for (std::size_t i = 0; i < threads; ++i)
+	workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    ~WorkStealingExecutor()
+    {
+      {
+	std::unique_lock<std::mutex> lock(wakeMutex_);
+	stop_ = true;
+      }
+      wakeCondition_.notify_all();
+      for (auto &worker : workers_) {
+	if (worker.joinable())
+	  worker.join();
+      }
+    }
+
+    // override the pure virtual submit() from IParallelExecutor
+    std::future<void> submit(std::function<void()> task) override
+    {
+      auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+      auto fut = packaged->get_future();
+
+      if (stop_.load(std::memory_order_acquire))
+	throw std::runtime_error("enqueue on stopped WorkStealingExecutor");
+
+      const std::size_t target = (currentWorker().executor == this)
+	? currentWorker().index
+	: nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+      {
+	// Count the task before it becomes visible so a worker never decrements past zero.
+	// Taking the wake mutex orders the increment with a worker's check before it sleeps.
+	std::lock_guard<std::mutex> lock(wakeMutex_);
+	pendingTasks_.fetch_add(1, std::memory_order_release);
+      }
+
+      {
+	std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+	queues_[target]->tasks.emplace_back([packaged]() { (*packaged)(); });
+      }
+      wakeCondition_.notify_one();
+      return fut;
+    }
+
+    void waitAll(std::vector<std::future<void>>& futures) override
+    {
+      if (currentWorker().executor == this)
+	{
+	  const std::size_t self = currentWorker().index;
+	  for (auto& f : futures)
+	    {
+	      while (f.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+		  if (!runOneTask(self))
+		    std::this_thread::yield();
+		}
+	    }
+	}
+
+      for (auto& f : futures)
+	f.get();
+    }
+
+    std::size_t getNumThreads() const
+    {
+      return workers_.size();
+    }
+
+  private:
+    struct WorkerQueue
+    {
+      std::mutex mutex;
+      std::deque<std::function<void()>> tasks;
+    };
+
+    struct WorkerIdentity
+    {
+      const WorkStealingExecutor* executor = nullptr;
+      std::size_t index = 0;
+    };
+
+    static WorkerIdentity& currentWorker()
+    {
+      thread_local WorkerIdentity identity;
+      return identity;
+    }
+
+    bool popLocal(std::size_t self, std::function<void()>& task)
+    {
+      WorkerQueue& queue = *queues_[self];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty())
+	return false;
+
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return true;
+    }
+
+    bool steal(std::size_t self, std::function<void()>& task)
+    {
+      const std::size_t numQueues = queues_.size();
+      for (std::size_t offset = 1; offset < numQueues; ++offset)
+	{
+	  WorkerQueue& victim = *queues_[(self + offset) % numQueues];
+	  std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+	  if (!lock.owns_lock() || victim.tasks.empty())
+	    continue;
+
+	  task = std::move(victim.tasks.front());
+	  victim.tasks.pop_front();
+	  return true;
+	}
+      return false;
+    }
+
+    bool runOneTask(std::size_t self)
+    {
+      std::function<void()> task;
+      if (!popLocal(self, task) && !steal(self, task))
+	return false;
+
+      pendingTasks_.fetch_sub(1, std::memory_order_acq_rel);
+      task();
+      return true;
+    }
+
+    void workerLoop(std::size_t self)
+    {
+      currentWorker().executor = this;
+      currentWorker().index = self;
+
+      for (;;)
+	{
+	  if (runOneTask(self))
+	    continue;
+
+	  // A steal can miss a task while its queue is locked, so only sleep when none are pending
+	  std::unique_lock<std::mutex> lock(wakeMutex_);
+	  if (pendingTasks_.load(std::memory_order_acquire) > 0)
+	    continue;
+	  if (stop_.load(std::memory_order_acquire))
+	    return;
+
+	  wakeCondition_.wait(lock, [this] {
+	    return stop_.load(std::memory_order_acquire) ||
+	      pendingTasks_.load(std::memory_order_acquire) > 0;
+	  });
+	}
+    }
+
+  private:
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread>                  workers_;
+    std::atomic<std::size_t>                  nextQueue_;
+    std::atomic<std::size_t>                  pendingTasks_;
+    std::atomic<bool>                         stop_;
+    std::mutex                                wakeMutex_;
+    std::condition_variable                   wakeCondition_;
+  };
 } // namespace concurrency
@@ -4,29 +4,49 @@
 #include <thread>     // for std::thread::hardware_concurrency()
 #include <vector>     // for std::vector
 #include <future>     // for std::future
-#include <algorithm>  // for std::min
+#include <atomic>     // for std::atomic
+#include <memory>     // for std::make_shared
+#include <algorithm>  // for std::min, std::max
 
 namespace concurrency {
 
-  // Split [0…total) into at most T chunks (where T = hardware_concurrency),
-  // submit each chunk to executor.submit, waitAll, and internally
-  // loop p from chunk.start to chunk.end calling your body(p).
+  // Run body(p) for every p in [0…total) on at most T tasks (where T = hardware_concurrency).
+  //
+  // Iterations are not split up front. Each task repeatedly claims the next chunk from a
+  // shared counter, sized at remaining / (2 * T) but never below minGrain. Chunks start
+  // large and shrink towards the end, so a task that drew expensive iterations leaves the
+  // remaining ones to the other tasks instead of finishing last with a fixed share.
+  //
+  // Each task works on its own copy of body, as before.
   template<typename Executor, typename Body>
-    void parallel_for(uint32_t total, Executor& exec, Body body) {
+    void parallel_for(uint32_t total, Executor& exec, Body body, uint32_t minGrain = 1) {
     if (total == 0) return;
 
     const unsigned hw = std::thread::hardware_concurrency();
-    const unsigned numTasks = hw ? hw : 2;
-    const uint32_t chunkSize = (total + numTasks - 1) / numTasks; // ceil-divide
+    const uint32_t numTasks = std::min<uint32_t>(hw ? hw : 2, total);
+    const uint32_t grain = std::max<uint32_t>(minGrain, 1);
+
+    auto next = std::make_shared<std::atomic<uint32_t>>(0);
 
     std::vector<std::future<void>> futures;
-    for (uint32_t start = 0; start < total; start += chunkSize)
+    futures.reserve(numTasks);
+    for (uint32_t t = 0; t < numTasks; ++t)
       {
-	uint32_t end = std::min(total, start + chunkSize);
 	futures.emplace_back(
 			     exec.submit([=]() {
-				 for (uint32_t p = start; p < end; ++p) {
-				   body(p);
+				 for (;;) {
+				   uint32_t start = next->load(std::memory_order_relaxed);
+				   uint32_t end;
+				   do {
+				     if (start >= total)
+				       return;
+				     const uint32_t chunk = std::max(grain, (total - start) / (2 * numTasks));
+				     end = start + std::min(chunk, total - start);
+				   } while (!next->compare_exchange_weak(start, end, std::memory_order_relaxed));
+
+				   for (uint32_t p = start; p < end; ++p) {
+				     body(p);
+				   }
 				 }
 			       })
 			     );
@@ -62,6 +62,14 @@ struct runner
     return std::move(res);
   }
 
+  // method to submit a job that reports its own completion (e.g. through a promise it
+  // captured). No future is created; the job must not let exceptions escape.
+  template<typename F>
+  void execute(F f)
+  {
+    ios.post(std::move(f));
+  }
+
   /// Returns true if the singleton has already been constructed.
   static bool is_initialized() { return instance_ptr() != nullptr; }
 
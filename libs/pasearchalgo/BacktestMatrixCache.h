@@ -0,0 +1,206 @@
+// Copyright (C) MKC Associates, LLC
+// All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+
+#ifndef BACKTESTMATRIXCACHE_H
+#define BACKTESTMATRIXCACHE_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <valarray>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "number.h"
+#include "BinaryCacheUtils.h"
+#include "TimeSeries.h"
+
+#ifndef USE_BLOOMBERG_DECIMALS
+
+namespace mkc_searchalgo
+{
+
+  ///
+  /// Everything the backtest result base depends on: the series, side, target and stop, the tick
+  /// they are rounded to, the date range the per-bar backtests are clipped to, and the version of the
+  /// simulation rules. The big point value is not part of it, the results are percent returns.
+  ///
+  struct BacktestMatrixKey
+  {
+    uint64_t mSeriesHash;
+    uint64_t mTradedSeriesHash;
+    int64_t mProfitTarget;
+    int64_t mStopLoss;
+    int64_t mTick;
+    int64_t mFirstDay;
+    int64_t mLastDay;
+    int32_t mTimeFrame;
+    uint32_t mIsLong;
+    uint32_t mDayBatches;
+    uint32_t mSimulationVersion;
+  };
+
+  ///
+  /// Binary cache of the backtest result base built by BacktestResultBaseGenerator::buildBacktestMatrix.
+  ///
+  /// Building the matrix runs one backtest per bar, while loading it back is a single read, so reruns and
+  /// searches repeating a (series, side, target, stop, date range) combination skip the simulation.
+  /// The file holds a header (format version, decimal precision, the key, number of entries),
+  /// the unbiased trade returns as int64 and the bars in position as uint32.
+  ///
+  template <class Decimal>
+  class BacktestMatrixCache
+  {
+    static_assert(std::is_same<Decimal, num::DefaultNumber>::value,
+                  "BacktestMatrixCache requires num::DefaultNumber");
+
+  public:
+    static constexpr uint32_t FormatVersion = 2;
+
+    ///
+    /// Version of the backtest rules the cached matrices were simulated with. Bump it whenever BackTester
+    /// changes how bars are stepped or how orders are filled, so matrices simulated under the old rules are
+    /// no longer found (2: bars walked with a cursor, intraday stepping through bar time stamps).
+    ///
+    static constexpr uint32_t SimulationVersion = 2;
+
+    /// FNV-1a over the bar time stamps and scaled OHLC values
+    static uint64_t hashSeries(const mkc_timeseries::OHLCTimeSeries<Decimal>& series)
+    {
+      uint64_t hash = mkc_timeseries::binary_cache::FnvOffsetBasis;
+      const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+      for (auto it = series.beginRandomAccess(); it != series.endRandomAccess(); ++it)
+        {
+          const int64_t values[5] = {(it->getDateTime() - epoch).total_microseconds(),
+                                     it->getOpenValue().getUnbiased(), it->getHighValue().getUnbiased(),
+                                     it->getLowValue().getUnbiased(), it->getCloseValue().getUnbiased()};
+          hash = mkc_timeseries::binary_cache::hashBytes(values, sizeof(values), hash);
+        }
+      return hash;
+    }
+
+    /// series is the one whose bars are iterated, tradedSeries the one of the security the positions are simulated on,
+    /// tick the one of that security (profit target and stop orders are rounded to it)
+    static BacktestMatrixKey makeKey(const mkc_timeseries::OHLCTimeSeries<Decimal>& series, const mkc_timeseries::OHLCTimeSeries<Decimal>& tradedSeries, bool isLong,
+                                     const Decimal& profitTarget, const Decimal& stopLoss, const Decimal& tick,
+                                     const boost::gregorian::date& firstDate, const boost::gregorian::date& lastDate,
+                                     unsigned int dayBatches)
+    {
+      BacktestMatrixKey key;
+      std::memset(&key, 0, sizeof(key));
+      key.mSeriesHash = hashSeries(series);
+      key.mTradedSeriesHash = (&tradedSeries == &series) ? key.mSeriesHash : hashSeries(tradedSeries);
+      key.mProfitTarget = profitTarget.getUnbiased();
+      key.mStopLoss = stopLoss.getUnbiased();
+      key.mTick = tick.getUnbiased();
+      key.mFirstDay = firstDate.day_number();
+      key.mLastDay = lastDate.day_number();
+      key.mTimeFrame = static_cast<int32_t>(series.getTimeFrame());
+      key.mIsLong = isLong ? 1 : 0;
+      key.mDayBatches = dayBatches;
+      key.mSimulationVersion = SimulationVersion;
+      return key;
+    }
+
+    static std::string getCacheFileName(const std::string& directory, const BacktestMatrixKey& key)
+    {
+      char name[64];
+      std::snprintf(name, sizeof(name), "backtestmatrix_%016llx.palbtm",
+                    static_cast<unsigned long long>(mkc_timeseries::binary_cache::hashBytes(&key, sizeof(key))));
+      return (boost::filesystem::path(directory) / name).string();
+    }
+
+    ///
+    /// \brief load - reads the cached matrix for key from directory
+    /// \return false (leaving the outputs untouched) when there is no matching cache
+    ///
+    static bool load(const std::string& directory, const BacktestMatrixKey& key,
+                     std::valarray<Decimal>& tradingVector, std::valarray<unsigned int>& numBarsInPosition)
+    {
+      const std::string cacheFileName = getCacheFileName(directory, key);
+      boost::system::error_code ec;
+      const uintmax_t fileSize = boost::filesystem::file_size(cacheFileName, ec);
+      if (ec || fileSize < sizeof(Header))
+        return false;
+
+      std::ifstream in(cacheFileName, std::ios::binary);
+      if (!in)
+        return false;
+
+      Header header;
+      if (!in.read(reinterpret_cast<char*>(&header), sizeof(Header)))
+        return false;
+      if (std::memcmp(header.mMagic, Magic, sizeof(header.mMagic)) != 0 || header.mVersion != FormatVersion
+          || header.mPrecFactor != Decimal::getPrecFactor() || std::memcmp(&header.mKey, &key, sizeof(key)) != 0)
+        return false;
+      if (fileSize != sizeof(Header) + header.mNumEntries * (sizeof(int64_t) + sizeof(uint32_t)))
+        return false;
+
+      std::vector<int64_t> returns(header.mNumEntries);
+      std::vector<uint32_t> bars(header.mNumEntries);
+      if (!in.read(reinterpret_cast<char*>(returns.data()), static_cast<std::streamsize>(returns.size() * sizeof(int64_t)))
+          || !in.read(reinterpret_cast<char*>(bars.data()), static_cast<std::streamsize>(bars.size() * sizeof(uint32_t))))
+        return false;
+
+      tradingVector.resize(header.mNumEntries);
+      numBarsInPosition.resize(header.mNumEntries);
+      for (size_t i = 0; i < header.mNumEntries; ++i)
+        {
+          tradingVector[i].setUnbiased(returns[i]);
+          numBarsInPosition[i] = bars[i];
+        }
+      return true;
+    }
+
+    ///
+    /// \brief store - caches the matrix, best effort (an unwritable directory just means no cache)
+    ///
+    /// Written to a unique temporary file and renamed into place, so concurrent searches never read a partial file.
+    ///
+    static bool store(const std::string& directory, const BacktestMatrixKey& key,
+                      const std::valarray<Decimal>& tradingVector, const std::valarray<unsigned int>& numBarsInPosition)
+    {
+      return mkc_timeseries::binary_cache::writeFileAtomically(getCacheFileName(directory, key), [&](std::ofstream& out)
+      {
+        Header header;
+        std::memset(&header, 0, sizeof(Header));
+        std::memcpy(header.mMagic, Magic, sizeof(header.mMagic));
+        header.mVersion = FormatVersion;
+        header.mPrecFactor = Decimal::getPrecFactor();
+        header.mKey = key;
+        header.mNumEntries = tradingVector.size();
+
+        std::vector<int64_t> returns(tradingVector.size());
+        std::vector<uint32_t> bars(std::begin(numBarsInPosition), std::end(numBarsInPosition));
+        for (size_t i = 0; i < tradingVector.size(); ++i)
+          returns[i] = tradingVector[i].getUnbiased();
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        out.write(reinterpret_cast<const char*>(returns.data()), static_cast<std::streamsize>(returns.size() * sizeof(int64_t)));
+        out.write(reinterpret_cast<const char*>(bars.data()), static_cast<std::streamsize>(bars.size() * sizeof(uint32_t)));
+      });
+    }
+
+  private:
+    static constexpr char Magic[8] = {'P', 'A', 'L', 'B', 'T', 'M', 'C', '\0'};
+
+    struct Header
+    {
+      char mMagic[8];
+      uint32_t mVersion;
+      uint32_t mReserved;
+      int64_t mPrecFactor;
+      BacktestMatrixKey mKey;
+      uint64_t mNumEntries;
+    };
+  };
+
+}
+
+#endif // USE_BLOOMBERG_DECIMALS
+
+#endif // BACKTESTMATRIXCACHE_H
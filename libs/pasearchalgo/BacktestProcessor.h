@@ -8,8 +8,14 @@
 #define BACKTESTPROCESSOR_H
 
 #include <unordered_map>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include "ParallelFor.h"
+#include "BoundedTopK.h"
 #include "Sorters.h"
 #include "SearchAlgoConfigurationFileReader.h"
+#include "OccurrenceBounds.h"
 
 namespace mkc_searchalgo
 {
@@ -34,45 +40,236 @@ namespace mkc_searchalgo
 
   using StrategyRepresentationType = std::vector<unsigned int>;
 
-  template <class Decimal, typename TSearchAlgoBacktester>
+  ///
+  /// TComparison selects the occurrence representation of the UniqueSinglePAMatrix
+  /// (std::valarray<Decimal> of 0/1 decimals, or OccurrenceBitset)
+  ///
+  template <class Decimal, typename TSearchAlgoBacktester, typename TComparison = std::valarray<Decimal>>
   class BacktestProcessor
   {
+    using ResultType = std::tuple<ResultStat<Decimal>, unsigned int, int>;
+    using TopResults = BoundedTopK<ResultType, StrategyRepresentationType>;
+    using ResultFilter = std::function<bool(const ResultStat<Decimal>&)>;
+
   public:
-    BacktestProcessor(const std::shared_ptr<SearchAlgoConfiguration<Decimal>>& searchConfiguration, std::shared_ptr<TSearchAlgoBacktester>& searchAlgoBacktester, const std::shared_ptr<UniqueSinglePAMatrix<Decimal, std::valarray<Decimal>>>& uniques):
+    BacktestProcessor(const std::shared_ptr<const SearchAlgoConfiguration<Decimal>>& searchConfiguration, std::shared_ptr<TSearchAlgoBacktester>& searchAlgoBacktester, const std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>>& uniques):
       mUniqueId(0),
       mMinTrades(searchConfiguration->getMinTrades()),
       mMaxInactivity(searchConfiguration->getMaxInactivitySpan()),
       mSearchAlgoBacktester(searchAlgoBacktester),
       mResults(),
       mStratMap(),
-      mUniques(uniques)
+      mUniques(uniques),
+      mOccurrences(),
+      mBounds(),
+      mNumPruned(0),
+      mTopResults(0, typename TopResults::Comparator()),
+      mRankedFilter(),
+      mRetainedFilter(),
+      mRetained()
     {}
 
+    ///
+    /// Enables branch-and-bound pruning: candidates whose bounds show that they (and every strategy
+    /// extending them) fail the minimum trades filter or have no winning trade are not backtested.
+    /// Such results could never be passed on or survive, so the search outcome does not change.
+    ///
+    void setPruningBounds(const std::shared_ptr<const OccurrenceBounds<Decimal, TComparison>>& bounds)
+    { mBounds = bounds; }
+
+    /// number of candidates skipped by the pruning bounds so far
+    unsigned long getNumPruned() const { return mNumPruned; }
+
+    ///
+    /// \brief setResultCapacity - keeps only the best capacity results of a level, as ranked by TSorter
+    ///
+    /// Results are streamed into a bounded heap instead of being collected and sorted as a whole,
+    /// so a level holds at most capacity results (plus those kept by the retained result filter),
+    /// and their strategies, whatever the number of candidates. A capacity of 0 keeps every result.
+    /// Ties of TSorter are broken on the unique id, as in sortResults().
+    ///
+    template <class TSorter>
+    void setResultCapacity(size_t capacity)
+    {
+      setResultCapacity(capacity, &TSorter::sort);
+    }
+
+    /// same as above for sorters that are function objects (e.g. Sorters::CombinationPPSorter)
+    template <class TOrder>
+    void setResultCapacity(size_t capacity, TOrder order)
+    {
+      mTopResults = TopResults(capacity, orderThenId(order));
+    }
+
+    size_t getResultCapacity() const { return mTopResults.capacity(); }
+
+    ///
+    /// Under a result capacity only results passing filter compete for it (the others are still kept when
+    /// retained), so that the capacity is spent on results the stepping policy can actually pass on.
+    ///
+    void setRankedResultFilter(const ResultFilter& filter)
+    { mRankedFilter = filter; }
+
+    ///
+    /// Results passing filter are kept even when they do not rank within the result capacity,
+    /// so that a survival policy sees every strategy meeting its criteria.
+    ///
+    void setRetainedResultFilter(const ResultFilter& filter)
+    { mRetainedFilter = filter; }
+
     void processResult(const StrategyRepresentationType & compareContainer)
     {
-      //init to ones
-      std::valarray<Decimal> occurences(DecimalConstants<Decimal>::DecimalOne, mUniques->getDateCount());
-      //the multiplication
-      for (unsigned int el: compareContainer)
-        occurences *= mUniques->getMappedElement(el);
-
-      mSearchAlgoBacktester->backtest(occurences);
-      const Decimal& pf = mSearchAlgoBacktester->getProfitFactor();
-      const Decimal& po = mSearchAlgoBacktester->getPayoffRatio();
-      const Decimal& pp = mSearchAlgoBacktester->getPALProfitability();
-      const Decimal& wp = mSearchAlgoBacktester->getPercentWinners();
-      unsigned int trades = mSearchAlgoBacktester->getTradeNumber();
-      unsigned int maxLosers = mSearchAlgoBacktester->getMaxConsecutiveLosers();
-      unsigned int maxInactivity = mSearchAlgoBacktester->getMaxInactivitySpan();
+      //combine the comparisons' occurrences (reusing the buffer of the previous call)
+      mUniques->combineElements(compareContainer, mOccurrences);
+      processResult(compareContainer, mOccurrences);
+    }
+
+    /// backtests a strategy whose combined occurrences the caller has already computed
+    void processResult(const StrategyRepresentationType & compareContainer, const TComparison& occurrences)
+    {
+      if (isPrunable(occurrences))
+        {
+          mNumPruned++;
+          return;
+        }
+      mSearchAlgoBacktester->backtest(occurrences);
 
       //pre-filtering, we don't need to keep these results in memory (only activity filters)
-      if (trades < mMinTrades || maxInactivity > mMaxInactivity)
+      if (!passesActivityFilters(*mSearchAlgoBacktester))
         return;
-      mResults.emplace_back(ResultStat<Decimal>(pf, po, pp, wp, trades, maxLosers), trades, mUniqueId);
-      mStratMap[mUniqueId] = compareContainer;
+      if (isBounded())
+        offerResult(mTopResults, mRetained,
+                    ResultType(makeResultStat(*mSearchAlgoBacktester), mSearchAlgoBacktester->getTradeNumber(), mUniqueId), compareContainer);
+      else
+        {
+          mResults.emplace_back(makeResultStat(*mSearchAlgoBacktester), mSearchAlgoBacktester->getTradeNumber(), mUniqueId);
+          mStratMap[mUniqueId] = compareContainer;
+        }
       mUniqueId++;
     }
 
+    ///
+    /// \brief collectResults - moves the results kept by a result capacity to getResults() and the strategy map
+    ///
+    /// processGroupsInParallel() collects by itself; serial processResult() calls need this once the level is done.
+    /// Does nothing without a result capacity.
+    ///
+    void collectResults()
+    {
+      if (!isBounded())
+        return;
+
+      std::vector<typename TopResults::Entry> kept = mTopResults.takeSorted();
+      kept.insert(kept.end(), std::make_move_iterator(mRetained.begin()), std::make_move_iterator(mRetained.end()));
+      mRetained.clear();
+      mRetained.shrink_to_fit();
+
+      mResults.reserve(mResults.size() + kept.size());
+      for (typename TopResults::Entry& entry: kept)
+        {
+          mStratMap[std::get<2>(entry.first)] = std::move(entry.second);
+          mResults.push_back(entry.first);
+        }
+    }
+
+    ///
+    /// Results of one slice of the candidates of a parallel round.
+    /// Every shard backtests on its own copy of the backtester and fills its own result list
+    /// (or its own bounded heap under a result capacity), so shards share no mutable state and need no locking.
+    ///
+    class ResultShard
+    {
+    public:
+      explicit ResultShard(const BacktestProcessor& processor):
+        mProcessor(processor),
+        mSearchAlgoBacktester(*processor.mSearchAlgoBacktester),
+        mOccurrences(),
+        mResults(),
+        mStrategies(),
+        mNumPruned(0),
+        mNumAccepted(0),
+        mTopResults(processor.mTopResults.capacity(), processor.mTopResults.getComparator()),
+        mRetained()
+      {}
+
+      /// scratch buffer for the caller to combine a candidate's occurrences into
+      TComparison& getOccurrences() { return mOccurrences; }
+
+      void processResult(const StrategyRepresentationType & compareContainer, const TComparison& occurrences)
+      {
+        if (mProcessor.isPrunable(occurrences))
+          {
+            mNumPruned++;
+            return;
+          }
+        mSearchAlgoBacktester.backtest(occurrences);
+
+        if (!mProcessor.passesActivityFilters(mSearchAlgoBacktester))
+          return;
+        //the unique id is assigned when the shard is merged, until then ids are local to the shard (same order)
+        const int localId = static_cast<int>(mNumAccepted++);
+        if (mProcessor.isBounded())
+          mProcessor.offerResult(mTopResults, mRetained,
+                                 ResultType(makeResultStat(mSearchAlgoBacktester), mSearchAlgoBacktester.getTradeNumber(), localId), compareContainer);
+        else
+          {
+            mResults.emplace_back(makeResultStat(mSearchAlgoBacktester), mSearchAlgoBacktester.getTradeNumber(), localId);
+            mStrategies.push_back(compareContainer);
+          }
+      }
+
+    private:
+      friend class BacktestProcessor;
+
+      const BacktestProcessor& mProcessor;
+      TSearchAlgoBacktester mSearchAlgoBacktester;
+      TComparison mOccurrences;
+      std::vector<std::tuple<ResultStat<Decimal>, unsigned int, int>> mResults;
+      std::vector<StrategyRepresentationType> mStrategies;
+      unsigned long mNumPruned;
+      unsigned long mNumAccepted;
+      TopResults mTopResults;
+      std::vector<typename TopResults::Entry> mRetained;
+    };
+
+    ///
+    /// \brief processGroupsInParallel - evaluates groups of candidates on the executor
+    ///
+    /// expandGroup(groupIndex, shard) must pass every candidate of the group to shard.processResult().
+    /// Consecutive groups are sliced into shards, which the executor runs concurrently, and the shards
+    /// are merged in group order, so results and unique ids are the same as those of a serial run
+    /// over the groups.
+    ///
+    template <class Executor, class ExpandGroup>
+    void processGroupsInParallel(unsigned int numGroups, Executor& executor, ExpandGroup expandGroup)
+    {
+      if (numGroups == 0)
+        return;
+
+      //several shards per thread, so that the executor can balance slices of uneven cost
+      const unsigned int hw = std::thread::hardware_concurrency();
+      const unsigned int numShards = std::min(numGroups, 8 * (hw ? hw : 2));
+
+      std::vector<ResultShard> shards;
+      shards.reserve(numShards);
+      for (unsigned int i = 0; i < numShards; ++i)
+        shards.emplace_back(*this);
+
+      concurrency::parallel_for(numShards, executor,
+                                [&shards, &expandGroup, numGroups, numShards](uint32_t shardIndex)
+                                {
+                                  ResultShard& shard = shards[shardIndex];
+                                  const unsigned int first = static_cast<unsigned int>((uint64_t(numGroups) * shardIndex) / numShards);
+                                  const unsigned int last = static_cast<unsigned int>((uint64_t(numGroups) * (shardIndex + 1)) / numShards);
+                                  for (unsigned int group = first; group < last; ++group)
+                                    expandGroup(group, shard);
+                                });
+
+      for (ResultShard& shard: shards)
+        mergeShard(shard);
+      collectResults();
+    }
+
 
     const std::vector<std::tuple<ResultStat<Decimal>, unsigned int, int>>& getResults() const
     { return mResults; }
@@ -82,35 +279,136 @@ namespace mkc_searchalgo
     { return mStratMap;}
 
 
+    /// ties of TSorter are broken on the unique id, so the order does not depend on the sort algorithm
     template <class TSorter>
     void sortResults()
     {
-      std::sort(mResults.begin(), mResults.end(), TSorter::sort);
+      std::sort(mResults.begin(), mResults.end(), orderThenId(&TSorter::sort));
     }
 
     template <class TSorter>
     void sortResults(Decimal ratio, Decimal multiplier)
     {
       std::cout << "sortResults called with: " << ratio << ", " << multiplier << std::endl;
-      std::sort(mResults.begin(), mResults.end(), TSorter(ratio, multiplier));
+      std::sort(mResults.begin(), mResults.end(), orderThenId(TSorter(ratio, multiplier)));
     }
 
     void clearAll()
     {
       mResults.clear();
       mResults.shrink_to_fit();
+      mTopResults.clear();
+      mRetained.clear();
+      mRetained.shrink_to_fit();
       //mStratMap.clear();
     }
 
   private:
 
+    bool isBounded() const { return mTopResults.capacity() > 0; }
+
+    /// order, with ties broken on ascending unique id
+    template <class TOrder>
+    static typename TopResults::Comparator orderThenId(TOrder order)
+    {
+      return [order](const ResultType& lhs, const ResultType& rhs) mutable
+      {
+        if (order(lhs, rhs))
+          return true;
+        if (order(rhs, lhs))
+          return false;
+        return std::get<2>(lhs) < std::get<2>(rhs);
+      };
+    }
+
+    /// streams a result into a bounded heap, results pushed out of it are kept aside when retained
+    void offerResult(TopResults& topResults, std::vector<typename TopResults::Entry>& retained,
+                     ResultType result, StrategyRepresentationType strategy) const
+    {
+      if (!isRanked(std::get<0>(result)))
+        {
+          if (isRetained(std::get<0>(result)))
+            retained.emplace_back(std::move(result), std::move(strategy));
+          return;
+        }
+      //results that cannot rank and are not retained are dropped without copying their strategy
+      if (!topResults.admits(result) && !isRetained(std::get<0>(result)))
+        return;
+
+      typename TopResults::Entry evicted;
+      if (topResults.offer(std::move(result), std::move(strategy), evicted) && isRetained(std::get<0>(evicted.first)))
+        retained.push_back(std::move(evicted));
+    }
+
+    bool isRanked(const ResultStat<Decimal>& stat) const
+    {
+      return !mRankedFilter || mRankedFilter(stat);
+    }
+
+    bool isRetained(const ResultStat<Decimal>& stat) const
+    {
+      return mRetainedFilter && mRetainedFilter(stat);
+    }
+
+    bool isPrunable(const TComparison& occurrences) const
+    {
+      if (!mBounds)
+        return false;
+      //trade count upper bound below the minimum, or profit factor bound of 0 (no possible winner)
+      return mBounds->maxTrades(occurrences) < mMinTrades || !mBounds->hasPossibleWinners(occurrences);
+    }
+
+    bool passesActivityFilters(const TSearchAlgoBacktester& backtester) const
+    {
+      return backtester.getTradeNumber() >= mMinTrades && backtester.getMaxInactivitySpan() <= mMaxInactivity;
+    }
+
+    static ResultStat<Decimal> makeResultStat(const TSearchAlgoBacktester& backtester)
+    {
+      return ResultStat<Decimal>(backtester.getProfitFactor(), backtester.getPayoffRatio(), backtester.getPALProfitability(),
+                                 backtester.getPercentWinners(), backtester.getTradeNumber(), backtester.getMaxConsecutiveLosers());
+    }
+
+    void mergeShard(ResultShard& shard)
+    {
+      mNumPruned += shard.mNumPruned;
+      for (size_t i = 0; i < shard.mResults.size(); ++i)
+        {
+          std::get<2>(shard.mResults[i]) = mUniqueId;
+          mResults.push_back(shard.mResults[i]);
+          mStratMap[mUniqueId] = std::move(shard.mStrategies[i]);
+          mUniqueId++;
+        }
+
+      //bounded: local ids become unique ids, results beyond the shard's heap were already beyond the level's
+      for (typename TopResults::Entry& entry: shard.mTopResults.takeSorted())
+        {
+          std::get<2>(entry.first) += mUniqueId;
+          offerResult(mTopResults, mRetained, std::move(entry.first), std::move(entry.second));
+        }
+      for (typename TopResults::Entry& entry: shard.mRetained)
+        {
+          std::get<2>(entry.first) += mUniqueId;
+          mRetained.push_back(std::move(entry));
+        }
+      if (isBounded())
+        mUniqueId += static_cast<int>(shard.mNumAccepted);
+    }
+
     int mUniqueId;
     unsigned int mMinTrades;
     unsigned int mMaxInactivity;
     std::shared_ptr<TSearchAlgoBacktester> mSearchAlgoBacktester;
     std::vector<std::tuple<ResultStat<Decimal>, unsigned int, int>> mResults;
     std::unordered_map<int, StrategyRepresentationType> mStratMap;
-    const std::shared_ptr<UniqueSinglePAMatrix<Decimal, std::valarray<Decimal>>>& mUniques;
+    const std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>>& mUniques;
+    TComparison mOccurrences;
+    std::shared_ptr<const OccurrenceBounds<Decimal, TComparison>> mBounds;
+    unsigned long mNumPruned;
+    TopResults mTopResults;
+    ResultFilter mRankedFilter;
+    ResultFilter mRetainedFilter;
+    std::vector<typename TopResults::Entry> mRetained;
 
   };
 
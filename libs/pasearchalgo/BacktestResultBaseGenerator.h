@@ -17,6 +17,10 @@
 #include "ComparisonToPalStrategy.h"
 #include <type_traits>
 #include <valarray>
+#include "TradeOutcomeTable.h"
+#include "BacktestMatrixCache.h"
+#include "ParallelExecutors.h"
+#include "ParallelFor.h"
 
 using namespace mkc_timeseries;
 using namespace mkc_searchalgo;
@@ -25,26 +29,39 @@ using std::shared_ptr;
 namespace mkc_searchalgo {
 
 
-  template <class Decimal, bool isLong> class BacktestResultBaseGenerator
+  ///
+  /// Builds the backtest result base of the search: the result and holding time of a position entered on every bar.
+  /// The per-bar backtests run in parallel on the executor passed in, and the result can be cached on disk (setCacheDirectory)
+  ///
+  template <class Decimal, bool isLong, typename Executor = concurrency::WorkStealingExecutor<>> class BacktestResultBaseGenerator
   {
   public:
 
     using SidedComparisonToPalType = std::conditional_t<isLong, ComparisonToPalLongStrategyAlwaysOn<Decimal>, ComparisonToPalShortStrategyAlwaysOn<Decimal>>;
 
-    BacktestResultBaseGenerator(const std::shared_ptr<McptConfiguration<Decimal>>& configuration,
-                                const std::shared_ptr<OHLCTimeSeries<Decimal>>& series,
+    BacktestResultBaseGenerator(const std::shared_ptr<const McptConfiguration<Decimal>>& configuration,
+                                const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series,
                                 const std::shared_ptr<Decimal>& profitTarget,
                                 const std::shared_ptr<Decimal>& stopLoss,
-                                bool inSampleOnly):
+                                bool inSampleOnly,
+                                Executor& executor):
       mConfiguration(configuration),
       mProfitTarget(profitTarget),
       mStopLoss(stopLoss),
       mDayBatches(10),
       mSideReady(false),
       mInSampleOnly(inSampleOnly),
-      mSeries(series)
+      mSeries(series),
+      mCacheDirectory(),
+      mExecutor(executor)
     {}
 
+    ///
+    /// Enables the binary cache of the built matrix in directory (empty disables it).
+    /// The cache is keyed by the series contents, side, target, stop, tick and date range.
+    ///
+    void setCacheDirectory(const std::string& directory) { mCacheDirectory = directory; }
+
 
     static std::shared_ptr<BackTester<Decimal>> getBackTester(TimeFrame::Duration theTimeFrame,
                                                        boost::gregorian::date startDate,
@@ -56,8 +73,10 @@ namespace mkc_searchalgo {
         return std::make_shared<WeeklyBackTester<Decimal>>(startDate, endDate);
       else if (theTimeFrame == TimeFrame::MONTHLY)
         return std::make_shared<MonthlyBackTester<Decimal>>(startDate, endDate);
+      else if (theTimeFrame == TimeFrame::INTRADAY)
+        return std::make_shared<IntradayBackTester<Decimal>>(startDate, endDate);
       else
-        throw PALMonteCarloValidationException("PALMonteCarloValidation::getBackTester - Only daily and monthly time frame supported at present.");
+        throw PALMonteCarloValidationException("PALMonteCarloValidation::getBackTester - Only daily, weekly, monthly and intraday time frames supported at present.");
     }
 
   private:
@@ -100,88 +119,100 @@ namespace mkc_searchalgo {
 
       ComparisonEntryType alwaysTrue {0, 1, 0, 2};  //aka on current bar: high greater than low = always true (as long as the bars are valid) -- no longer used, but still need to init somehow
 
-      std::vector<ComparisonEntryType> compareContainer { alwaysTrue };
-      //map to hold unique entries (keyed on signal dates)
-      std::map<TimeSeriesDate, std::tuple<Decimal, Decimal, unsigned int>> tradesMap;
+      const std::vector<ComparisonEntryType> compareContainer { alwaysTrue };
+
+#ifndef USE_BLOOMBERG_DECIMALS
+      BacktestMatrixKey cacheKey{};
+      if (!mCacheDirectory.empty())
+        {
+          const DateRange& isDates = mConfiguration->getInsampleDateRange();
+          cacheKey = BacktestMatrixCache<Decimal>::makeKey(*mSeries, *mConfiguration->getSecurity()->getTimeSeries(), isLong, *mProfitTarget, *mStopLoss,
+                                                           mConfiguration->getSecurity()->getTick(), isDates.getFirstDate(),
+                                                           mInSampleOnly ? isDates.getLastDate() : mConfiguration->getOosDateRange().getLastDate(),
+                                                           mDayBatches);
+          if (BacktestMatrixCache<Decimal>::load(mCacheDirectory, cacheKey, mTradingVector, mNumBarsInPosition))
+            {
+              std::cout << "Backtest matrix (long?:" << isLong << ") loaded from cache in: " << mCacheDirectory << std::endl;
+              storeTradeOutcomes();
+              return;
+            }
+        }
+#endif
 
       //get time series, iterate
       //std::shared_ptr<OHLCTimeSeries<Decimal>> series = mConfiguration->getSecurity()->getTimeSeries();
 
       std::cout << "Building backtest matrix (long?:" << isLong << ") with series size of: " << mSeries->getNumEntries() << std::endl;
-      typename OHLCTimeSeries<Decimal>::ConstRandomAccessIterator it = mSeries->beginRandomAccess();
 
-      unsigned long i = 0;
-      std::vector<boost::gregorian::date> validDates;
+      //collect the bars to backtest (serially, the order defines the matrix), each one is backtested independently
+      struct BarBacktest
+      {
+        unsigned long mBarNumber;
+        boost::gregorian::date mStartDate;
+        boost::gregorian::date mEndDate;
+      };
+      std::vector<BarBacktest> barBacktests;
 
-      for (; it != mSeries->endRandomAccess(); it++)
+      unsigned long i = 0;
+      for (auto it = mSeries->beginRandomAccess(); it != mSeries->endRandomAccess(); it++)
       {
-          auto orderDate = mSeries->getDateValue(it, 0);
           i++;
           if (i > 1)  //TimeSeries exception on first bar
             {
-              SidedComparisonToPalType comparison(compareContainer, 1, i, mProfitTarget.get(), mStopLoss.get(), aPortfolio);
               auto offset = std::min((mSeries->getNumEntries() - 1), (i + mDayBatches));
-              //std::cout << "offset: " << offset << ", size: " << series->getNumEntries() << ", i: " << i << std::endl;
               auto startDate = it->getDateValue();
               auto endDate = (mSeries->beginRandomAccess() + offset)->getDateValue();
 
-              std::shared_ptr<BackTester<Decimal>> interimBacktester;
               // it falls out of the in sample/ or in-and-out of sample range
               if (mInSampleOnly)
                 {
                   if (fitBetweenInSampleDates(startDate) != startDate)
                     continue;
-                  interimBacktester = getBackTester(mConfiguration->getSecurity()->getTimeSeries()->getTimeFrame(), startDate, fitBetweenInSampleDates(endDate));
+                  barBacktests.push_back({i, startDate, fitBetweenInSampleDates(endDate)});
                 }
               else
                 {
                   if (fitBetweenIsOosDates(startDate) != startDate)
                     continue;
-                  interimBacktester = getBackTester(mConfiguration->getSecurity()->getTimeSeries()->getTimeFrame(), startDate, fitBetweenIsOosDates(endDate));
-                }
-
-              interimBacktester->addStrategy(comparison.getPalStrategy());
-              interimBacktester->backtest();
-              std::shared_ptr<BacktesterStrategy<Decimal>> backTesterStrategy = (*(interimBacktester->beginStrategies()));
-              ClosedPositionHistory<Decimal> closedPositions = backTesterStrategy->getStrategyBroker().getClosedPositionHistory();
-              validDates.push_back(orderDate);
-              if (closedPositions.getNumPositions() > 0)
-                {
-                  std::pair<TimeSeriesDate,std::shared_ptr<TradingPosition<Decimal>>> firstPos = *(closedPositions.beginTradingPositions());
-
-                  tradesMap[orderDate] = std::make_tuple<Decimal, Decimal, unsigned int>(firstPos.second->getTradeReturn(), firstPos.second->getPercentReturn(), firstPos.second->getNumBarsInPosition());
-
-//                  std::cout << "(position for same day) first position on " << orderDate << ", Entry Date: " << firstPos.second->getEntryDate() << ": "
-//                            << firstPos.second->getTradeReturn() << " in percent: " << firstPos.second->getPercentReturn() << ", bars in pos: "
-//                            << firstPos.second->getNumBarsInPosition() << ", exit date: " << firstPos.second->getExitDate() << std::endl;
+                  barBacktests.push_back({i, startDate, fitBetweenIsOosDates(endDate)});
                 }
             }
       }
+
       //the crux: create (not so sparse) vector of trading result per signal-date.
-      std::valarray<Decimal> arr(Decimal(0.0), validDates.size());    //initialize to all 0-es
+      std::valarray<Decimal> arr(Decimal(0.0), barBacktests.size());    //initialize to all 0-es
       //then the number of bars that it should occupy
-      std::valarray<unsigned int> arrNumBars(static_cast<unsigned int>(0), validDates.size());
-
-      size_t  iCounter = 0; //offsetting first bar problem
-      for (auto it = mSeries->beginRandomAccess(); it != mSeries->endRandomAccess(); it++)
-        {
-          const auto& seriesDate = mSeries->getDateValue(it, 0);
-          if (std::find(validDates.begin(), validDates.end(), seriesDate) == validDates.end())
-            continue;
-          typename std::map<TimeSeriesDate, std::tuple<Decimal, Decimal, unsigned int>>::const_iterator mapIt = tradesMap.find(seriesDate);
-
-          if ( mapIt != tradesMap.end())
-            {
-              arr[iCounter] = std::get<1>(mapIt->second);
-              arrNumBars[iCounter] = std::get<2>(mapIt->second);
-            }
-          iCounter++;
-        }
+      std::valarray<unsigned int> arrNumBars(static_cast<unsigned int>(0), barBacktests.size());
+
+      const TimeFrame::Duration timeFrame = mConfiguration->getSecurity()->getTimeSeries()->getTimeFrame();
+      concurrency::parallel_for(static_cast<uint32_t>(barBacktests.size()), mExecutor,
+                                [this, &barBacktests, &compareContainer, &aPortfolio, &arr, &arrNumBars, timeFrame](uint32_t k)
+                                {
+                                  const BarBacktest& bar = barBacktests[k];
+                                  SidedComparisonToPalType comparison(compareContainer, 1, bar.mBarNumber, mProfitTarget.get(), mStopLoss.get(), aPortfolio);
+
+                                  std::shared_ptr<BackTester<Decimal>> interimBacktester = getBackTester(timeFrame, bar.mStartDate, bar.mEndDate);
+                                  interimBacktester->addStrategy(comparison.getPalStrategy());
+                                  interimBacktester->backtest();
+                                  std::shared_ptr<BacktesterStrategy<Decimal>> backTesterStrategy = (*(interimBacktester->beginStrategies()));
+                                  const ClosedPositionHistory<Decimal>& closedPositions = backTesterStrategy->getStrategyBroker().getClosedPositionHistory();
+                                  if (closedPositions.getNumPositions() > 0)
+                                    {
+                                      //first position, entered on the bar itself
+                                      std::shared_ptr<TradingPosition<Decimal>> firstPos = closedPositions.beginTradingPositions()->second;
+                                      arr[k] = firstPos->getPercentReturn();
+                                      arrNumBars[k] = firstPos->getNumBarsInPosition();
+                                    }
+                                });
 
       //store vectors
       mTradingVector = arr;
       mNumBarsInPosition = arrNumBars;
-      mSideReady = true;
+#ifndef USE_BLOOMBERG_DECIMALS
+      if (!mCacheDirectory.empty())
+        BacktestMatrixCache<Decimal>::store(mCacheDirectory, cacheKey, mTradingVector, mNumBarsInPosition);
+#endif
+      storeTradeOutcomes();
       if (isLong)
         std::cout << "Preprocessing backtest matrix built for side Long." << std::endl;
       else
@@ -204,17 +235,41 @@ namespace mkc_searchalgo {
           return mNumBarsInPosition;
     }
 
+#ifndef USE_BLOOMBERG_DECIMALS
+    /// the backtest results and bars in position in the integer form of the shortcut backtester kernel
+    const std::shared_ptr<const TradeOutcomeTable<Decimal>>& getTradeOutcomes()
+    {
+      if (!mSideReady)
+        buildBacktestMatrix();
+      return mTradeOutcomes;
+    }
+#endif
+
+  private:
+    void storeTradeOutcomes()
+    {
+#ifndef USE_BLOOMBERG_DECIMALS
+      mTradeOutcomes = std::make_shared<const TradeOutcomeTable<Decimal>>(mTradingVector, mNumBarsInPosition);
+#endif
+      mSideReady = true;
+    }
+
   private:
 
-    std::shared_ptr<McptConfiguration<Decimal>> mConfiguration;
+    std::shared_ptr<const McptConfiguration<Decimal>> mConfiguration;
     std::shared_ptr<Decimal> mProfitTarget;
     std::shared_ptr<Decimal> mStopLoss;
     unsigned int mDayBatches;
     bool mSideReady;
     std::valarray<Decimal> mTradingVector;
     std::valarray<unsigned int> mNumBarsInPosition;
+#ifndef USE_BLOOMBERG_DECIMALS
+    std::shared_ptr<const TradeOutcomeTable<Decimal>> mTradeOutcomes;
+#endif
     bool mInSampleOnly;
-    std::shared_ptr<OHLCTimeSeries<Decimal>> mSeries;
+    std::shared_ptr<const OHLCTimeSeries<Decimal>> mSeries;
+    std::string mCacheDirectory;
+    Executor& mExecutor;
 
   };
 
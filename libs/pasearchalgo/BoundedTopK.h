@@ -0,0 +1,105 @@
+// Copyright (C) MKC Associates, LLC
+// All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+
+#ifndef BOUNDEDTOPK_H
+#define BOUNDEDTOPK_H
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace mkc_searchalgo
+{
+
+  ///
+  /// Streaming collector of the best capacity() items seen, each with a payload.
+  ///
+  /// The items are kept in a heap with the worst kept item on top, so an offer is rejected with a single
+  /// comparison once the collector is full, and memory never exceeds capacity() entries.
+  /// better(lhs, rhs) must be a strict total order (true when lhs ranks before rhs).
+  ///
+  template <class T, class TPayload>
+  class BoundedTopK
+  {
+  public:
+    using Comparator = std::function<bool(const T&, const T&)>;
+    using Entry = std::pair<T, TPayload>;
+
+    BoundedTopK(size_t capacity, const Comparator& better):
+      mCapacity(capacity),
+      mBetter(better),
+      mHeap()
+    {}
+
+    size_t capacity() const { return mCapacity; }
+
+    const Comparator& getComparator() const { return mBetter; }
+
+    size_t size() const { return mHeap.size(); }
+
+    bool empty() const { return mHeap.empty(); }
+
+    /// true when item would be kept by offer()
+    bool admits(const T& item) const
+    {
+      return mHeap.size() < mCapacity || (mCapacity > 0 && mBetter(item, mHeap.front().first));
+    }
+
+    ///
+    /// \brief offer - keeps item when it ranks among the best capacity() items seen so far
+    /// \param evicted receives the entry pushed out to make room (or item itself when it is rejected)
+    /// \return true when an entry was written to evicted
+    ///
+    bool offer(T item, TPayload payload, Entry& evicted)
+    {
+      if (mHeap.size() < mCapacity)
+        {
+          mHeap.emplace_back(std::move(item), std::move(payload));
+          std::push_heap(mHeap.begin(), mHeap.end(), entryOrder());
+          return false;
+        }
+      if (!admits(item))
+        {
+          evicted = Entry(std::move(item), std::move(payload));
+          return true;
+        }
+      std::pop_heap(mHeap.begin(), mHeap.end(), entryOrder());
+      evicted = std::move(mHeap.back());
+      mHeap.back() = Entry(std::move(item), std::move(payload));
+      std::push_heap(mHeap.begin(), mHeap.end(), entryOrder());
+      return true;
+    }
+
+    /// moves the kept entries out, best first, and leaves the collector empty
+    std::vector<Entry> takeSorted()
+    {
+      std::sort_heap(mHeap.begin(), mHeap.end(), entryOrder());
+      std::vector<Entry> sorted;
+      sorted.swap(mHeap);
+      return sorted;
+    }
+
+    void clear()
+    {
+      mHeap.clear();
+      mHeap.shrink_to_fit();
+    }
+
+  private:
+    auto entryOrder() const
+    {
+      const Comparator& better = mBetter;
+      return [&better](const Entry& lhs, const Entry& rhs) { return better(lhs.first, rhs.first); };
+    }
+
+    size_t mCapacity;
+    Comparator mBetter;
+    std::vector<Entry> mHeap;
+  };
+
+}
+
+#endif // BOUNDEDTOPK_H
@@ -8,39 +8,17 @@
 #define COMPARISONSGENERATOR_H
 
 #include <boost/circular_buffer.hpp>
-#include <map>
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
-#include <set>
-#include <unordered_set>
 #include <iostream>
-#include "ComparableBar.h"
-#include <functional>
-
-///
-///Extend the (std) hash functionality to take std::array hashing
-///
-
-template <class T>
-inline void hash_combine(std::size_t& seed, const T& v)
-{
-    std::hash<T> hasher;
-    seed ^= hasher(v) + 0x9e3779b9 + (seed<<6) + (seed>>2);
-}
-
-template<typename T, std::size_t S>
-struct std::hash< std::array< T, S > >
-{
-  size_t operator() (const std::array< T, S > & arrayKey) const
-    {
-        std::size_t seed = 0;
-        for (size_t i = 0; i < arrayKey.size(); ++i)
-            hash_combine(seed, arrayKey[i]);
-
-        return seed;
-    }
-};
-
+#include "TimeSeries.h"
+#include "OccurrenceBitset.h"
 
 namespace mkc_searchalgo
 {
@@ -65,35 +43,72 @@ namespace mkc_searchalgo
   //a simplified type to represent bar to bar comparison
   using ComparisonEntryType = std::array<unsigned int, 4>;
 
+  ///
+  /// Generates the bar to bar comparisons of a series, and on which dates each of them holds.
+  ///
+  /// A comparison {offset1, field1, offset2, field2} (field: 0 open, 1 high, 2 low, 3 close) holds on a date
+  /// when field1 of the bar offset1 bars back is greater than field2 of the bar offset2 bars back.
+  /// Both offsets are below the look back, so the comparison space is small and every comparison gets a dense id
+  /// (in the same order as the comparisons themselves). Occurrences are kept as one bit per date and dense id.
+  ///
+  /// Bars are streamed in: every new bar is compared once with each bar of the look back window, and the outcome
+  /// is set directly on all the dates it stays in the window (with the offsets growing by one per date).
+  ///
   template <class Decimal> class ComparisonsGenerator
   {
   public:
+    static constexpr unsigned int NumFields = 4;
+
     explicit ComparisonsGenerator(unsigned int maxlookback, ComparisonType compType):
       mDateIndex(0),
       mMaxLookBack(maxlookback),
       mComparisonsCount(0),
       mBarBuffer(maxlookback),  //circular buffer instantiation
-      mComparisonsBatches{{mDateIndex, {}}},
-      mComparisonType(compType)
+      mComparisonType(compType),
+      mFieldPairs(),
+      mOccurrenceWords(static_cast<size_t>(maxlookback) * maxlookback * NumFields * NumFields),
+      mFirstDates(mOccurrenceWords.size(), std::numeric_limits<unsigned int>::max())
     {
+      std::vector<unsigned int> typesToSearch;
       if (mComparisonType == ComparisonType::CloseOnly)
-        mTypesToSearch = {{3}};
+        typesToSearch = {{3}};
       else if (mComparisonType == ComparisonType::OpenClose)
-          mTypesToSearch = {{0,3}};
+          typesToSearch = {{0,3}};
       else if (mComparisonType == ComparisonType::HighLow)
-          mTypesToSearch = {{1,2}};
+          typesToSearch = {{1,2}};
       else if (mComparisonType == ComparisonType::Ohlc)
-          mTypesToSearch = {{0,1,2,3}};
+          typesToSearch = {{0,1,2,3}};
       else
         throw std::logic_error("Comparison type not supported: " + std::to_string(mComparisonType) + ". Use CloseOnly(0), OpenClose(1), HighLow(2) or Ohlc(3)!");
 
+      for (unsigned int i: typesToSearch)
+        for (unsigned int c: typesToSearch)
+          mFieldPairs.emplace_back(i, c);
+
       std::cout << "Comparison Types to search: " << mComparisonType << std::endl;
 
     }
 
-    const std::unordered_map<unsigned int, std::unordered_set<ComparisonEntryType>>& getComparisons() const { return mComparisonsBatches; }
+    ///
+    /// The comparisons holding on at least one of the dates added so far, in ascending order.
+    /// A comparison that would only hold on the date after the last bar (a pair of bars that is
+    /// still in the window, shifted by one) is not unique yet: it has no occurrence to search.
+    ///
+    std::vector<ComparisonEntryType> getUniqueComparisons() const
+    {
+      std::vector<ComparisonEntryType> uniques;
+      for (size_t id = 0; id < mFirstDates.size(); ++id)
+        if (mFirstDates[id] < mDateIndex)
+          uniques.push_back(decode(id));
+      return uniques;
+    }
 
-    const std::set<ComparisonEntryType>& getUniqueComparisons() const { return mUniqueComparisons; }
+    /// the dates (one bit per date index) on which comparison holds
+    OccurrenceBitset getOccurrences(const ComparisonEntryType& comparison) const
+    {
+      const std::vector<uint64_t>& words = mOccurrenceWords.at(encode(comparison[0], comparison[1], comparison[2], comparison[3]));
+      return OccurrenceBitset(mDateIndex, words.data(), words.size());
+    }
 
     unsigned int getDateIndexCount() const { return mDateIndex; }
 
@@ -101,108 +116,98 @@ namespace mkc_searchalgo
 
     void addNewLastBar(const Decimal& open, const Decimal& high, const Decimal& low, const Decimal& close)
     {
-      //create new last bar (0 indexed)
-      ComparableBar<Decimal, 4> lastBar(open, high, low, close, 0);
-      //shift up all bar offsets in circular buffer
-      shiftBarsUp();
-      //add to circular buffer (because we will self-compare, too)
-      mBarBuffer.push_back(lastBar);
-//      std::cout << "bar buffer now has " << mBarBuffer.size() << " elements " << std::endl;
-//      for (int i = 0; i < mBarBuffer.size(); ++i)
-//        {
-//          std::cout << mBarBuffer[i] << std::endl;
-//        }
+      mBarBuffer.push_back(BarValues{{open, high, low, close}});
       runCompare();
       mDateIndex++;
-      newComparisonsBatch();
+    }
+
+    ///
+    /// Feed the bars [firstIndex, lastIndex) of a series, reading its OHLC
+    /// columns directly instead of going through per-bar iterator lookups
+    ///
+    void addBars(const mkc_timeseries::OHLCTimeSeries<Decimal>& series, size_t firstIndex, size_t lastIndex)
+    {
+      const auto& opens = series.getOpenColumn();
+      const auto& highs = series.getHighColumn();
+      const auto& lows = series.getLowColumn();
+      const auto& closes = series.getCloseColumn();
+
+      lastIndex = std::min(lastIndex, closes.size());
+      for (size_t i = firstIndex; i < lastIndex; ++i)
+        addNewLastBar(opens[i], highs[i], lows[i], closes[i]);
     }
 
   private:
+    using BarValues = std::array<Decimal, NumFields>;
 
-    template <class Comparable>
-    void compareWith(const Comparable& first, const Comparable& second)
+    size_t encode(unsigned int fOffset, unsigned int fOhlcId, unsigned int sOffset, unsigned int sOhlcId) const
     {
-      const auto& fOhlcArr = first.getOhlcArr();
-      const auto& sOhlcArr = second.getOhlcArr();
+      return ((static_cast<size_t>(fOffset) * NumFields + fOhlcId) * mMaxLookBack + sOffset) * NumFields + sOhlcId;
+    }
 
-      bool same = first.getOffset() == second.getOffset();
-      if (same && !(first == second))
-          throw;
+    ComparisonEntryType decode(size_t id) const
+    {
+      ComparisonEntryType entry;
+      entry[3] = static_cast<unsigned int>(id % NumFields);
+      id /= NumFields;
+      entry[2] = static_cast<unsigned int>(id % mMaxLookBack);
+      id /= mMaxLookBack;
+      entry[1] = static_cast<unsigned int>(id % NumFields);
+      entry[0] = static_cast<unsigned int>(id / NumFields);
+      return entry;
+    }
 
-      for (size_t i = 0; i < fOhlcArr.size(); ++i)
+    //compare the last bar with all older bars of the window (a bar is not compared with itself)
+    void runCompare()
+    {
+      const size_t lastIndex = mBarBuffer.size() - 1;
+      const BarValues& lastBar = mBarBuffer[lastIndex];
+      for (size_t j = 0; j < lastIndex; ++j)
         {
-          if (std::find(mTypesToSearch.begin(), mTypesToSearch.end(), i) == mTypesToSearch.end())
-            continue;
-          for (size_t c = 0; c < fOhlcArr.size(); ++c)
+          const BarValues& olderBar = mBarBuffer[j];
+          const unsigned int offset = static_cast<unsigned int>(lastIndex - j);
+          for (const std::pair<unsigned int, unsigned int>& fields: mFieldPairs)
             {
-              if (std::find(mTypesToSearch.begin(), mTypesToSearch.end(), c) == mTypesToSearch.end())
-                continue;
-              // self-checking case (high- and low- based comparison, or same-to-same does not make sense)
-              if (same && (c == 1 || i == 1 || c == 2 || i == 2 || c == i) )
-                continue;
-
-              if (fOhlcArr[i] > sOhlcArr[c])
-                {
-                  addComparison(first.getOffset(), i, second.getOffset(), c);
-                }
-              else if (fOhlcArr[i] < sOhlcArr[c])
-                {
-                  addComparison(second.getOffset(), c, first.getOffset(), i);
-                }
+              if (lastBar[fields.first] > olderBar[fields.second])
+                addComparison(0, fields.first, offset, fields.second);
+              else if (lastBar[fields.first] < olderBar[fields.second])
+                addComparison(offset, fields.second, 0, fields.first);
             }
         }
     }
 
+    ///
+    /// Marks the comparison on the current date and, with both offsets shifted, on the following dates
+    /// for as long as both bars stay within the look back window
+    ///
     void addComparison(unsigned int fOffset, unsigned int fOhlcId, unsigned int sOffset, unsigned int sOhlcId)
     {
-      ComparisonEntryType compEntry = {fOffset, fOhlcId, sOffset, sOhlcId};
-      mComparisonsBatches[mDateIndex].insert(compEntry);
       mComparisonsCount++;
-      mUniqueComparisons.insert(compEntry);
-    }
-    //compare last bar with all bars (including itself)
-    void runCompare()
-    {
-      const ComparableBar<Decimal, 4>& lastBar = mBarBuffer.back();
-      for (int i = mBarBuffer.size() -1; i --> 0;)
-          compareWith(lastBar, mBarBuffer[i]);
-
-    }
-
-    void shiftBarsUp()
-    {
-      for (size_t i = 0; i < mBarBuffer.size(); ++i)
-        mBarBuffer[i].incrementOffset();
-    }
-
-    void newComparisonsBatch()
-    {
-      std::unordered_set<ComparisonEntryType, std::hash<ComparisonEntryType>> newBatch{};
-      //increment offsets in old comparisons
-      for (const auto& entry: mComparisonsBatches[mDateIndex - 1])
+      const unsigned int maxOffset = std::max(fOffset, sOffset);
+      for (unsigned int shift = 0; maxOffset + shift < mMaxLookBack; ++shift)
         {
-          ComparisonEntryType newEntry = entry;
-          newEntry[0]++;
-          newEntry[2]++;
-
-          //erase/disregard comparisons outside of lookback window
-          if ( (newEntry)[0] <= mMaxLookBack - 1 && (newEntry)[2] <= mMaxLookBack -1 )
-            {
-              newBatch.insert(newEntry);
-              mUniqueComparisons.insert(newEntry);
-            }
+          const size_t id = encode(fOffset + shift, fOhlcId, sOffset + shift, sOhlcId);
+          const unsigned int date = mDateIndex + shift;
+          std::vector<uint64_t>& words = mOccurrenceWords[id];
+          const size_t wordIndex = date / OccurrenceBitset::BitsPerWord;
+          if (wordIndex >= words.size())
+            words.resize(wordIndex + 1, 0);
+          words[wordIndex] |= uint64_t(1) << (date % OccurrenceBitset::BitsPerWord);
+          mFirstDates[id] = std::min(mFirstDates[id], date);
         }
-      mComparisonsBatches[mDateIndex] = newBatch;
     }
 
     unsigned int mDateIndex;
     unsigned int mMaxLookBack;
     unsigned int mComparisonsCount;
-    boost::circular_buffer<ComparableBar<Decimal, 4>> mBarBuffer;
-    std::unordered_map<unsigned int, std::unordered_set<ComparisonEntryType, std::hash<ComparisonEntryType> >>  mComparisonsBatches;
-    std::set<ComparisonEntryType> mUniqueComparisons;
+    boost::circular_buffer<BarValues> mBarBuffer;
     ComparisonType mComparisonType;
-    std::vector<size_t> mTypesToSearch;
+    //(field of the new bar, field of the older bar) pairs to compare
+    std::vector<std::pair<unsigned int, unsigned int>> mFieldPairs;
+    //occurrence words per dense id, may already hold bits past the last date added
+    std::vector<std::vector<uint64_t>> mOccurrenceWords;
+    //first date each dense id holds on (max if never)
+    std::vector<unsigned int> mFirstDates;
   };
 }
 
@@ -18,6 +18,8 @@
 #include "ValarrayMutualizer.h"
 #include "SurvivalPolicy.h"
 #include "SurvivingStrategiesContainer.h"
+#include "OccurrenceCache.h"
+#include "ParallelExecutors.h"
 
 namespace mkc_searchalgo {
 
@@ -25,27 +27,33 @@ namespace mkc_searchalgo {
             typename TComparison = std::valarray<Decimal>,
             typename TSearchAlgoBacktester = ShortcutSearchAlgoBacktester<Decimal, ShortcutBacktestMethod::PlainVanilla>,
             //typename TSteppingPolicy = SimpleSteppingPolicy<Decimal, TSearchAlgoBacktester, Sorters::CombinationPPSorter<Decimal>>,
-            typename TSteppingPolicy = MutualInfoSteppingPolicy<Decimal, TSearchAlgoBacktester>,
-            typename TSurvivalPolicy = MutualInfoSurvivalPolicy<Decimal, TSearchAlgoBacktester>
+            typename TSteppingPolicy = MutualInfoSteppingPolicy<Decimal, TSearchAlgoBacktester, TComparison>,
+            typename TSurvivalPolicy = MutualInfoSurvivalPolicy<Decimal, TSearchAlgoBacktester, TComparison>,
+            typename Executor = concurrency::WorkStealingExecutor<>
             >
   class ForwardStepwiseSelector: private TSteppingPolicy, private TSurvivalPolicy
   {
   public:
-    ForwardStepwiseSelector(std::shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>>& backtestProcessor ,
+    ForwardStepwiseSelector(std::shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>>& backtestProcessor ,
                             std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>>& singlePA,
-                            const std::shared_ptr<SearchAlgoConfiguration<Decimal>>& searchConfiguration,
+                            const std::shared_ptr<const SearchAlgoConfiguration<Decimal>>& searchConfiguration,
                             Decimal targetStopRatio,
-                            std::shared_ptr<SurvivingStrategiesContainer<Decimal, std::valarray<Decimal>>>& survivingContainer):
-      TSteppingPolicy(backtestProcessor, singlePA, searchConfiguration->getPassingStratNumPerRound(), searchConfiguration->getProfitFactorCriterion(),
-                      searchConfiguration->getActivityMultiplier(), searchConfiguration->getStepRedundancyMultiplier()),
-      TSurvivalPolicy(backtestProcessor, singlePA, searchConfiguration->getProfitFactorCriterion(), targetStopRatio, searchConfiguration->getMaxConsecutiveLosers(),
+                            std::shared_ptr<SurvivingStrategiesContainer<Decimal, TComparison>>& survivingContainer,
+                            Executor& executor):
+      TSteppingPolicy(backtestProcessor, singlePA, executor, searchConfiguration->getPassingStratNumPerRound(), searchConfiguration->getProfitFactorCriterion(),
+                      searchConfiguration->getActivityMultiplier(), searchConfiguration->getStepRedundancyMultiplier(),
+                      searchConfiguration->getStepResultCapacity()),
+      TSurvivalPolicy(backtestProcessor, singlePA, executor, searchConfiguration->getProfitFactorCriterion(), targetStopRatio, searchConfiguration->getMaxConsecutiveLosers(),
                       searchConfiguration->getPalProfitabilitySafetyFactor(), searchConfiguration->getSurvivalFilterMultiplier(), searchConfiguration->getStepRedundancyMultiplier()),
       mBacktestProcessor(backtestProcessor),
       mSinglePa(singlePA),
       mMinTrades(searchConfiguration->getMinTrades()),
       mMaxDepth(searchConfiguration->getMaxDepth() - 1),
       mRuns(0),
-      mSurvivingContainer(survivingContainer)
+      mSurvivingContainer(survivingContainer),
+      //room for the parents of this depth and their prefixes from the previous one
+      mOccurrenceCache(2 * searchConfiguration->getPassingStratNumPerRound()),
+      mExecutor(executor)
     {
     }
     ~ForwardStepwiseSelector()
@@ -58,25 +66,27 @@ namespace mkc_searchalgo {
     }
 
   private:
-
+    using ShardType = typename BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>::ResultShard;
 
     std::vector<StrategyRepresentationType> step(unsigned int stepNo)
     {
       //bottom step
       if (stepNo == 0)
         {
-          for (unsigned int i = 0; i < mSinglePa->getMapSize(); ++i)
-            {
-              for (unsigned int c = 0; c < mSinglePa->getMapSize(); ++c)
-                {
-                  if (i == c)
-                    continue;
-                  std::vector<unsigned int> stratVect {i, c};
-                  mBacktestProcessor->processResult(stratVect);
-                }
-              if (i % 100 == 0)
-                std::cout << "Step 0 comparison, element group: " << i << std::endl;
-            }
+          //one group per first element, evaluated in parallel
+          const auto& singlePa = *mSinglePa;
+          mBacktestProcessor->processGroupsInParallel(singlePa.getMapSize(), mExecutor,
+                                                      [&singlePa](unsigned int i, ShardType& shard)
+                                                      {
+                                                        for (unsigned int c = 0; c < singlePa.getMapSize(); ++c)
+                                                          {
+                                                            if (i == c)
+                                                              continue;
+                                                            std::vector<unsigned int> stratVect {i, c};
+                                                            singlePa.extendElements(singlePa.getMappedElement(i), c, shard.getOccurrences());
+                                                            shard.processResult(stratVect, shard.getOccurrences());
+                                                          }
+                                                      });
           std::cout << "finished and returning from level 0, processed results: " << mBacktestProcessor->getResults().size() << std::endl;
           std::vector<StrategyRepresentationType> newret1 = TSteppingPolicy::passes(stepNo, mMaxDepth + 1);
           std::vector<StrategyRepresentationType> newret;
@@ -96,26 +106,31 @@ namespace mkc_searchalgo {
 
       std::vector<StrategyRepresentationType> ret(step(stepNo -1));
       //all other steps
-      int i = 0;
-      for (auto it = ret.begin(); it != ret.end(); it++)
-        {
-          i++;
-          StrategyRepresentationType & fetchedCompareContainer = *it;
-
-          for (unsigned int c = 0; c < mSinglePa->getMapSize(); ++c)
-          //for (unsigned int c = 0; c < 10; ++c)
-            {
-              if (findInVector(fetchedCompareContainer, c))
-                continue;
-
-              std::vector<unsigned int> stratVect(fetchedCompareContainer);
-              stratVect.push_back(c);
-
-              mBacktestProcessor->processResult(stratVect);
-            }
-          if (i % 100 == 0)
-            std::cout << "Step " << stepNo << " comparison, element group: " << i << std::endl;
-        }
+      //every child shares its parent's occurrences, compute them once (serially, the cache is not thread safe)
+      std::vector<TComparison> parentOccurrences;
+      parentOccurrences.reserve(ret.size());
+      for (const StrategyRepresentationType& parent: ret)
+        parentOccurrences.push_back(mOccurrenceCache.findOrDerive(parent, *mSinglePa));
+
+      //one group per parent, evaluated in parallel
+      const auto& singlePa = *mSinglePa;
+      mBacktestProcessor->processGroupsInParallel(static_cast<unsigned int>(ret.size()), mExecutor,
+                                                  [&singlePa, &ret, &parentOccurrences](unsigned int i, ShardType& shard)
+                                                  {
+                                                    const StrategyRepresentationType& fetchedCompareContainer = ret[i];
+                                                    for (unsigned int c = 0; c < singlePa.getMapSize(); ++c)
+                                                      {
+                                                        if (findInVector(fetchedCompareContainer, c))
+                                                          continue;
+
+                                                        std::vector<unsigned int> stratVect(fetchedCompareContainer);
+                                                        stratVect.push_back(c);
+
+                                                        singlePa.extendElements(parentOccurrences[i], c, shard.getOccurrences());
+                                                        shard.processResult(stratVect, shard.getOccurrences());
+                                                      }
+                                                  });
+      std::cout << "Step " << stepNo << " processed element groups: " << ret.size() << std::endl;
       std::vector<StrategyRepresentationType> newret1 = TSteppingPolicy::passes(stepNo, mMaxDepth + 1);
       std::vector<StrategyRepresentationType> newret;
       TSurvivalPolicy::filterSurvivors();
@@ -127,6 +142,9 @@ namespace mkc_searchalgo {
                               std::inserter(newret, newret.begin()));
       std::cout << "After step " << stepNo << ": Number of survivors: " << TSurvivalPolicy::getNumSurvivors()
                 << ", number of passes after excluding survivors: " << newret.size() << std::endl;
+      std::cout << "Candidates pruned by bounds so far: " << mBacktestProcessor->getNumPruned() << std::endl;
+      std::cout << "Parent occurrence cache hits: " << mOccurrenceCache.getHits()
+                << ", misses: " << mOccurrenceCache.getMisses() << std::endl;
       mBacktestProcessor->clearAll();
       TSurvivalPolicy::clearRound();
       return newret;
@@ -134,12 +152,16 @@ namespace mkc_searchalgo {
 
   private:
 
-    std::shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>> mBacktestProcessor;
+    std::shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>> mBacktestProcessor;
     std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>>& mSinglePa;
     unsigned mMinTrades;
     unsigned mMaxDepth;
     unsigned long mRuns;
-    std::shared_ptr<SurvivingStrategiesContainer<Decimal, std::valarray<Decimal>>> mSurvivingContainer;
+    std::shared_ptr<SurvivingStrategiesContainer<Decimal, TComparison>> mSurvivingContainer;
+    //occurrences of the strategies passed on between depths, keyed by strategy
+    OccurrenceCache<TComparison> mOccurrenceCache;
+    //candidates of a step are backtested concurrently on this executor, shared by every search of the run
+    Executor& mExecutor;
     //shared_ptr<TSearchAlgoBacktester> mSearchAlgoBacktester;
 
   };
@@ -0,0 +1,222 @@
+// Copyright (C) MKC Associates, LLC
+// All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+
+#ifndef OCCURRENCEBITSET_H
+#define OCCURRENCEBITSET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <stdexcept>
+#include <string>
+
+namespace mkc_searchalgo
+{
+
+  namespace bitops
+  {
+    inline unsigned int popcount(uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<unsigned int>(__builtin_popcountll(word));
+#else
+      unsigned int count = 0;
+      for (; word != 0; word &= word - 1)
+        count++;
+      return count;
+#endif
+    }
+
+    /// index of the lowest set bit, word must not be 0
+    inline unsigned int countrZero(uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<unsigned int>(__builtin_ctzll(word));
+#else
+      unsigned int index = 0;
+      for (; (word & 1) == 0; word >>= 1)
+        index++;
+      return index;
+#endif
+    }
+  }
+
+  ///
+  /// Packed 0/1 occurrence vector, one bit per date index.
+  ///
+  /// Drop-in replacement for the std::valarray<Decimal> of 0/1 decimals used by UniqueSinglePAMatrix:
+  /// 64 dates per word instead of one decimal per date. Combining comparisons is a word-wide AND,
+  /// counting trades is a popcount and visiting the entry bars jumps between set bits.
+  /// Bits past size() are always 0, so whole-word operations need no masking.
+  ///
+  class OccurrenceBitset
+  {
+  public:
+    static constexpr size_t BitsPerWord = 64;
+
+    OccurrenceBitset():
+      mSize(0),
+      mWords()
+    {}
+
+    explicit OccurrenceBitset(size_t size, bool value = false):
+      mSize(size),
+      mWords(numWordsFor(size), value ? ~uint64_t(0) : uint64_t(0))
+    {
+      clearTail();
+    }
+
+    /// Takes the first size bits of words (missing words are 0, bits past size are dropped)
+    OccurrenceBitset(size_t size, const uint64_t* words, size_t numWords):
+      mSize(size),
+      mWords(numWordsFor(size), uint64_t(0))
+    {
+      std::copy(words, words + std::min(numWords, mWords.size()), mWords.begin());
+      clearTail();
+    }
+
+    size_t size() const { return mSize; }
+
+    size_t numWords() const { return mWords.size(); }
+
+    const uint64_t* words() const { return mWords.data(); }
+
+    void set(size_t index)
+    {
+      mWords[index / BitsPerWord] |= (uint64_t(1) << (index % BitsPerWord));
+    }
+
+    void reset(size_t index)
+    {
+      mWords[index / BitsPerWord] &= ~(uint64_t(1) << (index % BitsPerWord));
+    }
+
+    bool test(size_t index) const
+    {
+      return (mWords[index / BitsPerWord] >> (index % BitsPerWord)) & 1;
+    }
+
+    /// Copies rhs without reallocating when the sizes already match
+    void assign(const OccurrenceBitset& rhs)
+    {
+      mSize = rhs.mSize;
+      mWords.assign(rhs.mWords.begin(), rhs.mWords.end());
+    }
+
+    /// Plain word loop over restrict pointers, which the compiler vectorizes
+    OccurrenceBitset& operator&=(const OccurrenceBitset& rhs)
+    {
+      if (rhs.mSize != mSize)
+        throw std::invalid_argument("OccurrenceBitset: size mismatch " + std::to_string(mSize) + " vs " + std::to_string(rhs.mSize));
+
+      uint64_t* __restrict dst = mWords.data();
+      const uint64_t* __restrict src = rhs.mWords.data();
+      const size_t n = mWords.size();
+      for (size_t i = 0; i < n; ++i)
+        dst[i] &= src[i];
+
+      return *this;
+    }
+
+    /// number of set bits
+    size_t count() const
+    {
+      size_t total = 0;
+      for (uint64_t word: mWords)
+        total += bitops::popcount(word);
+      return total;
+    }
+
+    /// number of positions where this and rhs differ
+    size_t countDifferences(const OccurrenceBitset& rhs) const
+    {
+      if (rhs.mSize != mSize)
+        throw std::invalid_argument("OccurrenceBitset: size mismatch " + std::to_string(mSize) + " vs " + std::to_string(rhs.mSize));
+
+      size_t total = 0;
+      for (size_t i = 0; i < mWords.size(); ++i)
+        total += bitops::popcount(mWords[i] ^ rhs.mWords[i]);
+      return total;
+    }
+
+    /// number of positions set in both this and rhs
+    size_t countIntersection(const OccurrenceBitset& rhs) const
+    {
+      if (rhs.mSize != mSize)
+        throw std::invalid_argument("OccurrenceBitset: size mismatch " + std::to_string(mSize) + " vs " + std::to_string(rhs.mSize));
+
+      size_t total = 0;
+      for (size_t i = 0; i < mWords.size(); ++i)
+        total += bitops::popcount(mWords[i] & rhs.mWords[i]);
+      return total;
+    }
+
+    ///
+    /// \brief findNext - first set bit at or after from
+    /// \return the bit index, or size() if there is none
+    ///
+    size_t findNext(size_t from) const
+    {
+      if (from >= mSize)
+        return mSize;
+
+      size_t wordIndex = from / BitsPerWord;
+      uint64_t word = mWords[wordIndex] & (~uint64_t(0) << (from % BitsPerWord));
+      while (word == 0)
+        {
+          if (++wordIndex == mWords.size())
+            return mSize;
+          word = mWords[wordIndex];
+        }
+      return wordIndex * BitsPerWord + bitops::countrZero(word);
+    }
+
+    /// calls fn(index) for every set bit, in increasing order
+    template <class Fn>
+    void forEachSetBit(Fn&& fn) const
+    {
+      for (size_t wordIndex = 0; wordIndex < mWords.size(); ++wordIndex)
+        {
+          uint64_t word = mWords[wordIndex];
+          while (word != 0)
+            {
+              fn(wordIndex * BitsPerWord + bitops::countrZero(word));
+              word &= word - 1;
+            }
+        }
+    }
+
+    bool operator==(const OccurrenceBitset& rhs) const
+    {
+      return mSize == rhs.mSize && mWords == rhs.mWords;
+    }
+
+    bool operator!=(const OccurrenceBitset& rhs) const
+    {
+      return !(*this == rhs);
+    }
+
+  private:
+    static size_t numWordsFor(size_t size)
+    {
+      return (size + BitsPerWord - 1) / BitsPerWord;
+    }
+
+    void clearTail()
+    {
+      const size_t usedBits = mSize % BitsPerWord;
+      if (usedBits != 0)
+        mWords.back() &= (uint64_t(1) << usedBits) - 1;
+    }
+
+  private:
+    size_t mSize;
+    std::vector<uint64_t> mWords;
+  };
+
+}
+
+#endif // OCCURRENCEBITSET_H
@@ -0,0 +1,92 @@
+// Copyright (C) MKC Associates, LLC
+// All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+
+#ifndef OCCURRENCEBOUNDS_H
+#define OCCURRENCEBOUNDS_H
+
+#include <valarray>
+#include "OccurrenceBitset.h"
+
+namespace mkc_searchalgo
+{
+
+  ///
+  /// Optimistic bounds on the backtest of an occurrence vector, computed without backtesting it.
+  ///
+  /// Trades are only taken on occurrences whose backtest result is non-zero, and winners on those
+  /// whose result is positive, so:
+  ///   - maxTrades() bounds the number of trades from above,
+  ///   - hasPossibleWinners() false means the profit factor is 0.
+  /// Adding a comparison only removes occurrences, so both bounds also hold for every descendant.
+  ///
+  /// Primary template: std::valarray<Decimal> occurrences of 0/1 decimals
+  ///
+  template <class Decimal, class TComparison = std::valarray<Decimal>>
+  class OccurrenceBounds
+  {
+  public:
+    explicit OccurrenceBounds(const std::valarray<Decimal>& backtestResults):
+      mBacktestResultBase(backtestResults)
+    {}
+
+    unsigned int maxTrades(const std::valarray<Decimal>& occurrences) const
+    {
+      unsigned int trades = 0;
+      for (size_t i = 0; i < occurrences.size(); ++i)
+        if (occurrences[i] != DecimalConstants<Decimal>::DecimalZero && mBacktestResultBase[i] != DecimalConstants<Decimal>::DecimalZero)
+          trades++;
+      return trades;
+    }
+
+    bool hasPossibleWinners(const std::valarray<Decimal>& occurrences) const
+    {
+      for (size_t i = 0; i < occurrences.size(); ++i)
+        if (occurrences[i] != DecimalConstants<Decimal>::DecimalZero && mBacktestResultBase[i] > DecimalConstants<Decimal>::DecimalZero)
+          return true;
+      return false;
+    }
+
+  private:
+    const std::valarray<Decimal>& mBacktestResultBase;
+  };
+
+  ///
+  /// Specialization for packed occurrences: the bounds are popcounts against precomputed masks
+  ///
+  template <class Decimal>
+  class OccurrenceBounds<Decimal, OccurrenceBitset>
+  {
+  public:
+    explicit OccurrenceBounds(const std::valarray<Decimal>& backtestResults):
+      mTradeMask(backtestResults.size()),
+      mWinnerMask(backtestResults.size())
+    {
+      for (size_t i = 0; i < backtestResults.size(); ++i)
+        {
+          if (backtestResults[i] != DecimalConstants<Decimal>::DecimalZero)
+            mTradeMask.set(i);
+          if (backtestResults[i] > DecimalConstants<Decimal>::DecimalZero)
+            mWinnerMask.set(i);
+        }
+    }
+
+    unsigned int maxTrades(const OccurrenceBitset& occurrences) const
+    {
+      return static_cast<unsigned int>(occurrences.countIntersection(mTradeMask));
+    }
+
+    bool hasPossibleWinners(const OccurrenceBitset& occurrences) const
+    {
+      return occurrences.countIntersection(mWinnerMask) != 0;
+    }
+
+  private:
+    OccurrenceBitset mTradeMask;
+    OccurrenceBitset mWinnerMask;
+  };
+
+}
+
+#endif // OCCURRENCEBOUNDS_H
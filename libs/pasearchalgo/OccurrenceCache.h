@@ -0,0 +1,142 @@
+// Copyright (C) MKC Associates, LLC
+// All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+
+#ifndef OCCURRENCECACHE_H
+#define OCCURRENCECACHE_H
+
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace mkc_searchalgo
+{
+
+  ///
+  /// Bounded least-recently-used cache of combined occurrence vectors, keyed by strategy
+  /// (the vector of comparison ids). Holds at most getCapacity() vectors; inserting into a full
+  /// cache evicts the one that was used longest ago.
+  ///
+  /// References returned by find(), insert() and findOrDerive() stay valid until that entry is evicted.
+  ///
+  template <class TComparison>
+  class OccurrenceCache
+  {
+  public:
+    using KeyType = std::vector<unsigned int>;
+
+    explicit OccurrenceCache(size_t capacity):
+      mCapacity(capacity),
+      mEntries(),
+      mIndex(),
+      mUncached(),
+      mDerived(),
+      mHits(0),
+      mMisses(0)
+    {}
+
+    /// \return the cached occurrences of strat, or nullptr
+    const TComparison* find(const KeyType& strat)
+    {
+      auto fnd = mIndex.find(strat);
+      if (fnd == mIndex.end())
+        {
+          mMisses++;
+          return nullptr;
+        }
+      mHits++;
+      //mark as most recently used
+      mEntries.splice(mEntries.begin(), mEntries, fnd->second);
+      return &fnd->second->second;
+    }
+
+    /// stores (or replaces) the occurrences of strat, evicting the least recently used entry if full
+    const TComparison& insert(const KeyType& strat, const TComparison& occurrences)
+    {
+      auto fnd = mIndex.find(strat);
+      if (fnd != mIndex.end())
+        {
+          fnd->second->second = occurrences;
+          mEntries.splice(mEntries.begin(), mEntries, fnd->second);
+          return fnd->second->second;
+        }
+
+      if (mCapacity == 0)
+        {
+          mUncached = occurrences;
+          return mUncached;
+        }
+
+      if (mEntries.size() >= mCapacity)
+        {
+          mIndex.erase(mEntries.back().first);
+          mEntries.pop_back();
+        }
+
+      mEntries.emplace_front(strat, occurrences);
+      mIndex.emplace(strat, mEntries.begin());
+      return mEntries.front().second;
+    }
+
+    ///
+    /// \brief findOrDerive - occurrences of strat, from the cache or derived from its prefix
+    ///
+    /// A strategy passed on between stepwise depths was built one depth earlier as (its prefix + one
+    /// comparison), so when the prefix is still cached (or is a single comparison) strat is derived by
+    /// extending it with that last comparison instead of recombining every element. Otherwise strat is
+    /// combined from scratch. The result is cached.
+    /// Both the lookup of strat and, on a miss, the lookup of a multi-comparison prefix count as a hit or miss.
+    ///
+    template <class TMatrix>
+    const TComparison& findOrDerive(const KeyType& strat, const TMatrix& singlePa)
+    {
+      const TComparison* cached = find(strat);
+      if (cached != nullptr)
+        return *cached;
+
+      const TComparison* prefixOccurrences = nullptr;
+      if (strat.size() == 2)
+        prefixOccurrences = &singlePa.getMappedElement(strat.front());
+      else if (strat.size() > 2)
+        prefixOccurrences = find(KeyType(strat.begin(), strat.end() - 1));
+
+      if (prefixOccurrences != nullptr)
+        singlePa.extendElements(*prefixOccurrences, strat.back(), mDerived);
+      else
+        singlePa.combineElements(strat, mDerived);
+
+      return insert(strat, mDerived);
+    }
+
+    void clear()
+    {
+      mEntries.clear();
+      mIndex.clear();
+    }
+
+    size_t size() const { return mEntries.size(); }
+
+    size_t getCapacity() const { return mCapacity; }
+
+    unsigned long getHits() const { return mHits; }
+
+    unsigned long getMisses() const { return mMisses; }
+
+  private:
+    using EntryList = std::list<std::pair<KeyType, TComparison>>;
+
+    size_t mCapacity;
+    EntryList mEntries;
+    std::map<KeyType, typename EntryList::iterator> mIndex;
+    TComparison mUncached;
+    //scratch for findOrDerive
+    TComparison mDerived;
+    unsigned long mHits;
+    unsigned long mMisses;
+  };
+
+}
+
+#endif // OCCURRENCECACHE_H
@@ -15,19 +15,22 @@ using namespace mkc_timeseries;
 
 namespace mkc_searchalgo {
 
-
-  template <class Decimal> class PalLongStrategyAlwaysOn : public PalStrategy<Decimal>
+  ///
+  /// PalLongStrategy entering on every bar it is flat on, whatever the pattern: used to backtest
+  /// a position entered on each bar (the backtest result base). Exits are those of PalLongStrategy.
+  ///
+  template <class Decimal> class PalLongStrategyAlwaysOn : public PalLongStrategy<Decimal>
     {
     public:
     PalLongStrategyAlwaysOn(const std::string& strategyName,
 			    std::shared_ptr<PriceActionLabPattern> pattern,
 			    std::shared_ptr<Portfolio<Decimal>> portfolio,
 			    const StrategyOptions& strategyOptions = defaultStrategyOptions)
-      : PalStrategy<Decimal>(strategyName, pattern, portfolio, strategyOptions)
+      : PalLongStrategy<Decimal>(strategyName, pattern, portfolio, strategyOptions)
         {}
 
       PalLongStrategyAlwaysOn(const PalLongStrategyAlwaysOn<Decimal>& rhs)
-        : PalStrategy<Decimal>(rhs)
+        : PalLongStrategy<Decimal>(rhs)
       {}
 
       const PalLongStrategyAlwaysOn<Decimal>&
@@ -36,7 +39,7 @@ namespace mkc_searchalgo {
         if (this == &rhs)
           return *this;
 
-        PalStrategy<Decimal>::operator=(rhs);
+        PalLongStrategy<Decimal>::operator=(rhs);
 
         return *this;
       }
@@ -45,96 +48,66 @@ namespace mkc_searchalgo {
       {}
 
       std::shared_ptr<BacktesterStrategy<Decimal>>
-      clone (std::shared_ptr<Portfolio<Decimal>> portfolio) const
+      clone (const std::shared_ptr<Portfolio<Decimal>>& portfolio) const
       {
-        return std::make_shared<PalLongStrategy<Decimal>>(this->getStrategyName(),
-                                                       this->getPalPattern(),
-                                                       portfolio);
+        return std::make_shared<PalLongStrategyAlwaysOn<Decimal>>(this->getStrategyName(),
+                                                                  this->getPalPattern(),
+                                                                  portfolio);
       }
 
       std::shared_ptr<PalStrategy<Decimal>>
       clone2 (std::shared_ptr<Portfolio<Decimal>> portfolio) const
       {
-        return std::make_shared<PalLongStrategy<Decimal>>(this->getStrategyName(),
-                                                       this->getPalPattern(),
-                                                       portfolio);
+        return std::make_shared<PalLongStrategyAlwaysOn<Decimal>>(this->getStrategyName(),
+                                                                  this->getPalPattern(),
+                                                                  portfolio);
       }
 
       std::shared_ptr<BacktesterStrategy<Decimal>>
       cloneForBackTesting () const
       {
-        return std::make_shared<PalLongStrategy<Decimal>>(this->getStrategyName(),
-                                                       this->getPalPattern(),
-                                                       this->getPortfolio());
+        return std::make_shared<PalLongStrategyAlwaysOn<Decimal>>(this->getStrategyName(),
+                                                                  this->getPalPattern(),
+                                                                  this->getPortfolio());
       }
 
-      void eventExitOrders (std::shared_ptr<Security<Decimal>> aSecurity,
-                            const InstrumentPosition<Decimal>& instrPos,
-                            const date& processingDate)
+      void eventEntryOrders (Security<Decimal>* aSecurity,
+                             const InstrumentPosition<Decimal>& instrPos,
+                             const date& processingDate)
       {
-        if (this->isLongPosition (aSecurity->getSymbol()))
-          {
-            std::shared_ptr<PriceActionLabPattern> pattern = this->getPalPattern();
-            Decimal target = pattern->getProfitTargetAsDecimal();
-            //std::cout << "PalLongStrategy::eventExitOrders, getProfitTargetAsDecimal(): " << pattern->getProfitTargetAsDecimal() << std::endl << std::endl;
-            PercentNumber<Decimal> targetAsPercent = PercentNumber<Decimal>::createPercentNumber (target);
-            //std::cout << "PalLongStrategy::eventExitOrders, createPercentNumber(): " << targetAsPercent.getAsPercent() << std::endl << std::endl;
-
-	    Decimal stop = pattern->getStopLossAsDecimal();
-	    PercentNumber<Decimal> stopAsPercent = PercentNumber<Decimal>::createPercentNumber (stop);
-
-	    Decimal fillPrice = instrPos.getFillPrice();
-
-	    //std::cout << "PalLongStrategy::eventExitOrders, fill Price =  " << fillPrice << std::endl;
-	    this->ExitLongAllUnitsAtLimit(aSecurity->getSymbol(), processingDate,
-					  fillPrice, targetAsPercent);
-	    this->ExitLongAllUnitsAtStop(aSecurity->getSymbol(), processingDate,
-					  fillPrice, stopAsPercent);
-	    instrPos.setRMultipleStop (LongStopLoss<Decimal> (fillPrice, stopAsPercent).getStopLoss());
-
-	    this->addLongPositionBar (aSecurity, processingDate);
-	  }
+        eventEntryOrders (aSecurity, instrPos, processingDate, aSecurity->getRandomAccessIteratorEnd());
       }
 
-      void eventEntryOrders (std::shared_ptr<Security<Decimal>> aSecurity,
+      void eventEntryOrders (Security<Decimal>* aSecurity,
                              const InstrumentPosition<Decimal>& instrPos,
-                             const date& processingDate)
+                             const date& processingDate,
+                             const typename Security<Decimal>::ConstRandomAccessIterator& bar)
       {
-        if (this->isFlatPosition (aSecurity->getSymbol()))
+        const std::string& sym = aSecurity->getSymbol();
+        if (this->isFlatPosition (sym) &&
+            this->getSecurityBarNumber(sym) > this->getPalPattern()->getMaxBarsBack())
           {
-            if (this->getSecurityBarNumber(aSecurity->getSymbol()) >
-                this->getPalPattern()->getMaxBarsBack())
-              {
-//                PatternExpression *expr = this->getPalPattern()->getPatternExpression().get();
-//                typename Security<Decimal>::ConstRandomAccessIterator it =
-//                  aSecurity->getRandomAccessIterator (processingDate);
-
-//The only difference
-		if (true)
-		  {
-		    this->EnterLongOnOpen (aSecurity->getSymbol(), processingDate);
-		    //std::cout << "PalLongStrategy entered LongOnOpen Order on " << processingDate << std::endl;
-		  }
-		this->addFlatPositionBar (aSecurity, processingDate);
-	      }
-	  }
+            //The only difference: the pattern is not evaluated
+            this->EnterLongOnOpen (sym, this->resolveOrderDateTime (*aSecurity, processingDate, bar));
+          }
       }
   };
 
-  //
-
-  template <class Decimal> class PalShortStrategyAlwaysOn : public PalStrategy<Decimal>
+  ///
+  /// PalShortStrategy entering on every bar it is flat on, whatever the pattern
+  ///
+  template <class Decimal> class PalShortStrategyAlwaysOn : public PalShortStrategy<Decimal>
     {
     public:
     PalShortStrategyAlwaysOn(const std::string& strategyName,
 			     std::shared_ptr<PriceActionLabPattern> pattern,
 			     std::shared_ptr<Portfolio<Decimal>> portfolio,
 			     const StrategyOptions& strategyOptions = defaultStrategyOptions)
-      : PalStrategy<Decimal>(strategyName, pattern, portfolio, strategyOptions)
+      : PalShortStrategy<Decimal>(strategyName, pattern, portfolio, strategyOptions)
         {}
 
       PalShortStrategyAlwaysOn(const PalShortStrategyAlwaysOn<Decimal>& rhs)
-        : PalStrategy<Decimal>(rhs)
+        : PalShortStrategy<Decimal>(rhs)
       {}
 
       const PalShortStrategyAlwaysOn<Decimal>&
@@ -143,7 +116,7 @@ namespace mkc_searchalgo {
         if (this == &rhs)
           return *this;
 
-        PalStrategy<Decimal>::operator=(rhs);
+        PalShortStrategy<Decimal>::operator=(rhs);
 
         return *this;
       }
@@ -152,80 +125,48 @@ namespace mkc_searchalgo {
       {}
 
       std::shared_ptr<BacktesterStrategy<Decimal>>
-      clone (std::shared_ptr<Portfolio<Decimal>> portfolio) const
+      clone (const std::shared_ptr<Portfolio<Decimal>>& portfolio) const
       {
-        return std::make_shared<PalShortStrategy<Decimal>>(this->getStrategyName(),
-                                                       this->getPalPattern(),
-                                                       portfolio);
+        return std::make_shared<PalShortStrategyAlwaysOn<Decimal>>(this->getStrategyName(),
+                                                                   this->getPalPattern(),
+                                                                   portfolio);
       }
 
       std::shared_ptr<PalStrategy<Decimal>>
       clone2 (std::shared_ptr<Portfolio<Decimal>> portfolio) const
       {
-        return std::make_shared<PalShortStrategy<Decimal>>(this->getStrategyName(),
-                                                       this->getPalPattern(),
-                                                       portfolio);
+        return std::make_shared<PalShortStrategyAlwaysOn<Decimal>>(this->getStrategyName(),
+                                                                   this->getPalPattern(),
+                                                                   portfolio);
       }
 
       std::shared_ptr<BacktesterStrategy<Decimal>>
       cloneForBackTesting () const
       {
-        return std::make_shared<PalShortStrategy<Decimal>>(this->getStrategyName(),
-                                                       this->getPalPattern(),
-                                                       this->getPortfolio());
+        return std::make_shared<PalShortStrategyAlwaysOn<Decimal>>(this->getStrategyName(),
+                                                                   this->getPalPattern(),
+                                                                   this->getPortfolio());
       }
-      void eventExitOrders (std::shared_ptr<Security<Decimal>> aSecurity,
-                            const InstrumentPosition<Decimal>& instrPos,
-                            const date& processingDate)
+
+      void eventEntryOrders (Security<Decimal>* aSecurity,
+                             const InstrumentPosition<Decimal>& instrPos,
+                             const date& processingDate)
       {
-        //std::cout << "PalShortStrategy::eventExitOrders - In eventExitOrders" << std::endl;
-        if (this->isShortPosition (aSecurity->getSymbol()))
-          {
-            //std::cout << "!!!! PalShortStrategy::eventExitOrders - isShortPosition true" << std::endl << std::endl;
-            std::shared_ptr<PriceActionLabPattern> pattern = this->getPalPattern();
-            Decimal target = pattern->getProfitTargetAsDecimal();
-
-	    //std::cout << "PalShortStrategy::eventExitOrders, getProfitTargetAsDecimal(): " << pattern->getProfitTargetAsDecimal() << std::endl << std::endl;
-	    PercentNumber<Decimal> targetAsPercent = PercentNumber<Decimal>::createPercentNumber (target);
-	    //std::cout << "PalShortStrategy::eventExitOrders, createPercentNumber(): " << targetAsPercent.getAsPercent() << std::endl << std::endl;
-
-	    Decimal stop = pattern->getStopLossAsDecimal();
-	    //std::cout << "PalShortStrategy::eventExitOrders, getStopLossAsDecimal(): " << pattern->getStopLossAsDecimal() << std::endl << std::endl;
-	    PercentNumber<Decimal> stopAsPercent = PercentNumber<Decimal>::createPercentNumber (stop);
-
-	    Decimal fillPrice = instrPos.getFillPrice();
-	    //std::cout << "PalShortStrategy::eventExitOrders, fill Price =  " << fillPrice << std::endl;
-
-	    this->ExitShortAllUnitsAtLimit(aSecurity->getSymbol(), processingDate,
-					  fillPrice, targetAsPercent);
-	    this->ExitShortAllUnitsAtStop(aSecurity->getSymbol(), processingDate,
-					  fillPrice, stopAsPercent);
-	    instrPos.setRMultipleStop (ShortStopLoss<Decimal> (fillPrice, stopAsPercent).getStopLoss());
-	    this->addShortPositionBar (aSecurity, processingDate);
-	  }
+        eventEntryOrders (aSecurity, instrPos, processingDate, aSecurity->getRandomAccessIteratorEnd());
       }
 
-      void eventEntryOrders (std::shared_ptr<Security<Decimal>> aSecurity,
+      void eventEntryOrders (Security<Decimal>* aSecurity,
                              const InstrumentPosition<Decimal>& instrPos,
-                             const date& processingDate)
+                             const date& processingDate,
+                             const typename Security<Decimal>::ConstRandomAccessIterator& bar)
       {
-        if (this->isFlatPosition (aSecurity->getSymbol()))
+        const std::string& sym = aSecurity->getSymbol();
+        if (this->isFlatPosition (sym) &&
+            this->getSecurityBarNumber(sym) > this->getPalPattern()->getMaxBarsBack())
           {
-            if (this->getSecurityBarNumber(aSecurity->getSymbol()) >
-                this->getPalPattern()->getMaxBarsBack())
-              {
-//                PatternExpression *expr = this->getPalPattern()->getPatternExpression().get();
-//                typename Security<Decimal>::ConstRandomAccessIterator it =
-//                  aSecurity->getRandomAccessIterator (processingDate);
-
-		if (true)
-		  {
-		    //std::cout << "PalShortStrategy entered ShortOnOpen Order on " << processingDate << std::endl;
-		    this->EnterShortOnOpen (aSecurity->getSymbol(), processingDate);
-		  }
-		this->addFlatPositionBar (aSecurity, processingDate);
-	      }
-	  }
+            //The only difference: the pattern is not evaluated
+            this->EnterShortOnOpen (sym, this->resolveOrderDateTime (*aSecurity, processingDate, bar));
+          }
       }
   };
 }
@@ -59,19 +59,26 @@ namespace mkc_searchalgo
     const std::shared_ptr<Security<Decimal>> security = mcptConfiguration->getSecurity();
     std::cout << "Time frame id started: " << timeFrameIdToLoad << std::endl;
     //io::CSVReader<8, io::trim_chars<' '>, io::double_quote_escape<',','\"'>> mCsvFile;
-    io::CSVReader<12, io::trim_chars<' '>, io::double_quote_escape<',','\"'>> csvConfigFile(mRunParameters->getSearchConfigFilePath().c_str());
+    io::CSVReader<13, io::trim_chars<' '>, io::double_quote_escape<',','\"'>> csvConfigFile(mRunParameters->getSearchConfigFilePath().c_str());
 
-    csvConfigFile.read_header(io::ignore_extra_column, "MaxDepth", "MinTrades", "ActivityMultiplier","PassingStratNumPerRound","ProfitFactorCriterion", "MaxConsecutiveLosers",
+    //StepResultCapacity is optional (older config files do not have it), every other column is required
+    csvConfigFile.read_header(io::ignore_extra_column | io::ignore_missing_column, "MaxDepth", "MinTrades", "ActivityMultiplier","PassingStratNumPerRound","ProfitFactorCriterion", "MaxConsecutiveLosers",
                              "MaxInactivitySpan", "TargetsToSearchConfigFilePath", "ValidationConfigFilePath", "PALSafetyFactor",
-                              "StepRedundancyMultiplier", "SurvivalFilterMultiplier");
+                              "StepRedundancyMultiplier", "SurvivalFilterMultiplier", "StepResultCapacity");
+    for (const char* column: {"MaxDepth", "MinTrades", "ActivityMultiplier","PassingStratNumPerRound","ProfitFactorCriterion", "MaxConsecutiveLosers",
+                              "MaxInactivitySpan", "TargetsToSearchConfigFilePath", "ValidationConfigFilePath", "PALSafetyFactor",
+                              "StepRedundancyMultiplier", "SurvivalFilterMultiplier"})
+      if (!csvConfigFile.has_column(column))
+        throw SearchAlgoConfigurationFileReaderException("Search config file: " + mRunParameters->getSearchConfigFilePath() + " has no " + column + " column");
 
     std::string maxDepth, minTrades, activityMultiplier, passingStratNumPerRound, profitFactorCritierion, maxConsecutiveLosers;
     std::string maxInactivitySpan, targetsToSearchConfigFilePath;
     std::string validationConfigFilePath, palSafetyFactor, stepRedundancyMultiplier, survivalFilterMultiplier;
+    std::string stepResultCapacity("0");
 
     csvConfigFile.read_row (maxDepth, minTrades, activityMultiplier, passingStratNumPerRound, profitFactorCritierion, maxConsecutiveLosers,
                             maxInactivitySpan, targetsToSearchConfigFilePath,
-                            validationConfigFilePath, palSafetyFactor, stepRedundancyMultiplier, survivalFilterMultiplier);
+                            validationConfigFilePath, palSafetyFactor, stepRedundancyMultiplier, survivalFilterMultiplier, stepResultCapacity);
 
     double palSafetyDbl = tryCast<double>(palSafetyFactor);
     if (palSafetyDbl > 0.9 || palSafetyDbl < 0.7)
@@ -124,9 +131,9 @@ namespace mkc_searchalgo
       // read the data file, infer the time frames, and create all of the synthetic files - once
       if(downloadFile)
       {
-        std::shared_ptr<TimeSeriesCsvReader<Decimal>> reader = std::make_shared<TradeStationFormatCsvReader<Decimal>>(
+        std::shared_ptr<TimeSeriesCsvReader<Decimal>> reader = withBinaryCache<Decimal>(std::make_shared<TradeStationFormatCsvReader<Decimal>>(
           hourlyDataFilePath, TimeFrame::INTRADAY, getVolumeUnit(security), security->getTick()
-        );
+        ));
         reader->readFile();
 
         std::shared_ptr<TimeFrameDiscovery<Decimal>> timeFrameDiscovery = std::make_shared<TimeFrameDiscovery<Decimal>>(reader->getTimeSeries());
@@ -153,9 +160,9 @@ namespace mkc_searchalgo
     else
     {
       std::string timeFrameFilename = hourlyDataFilePath + "_timeframe_" + std::to_string(timeFrameIdToLoad);
-      std::shared_ptr<TimeSeriesCsvReader<Decimal>> reader = std::make_shared<PALFormatCsvReader<Decimal>>(
+      std::shared_ptr<TimeSeriesCsvReader<Decimal>> reader = withBinaryCache<Decimal>(std::make_shared<PALFormatCsvReader<Decimal>>(
           timeFrameFilename, TimeFrame::DAILY, getVolumeUnit(security), security->getTick()
-      );
+      ));
       reader->readFile();
       series = reader->getTimeSeries();
 
@@ -195,7 +202,8 @@ namespace mkc_searchalgo
                                                               tryCast<unsigned int>(numStratsBeforeValidation),
                                                               Decimal(palSafetyDbl),
                                                               Decimal(tryCast<double>(stepRedundancyMultiplier)),
-                                                              Decimal(tryCast<double>(survivalFilterMultiplier))
+                                                              Decimal(tryCast<double>(survivalFilterMultiplier)),
+                                                              tryCast<unsigned int>(stepResultCapacity)
                                                               );
 
   }
@@ -19,6 +19,7 @@
 #include "TimeFrameUtility.h"
 #include "TimeSeriesEntry.h"
 #include "TimeSeriesCsvReader.h"
+#include "TimeSeriesBinaryCache.h"
 #include <cstdio>
 #include "number.h"
 #include "boost/lexical_cast.hpp"
@@ -67,7 +68,8 @@ namespace mkc_searchalgo
         unsigned int numPermutations, unsigned int minNumStratsFullPeriod, unsigned int minNumStratsBeforeValidation,
                              Decimal palSafetyFactor,
                              Decimal stepRedundancyMultiplier,
-                             Decimal survivalFilterMultiplier)
+                             Decimal survivalFilterMultiplier,
+                             unsigned int stepResultCapacity = 0)
       :
       mMaxDepth(maxDepth),
       mMinTrades(minTrades),
@@ -84,7 +86,8 @@ namespace mkc_searchalgo
       mMinNumStratsBeforeValidation(minNumStratsBeforeValidation),
       mPalSafetyFactor(palSafetyFactor),
       mStepRedundancyMultiplier(stepRedundancyMultiplier),
-      mSurvivalFilterMultiplier(survivalFilterMultiplier)
+      mSurvivalFilterMultiplier(survivalFilterMultiplier),
+      mStepResultCapacity(stepResultCapacity)
     {}
 
     SearchAlgoConfiguration (const SearchAlgoConfiguration& rhs)
@@ -103,7 +106,8 @@ namespace mkc_searchalgo
         mMinNumStratsBeforeValidation(rhs.mMinNumStratsBeforeValidation),
         mPalSafetyFactor(rhs.mSafetyFactor),
         mStepRedundancyMultiplier(rhs.mStepRedundancyMultiplier),
-        mSurvivalFilterMultiplier(rhs.mSurvivalFilterMultiplier)
+        mSurvivalFilterMultiplier(rhs.mSurvivalFilterMultiplier),
+        mStepResultCapacity(rhs.mStepResultCapacity)
     {}
 
     SearchAlgoConfiguration<Decimal>&
@@ -127,6 +131,7 @@ namespace mkc_searchalgo
 	mPalSafetyFactor = rhs.mPalSafetyFactor;
 	mStepRedundancyMultiplier = rhs.mStepRedundancyMultiplier;
 	mSurvivalFilterMultiplier = rhs.mSurvivalFilterMultiplier;
+	mStepResultCapacity = rhs.mStepResultCapacity;
 
       return *this;
     }
@@ -141,6 +146,7 @@ namespace mkc_searchalgo
                    << ", MaxConsecutiveLosers: " << obj.mMaxConsecutiveLosers << ", MaxInactivitySpan: " << obj.mMaxInactivitySpan
                    << ", Targets&Stops#: "<< obj.mTargetStopPairs.size() << ", TimeFrames#: " << obj.mTimeFrames.size()
                    << ", SafetyFactor: " << obj.mPalSafetyFactor << ", StepMultiplier: " << obj.mStepRedundancyMultiplier << ", survivalFilt: " << obj.mSurvivalFilterMultiplier
+                   << ", StepResultCapacity: " << obj.getStepResultCapacity()
                    << "\nValidation settings -- # of permutations: " << obj.mNumPermutations
                    << ", Min # of strats full period: "<< obj.mMinNumStratsFullPeriod
                    << ", Min # of strats before validation: " << obj.mMinNumStratsBeforeValidation;
@@ -186,6 +192,13 @@ namespace mkc_searchalgo
 
     const Decimal& getSurvivalFilterMultiplier() const {return mSurvivalFilterMultiplier; }
 
+    ///
+    /// number of results of a search step ranked for the stepping policy (the best ones by PAL profitability),
+    /// 0 (the default) keeps every result. The max relevance min redundancy selection skips redundant results,
+    /// so a capacity should be several times the number of strategies passed per round
+    ///
+    unsigned int getStepResultCapacity() const { return mStepResultCapacity; }
+
   private:
     unsigned int mMaxDepth;
     unsigned int mMinTrades;
@@ -203,6 +216,7 @@ namespace mkc_searchalgo
     Decimal mPalSafetyFactor;
     Decimal mStepRedundancyMultiplier;
     Decimal mSurvivalFilterMultiplier;
+    unsigned int mStepResultCapacity;
   };
 
   class SearchAlgoConfigurationFileReader
@@ -25,12 +25,26 @@ namespace mkc_searchalgo
   template <class Decimal>
   class   SearchController
   {
+    //occurrence representation of the comparisons matrix (one bit per date)
+    using TComparison = OccurrenceBitset;
+
   public:
-    SearchController(const std::shared_ptr<McptConfiguration<Decimal>>& configuration, const std::shared_ptr<OHLCTimeSeries<Decimal>>& series, const std::shared_ptr<SearchAlgoConfiguration<Decimal>>& searchConfiguration):
+    using Executor = concurrency::WorkStealingExecutor<>;
+
+    ///
+    /// executor: runs the parallel parts of the search, shared by the controllers running at the same time
+    /// so that they do not each start a thread per core.
+    /// backtestCacheDirectory: where backtest matrices are cached for reruns with the same target/stop,
+    /// empty (the default) builds them every time without caching
+    ///
+    SearchController(const std::shared_ptr<const McptConfiguration<Decimal>>& configuration, const std::shared_ptr<const OHLCTimeSeries<Decimal>>& series, const std::shared_ptr<const SearchAlgoConfiguration<Decimal>>& searchConfiguration,
+                     Executor& executor, const std::string& backtestCacheDirectory = std::string()):
       mSearchConfiguration(searchConfiguration),
       mConfiguration(configuration),
       mSeries(series),
-      mPatternIndex(0)
+      mPatternIndex(0),
+      mExecutor(executor),
+      mBacktestCacheDirectory(backtestCacheDirectory)
     {}
     void prepare(ComparisonType patternSearchType, bool inSampleOnly)
     {
@@ -38,8 +52,6 @@ namespace mkc_searchalgo
       mPortfolio = std::make_shared<Portfolio<Decimal>>(portfolioName);
       mPortfolio->addSecurity(mConfiguration->getSecurity());
 
-      typename OHLCTimeSeries<Decimal>::ConstRandomAccessIterator it = mSeries->beginRandomAccess();
-
       mComparisonGenerator = std::make_shared<ComparisonsGenerator<Decimal>>(mSearchConfiguration->getMaxDepth(), patternSearchType);
 
       std::cout << "Preparing controller with timeseries of size: " << mSeries->getNumEntries() << std::endl;
@@ -51,32 +63,25 @@ namespace mkc_searchalgo
       if (!inSampleOnly)
         endDate = oosDates.getLastDate();
 
-      for (; it != mSeries->endRandomAccess(); it++)
-      {       
-          //Skip if not the sought dates.
-          const auto& seriesDate = mSeries->getDateValue(it, 0);
-          if (seriesDate < startDate || seriesDate > endDate)
-            continue;
-
-          const Decimal& cOpen = mSeries->getOpenValue (it, 0);
-          const Decimal& cHigh = mSeries->getHighValue (it, 0);
-          const Decimal& cLow = mSeries->getLowValue (it, 0);
-          const Decimal& cClose = mSeries->getCloseValue (it, 0);
-
-          //auto dt = mSeries->getDateValue(it, 0);
-          //std::cout << dt << " OHLC: " << cOpen << "," << cHigh << "," << cLow << "," << cClose << std::endl;
+      //The date column is sorted, so the sought dates form one contiguous index range.
+      const auto& dates = mSeries->getDateTimeColumn();
+      auto firstIt = std::lower_bound(dates.begin(), dates.end(), startDate,
+                                      [](const boost::posix_time::ptime& dt, const boost::gregorian::date& d) { return dt.date() < d; });
+      auto lastIt = std::upper_bound(firstIt, dates.end(), endDate,
+                                     [](const boost::gregorian::date& d, const boost::posix_time::ptime& dt) { return d < dt.date(); });
 
-          mComparisonGenerator->addNewLastBar(cOpen, cHigh, cLow, cClose);
+      mComparisonGenerator->addBars(*mSeries,
+                                    static_cast<size_t>(std::distance(dates.begin(), firstIt)),
+                                    static_cast<size_t>(std::distance(dates.begin(), lastIt)));
 
-      }
       std::cout << " Comparisons have been generated. " << std::endl;
       std::cout << " Full comparisons universe #: " << mComparisonGenerator->getComparisonsCount() << std::endl;
       std::cout << " Unique comparisons #: " << mComparisonGenerator->getUniqueComparisons().size() << std::endl;
       std::cout << " Dates used #: " << mComparisonGenerator->getDateIndexCount() << std::endl;
 
-      mPaMatrix = std::make_shared<UniqueSinglePAMatrix<Decimal, std::valarray<Decimal>>>(mComparisonGenerator, mComparisonGenerator->getDateIndexCount());
-      mLongSurvivors = std::make_shared<SurvivingStrategiesContainer<Decimal, std::valarray<Decimal>>>(mPaMatrix);
-      mShortSurvivors = std::make_shared<SurvivingStrategiesContainer<Decimal, std::valarray<Decimal>>>(mPaMatrix);;
+      mPaMatrix = std::make_shared<UniqueSinglePAMatrix<Decimal, TComparison>>(mComparisonGenerator, mComparisonGenerator->getDateIndexCount());
+      mLongSurvivors = std::make_shared<SurvivingStrategiesContainer<Decimal, TComparison>>(mPaMatrix);
+      mShortSurvivors = std::make_shared<SurvivingStrategiesContainer<Decimal, TComparison>>(mPaMatrix);;
 
     }
 
@@ -85,7 +90,9 @@ namespace mkc_searchalgo
     {
       //std::shared_ptr<Decimal> profitTarget = std::make_shared<Decimal>(2.04);
       //std::shared_ptr<Decimal> stopLoss = std::make_shared<Decimal>(2.04);
-      BacktestResultBaseGenerator<Decimal, isLong> resultBase(mConfiguration, mSeries, profitTarget, stopLoss, inSampleOnly);
+      BacktestResultBaseGenerator<Decimal, isLong> resultBase(mConfiguration, mSeries, profitTarget, stopLoss, inSampleOnly, mExecutor);
+      //reruns and other searches with the same target/stop reuse the matrix (when a cache directory is set)
+      resultBase.setCacheDirectory(mBacktestCacheDirectory);
 
       resultBase.buildBacktestMatrix();
 
@@ -101,17 +108,23 @@ namespace mkc_searchalgo
       //2: 4, 10000
       //3: 1, 500
       //4: 4, 500 (sorter: 5.0)
+#ifndef USE_BLOOMBERG_DECIMALS
+      std::shared_ptr<TBacktester> shortcut = std::make_shared<TBacktester>(resultBase.getBacktestResultBase(), resultBase.getBacktestNumBarsInPosition(), resultBase.getTradeOutcomes(), mSearchConfiguration->getMinTrades(), isLong);
+#else
       std::shared_ptr<TBacktester> shortcut = std::make_shared<TBacktester>(resultBase.getBacktestResultBase(), resultBase.getBacktestNumBarsInPosition(), mSearchConfiguration->getMinTrades(), isLong);
-      std::shared_ptr<BacktestProcessor<Decimal, TBacktester>> backtestProcessor = std::make_shared<BacktestProcessor<Decimal, TBacktester>>(
+#endif
+      std::shared_ptr<BacktestProcessor<Decimal, TBacktester, TComparison>> backtestProcessor = std::make_shared<BacktestProcessor<Decimal, TBacktester, TComparison>>(
             mSearchConfiguration,
             shortcut,
             mPaMatrix);
-      ForwardStepwiseSelector<Decimal> forwardStepwise(
+      backtestProcessor->setPruningBounds(std::make_shared<const OccurrenceBounds<Decimal, TComparison>>(resultBase.getBacktestResultBase()));
+      ForwardStepwiseSelector<Decimal, TComparison> forwardStepwise(
             backtestProcessor,
             mPaMatrix,
             mSearchConfiguration,
             ( (*profitTarget)/(*stopLoss) ),
-            (isLong)? mLongSurvivors: mShortSurvivors);
+            (isLong)? mLongSurvivors: mShortSurvivors,
+            mExecutor);
       forwardStepwise.runSteps();
     }
 
@@ -146,14 +159,16 @@ namespace mkc_searchalgo
 
   private:
     std::shared_ptr<Portfolio<Decimal>> mPortfolio;
-    std::shared_ptr<SearchAlgoConfiguration<Decimal>> mSearchConfiguration;
-    std::shared_ptr<McptConfiguration<Decimal>> mConfiguration;
+    std::shared_ptr<const SearchAlgoConfiguration<Decimal>> mSearchConfiguration;
+    std::shared_ptr<const McptConfiguration<Decimal>> mConfiguration;
     std::shared_ptr<ComparisonsGenerator<Decimal>> mComparisonGenerator;
-    std::shared_ptr<OHLCTimeSeries<Decimal>> mSeries;
-    std::shared_ptr<UniqueSinglePAMatrix<Decimal, std::valarray<Decimal>>> mPaMatrix;
-    std::shared_ptr<SurvivingStrategiesContainer<Decimal, std::valarray<Decimal>>> mLongSurvivors;
-    std::shared_ptr<SurvivingStrategiesContainer<Decimal, std::valarray<Decimal>>> mShortSurvivors;
+    std::shared_ptr<const OHLCTimeSeries<Decimal>> mSeries;
+    std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>> mPaMatrix;
+    std::shared_ptr<SurvivingStrategiesContainer<Decimal, TComparison>> mLongSurvivors;
+    std::shared_ptr<SurvivingStrategiesContainer<Decimal, TComparison>> mShortSurvivors;
     unsigned int mPatternIndex;
+    Executor& mExecutor;
+    std::string mBacktestCacheDirectory;
   };
 
 }
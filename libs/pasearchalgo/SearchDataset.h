@@ -0,0 +1,64 @@
+// Copyright (C) MKC Associates, LLC
+// All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+
+#ifndef SEARCHDATASET_H
+#define SEARCHDATASET_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "McptConfigurationFileReader.h"
+#include "SearchAlgoConfigurationFileReader.h"
+
+namespace mkc_searchalgo
+{
+
+  ///
+  /// The immutable inputs of a search: the configuration and, per time frame, the search configuration
+  /// together with its parsed series.
+  ///
+  /// Loaded once and shared (read-only) by every search task, instead of each task re-parsing the
+  /// configuration files and re-reading the historic data of its time frame.
+  ///
+  template <class Decimal>
+  class SearchDataset
+  {
+  public:
+    /// searchConfigurations[timeFrameId] holds the search configuration (and series) of that time frame, 0 being the base series
+    SearchDataset(const std::shared_ptr<const McptConfiguration<Decimal>>& configuration,
+                  const std::vector<std::shared_ptr<const SearchAlgoConfiguration<Decimal>>>& searchConfigurations):
+      mConfiguration(configuration),
+      mSearchConfigurations(searchConfigurations)
+    {
+      if (mSearchConfigurations.empty())
+        throw std::invalid_argument("SearchDataset: no time frame was loaded");
+    }
+
+    const std::shared_ptr<const McptConfiguration<Decimal>>& getConfiguration() const { return mConfiguration; }
+
+    const std::shared_ptr<const SearchAlgoConfiguration<Decimal>>& getSearchConfiguration(size_t timeFrameId) const
+    {
+      if (timeFrameId >= mSearchConfigurations.size())
+        throw std::out_of_range("SearchDataset: time frame id " + std::to_string(timeFrameId) + " not loaded, number of loaded time frames: "
+                                + std::to_string(mSearchConfigurations.size()));
+      return mSearchConfigurations[timeFrameId];
+    }
+
+    std::shared_ptr<const OHLCTimeSeries<Decimal>> getTimeSeries(size_t timeFrameId) const
+    {
+      return getSearchConfiguration(timeFrameId)->getTimeSeries();
+    }
+
+    size_t getNumLoadedTimeFrames() const { return mSearchConfigurations.size(); }
+
+  private:
+    std::shared_ptr<const McptConfiguration<Decimal>> mConfiguration;
+    std::vector<std::shared_ptr<const SearchAlgoConfiguration<Decimal>>> mSearchConfigurations;
+  };
+
+}
+
+#endif // SEARCHDATASET_H
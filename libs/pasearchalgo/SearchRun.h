@@ -5,6 +5,7 @@
 #include "SearchAlgoConfigurationFileReader.h"
 #include "StdEstimator.h"
 #include "SearchController.h"
+#include "SearchDataset.h"
 #include "runner.hpp"
 #include "RunParameters.h"
 
@@ -35,6 +36,7 @@ namespace mkc_searchalgo
       std::cout << parameters->getSearchConfigFilePath() << std::endl;
       SearchAlgoConfigurationFileReader searchReader(parameters);
       mSearchConfig = searchReader.readConfigurationFile(mConfiguration, 0, true);
+      mDataset = loadDataset(searchReader);
       mNow = std::time(nullptr);
       std::cout << "Time since epoch: " << static_cast<long>(mNow) << std::endl;
     }
@@ -55,6 +57,7 @@ namespace mkc_searchalgo
       std::vector<boost::unique_future<void>> resultsOrErrorsVector;
 
       auto targetstop = mSearchConfig->getTargetStopPair()[targetStopIndex];
+      const std::string backtestCacheDirectory = mRunParameters->getBacktestCacheDirectory();
 
       for (size_t timeFrameId = 0; timeFrameId <= mSearchConfig->getNumTimeFrames(); timeFrameId++)
         {
@@ -69,18 +72,11 @@ namespace mkc_searchalgo
                                                              stopLoss,
                                                              inSampleOnly,
                                                              timeFrameId,
-                                                             side
+                                                             side,
+                                                             backtestCacheDirectory
                                                              ]()-> void {
-                  McptConfigurationFileReader reader(mRunParameters);
-                  std::shared_ptr<McptConfiguration<Decimal>> configuration = nullptr;
-                  configuration = reader.readConfigurationFile(true);
-
-                  SearchAlgoConfigurationFileReader searchReader(mRunParameters);
-                  std::shared_ptr<SearchAlgoConfiguration<Decimal>> searchConfig = searchReader.readConfigurationFile(configuration, static_cast<int>(timeFrameId), false);
-
-                  std::cout << "Parsed search algo config: " << mRunParameters->getSearchConfigFilePath() << std::endl;
-                  std::cout << (*searchConfig) << std::endl;
-                  SearchController<Decimal> controller(configuration, searchConfig->getTimeSeries(), searchConfig);
+                  const std::shared_ptr<const SearchAlgoConfiguration<Decimal>>& searchConfig = mDataset->getSearchConfiguration(timeFrameId);
+                  SearchController<Decimal> controller(mDataset->getConfiguration(), mDataset->getTimeSeries(timeFrameId), searchConfig, mExecutor, backtestCacheDirectory);
                   controller.prepare(patternSearchType, inSampleOnly);
                   if (side)
                     {
@@ -124,14 +120,36 @@ namespace mkc_searchalgo
 
     const std::shared_ptr<McptConfiguration<Decimal>>& getConfig() const { return mConfiguration; }
 
+  private:
+    ///
+    /// \brief loadDataset - reads the search configuration and series of every time frame once, for all the runs to share
+    ///
+    /// The base time frame (0) was read by the constructor, which also created the time frame files the others are read from.
+    ///
+    std::shared_ptr<const SearchDataset<Decimal>> loadDataset(SearchAlgoConfigurationFileReader& searchReader) const
+    {
+      std::vector<std::shared_ptr<const SearchAlgoConfiguration<Decimal>>> searchConfigurations { mSearchConfig };
+      for (size_t timeFrameId = 1; timeFrameId <= mSearchConfig->getNumTimeFrames(); timeFrameId++)
+        {
+          std::shared_ptr<SearchAlgoConfiguration<Decimal>> searchConfig = searchReader.readConfigurationFile(mConfiguration, static_cast<int>(timeFrameId), false);
+          std::cout << "Parsed search algo config: " << mRunParameters->getSearchConfigFilePath() << std::endl;
+          std::cout << (*searchConfig) << std::endl;
+          searchConfigurations.push_back(searchConfig);
+        }
+      return std::make_shared<const SearchDataset<Decimal>>(mConfiguration, searchConfigurations);
+    }
+
   private:
     std::string mConfigurationFileName;
     std::string mSearchConfigFileName;
     std::shared_ptr<McptConfiguration<Decimal>> mConfiguration;
     std::shared_ptr<SearchAlgoConfiguration<Decimal>> mSearchConfig;
+    std::shared_ptr<const SearchDataset<Decimal>> mDataset;
     std::shared_ptr<RunParameters> mRunParameters;
     Decimal mTargetBase;
     std::time_t mNow;
+    //one pool for the parallel parts of every search posted by run(), however many run at the same time
+    SearchController<Decimal>::Executor mExecutor;
   };
 
 }
@@ -9,6 +9,8 @@
 
 //#include "McptConfigurationFileReader.h"
 #include "PALMonteCarloValidation.h"
+#include "OccurrenceBitset.h"
+#include "TradeOutcomeTable.h"
 #include <algorithm>
 
 using namespace mkc_timeseries;
@@ -41,11 +43,30 @@ namespace mkc_searchalgo {
     ShortcutSearchAlgoBacktester(const std::valarray<Decimal>& backtestResults, const std::valarray<unsigned int>& numBarsInPosition, unsigned int minTrades, bool isLong):
       mBacktestResultBase(backtestResults),
       mNumBarsInPosition(numBarsInPosition),
+#ifndef USE_BLOOMBERG_DECIMALS
+      mOutcomes(std::make_shared<const TradeOutcomeTable<Decimal>>(backtestResults, numBarsInPosition)),
+#endif
       mMinTrades(minTrades),
       mNumTrades(0),
       mIsLong(isLong)
     {}
 
+#ifndef USE_BLOOMBERG_DECIMALS
+    /// Shares the integer outcomes already built by the BacktestResultBaseGenerator
+    ShortcutSearchAlgoBacktester(const std::valarray<Decimal>& backtestResults, const std::valarray<unsigned int>& numBarsInPosition,
+                                 const std::shared_ptr<const TradeOutcomeTable<Decimal>>& outcomes, unsigned int minTrades, bool isLong):
+      mBacktestResultBase(backtestResults),
+      mNumBarsInPosition(numBarsInPosition),
+      mOutcomes(outcomes),
+      mMinTrades(minTrades),
+      mNumTrades(0),
+      mIsLong(isLong)
+    {
+      if (mOutcomes->size() != backtestResults.size())
+        throw ShortcutBacktestException("Trade outcome table size is: " + std::to_string(mOutcomes->size()) + " whilst backtest results: " + std::to_string(backtestResults.size()));
+    }
+#endif
+
     bool getIsLong() const { return mIsLong; }
 
     void backtest(const std::valarray<Decimal>& compareContainer)
@@ -53,6 +74,12 @@ namespace mkc_searchalgo {
       throw ShortcutBacktestException("Backtesting logic for ShortcutBacktestMethod specified in template has not been implemented yet!");
     }
 
+    /// Same results as the valarray version, visiting only the dates whose bit is set
+    void backtest(const OccurrenceBitset& occurrences)
+    {
+      throw ShortcutBacktestException("Backtesting logic for ShortcutBacktestMethod specified in template has not been implemented yet!");
+    }
+
     Decimal getProfitFactor() const
     {
       if (mNumTrades < mMinTrades)
@@ -154,6 +181,9 @@ namespace mkc_searchalgo {
   private:
     const std::valarray<Decimal>& mBacktestResultBase;
     const std::valarray<unsigned int>& mNumBarsInPosition;
+#ifndef USE_BLOOMBERG_DECIMALS
+    std::shared_ptr<const TradeOutcomeTable<Decimal>> mOutcomes;
+#endif
     unsigned int mMinTrades;
     unsigned int mNumTrades;
     Decimal mSumWinners;
@@ -167,7 +197,7 @@ namespace mkc_searchalgo {
 
 
   template <>
-  void ShortcutSearchAlgoBacktester<Decimal, ShortcutBacktestMethod::PlainVanilla>::backtest(const std::valarray<Decimal>& occurences)
+  inline void ShortcutSearchAlgoBacktester<Decimal, ShortcutBacktestMethod::PlainVanilla>::backtest(const std::valarray<Decimal>& occurences)
   {
     reset();
     if (occurences.size() != mBacktestResultBase.size())
@@ -227,7 +257,7 @@ namespace mkc_searchalgo {
   }
 
   template <>
-  void ShortcutSearchAlgoBacktester<Decimal, ShortcutBacktestMethod::Pyramiding>::backtest(const std::valarray<Decimal>& occurences)
+  inline void ShortcutSearchAlgoBacktester<Decimal, ShortcutBacktestMethod::Pyramiding>::backtest(const std::valarray<Decimal>& occurences)
   {
     reset();
     if (occurences.size() != mBacktestResultBase.size())
@@ -256,6 +286,191 @@ namespace mkc_searchalgo {
       }
   }
 
+#ifndef USE_BLOOMBERG_DECIMALS
+  ///
+  /// Integer kernel over the precomputed TradeOutcomeTable: walks the words of (occurrences AND trade mask),
+  /// masking off the bars still covered by the previous position, and accumulates the fixed-point returns
+  /// in int64 (exactly the decimal sums) without allocating
+  ///
+  template <>
+  inline void ShortcutSearchAlgoBacktester<Decimal, ShortcutBacktestMethod::PlainVanilla>::backtest(const OccurrenceBitset& occurrences)
+  {
+    reset();
+    if (occurrences.size() != mOutcomes->size())
+      throw std::runtime_error("BacktesterBase size is: " + std::to_string(mOutcomes->size()) + " whilst occurrences: " + std::to_string(occurrences.size()));
+
+    const int64_t* returns = mOutcomes->returns();
+    const uint32_t* strides = mOutcomes->strides();
+    const uint64_t* occurrenceWords = occurrences.words();
+    const uint64_t* tradeWords = mOutcomes->getTradeMask().words();
+    const size_t numWords = occurrences.numWords();
+
+    int64_t sumWinners = 0;
+    int64_t sumLosers = 0;
+    unsigned int numWinners = 0;
+    unsigned int numLosers = 0;
+    unsigned int lastTradeBar = 0;
+    unsigned int consLosers = 0;
+    unsigned int maxConsLosers = 0;
+    unsigned int maxInactivity = 0;
+    //first bar where a new position may be entered
+    size_t nextEntry = 0;
+
+    for (size_t wordIndex = 0; wordIndex < numWords; ++wordIndex)
+      {
+        const size_t wordStart = wordIndex * OccurrenceBitset::BitsPerWord;
+        const size_t wordEnd = wordStart + OccurrenceBitset::BitsPerWord;
+        if (nextEntry >= wordEnd)
+          continue;
+
+        uint64_t word = occurrenceWords[wordIndex] & tradeWords[wordIndex];
+        if (nextEntry > wordStart)
+          word &= ~uint64_t(0) << (nextEntry - wordStart);
+
+        while (word != 0)
+          {
+            const size_t i = wordStart + bitops::countrZero(word);
+            const int64_t res = returns[i];
+
+            //inactivity check
+            const unsigned int inactivity = static_cast<unsigned int>(i) - lastTradeBar;
+            maxInactivity = std::max(maxInactivity, inactivity);
+            lastTradeBar = static_cast<unsigned int>(i);
+
+            //winners and losers come in random order, select instead of branching on the sign
+            const bool isWinner = res > 0;
+            numWinners += isWinner;
+            numLosers += !isWinner;
+            sumWinners += isWinner ? res : 0;
+            sumLosers += isWinner ? 0 : res;
+            consLosers = isWinner ? 0 : consLosers + 1;
+            maxConsLosers = std::max(maxConsLosers, consLosers);
+
+            //skip the bars where this position is still on
+            nextEntry = i + strides[i];
+            if (nextEntry >= wordEnd)
+              break;
+            word &= ~uint64_t(0) << (nextEntry - wordStart);
+          }
+      }
+
+    mNumWinners = numWinners;
+    mNumLosers = numLosers;
+    mNumTrades = numWinners + numLosers;
+    mSumWinners = TradeOutcomeTable<Decimal>::toDecimal(sumWinners);
+    mSumLosers = TradeOutcomeTable<Decimal>::toDecimal(sumLosers);
+    mMaxConsLosers = maxConsLosers;
+    mMaxInactivitySpan = maxInactivity;
+  }
+
+  template <>
+  inline void ShortcutSearchAlgoBacktester<Decimal, ShortcutBacktestMethod::Pyramiding>::backtest(const OccurrenceBitset& occurrences)
+  {
+    reset();
+    if (occurrences.size() != mOutcomes->size())
+      throw std::runtime_error("BacktesterBase size is: " + std::to_string(mOutcomes->size()) + " whilst occurrences: " + std::to_string(occurrences.size()));
+
+    const int64_t* returns = mOutcomes->returns();
+    const uint64_t* occurrenceWords = occurrences.words();
+    const uint64_t* tradeWords = mOutcomes->getTradeMask().words();
+
+    int64_t sumWinners = 0;
+    int64_t sumLosers = 0;
+    unsigned int numWinners = 0;
+    unsigned int numLosers = 0;
+
+    for (size_t wordIndex = 0; wordIndex < occurrences.numWords(); ++wordIndex)
+      {
+        for (uint64_t word = occurrenceWords[wordIndex] & tradeWords[wordIndex]; word != 0; word &= word - 1)
+          {
+            const int64_t res = returns[wordIndex * OccurrenceBitset::BitsPerWord + bitops::countrZero(word)];
+            const bool isWinner = res > 0;
+            numWinners += isWinner;
+            numLosers += !isWinner;
+            sumWinners += isWinner ? res : 0;
+            sumLosers += isWinner ? 0 : res;
+          }
+      }
+
+    mNumWinners = numWinners;
+    mNumLosers = numLosers;
+    mNumTrades = numWinners + numLosers;
+    mSumWinners = TradeOutcomeTable<Decimal>::toDecimal(sumWinners);
+    mSumLosers = TradeOutcomeTable<Decimal>::toDecimal(sumLosers);
+  }
+#else
+  template <>
+  inline void ShortcutSearchAlgoBacktester<Decimal, ShortcutBacktestMethod::PlainVanilla>::backtest(const OccurrenceBitset& occurrences)
+  {
+    reset();
+    if (occurrences.size() != mBacktestResultBase.size())
+      throw std::runtime_error("BacktesterBase size is: " + std::to_string(mBacktestResultBase.size()) + " whilst occurrences: " + std::to_string(occurrences.size()));
+
+    unsigned int lastTradeBar = 0;
+    unsigned int consLosers = 0;
+
+    //jump from signal to signal, skipping the bars where the previous position is still on
+    for (size_t i = occurrences.findNext(0); i < occurrences.size(); )
+      {
+        const Decimal& res = mBacktestResultBase[i];
+        if (res == DecimalConstants<Decimal>::DecimalZero)
+          {
+            i = occurrences.findNext(i + 1);
+            continue;
+          }
+
+        mNumTrades++;
+        //inactivity check
+        unsigned int inactivity = (i - lastTradeBar);
+        if (inactivity > mMaxInactivitySpan)
+          mMaxInactivitySpan = inactivity;
+
+        lastTradeBar = i;
+        if (res > DecimalConstants<Decimal>::DecimalZero)
+          {
+            mNumWinners++;
+            consLosers = 0;
+            mSumWinners += res;
+          }
+        else
+          {
+            mNumLosers++;
+            consLosers++;
+            if (consLosers > mMaxConsLosers)
+              mMaxConsLosers = consLosers;
+            mSumLosers += res;
+          }
+
+        i = occurrences.findNext(i + std::max(mNumBarsInPosition[i], 1u));
+      }
+  }
+
+  template <>
+  inline void ShortcutSearchAlgoBacktester<Decimal, ShortcutBacktestMethod::Pyramiding>::backtest(const OccurrenceBitset& occurrences)
+  {
+    reset();
+    if (occurrences.size() != mBacktestResultBase.size())
+      throw std::runtime_error("BacktesterBase size is: " + std::to_string(mBacktestResultBase.size()) + " whilst occurrences: " + std::to_string(occurrences.size()));
+
+    occurrences.forEachSetBit([this](size_t i)
+    {
+      const Decimal& res = mBacktestResultBase[i];
+      if (res > DecimalConstants<Decimal>::DecimalZero)
+        {
+          mNumTrades++;
+          mNumWinners++;
+          mSumWinners += res;
+        }
+      else if (res < DecimalConstants<Decimal>::DecimalZero)
+        {
+          mNumTrades++;
+          mNumLosers++;
+          mSumLosers += res;
+        }
+    });
+  }
+
+#endif // USE_BLOOMBERG_DECIMALS
 
 }
 
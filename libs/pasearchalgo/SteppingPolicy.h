@@ -16,23 +16,40 @@ namespace mkc_searchalgo
   ///
   /// The Stepping policy based on Max relevance min redundancy (and activity)
   ///
-  template <class Decimal, typename TSearchAlgoBacktester>
+  template <class Decimal, typename TSearchAlgoBacktester, typename TComparison = std::valarray<Decimal>>
   class MutualInfoSteppingPolicy
   {
   public:
-    MutualInfoSteppingPolicy(const shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>>& processingPolicy,
-                         const std::shared_ptr<UniqueSinglePAMatrix<Decimal, std::valarray<Decimal>>>& singlePA,
+    MutualInfoSteppingPolicy(const shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>>& processingPolicy,
+                         const std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>>& singlePA,
+                         concurrency::WorkStealingExecutor<>& executor,
                          size_t passingStratNumPerRound,
                          Decimal survivalCriterion,
                          const Decimal& activityMultiplier,
-                         const Decimal& stepRedundancyMultiplier):
+                         const Decimal& stepRedundancyMultiplier,
+                         size_t resultCapacity = 0):
       mProcessingPolicy(processingPolicy),
       mPassingStratNumPerRound(passingStratNumPerRound),
       mSurvivalCriterion(survivalCriterion),
       mActivityMultiplier(activityMultiplier),
-      mMutualizer(processingPolicy, singlePA, "Stepping"),
+      mMutualizer(processingPolicy, singlePA, "Stepping", executor),
       mStepRedundancyMultiplier(stepRedundancyMultiplier)
-      {}
+      {
+        //resultCapacity > 0: the processor keeps only the best results in the order passes() ranks them,
+        //the max relevance min redundancy selection then only looks that deep (0 keeps every result).
+        //Only the results the selection can pass on compete for the capacity: it skips those without losers or winners
+        //and those beyond the survival criterion (survivors are left to the survival policy)
+        if (resultCapacity > 0)
+          {
+            mProcessingPolicy->template setResultCapacity<Sorters::PALProfitabilitySorter<Decimal>>(resultCapacity);
+            mProcessingPolicy->setRankedResultFilter([survivalCriterion](const ResultStat<Decimal>& stat)
+                                                     {
+                                                       return stat.ProfitFactor != DecimalConstants<Decimal>::DecimalOneHundred
+                                                           && stat.ProfitFactor != DecimalConstants<Decimal>::DecimalZero
+                                                           && (survivalCriterion <= DecimalConstants<Decimal>::DecimalZero || stat.ProfitFactor <= survivalCriterion);
+                                                     });
+          }
+      }
 
     protected:
       std::vector<StrategyRepresentationType> passes(int stepNo, int maxDepth)
@@ -48,11 +65,11 @@ namespace mkc_searchalgo
       }
 
   private:
-    shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>> mProcessingPolicy;
+    shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>> mProcessingPolicy;
     size_t mPassingStratNumPerRound;
     Decimal mSurvivalCriterion;
     Decimal mActivityMultiplier;
-    ValarrayMutualizer<Decimal, TSearchAlgoBacktester> mMutualizer;
+    ValarrayMutualizer<Decimal, TSearchAlgoBacktester, TComparison> mMutualizer;
     Decimal mStepRedundancyMultiplier;
   };
 
@@ -61,12 +78,12 @@ namespace mkc_searchalgo
   /// The Stepping policy based on single sorter
   /// and a 80/20 (20% sampled from strategies not found at the top of the list)
   ///
-  template <class Decimal, typename TSearchAlgoBacktester, typename TSorter>
+  template <class Decimal, typename TSearchAlgoBacktester, typename TSorter, typename TComparison = std::valarray<Decimal>>
   class SimpleSteppingPolicy
   {
   public:
-    SimpleSteppingPolicy(const shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>>& processingPolicy,
-                         const std::shared_ptr<UniqueSinglePAMatrix<Decimal, std::valarray<Decimal>>>& singlePA,
+    SimpleSteppingPolicy(const shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>>& processingPolicy,
+                         const std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>>& singlePA,
                          size_t passingStratNumPerRound,
                          Decimal sortMultiplier):
       mProcessingPolicy(processingPolicy),
@@ -169,7 +186,7 @@ namespace mkc_searchalgo
     }
 
   private:
-    shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>> mProcessingPolicy;
+    shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>> mProcessingPolicy;
     size_t mPassingStratNumPerRound;
     Decimal mSortMultiplier;
 
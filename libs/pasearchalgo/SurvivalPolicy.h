@@ -13,13 +13,14 @@ namespace mkc_searchalgo
 {
 
 
-  template <class Decimal, typename TSearchAlgoBacktester>
+  template <class Decimal, typename TSearchAlgoBacktester, typename TComparison = std::valarray<Decimal>>
   class MutualInfoSurvivalPolicy
   {
 
   public:
-    MutualInfoSurvivalPolicy(const shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>>& processingPolicy,
-                            std::shared_ptr<UniqueSinglePAMatrix<Decimal, std::valarray<Decimal>>>& singlePA,
+    MutualInfoSurvivalPolicy(const shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>>& processingPolicy,
+                            std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>>& singlePA,
+                            concurrency::WorkStealingExecutor<>& executor,
                           Decimal survivalCriterion, Decimal targetStopRatio, unsigned int maxConsecutiveLosersLimit,
                           const Decimal& palSafetyFactor, const Decimal& survivalFilterMultiplier, const Decimal& stepRedundancyMultiplier):
       mSurvivalCriterion(survivalCriterion),
@@ -27,10 +28,17 @@ namespace mkc_searchalgo
       mProcessingPolicy(processingPolicy),
       mMaxConsecutiveLosersLimit(maxConsecutiveLosersLimit),
       mPalProfitabilitySafetyFactor(palSafetyFactor),
-      mMutualizer(processingPolicy, singlePA, "Survival"),
+      mMutualizer(processingPolicy, singlePA, "Survival", executor),
       mSurvivalFilterMultiplier(survivalFilterMultiplier),
       mStepRedundancyMultiplier(stepRedundancyMultiplier)
-    {}
+    {
+      //a bounded processor must not drop results that would survive
+      const Decimal profRequirement = getProfitabilityRequirement();
+      processingPolicy->setRetainedResultFilter([maxLosers = maxConsecutiveLosersLimit, survivalCriterion, profRequirement](const ResultStat<Decimal>& stat)
+      {
+        return passesSurvivalCriteria(stat, maxLosers, survivalCriterion, profRequirement);
+      });
+    }
 
     void filterSurvivors()
     {
@@ -40,30 +48,25 @@ namespace mkc_searchalgo
       std::unordered_map<int, StrategyRepresentationType>&
           stratMap = mProcessingPolicy->getStrategyMap();
 
+      //Profitability requirement
+      const Decimal profRequirement = getProfitabilityRequirement();
+
       for (const auto& tup: results)
         {
           const ResultStat<Decimal>& stat = std::get<0>(tup);
-          if (stat.MaxLosers > mMaxConsecutiveLosersLimit)
+//          if (stat.PALProfitability < stat.WinPercent)
+//            std::cout << "!!!Strategy found with Pal prof: " << stat.PALProfitability << " and win %: " << stat.WinPercent << std::endl;
+          if (!passesSurvivalCriteria(stat, mMaxConsecutiveLosersLimit, mSurvivalCriterion, profRequirement))
             continue;
-          if (stat.ProfitFactor > mSurvivalCriterion)
-            {
-              //Profitability requirement
-              Decimal profRequirement = (mSurvivalCriterion)/ (mSurvivalCriterion +  mPalProfitabilitySafetyFactor * mTargetStopRatio);
-//              if (stat.PALProfitability < stat.WinPercent)
-//                std::cout << "!!!Strategy found with Pal prof: " << stat.PALProfitability << " and win %: " << stat.WinPercent << std::endl;
 
-              if (stat.PALProfitability > profRequirement && stat.WinPercent > profRequirement)
-                {
-                  int ind = std::get<2>(tup);
-                  StrategyRepresentationType & strat = stratMap[ind];
-                  //check for repeats (only here, as at this stage processing time is less pertinent)
-                  std::sort(strat.begin(), strat.end());
-                  if (!findInVector(mSurvivors, strat))
-                    {
-                      mResults.push_back(tup);
-                      mSurvivors.push_back(strat);
-                    }
-                }
+          int ind = std::get<2>(tup);
+          StrategyRepresentationType & strat = stratMap[ind];
+          //check for repeats (only here, as at this stage processing time is less pertinent)
+          std::sort(strat.begin(), strat.end());
+          if (!findInVector(mSurvivors, strat))
+            {
+              mResults.push_back(tup);
+              mSurvivors.push_back(strat);
             }
         }
     }
@@ -82,7 +85,7 @@ namespace mkc_searchalgo
       return mMutualizer.getSelectedStatistics();
     }
 
-    ValarrayMutualizer<Decimal, TSearchAlgoBacktester>& getMutualizer() { return mMutualizer; }
+    ValarrayMutualizer<Decimal, TSearchAlgoBacktester, TComparison>& getMutualizer() { return mMutualizer; }
 
     const std::vector<StrategyRepresentationType>& getSurvivors() const {return mSurvivors;}
 
@@ -97,27 +100,39 @@ namespace mkc_searchalgo
     }
 
   private:
+    Decimal getProfitabilityRequirement() const
+    {
+      return (mSurvivalCriterion)/ (mSurvivalCriterion +  mPalProfitabilitySafetyFactor * mTargetStopRatio);
+    }
+
+    static bool passesSurvivalCriteria(const ResultStat<Decimal>& stat, unsigned int maxConsecutiveLosersLimit,
+                                       const Decimal& survivalCriterion, const Decimal& profRequirement)
+    {
+      return stat.MaxLosers <= maxConsecutiveLosersLimit && stat.ProfitFactor > survivalCriterion
+          && stat.PALProfitability > profRequirement && stat.WinPercent > profRequirement;
+    }
+
     Decimal mSurvivalCriterion;
     Decimal mTargetStopRatio;
-    shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>> mProcessingPolicy;
+    shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>> mProcessingPolicy;
     std::vector<StrategyRepresentationType> mSurvivors;
     std::vector<std::tuple<ResultStat<Decimal>, unsigned int, int>> mResults;
     //std::vector<std::valarray<Decimal>> mUniqueOccurences;
     unsigned int mMaxConsecutiveLosersLimit;
     Decimal mPalProfitabilitySafetyFactor;
-    ValarrayMutualizer<Decimal, TSearchAlgoBacktester> mMutualizer;
+    ValarrayMutualizer<Decimal, TSearchAlgoBacktester, TComparison> mMutualizer;
     Decimal mSurvivalFilterMultiplier;
     Decimal mStepRedundancyMultiplier;
 
   };
 
-  template <class Decimal, typename TSearchAlgoBacktester>
+  template <class Decimal, typename TSearchAlgoBacktester, typename TComparison = std::valarray<Decimal>>
   class DefaultSurvivalPolicy
   {
 
   public:
-    DefaultSurvivalPolicy(const shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>>& processingPolicy,
-                          std::shared_ptr<UniqueSinglePAMatrix<Decimal, std::valarray<Decimal>>>& singlePA,
+    DefaultSurvivalPolicy(const shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>>& processingPolicy,
+                          std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>>& singlePA,
                         Decimal survivalCriterion, Decimal targetStopRatio, unsigned int maxConsecutiveLosersLimit,
                         const Decimal& palSafetyFactor):
       mSurvivalCriterion(survivalCriterion),
@@ -125,7 +140,14 @@ namespace mkc_searchalgo
       mProcessingPolicy(processingPolicy),
       mMaxConsecutiveLosersLimit(maxConsecutiveLosersLimit),
       mPalProfitabilitySafetyFactor(palSafetyFactor)
-    {}
+    {
+      //a bounded processor must not drop results that would survive
+      const Decimal profRequirement = (mSurvivalCriterion)/ (mSurvivalCriterion +  mPalProfitabilitySafetyFactor * mTargetStopRatio);
+      processingPolicy->setRetainedResultFilter([maxLosers = maxConsecutiveLosersLimit, survivalCriterion, profRequirement](const ResultStat<Decimal>& stat)
+      {
+        return stat.MaxLosers <= maxLosers && stat.ProfitFactor > survivalCriterion && stat.PALProfitability > profRequirement;
+      });
+    }
 
     void filterSurvivors()
     {
@@ -194,7 +216,7 @@ namespace mkc_searchalgo
   private:
     Decimal mSurvivalCriterion;
     Decimal mTargetStopRatio;
-    shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>> mProcessingPolicy;
+    shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>> mProcessingPolicy;
     std::vector<StrategyRepresentationType> mSurvivors;
     std::vector<std::tuple<ResultStat<Decimal>, unsigned int, int>> mResults;
     //std::vector<std::valarray<Decimal>> mUniqueOccurences;
@@ -36,7 +36,7 @@ namespace mkc_searchalgo
     }
 
     template<class TSearchAlgoBacktester>
-    void removeRedundant(ValarrayMutualizer<Decimal, TSearchAlgoBacktester>& mutualizer)
+    void removeRedundant(ValarrayMutualizer<Decimal, TSearchAlgoBacktester, TComparison>& mutualizer)
     {
         std::cout << "REMOVING REDUNDANT in compiled survival strategies container." << std::endl;
         mutualizer.getMaxRelMinRed(mStatistics, mStatistics.size(), 0.0, 1.0, 1.0);
@@ -0,0 +1,82 @@
+// Copyright (C) MKC Associates, LLC
+// All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+
+#ifndef TRADEOUTCOMETABLE_H
+#define TRADEOUTCOMETABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <valarray>
+#include <vector>
+#include "number.h"
+#include "OccurrenceBitset.h"
+
+#ifndef USE_BLOOMBERG_DECIMALS
+
+namespace mkc_searchalgo
+{
+
+  ///
+  /// The backtest result base (trade return and bars in position per signal date) in compact integer form,
+  /// for the integer backtest kernel of ShortcutSearchAlgoBacktester.
+  ///
+  /// Returns are kept as the unbiased fixed-point value of the decimal, so sums of them are exactly the
+  /// decimal sums, and their sign tells winner from loser. The trade mask has a bit set for every date
+  /// with a non-zero return, so the kernel only visits dates where a trade can happen.
+  /// Built once per BacktestResultBaseGenerator and shared read-only by every backtester copy.
+  ///
+  template <class Decimal>
+  class TradeOutcomeTable
+  {
+  public:
+    TradeOutcomeTable(const std::valarray<Decimal>& backtestResults, const std::valarray<unsigned int>& numBarsInPosition):
+      mReturns(backtestResults.size()),
+      mStrides(backtestResults.size()),
+      mTradeMask(backtestResults.size())
+    {
+      if (backtestResults.size() != numBarsInPosition.size())
+        throw std::invalid_argument("TradeOutcomeTable: " + std::to_string(backtestResults.size()) + " results vs "
+                                    + std::to_string(numBarsInPosition.size()) + " bars in position");
+
+      for (size_t i = 0; i < backtestResults.size(); ++i)
+        {
+          mReturns[i] = backtestResults[i].getUnbiased();
+          mStrides[i] = std::max(numBarsInPosition[i], 1u);
+          if (mReturns[i] != 0)
+            mTradeMask.set(i);
+        }
+    }
+
+    size_t size() const { return mReturns.size(); }
+
+    /// unbiased fixed-point trade return per date
+    const int64_t* returns() const { return mReturns.data(); }
+
+    /// bars to advance to the next possible entry after a trade entered on each date (never 0)
+    const uint32_t* strides() const { return mStrides.data(); }
+
+    const OccurrenceBitset& getTradeMask() const { return mTradeMask; }
+
+    /// converts a sum of returns back to the decimal it represents
+    static Decimal toDecimal(int64_t unbiased)
+    {
+      Decimal result;
+      result.setUnbiased(unbiased);
+      return result;
+    }
+
+  private:
+    std::vector<int64_t> mReturns;
+    std::vector<uint32_t> mStrides;
+    OccurrenceBitset mTradeMask;
+  };
+
+}
+
+#endif // USE_BLOOMBERG_DECIMALS
+
+#endif // TRADEOUTCOMETABLE_H
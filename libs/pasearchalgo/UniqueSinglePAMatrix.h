@@ -9,7 +9,9 @@
 
 #include <iostream>
 #include <valarray>
+#include <unordered_map>
 #include "DecimalConstants.h"
+#include "OccurrenceBitset.h"
 
 #include "ComparisonsGenerator.h"
 #include "PalAst.h"
@@ -31,12 +33,10 @@ namespace mkc_searchalgo {
     UniqueSinglePAMatrix(const ComparisonsGenerator<Decimal>& compareGenerator, unsigned int dateIndexCount):
       mDateIndexCount(dateIndexCount)
     {
-      typename std::set<TComparison>::const_iterator it = compareGenerator.getUniqueComparisons().begin();
-
       unsigned int i = 0;
-      for (; it != compareGenerator.getUniqueComparisons().end(); ++ it)
+      for (const ComparisonEntryType& entry: compareGenerator.getUniqueComparisons())
         {
-          mUniquesMap[i] = (*it);
+          mUniquesMap[i] = entry;
           i++;
         }
       std::cout << "Unique maps size: " << mUniquesMap.size() << std::endl;
@@ -68,42 +68,23 @@ public:
   UniqueSinglePAMatrix(const std::shared_ptr<ComparisonsGenerator<Decimal>>& compareGenerator, unsigned int dateIndexCount):
     mDateIndexCount(dateIndexCount)
   {
-    std::set<ComparisonEntryType>::const_iterator it = compareGenerator->getUniqueComparisons().begin();
-    //"vector" initialized to zeros
-    std::valarray<Decimal> initVector(DecimalConstants<Decimal>::DecimalZero, dateIndexCount);
     unsigned int i = 0;
-    for (; it != compareGenerator->getUniqueComparisons().end(); ++ it)
+    for (const ComparisonEntryType& entry: compareGenerator->getUniqueComparisons())
       {
-        mUniqueMaps[i] = (*it);
-        mMatrix[i] = initVector;
+        mUniqueMaps[i] = entry;
+        //"vector" initialized to zeros, with a one on every date the comparison holds ("sparse" vector)
+        std::valarray<Decimal>& vector = mMatrix[i];
+        vector.resize(dateIndexCount, DecimalConstants<Decimal>::DecimalZero);
+        compareGenerator->getOccurrences(entry).forEachSetBit([&vector, dateIndexCount](size_t dateIndex)
+                                                            {
+                                                              if (dateIndex < dateIndexCount)
+                                                                vector[dateIndex] = DecimalConstants<Decimal>::DecimalOne;
+                                                            });
         i++;
-
       }
     std::cout << "Unique maps size: " << mUniqueMaps.size() << ", underlying mMatrix size: " << mMatrix.size() << std::endl;
-    vectorizeComparisons(compareGenerator->getComparisons());
   }
 
-  void vectorizeComparisons(const std::unordered_map<unsigned int, std::unordered_set<ComparisonEntryType>>& comparisonsBatches)
-  {
-    //iterate over "date indices"
-    for (unsigned int i = 0; i < mDateIndexCount; i++)
-      {
-        //std::cout << "index date: " << i << std::endl;
-        const auto& compareSet = comparisonsBatches.at(i);
-        //iterate the 0 matrix
-        std::unordered_map<unsigned int, ComparisonEntryType>::const_iterator it;
-        for (it = mUniqueMaps.begin(); it != mUniqueMaps.end(); ++it)
-          {
-            const ComparisonEntryType& compareKey = it->second;
-            std::valarray<Decimal>& vector = mMatrix[it->first];
-            std::unordered_set<ComparisonEntryType>::const_iterator fnd = compareSet.find(compareKey);
-            if (fnd != compareSet.end())
-              { //found comparison entry for this dateindex
-                vector[i] = DecimalConstants<Decimal>::DecimalOne;  //create "sparse" vector entry
-              }
-          }
-      }
-  }
   const std::unordered_map<unsigned int, std::valarray<Decimal>>& getMap() const { return mMatrix; }
 
   const typename std::unordered_map<unsigned int, std::valarray<Decimal>>::const_iterator getMapBegin() const { return mMatrix.begin(); }
@@ -112,6 +93,20 @@ public:
 
   const std::valarray<Decimal>& getMappedElement(unsigned int id) const { return mMatrix.at(id); }
 
+  /// occurrences of a strategy: the element-wise product of its comparisons' vectors
+  void combineElements(const std::vector<unsigned int>& elements, std::valarray<Decimal>& occurrences) const
+  {
+    occurrences.resize(mDateIndexCount, DecimalConstants<Decimal>::DecimalOne);
+    for (unsigned int el: elements)
+      occurrences *= getMappedElement(el);
+  }
+
+  /// occurrences of a parent strategy extended by one more comparison
+  void extendElements(const std::valarray<Decimal>& parentOccurrences, unsigned int element, std::valarray<Decimal>& occurrences) const
+  {
+    occurrences = parentOccurrences * getMappedElement(element);
+  }
+
   const ComparisonEntryType& getUnderlying(unsigned int id) const { return mUniqueMaps.at(id); }
 
   size_t getMapSize() const { return mMatrix.size(); }
@@ -126,6 +121,68 @@ private:
   std::unordered_map<unsigned int, std::valarray<Decimal>> mMatrix;
   std::unordered_map<unsigned int, ComparisonEntryType> mUniqueMaps;
 
+};
+
+  ///
+  /// Specialization with packed bitset representation of comparisons (one bit per date index)
+  /// Same ids and same content as the valarray version, at 1/64th of its memory per date and comparison
+  ///
+template <class Decimal> class UniqueSinglePAMatrix<Decimal, OccurrenceBitset>
+{
+public:
+  UniqueSinglePAMatrix(const std::shared_ptr<ComparisonsGenerator<Decimal>>& compareGenerator, unsigned int dateIndexCount):
+    mDateIndexCount(dateIndexCount)
+  {
+    //ids follow the sorted order of the unique comparisons, as in the valarray version
+    const std::vector<ComparisonEntryType> uniques = compareGenerator->getUniqueComparisons();
+    mUniques.reserve(uniques.size());
+    mMatrix.reserve(uniques.size());
+    for (const ComparisonEntryType& entry: uniques)
+      {
+        const OccurrenceBitset occurrences = compareGenerator->getOccurrences(entry);
+        mUniques.push_back(entry);
+        mMatrix.emplace_back(dateIndexCount, occurrences.words(), occurrences.numWords());
+      }
+    std::cout << "Unique maps size: " << mUniques.size() << ", underlying bitset matrix size: " << mMatrix.size() << std::endl;
+  }
+
+  const OccurrenceBitset& getMappedElement(unsigned int id) const { return mMatrix.at(id); }
+
+  /// occurrences of a strategy: the AND of its comparisons' bitsets
+  void combineElements(const std::vector<unsigned int>& elements, OccurrenceBitset& occurrences) const
+  {
+    if (elements.empty())
+      {
+        occurrences = OccurrenceBitset(mDateIndexCount, true);
+        return;
+      }
+
+    occurrences.assign(getMappedElement(elements.front()));
+    for (size_t i = 1; i < elements.size(); ++i)
+      occurrences &= getMappedElement(elements[i]);
+  }
+
+  /// occurrences of a parent strategy extended by one more comparison
+  void extendElements(const OccurrenceBitset& parentOccurrences, unsigned int element, OccurrenceBitset& occurrences) const
+  {
+    occurrences.assign(parentOccurrences);
+    occurrences &= getMappedElement(element);
+  }
+
+  const ComparisonEntryType& getUnderlying(unsigned int id) const { return mUniques.at(id); }
+
+  size_t getMapSize() const { return mMatrix.size(); }
+
+  unsigned int getDateCount() const { return mDateIndexCount; }
+
+  ~UniqueSinglePAMatrix()
+  {}
+
+private:
+  unsigned int mDateIndexCount;
+  std::vector<OccurrenceBitset> mMatrix;
+  std::vector<ComparisonEntryType> mUniques;
+
 };
 
 
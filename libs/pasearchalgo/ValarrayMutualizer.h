@@ -9,6 +9,9 @@
 
 #include "BacktestProcessor.h"
 #include <chrono>
+#include <set>
+#include "ParallelExecutors.h"
+#include "ParallelFor.h"
 
 using namespace std::chrono;
 namespace mkc_searchalgo
@@ -25,29 +28,49 @@ namespace mkc_searchalgo
 //      }
 //  };
 
-  template <class Decimal, class TSearchAlgoBacktester>
+  ///
+  /// Max relevance min redundancy selection of strategies.
+  ///
+  /// The redundancy of two strategies is the highest redundancy between any comparison of the one and any
+  /// comparison of the other, and the redundancy of a candidate is its highest redundancy with the strategies
+  /// selected so far. The comparison pairs are scored once (a popcount per pair for bitsets), and every candidate
+  /// keeps its running maximum, only folding in the strategies selected since it was last looked at.
+  /// Folding is done in parallel on the executor passed in (shared with the rest of the search), for blocks of
+  /// candidates ahead of the scan.
+  /// Scores only fall from round to round, so no round stops its scan before the first one did: every candidate
+  /// scored once is scored in every later round too.
+  ///
+  template <class Decimal, class TSearchAlgoBacktester, class TComparison = std::valarray<Decimal>,
+            typename Executor = concurrency::WorkStealingExecutor<>>
   class ValarrayMutualizer
   {
   public:
-    ValarrayMutualizer(const shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester>>& processingPolicy,
-                       const std::shared_ptr<UniqueSinglePAMatrix<Decimal, std::valarray<Decimal>>>& singlePA,
-                       const std::string& runType):
+    ValarrayMutualizer(const shared_ptr<BacktestProcessor<Decimal, TSearchAlgoBacktester, TComparison>>& processingPolicy,
+                       const std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>>& singlePA,
+                       const std::string& runType,
+                       Executor& executor):
+      mExecutor(executor),
       mStratMap(processingPolicy->getStrategyMap()),
       mSinglePA(singlePA),
-      mRunType(runType)
+      mRunType(runType),
+      mNumComparisons(singlePA->getMapSize()),
+      mPairRedundancy(mNumComparisons * mNumComparisons)
     {
       std::cout << mRunType << " - Building mutual info matrix." << std::endl;
-      for (size_t i = 0; i < mSinglePA->getMapSize(); i++)
-        {
-          for (size_t c = 0; c < mSinglePA->getMapSize(); c++)
-            {
-              const std::valarray<Decimal>& v1 = mSinglePA->getMappedElement(i);
-              const std::valarray<Decimal>& v2 = mSinglePA->getMappedElement(c);
-              Decimal red = getRedundancy(v1, v2);
-              mIndividualRedundancyPairValues.insert(std::make_pair((i < c)?(i*10000 + c):(c*10000 + i), red.getAsDouble()));
-            }
-        }
-        std::cout << mRunType << " - Built mutual info matrix of size: " << mIndividualRedundancyPairValues.size() << std::endl;
+      //symmetric: each row scores the pairs from its diagonal on and mirrors them
+      concurrency::parallel_for(static_cast<uint32_t>(mNumComparisons), mExecutor,
+                                [this](uint32_t i)
+                                {
+                                  const TComparison& v1 = mSinglePA->getMappedElement(i);
+                                  for (size_t c = i; c < mNumComparisons; c++)
+                                    {
+                                      const TComparison& v2 = mSinglePA->getMappedElement(static_cast<unsigned int>(c));
+                                      const double red = getRedundancy(v1, v2).getAsDouble();
+                                      mPairRedundancy[i * mNumComparisons + c] = red;
+                                      mPairRedundancy[c * mNumComparisons + i] = red;
+                                    }
+                                });
+      std::cout << mRunType << " - Built mutual info matrix of size: " << mPairRedundancy.size() << std::endl;
     }
 
   public:
@@ -68,7 +91,8 @@ namespace mkc_searchalgo
       mSelectedStrategies.shrink_to_fit();
       mSelectedStatistics.clear();
       mSelectedStatistics.shrink_to_fit();
-      mIndexedSums.clear();
+      mSelectedSet.clear();
+      prepareCandidates(sortedResults, inverseSurvivalFilter);
       double bestRelevance;
       double bestRedundancy = 0.0;
       double bestActivity;
@@ -83,11 +107,12 @@ namespace mkc_searchalgo
           //redundancyMult += redundancySeedMultiplier * 0.5;
           redundancyMult = redundancySeedMultiplier;
           //std::cout << "New redundancy mult: " << redundancyMult << std::endl;
+          //candidates before this index have folded in every selected strategy
+          size_t foldedUpTo = 0;
           StrategyRepresentationType bestStrat;
           std::tuple<ResultStat<Decimal>, unsigned int, int> selectedStatistics;
           for (const std::tuple<ResultStat<Decimal>, unsigned int, int>& tup: sortedResults)
             {
-              int ind = std::get<2>(tup);
               unsigned int trades = std::get<1>(tup);
               const ResultStat<Decimal>& stat = std::get<0>(tup);
               //increment index immediately
@@ -99,9 +124,9 @@ namespace mkc_searchalgo
               if (inverseSurvivalFilter > DecimalConstants<Decimal>::DecimalZero && stat.ProfitFactor > inverseSurvivalFilter)
                 continue;
 
-              const StrategyRepresentationType& strat = mStratMap[ind];
+              const StrategyRepresentationType& strat = *mCandidateStrategies[index];
 
-              if (findInVector(mSelectedStrategies, strat))
+              if (mSelectedSet.count(strat) > 0)
                 continue;
 
               double relevance = stat.PALProfitability.getAsDouble();
@@ -126,11 +151,9 @@ namespace mkc_searchalgo
                   selectedStatistics = tup;
                   break;
                 }
-              double redundancy;
-              if (mSelectedStrategies.size() == 1)
-                redundancy = initRedundancyMax(index, mSelectedStrategies.back(), strat) * redundancyMult;
-              else
-                redundancy = getRedundancyMax(index, strat) * redundancyMult;
+              if (static_cast<size_t>(index) >= foldedUpTo)
+                foldedUpTo = foldRedundancies(static_cast<size_t>(index), static_cast<size_t>(maxIndexToSearch));
+              double redundancy = mRunningMaxRedundancy[index] * redundancyMult;
 
               if (redundancy >= redundancyFilter * redundancyMult)
                 {
@@ -168,6 +191,7 @@ namespace mkc_searchalgo
                 }
               //mSelectedGroup.insert(mSelectedGroup.begin(), bestStrat.begin(), bestStrat.end());
               mSelectedStrategies.push_back(bestStrat);
+              mSelectedSet.insert(bestStrat);
               mSelectedStatistics.push_back(selectedStatistics);
               //mSelectedRelActRed.push_back(std::make_tuple(bestRelevance, bestActivity, bestRedundancy));
             }
@@ -176,78 +200,59 @@ namespace mkc_searchalgo
 
   private:
 
-    double initRedundancyMax(int index, const StrategyRepresentationType& strat1, const StrategyRepresentationType& strat2)
-    {
-      double maxRed = 0.0;
-      for (unsigned int i: strat1)
-        {
-          for (unsigned int c: strat2)
-            {
-              double red = mIndividualRedundancyPairValues[(i < c)?(i*10000 + c):(c*10000 + i)];
-              if (red > maxRed){
-                  maxRed = red;
-                }
-            }
-        }
-        mIndexedSums[index] = maxRed;
-        return maxRed;
-    }
+    static constexpr size_t FoldBlockSize = 1024;
 
-    double getRedundancyMax(int index, const StrategyRepresentationType& strat2)
+    /// resolves the candidates' strategies and resets their running max redundancy
+    void prepareCandidates(const std::vector<std::tuple<ResultStat<Decimal>, unsigned int, int>>& sortedResults, const Decimal& inverseSurvivalFilter)
     {
-      //the last added strategy is the only one missing from the recorded sum
-      const StrategyRepresentationType& strat1 = mSelectedStrategies.back();
-      double maxRed = 0.0;
-      for (unsigned int i: strat1)
+      mCandidateStrategies.resize(sortedResults.size());
+      mCandidateEligible.resize(sortedResults.size());
+      for (size_t k = 0; k < sortedResults.size(); k++)
         {
-          for (unsigned int c: strat2)
-            {
-              double red = mIndividualRedundancyPairValues[(i < c)?(i*10000 + c):(c*10000 + i)];
-              if (red > maxRed){
-                  maxRed = red;
-                }
-            }
+          mCandidateStrategies[k] = &mStratMap[std::get<2>(sortedResults[k])];
+          const Decimal& profitFactor = std::get<0>(sortedResults[k]).ProfitFactor;
+          mCandidateEligible[k] = !(profitFactor == DecimalConstants<Decimal>::DecimalOneHundred || profitFactor == DecimalConstants<Decimal>::DecimalZero
+                                    || (inverseSurvivalFilter > DecimalConstants<Decimal>::DecimalZero && profitFactor > inverseSurvivalFilter));
         }
-      double& originalMax = mIndexedSums[index];
-      originalMax = std::max(originalMax, maxRed);
-      return originalMax;
+      mRunningMaxRedundancy.assign(sortedResults.size(), 0.0);
+      mFoldedCount.assign(sortedResults.size(), 0);
     }
 
-    double initRedundancy(int index, const StrategyRepresentationType& strat1, const StrategyRepresentationType& strat2)
+    ///
+    /// \brief foldRedundancies - brings the running max redundancy of a block of candidates from first on up to date
+    /// \return the end of the block
+    ///
+    size_t foldRedundancies(size_t first, size_t end)
     {
-      double sumRed = 0.0;
-      int cnt = 0;
-      for (unsigned int i: strat1)
-        {
-          for (unsigned int c: strat2)
-            {
-              double red = mIndividualRedundancyPairValues[(i < c)?(i*10000 + c):(c*10000 + i)];
-              sumRed += red;
-              cnt++;
-            }
-        }
-        mIndexedSums[index] = sumRed;
-        return (sumRed / cnt);
+      const size_t last = std::min(end, first + FoldBlockSize);
+      if (last <= first)
+        return first + 1;
+
+      concurrency::parallel_for(static_cast<uint32_t>(last - first), mExecutor,
+                                [this, first](uint32_t p)
+                                {
+                                  const size_t k = first + p;
+                                  if (!mCandidateEligible[k])
+                                    return;
+                                  double& runningMax = mRunningMaxRedundancy[k];
+                                  for (size_t j = mFoldedCount[k]; j < mSelectedStrategies.size(); j++)
+                                    runningMax = std::max(runningMax, getStrategyRedundancy(mSelectedStrategies[j], *mCandidateStrategies[k]));
+                                  mFoldedCount[k] = mSelectedStrategies.size();
+                                }, 32);
+      return last;
     }
 
-    double getRedundancy(int index, const StrategyRepresentationType& strat2)
+    /// the highest redundancy between a comparison of strat1 and a comparison of strat2
+    double getStrategyRedundancy(const StrategyRepresentationType& strat1, const StrategyRepresentationType& strat2) const
     {
-      //the last added strategy is the only one missing from the recorded sum
-      const StrategyRepresentationType& strat1 = mSelectedStrategies.back();
-      double sumRed = 0.0;
-      int cnt = 0;
+      double maxRed = 0.0;
       for (unsigned int i: strat1)
         {
+          const double* row = &mPairRedundancy[i * mNumComparisons];
           for (unsigned int c: strat2)
-            {
-              double red = mIndividualRedundancyPairValues[(i < c)?(i*10000 + c):(c*10000 + i)];
-              sumRed += red;
-              cnt++;
-            }
+            maxRed = std::max(maxRed, row[c]);
         }
-      double& origsum = mIndexedSums[index];
-      origsum += sumRed;
-      return (origsum / (mSelectedStrategies.size()*strat1.size()*strat1.size() + cnt));
+      return maxRed;
     }
 
     ///
@@ -273,17 +278,14 @@ namespace mkc_searchalgo
     }
 
     ///
-    /// \brief getTrading - retrieves trading rep for a given strategy
-    /// \param strat - strategy as represented by vector of int indices
-    /// \return valarray of trading either 0 for no trade, or 1 for trade
+    /// \brief getRedundancy - the same score for bitsets: the sum of abs differences of two 0/1 vectors
+    ///         is the popcount of their XOR
     ///
-    std::valarray<Decimal> getTrading(const StrategyRepresentationType & strat)
+    Decimal getRedundancy(const OccurrenceBitset& baseArray, const OccurrenceBitset& newArray)
     {
-      std::valarray<Decimal> occurences(DecimalConstants<Decimal>::DecimalOne, mSinglePA->getDateCount());
-      //the multiplication
-      for (unsigned int el: strat)
-        occurences *= mSinglePA->getMappedElement(el);
-      return occurences;
+      Decimal diffSum(static_cast<unsigned int>(baseArray.countDifferences(newArray)));
+      Decimal avgDiff(diffSum / Decimal(static_cast<double>(baseArray.size())));
+      return (DecimalConstants<Decimal>::DecimalOne - avgDiff);
     }
 
   public:
@@ -292,12 +294,22 @@ namespace mkc_searchalgo
     const std::vector<std::tuple<ResultStat<Decimal>, unsigned int, int>>& getSelectedStatistics() const { return mSelectedStatistics; }
 
   private:
+    Executor& mExecutor;
     std::unordered_map<int, StrategyRepresentationType>& mStratMap;
-    const std::shared_ptr<UniqueSinglePAMatrix<Decimal, std::valarray<Decimal>>>& mSinglePA;
+    const std::shared_ptr<UniqueSinglePAMatrix<Decimal, TComparison>>& mSinglePA;
     std::vector<StrategyRepresentationType> mSelectedStrategies;
-    std::unordered_map<unsigned int, double> mIndividualRedundancyPairValues;
-    std::unordered_map<int, double> mIndexedSums;
+    //the selected strategies again, for lookups
+    std::set<StrategyRepresentationType> mSelectedSet;
     std::string mRunType;
+    size_t mNumComparisons;
+    //redundancy of every pair of comparisons, row-major
+    std::vector<double> mPairRedundancy;
+    //per candidate (position in the sorted results): strategy, whether it can be selected at all,
+    //max redundancy with the selected strategies folded in so far, and how many of them were folded in
+    std::vector<const StrategyRepresentationType*> mCandidateStrategies;
+    std::vector<char> mCandidateEligible;
+    std::vector<double> mRunningMaxRedundancy;
+    std::vector<size_t> mFoldedCount;
     std::vector<std::tuple<ResultStat<Decimal>, unsigned int, int>> mSelectedStatistics;
     //std::vector<std::tuple<double, double, double>> mSelectedRelActRed;
 
@@ -0,0 +1,76 @@
+// BacktestMatrixCacheTest.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include "number.h"
+#include "BacktestMatrixCache.h"
+
+using namespace mkc_searchalgo;
+using namespace mkc_timeseries;
+
+typedef num::DefaultNumber DecimalType;
+
+TEST_CASE ("BacktestMatrixCache keys on the simulation version", "[BacktestMatrixCache]")
+{
+  using Cache = BacktestMatrixCache<DecimalType>;
+
+  OHLCTimeSeries<DecimalType> series(TimeFrame::DAILY, TradingVolume::SHARES);
+  series.addEntry(OHLCTimeSeriesEntry<DecimalType>(boost::gregorian::date(2016, 1, 4), DecimalType("100.0"), DecimalType("101.5"),
+                                                   DecimalType("99.0"), DecimalType("101.0"), DecimalType("0"), TimeFrame::DAILY));
+  series.addEntry(OHLCTimeSeriesEntry<DecimalType>(boost::gregorian::date(2016, 1, 5), DecimalType("101.0"), DecimalType("102.0"),
+                                                   DecimalType("100.5"), DecimalType("100.75"), DecimalType("0"), TimeFrame::DAILY));
+
+  const BacktestMatrixKey key = Cache::makeKey(series, series, true, DecimalType("2.5"), DecimalType("1.25"), DecimalType("0.01"),
+                                               boost::gregorian::date(2016, 1, 4), boost::gregorian::date(2016, 1, 5), 0);
+  REQUIRE (key.mSimulationVersion == Cache::SimulationVersion);
+
+  const boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("palbtm-%%%%-%%%%");
+  boost::filesystem::create_directories(directory);
+
+  std::valarray<DecimalType> tradingVector {DecimalType("0.5"), DecimalType("-1.25")};
+  std::valarray<unsigned int> numBarsInPosition {3, 1};
+  REQUIRE (Cache::store(directory.string(), key, tradingVector, numBarsInPosition));
+
+  SECTION ("The same key loads the stored matrix")
+    {
+      std::valarray<DecimalType> loadedVector;
+      std::valarray<unsigned int> loadedBars;
+      REQUIRE (Cache::load(directory.string(), key, loadedVector, loadedBars));
+      REQUIRE (loadedVector.size() == 2);
+      REQUIRE (loadedVector[1] == DecimalType("-1.25"));
+      REQUIRE (loadedBars[0] == 3);
+    }
+
+  SECTION ("A matrix simulated under other rules is not found")
+    {
+      BacktestMatrixKey olderRules = key;
+      olderRules.mSimulationVersion = Cache::SimulationVersion - 1;
+      REQUIRE (Cache::getCacheFileName(directory.string(), olderRules) != Cache::getCacheFileName(directory.string(), key));
+
+      std::valarray<DecimalType> loadedVector;
+      std::valarray<unsigned int> loadedBars;
+      REQUIRE_FALSE (Cache::load(directory.string(), olderRules, loadedVector, loadedBars));
+      REQUIRE (loadedVector.size() == 0);
+    }
+
+  SECTION ("A matrix simulated with another tick is not found")
+    {
+      const BacktestMatrixKey otherTick = Cache::makeKey(series, series, true, DecimalType("2.5"), DecimalType("1.25"), DecimalType("0.25"),
+                                                         boost::gregorian::date(2016, 1, 4), boost::gregorian::date(2016, 1, 5), 0);
+      std::valarray<DecimalType> loadedVector;
+      std::valarray<unsigned int> loadedBars;
+      REQUIRE_FALSE (Cache::load(directory.string(), otherTick, loadedVector, loadedBars));
+    }
+
+  SECTION ("No temporary file is left behind")
+    {
+      unsigned int files = 0;
+      for (boost::filesystem::directory_iterator it(directory); it != boost::filesystem::directory_iterator(); ++it)
+        {
+          REQUIRE (it->path().extension() == ".palbtm");
+          files++;
+        }
+      REQUIRE (files == 1);
+    }
+
+  boost::filesystem::remove_all(directory);
+}
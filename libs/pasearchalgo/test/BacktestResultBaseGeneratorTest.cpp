@@ -0,0 +1,114 @@
+// BacktestResultBaseGeneratorTest.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <valarray>
+#include <boost/filesystem.hpp>
+#include "number.h"
+#include "BacktestResultBaseGenerator.h"
+#include "TestUtils.h"
+
+using namespace mkc_searchalgo;
+using namespace mkc_timeseries;
+
+namespace {
+
+  template <class TLhs, class TRhs>
+  void requireSameMatrix(TLhs& lhs, TRhs& rhs)
+  {
+    const std::valarray<DecimalType>& lhsResults = lhs.getBacktestResultBase();
+    const std::valarray<DecimalType>& rhsResults = rhs.getBacktestResultBase();
+    const std::valarray<unsigned int>& lhsBars = lhs.getBacktestNumBarsInPosition();
+    const std::valarray<unsigned int>& rhsBars = rhs.getBacktestNumBarsInPosition();
+
+    REQUIRE (lhsResults.size() == rhsResults.size());
+    REQUIRE (lhsBars.size() == rhsBars.size());
+    for (size_t i = 0; i < lhsResults.size(); ++i)
+      {
+        REQUIRE (lhsResults[i] == rhsResults[i]);
+        REQUIRE (lhsBars[i] == rhsBars[i]);
+      }
+
+    REQUIRE (lhs.getTradeOutcomes()->size() == rhs.getTradeOutcomes()->size());
+    REQUIRE (lhs.getTradeOutcomes()->getTradeMask() == rhs.getTradeOutcomes()->getTradeMask());
+  }
+
+  template <bool isLong>
+  void checkBacktestMatrix(const std::shared_ptr<const McptConfiguration<DecimalType>>& configuration,
+                           const std::shared_ptr<const OHLCTimeSeries<DecimalType>>& series)
+  {
+    auto profitTarget = std::make_shared<DecimalType>("2.0");
+    auto stopLoss = std::make_shared<DecimalType>("1.0");
+    concurrency::SingleThreadExecutor serialExecutor;
+    concurrency::WorkStealingExecutor<> executor;
+
+    BacktestResultBaseGenerator<DecimalType, isLong, concurrency::SingleThreadExecutor> serial(configuration, series, profitTarget, stopLoss, false, serialExecutor);
+    BacktestResultBaseGenerator<DecimalType, isLong> parallel(configuration, series, profitTarget, stopLoss, false, executor);
+
+    // one position per bar of the in-sample and out-of-sample range, except the first bar of the series
+    const std::valarray<DecimalType>& results = serial.getBacktestResultBase();
+    const std::valarray<unsigned int>& numBarsInPosition = serial.getBacktestNumBarsInPosition();
+    REQUIRE (results.size() == series->getNumEntries() - 1);
+
+    unsigned int trades = 0;
+    for (size_t i = 0; i < results.size(); ++i)
+      if (results[i] != DecimalConstants<DecimalType>::DecimalZero)
+        {
+          trades++;
+          REQUIRE (numBarsInPosition[i] >= 1);
+        }
+    REQUIRE (trades > results.size() / 2);
+
+    requireSameMatrix(serial, parallel);
+
+    SECTION ("A matrix loaded from the cache is the one built")
+      {
+        const boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("palbtm-%%%%-%%%%");
+        boost::filesystem::create_directories(directory);
+
+        BacktestResultBaseGenerator<DecimalType, isLong> stored(configuration, series, profitTarget, stopLoss, false, executor);
+        stored.setCacheDirectory(directory.string());
+        stored.buildBacktestMatrix();
+        REQUIRE (std::distance(boost::filesystem::directory_iterator(directory), boost::filesystem::directory_iterator()) == 1);
+
+        BacktestResultBaseGenerator<DecimalType, isLong> loaded(configuration, series, profitTarget, stopLoss, false, executor);
+        loaded.setCacheDirectory(directory.string());
+        loaded.buildBacktestMatrix();
+        requireSameMatrix(serial, loaded);
+
+        // another target is another matrix
+        BacktestResultBaseGenerator<DecimalType, isLong> otherTarget(configuration, series, std::make_shared<DecimalType>("3.0"), stopLoss, false, executor);
+        otherTarget.setCacheDirectory(directory.string());
+        otherTarget.buildBacktestMatrix();
+        REQUIRE (std::distance(boost::filesystem::directory_iterator(directory), boost::filesystem::directory_iterator()) == 2);
+
+        boost::filesystem::remove_all(directory);
+      }
+
+    SECTION ("In-sample only stops at the in-sample range")
+      {
+        BacktestResultBaseGenerator<DecimalType, isLong> inSample(configuration, series, profitTarget, stopLoss, true, executor);
+        // the in-sample range holds the first 80 bars
+        REQUIRE (inSample.getBacktestResultBase().size() == 79);
+      }
+  }
+}
+
+TEST_CASE ("BacktestResultBaseGenerator builds the same matrix serially, in parallel and from the cache", "[BacktestResultBaseGenerator]")
+{
+  auto series = createRandomWalkSeries(120);
+  // the broker looks the tick up by symbol, so the series trades under a known one
+  auto security = std::make_shared<EquitySecurity<DecimalType>>("SPY", "Random walk", series);
+  const DateRange inSample(series->getFirstDate(), (series->beginRandomAccess() + 79)->getDateValue());
+  const DateRange outOfSample((series->beginRandomAccess() + 80)->getDateValue(), series->getLastDate());
+  auto configuration = std::make_shared<const McptConfiguration<DecimalType>>(nullptr, nullptr, security, nullptr, inSample, outOfSample, "");
+
+  SECTION ("Long side")
+    {
+      checkBacktestMatrix<true>(configuration, series);
+    }
+
+  SECTION ("Short side")
+    {
+      checkBacktestMatrix<false>(configuration, series);
+    }
+}
@@ -0,0 +1,127 @@
+// ComparisonsGeneratorTest.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "number.h"
+#include "ComparisonsGenerator.h"
+#include "TestUtils.h"
+
+using namespace mkc_searchalgo;
+
+namespace {
+
+  using Bar = std::array<DecimalType, ComparisonsGenerator<DecimalType>::NumFields>;
+
+  /// bars on a coarse grid, so that many fields compare equal
+  std::vector<Bar> createCoarseBars(unsigned int numBars, TestRandom& random)
+  {
+    std::vector<Bar> bars;
+    for (unsigned int i = 0; i < numBars; ++i)
+      {
+        const DecimalType open(100 + static_cast<int>(random.nextBelow(5)));
+        const DecimalType close(100 + static_cast<int>(random.nextBelow(5)));
+        const DecimalType high = std::max(open, close) + DecimalType(static_cast<int>(random.nextBelow(3)));
+        const DecimalType low = std::min(open, close) - DecimalType(static_cast<int>(random.nextBelow(3)));
+        bars.push_back(Bar{{open, high, low, close}});
+      }
+    return bars;
+  }
+
+  std::vector<unsigned int> getFields(ComparisonType comparisonType)
+  {
+    switch (comparisonType)
+      {
+      case ComparisonType::CloseOnly: return {3};
+      case ComparisonType::OpenClose: return {0, 3};
+      case ComparisonType::HighLow:   return {1, 2};
+      default:                        return {0, 1, 2, 3};
+      }
+  }
+
+  /// whether comparison holds on date, straight from the bars
+  bool holds(const std::vector<Bar>& bars, const std::vector<unsigned int>& fields, unsigned int maxLookBack,
+             const ComparisonEntryType& comparison, unsigned int date)
+  {
+    const auto isSearched = [&fields](unsigned int field) { return std::find(fields.begin(), fields.end(), field) != fields.end(); };
+    if (comparison[0] == comparison[2] || std::max(comparison[0], comparison[2]) >= maxLookBack
+        || !isSearched(comparison[1]) || !isSearched(comparison[3]))
+      return false;
+    if (comparison[0] > date || comparison[2] > date)
+      return false;
+    return bars[date - comparison[0]][comparison[1]] > bars[date - comparison[2]][comparison[3]];
+  }
+}
+
+TEST_CASE ("ComparisonsGenerator matches a brute force bar pair comparator", "[ComparisonsGenerator]")
+{
+  TestRandom random(43);
+  const unsigned int numBars = 70;
+  const std::vector<Bar> bars = createCoarseBars(numBars, random);
+
+  for (ComparisonType comparisonType: {ComparisonType::CloseOnly, ComparisonType::OpenClose, ComparisonType::HighLow, ComparisonType::Ohlc})
+    for (unsigned int maxLookBack = 1; maxLookBack <= 6; ++maxLookBack)
+      {
+        const std::vector<unsigned int> fields = getFields(comparisonType);
+        ComparisonsGenerator<DecimalType> generator(maxLookBack, comparisonType);
+        for (const Bar& bar: bars)
+          generator.addNewLastBar(bar[0], bar[1], bar[2], bar[3]);
+        REQUIRE (generator.getDateIndexCount() == numBars);
+
+        // every bar is compared once with each older bar of its window, on each pair of searched fields
+        unsigned int comparisonsCount = 0;
+        for (unsigned int date = 0; date < numBars; ++date)
+          for (unsigned int offset = 1; offset < maxLookBack && offset <= date; ++offset)
+            for (unsigned int newField: fields)
+              for (unsigned int oldField: fields)
+                comparisonsCount += bars[date][newField] != bars[date - offset][oldField];
+        REQUIRE (generator.getComparisonsCount() == comparisonsCount);
+
+        // the whole comparison space, in ascending order
+        std::vector<ComparisonEntryType> expectedUniques;
+        for (unsigned int fOffset = 0; fOffset < maxLookBack; ++fOffset)
+          for (unsigned int fField = 0; fField < 4; ++fField)
+            for (unsigned int sOffset = 0; sOffset < maxLookBack; ++sOffset)
+              for (unsigned int sField = 0; sField < 4; ++sField)
+                {
+                  const ComparisonEntryType comparison {fOffset, fField, sOffset, sField};
+                  const OccurrenceBitset occurrences = generator.getOccurrences(comparison);
+                  REQUIRE (occurrences.size() == numBars);
+
+                  bool holdsOnce = false;
+                  for (unsigned int date = 0; date < numBars; ++date)
+                    {
+                      const bool expected = holds(bars, fields, maxLookBack, comparison, date);
+                      REQUIRE (occurrences.test(date) == expected);
+                      holdsOnce = holdsOnce || expected;
+                    }
+                  if (holdsOnce)
+                    expectedUniques.push_back(comparison);
+                }
+
+        REQUIRE (generator.getUniqueComparisons() == expectedUniques);
+        if (maxLookBack == 1)
+          REQUIRE (expectedUniques.empty());
+      }
+}
+
+TEST_CASE ("ComparisonsGenerator uniques exclude comparisons only holding after the last bar", "[ComparisonsGenerator]")
+{
+  // Closes 10, 8, 9: "close of 1 bar ago > close of 2 bars ago" (9 > 8) would first hold on the date after the last bar
+  ComparisonsGenerator<DecimalType> generator(3, ComparisonType::CloseOnly);
+  for (int close: {10, 8, 9})
+    generator.addNewLastBar(DecimalType(close), DecimalType(close), DecimalType(close), DecimalType(close));
+
+  const ComparisonEntryType nextDateOnly {1, 3, 2, 3};
+  const std::vector<ComparisonEntryType> expected {{0, 3, 1, 3}, {1, 3, 0, 3}, {2, 3, 0, 3}, {2, 3, 1, 3}};
+  REQUIRE (generator.getUniqueComparisons() == expected);
+  REQUIRE (generator.getOccurrences(nextDateOnly).count() == 0);
+
+  // it becomes unique once that date is added
+  generator.addNewLastBar(DecimalType(7), DecimalType(7), DecimalType(7), DecimalType(7));
+  const std::vector<ComparisonEntryType> uniques = generator.getUniqueComparisons();
+  REQUIRE (std::find(uniques.begin(), uniques.end(), nextDateOnly) != uniques.end());
+  REQUIRE (generator.getOccurrences(nextDateOnly).count() == 1);
+  REQUIRE (generator.getOccurrences(nextDateOnly).test(3));
+}
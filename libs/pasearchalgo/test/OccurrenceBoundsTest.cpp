@@ -0,0 +1,192 @@
+// OccurrenceBoundsTest.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <map>
+#include <valarray>
+#include <vector>
+#include "ShortcutSearchAlgoBacktester.h"
+#include "BacktestProcessor.h"
+#include "OccurrenceBounds.h"
+#include "TestUtils.h"
+
+using namespace mkc_searchalgo;
+
+namespace {
+
+  using Backtester = ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::PlainVanilla>;
+  using Processor = BacktestProcessor<DecimalType, Backtester, OccurrenceBitset>;
+  using Matrix = UniqueSinglePAMatrix<DecimalType, OccurrenceBitset>;
+
+  std::shared_ptr<const SearchAlgoConfiguration<DecimalType>> makeSearchConfiguration(unsigned int minTrades)
+  {
+    return std::make_shared<SearchAlgoConfiguration<DecimalType>>(2, minTrades, DecimalType("0.5"), 20, DecimalType("1.5"), 4, 1000,
+                                                                  std::vector<std::pair<DecimalType, DecimalType>>(),
+                                                                  std::vector<boost::posix_time::time_duration>(),
+                                                                  std::shared_ptr<OHLCTimeSeries<DecimalType>>(),
+                                                                  1000, 5, 5, DecimalType("0.8"), DecimalType("1.0"), DecimalType("1.0"));
+  }
+
+  OccurrenceBitset makeOccurrences(size_t size, std::initializer_list<size_t> dates)
+  {
+    OccurrenceBitset occurrences(size);
+    for (size_t date: dates)
+      occurrences.set(date);
+    return occurrences;
+  }
+}
+
+TEST_CASE ("Pruned candidates could never pass the activity filters or win", "[OccurrenceBounds]")
+{
+  // 10 dates, one bar in position each: winners on 1 and 5, losers on 3, 7 and 9
+  std::valarray<DecimalType> results(DecimalConstants<DecimalType>::DecimalZero, 10);
+  const std::valarray<unsigned int> numBarsInPosition(1u, 10);
+  results[1] = DecimalType(2);
+  results[5] = DecimalType(1);
+  results[3] = DecimalType(-1);
+  results[7] = DecimalType(-1);
+  results[9] = DecimalType(-2);
+
+  const unsigned int minTrades = 3;
+  const OccurrenceBounds<DecimalType, OccurrenceBitset> bounds(results);
+  std::shared_ptr<Matrix> noMatrix;
+  auto backtester = std::make_shared<Backtester>(results, numBarsInPosition, minTrades, true);
+  Processor processor(makeSearchConfiguration(minTrades), backtester, noMatrix);
+  processor.setPruningBounds(std::make_shared<const OccurrenceBounds<DecimalType, OccurrenceBitset>>(results));
+
+  SECTION ("Fewer possible trades than the minimum")
+    {
+      // 4 occurrences, but only 1 and 3 are trades
+      const OccurrenceBitset occurrences = makeOccurrences(10, {0, 1, 2, 3});
+      REQUIRE (bounds.maxTrades(occurrences) == 2);
+
+      backtester->backtest(occurrences);
+      REQUIRE (backtester->getTradeNumber() < minTrades);
+
+      processor.processResult({0, 1}, occurrences);
+      REQUIRE (processor.getNumPruned() == 1);
+      REQUIRE (processor.getResults().empty());
+    }
+
+  SECTION ("No possible winner")
+    {
+      const OccurrenceBitset occurrences = makeOccurrences(10, {3, 7, 8, 9});
+      REQUIRE (bounds.maxTrades(occurrences) == 3);
+      REQUIRE_FALSE (bounds.hasPossibleWinners(occurrences));
+
+      // enough trades, but a profit factor of 0 that no stepping or survival policy passes on
+      backtester->backtest(occurrences);
+      REQUIRE (backtester->getTradeNumber() == minTrades);
+      REQUIRE (backtester->getProfitFactor() == DecimalConstants<DecimalType>::DecimalZero);
+
+      processor.processResult({0, 1}, occurrences);
+      REQUIRE (processor.getNumPruned() == 1);
+      REQUIRE (processor.getResults().empty());
+    }
+
+  SECTION ("A candidate at the boundary is backtested")
+    {
+      // exactly minTrades possible trades, one of them a winner
+      const OccurrenceBitset occurrences = makeOccurrences(10, {1, 3, 7});
+      REQUIRE (bounds.maxTrades(occurrences) == minTrades);
+      REQUIRE (bounds.hasPossibleWinners(occurrences));
+
+      processor.processResult({0, 1}, occurrences);
+      REQUIRE (processor.getNumPruned() == 0);
+      REQUIRE (processor.getResults().size() == 1);
+      REQUIRE (std::get<0>(processor.getResults().front()).Trades == minTrades);
+      REQUIRE (std::get<0>(processor.getResults().front()).ProfitFactor == DecimalType(1));
+    }
+}
+
+TEST_CASE ("Occurrence bounds hold for random strategies and their descendants", "[OccurrenceBounds]")
+{
+  TestRandom random(31);
+  auto generator = createRandomWalkComparisons(4, ComparisonType::Ohlc, 500);
+  const unsigned int dateCount = generator->getDateIndexCount();
+  auto bitsetMatrix = std::make_shared<Matrix>(generator, dateCount);
+  UniqueSinglePAMatrix<DecimalType, std::valarray<DecimalType>> valarrayMatrix(generator, dateCount);
+  const unsigned int numComparisons = static_cast<unsigned int>(bitsetMatrix->getMapSize());
+
+  const RandomResultBase base(dateCount, 8, random);
+  const OccurrenceBounds<DecimalType, OccurrenceBitset> bitsetBounds(base.mResults);
+  const OccurrenceBounds<DecimalType> valarrayBounds(base.mResults);
+  Backtester plainVanilla(base.mResults, base.mNumBarsInPosition, 0, true);
+  ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::Pyramiding> pyramiding(base.mResults, base.mNumBarsInPosition, 0, true);
+
+  OccurrenceBitset parent, child;
+  std::valarray<DecimalType> valarrayParent;
+  for (unsigned int trial = 0; trial < 200; ++trial)
+    {
+      std::vector<unsigned int> elements;
+      const unsigned int depth = 1 + random.nextBelow(3);
+      for (unsigned int d = 0; d < depth; ++d)
+        elements.push_back(random.nextBelow(numComparisons));
+
+      bitsetMatrix->combineElements(elements, parent);
+      valarrayMatrix.combineElements(elements, valarrayParent);
+      const unsigned int maxTrades = bitsetBounds.maxTrades(parent);
+      REQUIRE (valarrayBounds.maxTrades(valarrayParent) == maxTrades);
+      REQUIRE (valarrayBounds.hasPossibleWinners(valarrayParent) == bitsetBounds.hasPossibleWinners(parent));
+
+      // Pyramiding takes every possible trade, PlainVanilla at most that many
+      plainVanilla.backtest(parent);
+      pyramiding.backtest(parent);
+      REQUIRE (pyramiding.getTradeNumber() == maxTrades);
+      REQUIRE (plainVanilla.getTradeNumber() <= maxTrades);
+      if (!bitsetBounds.hasPossibleWinners(parent))
+        {
+          REQUIRE (plainVanilla.getProfitFactor() == DecimalConstants<DecimalType>::DecimalZero);
+          REQUIRE (pyramiding.getProfitFactor() == DecimalConstants<DecimalType>::DecimalZero);
+        }
+
+      // Extending a strategy never raises its bounds
+      bitsetMatrix->extendElements(parent, random.nextBelow(numComparisons), child);
+      REQUIRE (bitsetBounds.maxTrades(child) <= maxTrades);
+      if (!bitsetBounds.hasPossibleWinners(parent))
+        REQUIRE_FALSE (bitsetBounds.hasPossibleWinners(child));
+    }
+}
+
+TEST_CASE ("Pruning only drops results with too few trades or no winner", "[OccurrenceBounds]")
+{
+  TestRandom random(37);
+  auto generator = createRandomWalkComparisons(4, ComparisonType::Ohlc, 400);
+  const unsigned int dateCount = generator->getDateIndexCount();
+  auto singlePa = std::make_shared<Matrix>(generator, dateCount);
+  const unsigned int numComparisons = static_cast<unsigned int>(singlePa->getMapSize());
+
+  const RandomResultBase base(dateCount, 6, random);
+  const unsigned int minTrades = 15;
+  auto searchConfiguration = makeSearchConfiguration(minTrades);
+
+  auto prunedBacktester = std::make_shared<Backtester>(base.mResults, base.mNumBarsInPosition, minTrades, true);
+  Processor pruned(searchConfiguration, prunedBacktester, singlePa);
+  pruned.setPruningBounds(std::make_shared<const OccurrenceBounds<DecimalType, OccurrenceBitset>>(base.mResults));
+
+  auto fullBacktester = std::make_shared<Backtester>(base.mResults, base.mNumBarsInPosition, minTrades, true);
+  Processor full(searchConfiguration, fullBacktester, singlePa);
+
+  for (unsigned int i = 0; i < numComparisons; ++i)
+    for (unsigned int c = 0; c < numComparisons; ++c)
+      if (i != c)
+        {
+          pruned.processResult({i, c});
+          full.processResult({i, c});
+        }
+
+  REQUIRE (pruned.getNumPruned() > 0);
+
+  // results with a profit factor of 0 are never passed on, so only these need to be the same
+  std::map<std::vector<unsigned int>, DecimalType> expected;
+  for (const auto& result: full.getResults())
+    if (std::get<0>(result).ProfitFactor != DecimalConstants<DecimalType>::DecimalZero)
+      expected[full.getStrategyMap().at(std::get<2>(result))] = std::get<0>(result).ProfitFactor;
+
+  std::map<std::vector<unsigned int>, DecimalType> kept;
+  for (const auto& result: pruned.getResults())
+    if (std::get<0>(result).ProfitFactor != DecimalConstants<DecimalType>::DecimalZero)
+      kept[pruned.getStrategyMap().at(std::get<2>(result))] = std::get<0>(result).ProfitFactor;
+
+  REQUIRE_FALSE (expected.empty());
+  REQUIRE (kept == expected);
+}
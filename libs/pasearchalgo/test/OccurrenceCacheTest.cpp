@@ -0,0 +1,136 @@
+// OccurrenceCacheTest.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <valarray>
+#include <vector>
+#include "number.h"
+#include "OccurrenceCache.h"
+#include "UniqueSinglePAMatrix.h"
+#include "TestUtils.h"
+
+using namespace mkc_searchalgo;
+
+TEST_CASE ("OccurrenceCache evicts the least recently used entry", "[OccurrenceCache]")
+{
+  using Key = OccurrenceCache<std::string>::KeyType;
+  const Key a {1, 2}, b {1, 3}, c {2, 3};
+
+  OccurrenceCache<std::string> cache(2);
+  REQUIRE (cache.getCapacity() == 2);
+
+  cache.insert(a, "a");
+  cache.insert(b, "b");
+  REQUIRE (cache.size() == 2);
+
+  // a becomes the most recently used, so c evicts b
+  REQUIRE (*cache.find(a) == "a");
+  cache.insert(c, "c");
+  REQUIRE (cache.size() == 2);
+  REQUIRE (cache.find(b) == nullptr);
+  REQUIRE (*cache.find(a) == "a");
+  REQUIRE (*cache.find(c) == "c");
+  REQUIRE (cache.getHits() == 3);
+  REQUIRE (cache.getMisses() == 1);
+
+  SECTION ("Inserting a cached key replaces it without evicting")
+    {
+      cache.insert(c, "c2");
+      REQUIRE (cache.size() == 2);
+      REQUIRE (*cache.find(a) == "a");
+      REQUIRE (*cache.find(c) == "c2");
+    }
+
+  SECTION ("Found entries are refreshed")
+    {
+      // c was found last, so b evicts a
+      cache.insert(b, "b");
+      REQUIRE (cache.find(a) == nullptr);
+      REQUIRE (*cache.find(c) == "c");
+      REQUIRE (cache.getMisses() == 2);
+    }
+
+  SECTION ("clear empties the cache")
+    {
+      cache.clear();
+      REQUIRE (cache.size() == 0);
+      REQUIRE (cache.find(a) == nullptr);
+    }
+}
+
+TEST_CASE ("OccurrenceCache of capacity 0 caches nothing", "[OccurrenceCache]")
+{
+  OccurrenceCache<std::string> cache(0);
+  REQUIRE (cache.insert({1, 2}, "a") == "a");
+  REQUIRE (cache.size() == 0);
+  REQUIRE (cache.find({1, 2}) == nullptr);
+  REQUIRE (cache.getMisses() == 1);
+}
+
+TEST_CASE ("OccurrenceCache derives a strategy from its cached prefix", "[OccurrenceCache]")
+{
+  auto generator = createRandomWalkComparisons(4, ComparisonType::Ohlc, 300);
+  const UniqueSinglePAMatrix<DecimalType, OccurrenceBitset> singlePa(generator, generator->getDateIndexCount());
+  REQUIRE (singlePa.getMapSize() > 10);
+
+  auto combined = [&singlePa](const std::vector<unsigned int>& strat)
+  {
+    OccurrenceBitset occurrences;
+    singlePa.combineElements(strat, occurrences);
+    return occurrences;
+  };
+
+  OccurrenceCache<OccurrenceBitset> cache(4);
+
+  // Depth 2: extended from the single comparison, one miss
+  const std::vector<unsigned int> parent {0, 5};
+  REQUIRE (cache.findOrDerive(parent, singlePa) == combined(parent));
+  REQUIRE (cache.getHits() == 0);
+  REQUIRE (cache.getMisses() == 1);
+
+  // Found the second time
+  REQUIRE (&cache.findOrDerive(parent, singlePa) == cache.find(parent));
+  REQUIRE (cache.getHits() == 2);
+
+  SECTION ("A child of a cached parent is extended from the parent")
+    {
+      const std::vector<unsigned int> child {0, 5, 9};
+      const unsigned long hits = cache.getHits();
+      REQUIRE (cache.findOrDerive(child, singlePa) == combined(child));
+      // miss on the child, hit on its prefix
+      REQUIRE (cache.getHits() == hits + 1);
+
+      const std::vector<unsigned int> grandChild {0, 5, 9, 2};
+      REQUIRE (cache.findOrDerive(grandChild, singlePa) == combined(grandChild));
+      REQUIRE (cache.getHits() == hits + 2);
+      REQUIRE (cache.size() == 3);
+    }
+
+  SECTION ("A child whose parent was evicted is combined from scratch")
+    {
+      for (unsigned int other = 1; other <= 4; ++other)
+        cache.findOrDerive({other, 7}, singlePa);
+      REQUIRE (cache.find(parent) == nullptr);
+
+      const std::vector<unsigned int> child {0, 5, 9};
+      const unsigned long misses = cache.getMisses();
+      REQUIRE (cache.findOrDerive(child, singlePa) == combined(child));
+      // miss on the child and on its prefix
+      REQUIRE (cache.getMisses() == misses + 2);
+    }
+}
+
+TEST_CASE ("OccurrenceCache derives valarray occurrences like combineElements", "[OccurrenceCache]")
+{
+  auto generator = createRandomWalkComparisons(3, ComparisonType::HighLow, 150);
+  const UniqueSinglePAMatrix<DecimalType, std::valarray<DecimalType>> singlePa(generator, generator->getDateIndexCount());
+  REQUIRE (singlePa.getMapSize() > 3);
+
+  OccurrenceCache<std::valarray<DecimalType>> cache(2);
+  for (const std::vector<unsigned int>& strat: std::vector<std::vector<unsigned int>>{{0, 1}, {0, 1, 2}, {0, 1, 2, 3}, {1, 3, 0}})
+    {
+      std::valarray<DecimalType> expected;
+      singlePa.combineElements(strat, expected);
+      REQUIRE ((cache.findOrDerive(strat, singlePa) == expected).min());
+    }
+}
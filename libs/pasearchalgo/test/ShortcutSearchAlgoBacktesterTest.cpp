@@ -0,0 +1,204 @@
+// ShortcutSearchAlgoBacktesterTest.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <valarray>
+#include <vector>
+#include "ShortcutSearchAlgoBacktester.h"
+#include "TradeOutcomeTable.h"
+#include "UniqueSinglePAMatrix.h"
+#include "TestUtils.h"
+
+using namespace mkc_searchalgo;
+
+namespace {
+
+  template <ShortcutBacktestMethod Method>
+  void requireSameResultStat(const ShortcutSearchAlgoBacktester<DecimalType, Method>& lhs,
+                             const ShortcutSearchAlgoBacktester<DecimalType, Method>& rhs)
+  {
+    REQUIRE (lhs.getTradeNumber() == rhs.getTradeNumber());
+    REQUIRE (lhs.getProfitFactor() == rhs.getProfitFactor());
+    REQUIRE (lhs.getPayoffRatio() == rhs.getPayoffRatio());
+    REQUIRE (lhs.getPercentWinners() == rhs.getPercentWinners());
+    REQUIRE (lhs.getPALProfitability() == rhs.getPALProfitability());
+    REQUIRE (lhs.getAverageWinningTrade() == rhs.getAverageWinningTrade());
+    REQUIRE (lhs.getAverageLosingTrade() == rhs.getAverageLosingTrade());
+    REQUIRE (lhs.getMaxConsecutiveLosers() == rhs.getMaxConsecutiveLosers());
+    REQUIRE (lhs.getMaxInactivitySpan() == rhs.getMaxInactivitySpan());
+  }
+}
+
+TEST_CASE ("PlainVanilla bitset backtest skips the bars of an open position", "[ShortcutSearchAlgoBacktester]")
+{
+  // 70 dates: trades on 0, 1, 2, 5, 62, 64 and 66; the position entered on 62 covers 62..65
+  std::valarray<DecimalType> results(DecimalConstants<DecimalType>::DecimalZero, 70);
+  std::valarray<unsigned int> numBarsInPosition(1u, 70);
+  for (size_t i: {0, 1, 2, 5, 62, 64, 66})
+    results[i] = DecimalType(1);
+  results[5] = DecimalType(-2);
+  numBarsInPosition[0] = 3;
+  numBarsInPosition[62] = 4;
+
+  OccurrenceBitset occurrences(70);
+  for (size_t i: {0, 1, 2, 3, 5, 62, 64, 66})
+    occurrences.set(i);
+
+  ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::PlainVanilla> bitsetBacktester(results, numBarsInPosition, 0, true);
+  ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::PlainVanilla> valarrayBacktester(results, numBarsInPosition, 0, true);
+  bitsetBacktester.backtest(occurrences);
+  valarrayBacktester.backtest(toValarray(occurrences));
+
+  // 1 and 2 fall inside the position entered on 0, 64 inside the one entered on 62, 3 is no trade
+  REQUIRE (bitsetBacktester.getTradeNumber() == 4);
+  REQUIRE (bitsetBacktester.getProfitFactor() == DecimalType("1.5"));
+  REQUIRE (bitsetBacktester.getMaxConsecutiveLosers() == 1);
+  REQUIRE (bitsetBacktester.getMaxInactivitySpan() == 57);
+  requireSameResultStat(bitsetBacktester, valarrayBacktester);
+
+  ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::Pyramiding> pyramiding(results, numBarsInPosition, 0, true);
+  pyramiding.backtest(occurrences);
+  REQUIRE (pyramiding.getTradeNumber() == 7);
+}
+
+TEST_CASE ("Bitset backtests of matrix strategies match the valarray backtests", "[ShortcutSearchAlgoBacktester]")
+{
+  TestRandom random(23);
+
+  for (unsigned int numBars: {130u, 201u, 1000u})
+    {
+      auto generator = createRandomWalkComparisons(4, ComparisonType::Ohlc, numBars, numBars);
+      const unsigned int dateCount = generator->getDateIndexCount();
+      UniqueSinglePAMatrix<DecimalType, std::valarray<DecimalType>> valarrayMatrix(generator, dateCount);
+      UniqueSinglePAMatrix<DecimalType, OccurrenceBitset> bitsetMatrix(generator, dateCount);
+      const unsigned int numComparisons = static_cast<unsigned int>(bitsetMatrix.getMapSize());
+
+      const RandomResultBase base(dateCount, 12, random);
+      ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::PlainVanilla> plainBitset(base.mResults, base.mNumBarsInPosition, 3, true);
+      ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::PlainVanilla> plainValarray(base.mResults, base.mNumBarsInPosition, 3, true);
+      ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::Pyramiding> pyramidingBitset(base.mResults, base.mNumBarsInPosition, 3, true);
+      ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::Pyramiding> pyramidingValarray(base.mResults, base.mNumBarsInPosition, 3, true);
+
+      OccurrenceBitset bitsetOccurrences;
+      std::valarray<DecimalType> valarrayOccurrences;
+      for (unsigned int trial = 0; trial < 100; ++trial)
+        {
+          std::vector<unsigned int> elements;
+          const unsigned int depth = random.nextBelow(4);
+          for (unsigned int d = 0; d < depth; ++d)
+            elements.push_back(random.nextBelow(numComparisons));
+
+          bitsetMatrix.combineElements(elements, bitsetOccurrences);
+          valarrayMatrix.combineElements(elements, valarrayOccurrences);
+
+          plainBitset.backtest(bitsetOccurrences);
+          plainValarray.backtest(valarrayOccurrences);
+          requireSameResultStat(plainBitset, plainValarray);
+
+          pyramidingBitset.backtest(bitsetOccurrences);
+          pyramidingValarray.backtest(valarrayOccurrences);
+          requireSameResultStat(pyramidingBitset, pyramidingValarray);
+        }
+    }
+}
+
+TEST_CASE ("TradeOutcomeTable holds the fixed-point returns and strides", "[TradeOutcomeTable]")
+{
+  std::valarray<DecimalType> results(DecimalConstants<DecimalType>::DecimalZero, 5);
+  results[1] = DecimalType("1.25");
+  results[3] = DecimalType("-0.0000001");
+  results[4] = DecimalType("-3");
+  const std::valarray<unsigned int> numBarsInPosition {2, 0, 1, 5, 0};
+
+  const TradeOutcomeTable<DecimalType> outcomes(results, numBarsInPosition);
+  REQUIRE (outcomes.size() == 5);
+  REQUIRE (outcomes.getTradeMask().count() == 3);
+  REQUIRE_FALSE (outcomes.getTradeMask().test(0));
+  REQUIRE (outcomes.getTradeMask().test(3));
+
+  for (size_t i = 0; i < outcomes.size(); ++i)
+    {
+      REQUIRE (TradeOutcomeTable<DecimalType>::toDecimal(outcomes.returns()[i]) == results[i]);
+      REQUIRE (outcomes.strides()[i] == std::max(numBarsInPosition[i], 1u));
+    }
+
+  REQUIRE_THROWS_AS (TradeOutcomeTable<DecimalType>(results, std::valarray<unsigned int>(1u, 4)), std::invalid_argument);
+}
+
+TEST_CASE ("Integer kernel matches the valarray backtest on random tables", "[ShortcutSearchAlgoBacktester]")
+{
+  TestRandom random(29);
+
+  for (size_t numDates: {1, 63, 64, 65, 130, 1000})
+    {
+      // about half the returns are 0, and bars in position include 0
+      const RandomResultBase base(numDates, 9, random);
+      auto outcomes = std::make_shared<const TradeOutcomeTable<DecimalType>>(base.mResults, base.mNumBarsInPosition);
+
+      ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::PlainVanilla> plainKernel(base.mResults, base.mNumBarsInPosition, outcomes, 2, true);
+      ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::PlainVanilla> plainValarray(base.mResults, base.mNumBarsInPosition, 2, true);
+      ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::Pyramiding> pyramidingKernel(base.mResults, base.mNumBarsInPosition, outcomes, 2, true);
+      ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::Pyramiding> pyramidingValarray(base.mResults, base.mNumBarsInPosition, 2, true);
+
+      for (unsigned int percentSet: {0u, 5u, 30u, 70u, 100u})
+        for (unsigned int trial = 0; trial < 20; ++trial)
+          {
+            const OccurrenceBitset occurrences = createRandomBitset(numDates, percentSet, random);
+            const std::valarray<DecimalType> valarrayOccurrences = toValarray(occurrences);
+
+            plainKernel.backtest(occurrences);
+            plainValarray.backtest(valarrayOccurrences);
+            requireSameResultStat(plainKernel, plainValarray);
+
+            pyramidingKernel.backtest(occurrences);
+            pyramidingValarray.backtest(valarrayOccurrences);
+            requireSameResultStat(pyramidingKernel, pyramidingValarray);
+          }
+    }
+
+  // the shared table must describe the same dates as the backtest results
+  const RandomResultBase base(10, 3, random);
+  auto outcomes = std::make_shared<const TradeOutcomeTable<DecimalType>>(std::valarray<DecimalType>(11), std::valarray<unsigned int>(11));
+  REQUIRE_THROWS_AS ((ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::PlainVanilla>(base.mResults, base.mNumBarsInPosition, outcomes, 2, true)),
+                     ShortcutBacktestException);
+}
+
+TEST_CASE ("Shortcut backtester benchmark", "[.][benchmark][ShortcutSearchAlgoBacktester]")
+{
+  TestRandom random(41);
+  const size_t numDates = 5000;
+  const RandomResultBase base(numDates, 5, random);
+
+  std::vector<OccurrenceBitset> strategies;
+  std::vector<std::valarray<DecimalType>> valarrayStrategies;
+  for (unsigned int i = 0; i < 100; ++i)
+    {
+      strategies.push_back(createRandomBitset(numDates, 10, random));
+      valarrayStrategies.push_back(toValarray(strategies.back()));
+    }
+
+  ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::PlainVanilla> backtester(base.mResults, base.mNumBarsInPosition, 0, true);
+
+  // Each run backtests 100 strategies over 5000 dates
+  BENCHMARK ("PlainVanilla valarray backtest")
+    {
+      unsigned int trades = 0;
+      for (const std::valarray<DecimalType>& occurrences: valarrayStrategies)
+        {
+          backtester.backtest(occurrences);
+          trades += backtester.getTradeNumber();
+        }
+      return trades;
+    };
+
+  BENCHMARK ("PlainVanilla integer kernel backtest")
+    {
+      unsigned int trades = 0;
+      for (const OccurrenceBitset& occurrences: strategies)
+        {
+          backtester.backtest(occurrences);
+          trades += backtester.getTradeNumber();
+        }
+      return trades;
+    };
+}
@@ -0,0 +1,145 @@
+// SteppingPolicyTest.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include "number.h"
+#include "SteppingPolicy.h"
+#include "ParallelExecutors.h"
+#include "TestUtils.h"
+
+using namespace mkc_searchalgo;
+
+namespace {
+
+  ///
+  /// Stand-in for the shortcut backtester: every occurrence is a trade, which wins on the
+  /// dates set in the winners bitset (at a 2:1 target/stop).
+  ///
+  class WinnerDatesBacktester
+  {
+  public:
+    explicit WinnerDatesBacktester(const OccurrenceBitset& winners):
+      mWinners(winners),
+      mTrades(0),
+      mWinningTrades(0)
+    {}
+
+    void backtest(const OccurrenceBitset& occurrences)
+    {
+      mTrades = static_cast<unsigned int>(occurrences.count());
+      mWinningTrades = static_cast<unsigned int>(occurrences.countIntersection(mWinners));
+    }
+
+    unsigned int getTradeNumber() const { return mTrades; }
+
+    unsigned int getMaxInactivitySpan() const { return 0; }
+
+    unsigned int getMaxConsecutiveLosers() const { return 0; }
+
+    DecimalType getProfitFactor() const
+    {
+      if (mWinningTrades == 0)
+        return DecimalConstants<DecimalType>::DecimalZero;
+      if (mWinningTrades == mTrades)
+        return DecimalConstants<DecimalType>::DecimalOneHundred;
+      return DecimalType(2 * mWinningTrades) / DecimalType(mTrades - mWinningTrades);
+    }
+
+    DecimalType getPayoffRatio() const { return DecimalType(2); }
+
+    DecimalType getPercentWinners() const
+    {
+      return (mTrades == 0)? DecimalConstants<DecimalType>::DecimalZero:
+                             DecimalType(mWinningTrades) * DecimalConstants<DecimalType>::DecimalOneHundred / DecimalType(mTrades);
+    }
+
+    DecimalType getPALProfitability() const { return getPercentWinners(); }
+
+  private:
+    OccurrenceBitset mWinners;
+    unsigned int mTrades;
+    unsigned int mWinningTrades;
+  };
+
+  using Processor = BacktestProcessor<DecimalType, WinnerDatesBacktester, OccurrenceBitset>;
+
+  class TestSteppingPolicy: public MutualInfoSteppingPolicy<DecimalType, WinnerDatesBacktester, OccurrenceBitset>
+  {
+    using Base = MutualInfoSteppingPolicy<DecimalType, WinnerDatesBacktester, OccurrenceBitset>;
+
+  public:
+    using Base::Base;
+    using Base::passes;
+  };
+
+  std::shared_ptr<const SearchAlgoConfiguration<DecimalType>> makeSearchConfiguration(unsigned int passingStratNumPerRound, unsigned int stepResultCapacity = 0)
+  {
+    return std::make_shared<SearchAlgoConfiguration<DecimalType>>(2, 5, DecimalType("0.5"), passingStratNumPerRound, DecimalType("1.5"), 4, 1000,
+                                                                  std::vector<std::pair<DecimalType, DecimalType>>(),
+                                                                  std::vector<boost::posix_time::time_duration>(),
+                                                                  std::shared_ptr<OHLCTimeSeries<DecimalType>>(),
+                                                                  1000, 5, 5, DecimalType("0.8"), DecimalType("1.0"), DecimalType("1.0"), stepResultCapacity);
+  }
+
+  /// backtests every pair of comparisons (the first step of the forward stepwise selection)
+  void processPairs(Processor& processor, const UniqueSinglePAMatrix<DecimalType, OccurrenceBitset>& singlePa,
+                    concurrency::WorkStealingExecutor<>& executor)
+  {
+    processor.processGroupsInParallel(static_cast<unsigned int>(singlePa.getMapSize()), executor,
+                                      [&singlePa](unsigned int i, Processor::ResultShard& shard)
+                                      {
+                                        for (unsigned int c = 0; c < singlePa.getMapSize(); ++c)
+                                          {
+                                            if (i == c)
+                                              continue;
+                                            std::vector<unsigned int> stratVect {i, c};
+                                            singlePa.extendElements(singlePa.getMappedElement(i), c, shard.getOccurrences());
+                                            shard.processResult(stratVect, shard.getOccurrences());
+                                          }
+                                      });
+  }
+}
+
+TEST_CASE ("MutualInfoSteppingPolicy passes the same strategies with a result capacity", "[SteppingPolicy]")
+{
+  auto generator = createRandomWalkComparisons(3, ComparisonType::Ohlc, 400);
+  auto singlePa = std::make_shared<UniqueSinglePAMatrix<DecimalType, OccurrenceBitset>>(generator, generator->getDateIndexCount());
+
+  OccurrenceBitset winners(generator->getDateIndexCount());
+  for (size_t d = 0; d < winners.size(); ++d)
+    if ((d * 7919) % 5 < 2)
+      winners.set(d);
+
+  concurrency::WorkStealingExecutor<> executor;
+  const unsigned int passingStratNumPerRound = 20;
+  // every result is kept unless a capacity is configured
+  REQUIRE (makeSearchConfiguration(passingStratNumPerRound)->getStepResultCapacity() == 0);
+  const unsigned int capacity = 10 * passingStratNumPerRound;
+  auto searchConfiguration = makeSearchConfiguration(passingStratNumPerRound, capacity);
+  REQUIRE (searchConfiguration->getStepResultCapacity() == capacity);
+
+  auto fullBacktester = std::make_shared<WinnerDatesBacktester>(winners);
+  auto fullProcessor = std::make_shared<Processor>(searchConfiguration, fullBacktester, singlePa);
+  TestSteppingPolicy fullSort(fullProcessor, singlePa, executor, passingStratNumPerRound, searchConfiguration->getProfitFactorCriterion(),
+                              searchConfiguration->getActivityMultiplier(), searchConfiguration->getStepRedundancyMultiplier());
+
+  auto boundedBacktester = std::make_shared<WinnerDatesBacktester>(winners);
+  auto boundedProcessor = std::make_shared<Processor>(searchConfiguration, boundedBacktester, singlePa);
+  TestSteppingPolicy bounded(boundedProcessor, singlePa, executor, passingStratNumPerRound, searchConfiguration->getProfitFactorCriterion(),
+                             searchConfiguration->getActivityMultiplier(), searchConfiguration->getStepRedundancyMultiplier(),
+                             capacity);
+
+  REQUIRE (fullProcessor->getResultCapacity() == 0);
+  REQUIRE (boundedProcessor->getResultCapacity() == capacity);
+
+  processPairs(*fullProcessor, *singlePa, executor);
+  processPairs(*boundedProcessor, *singlePa, executor);
+
+  REQUIRE (fullProcessor->getResults().size() > 10 * capacity);
+  REQUIRE (boundedProcessor->getResults().size() == capacity);
+
+  const std::vector<StrategyRepresentationType> fullPasses = fullSort.passes(0, 2);
+  const std::vector<StrategyRepresentationType> boundedPasses = bounded.passes(0, 2);
+
+  REQUIRE (fullPasses.size() == passingStratNumPerRound);
+  REQUIRE (boundedPasses == fullPasses);
+}
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <valarray>
+#include "TestUtils.h"
+#include "DecimalConstants.h"
+
+using namespace mkc_searchalgo;
+using namespace mkc_timeseries;
+
+RandomResultBase::RandomResultBase(size_t numDates, unsigned int maxBarsInPosition, TestRandom& random):
+  mResults(DecimalConstants<DecimalType>::DecimalZero, numDates),
+  mNumBarsInPosition(0u, numDates)
+{
+  for (size_t i = 0; i < numDates; ++i)
+    {
+      mNumBarsInPosition[i] = random.nextBelow(maxBarsInPosition + 1);
+      if (random.nextBelow(2) == 0)
+        continue;
+      const int cents = static_cast<int>(random.nextBelow(601)) - 300;
+      mResults[i] = DecimalType(cents) / DecimalType(100);
+    }
+}
+
+namespace {
+
+  /// calls addBar(open, high, low, close) for each bar of the random walk
+  template <class TAddBar>
+  void generateRandomWalk(unsigned int numBars, uint32_t seed, TAddBar addBar)
+  {
+    TestRandom random(seed);
+    auto next = [&random]() { return static_cast<int>(random.nextBelow(200)) - 100; };
+
+    double close = 100.0;
+    for (unsigned int i = 0; i < numBars; ++i)
+      {
+        const double open = close + next() / 100.0;
+        close = open + next() / 50.0;
+        const double high = std::max(open, close) + (next() + 100) / 100.0;
+        const double low = std::min(open, close) - (next() + 100) / 100.0;
+        addBar(DecimalType(open), DecimalType(high), DecimalType(low), DecimalType(close));
+      }
+  }
+}
+
+std::shared_ptr<OHLCTimeSeries<DecimalType>> createRandomWalkSeries(unsigned int numBars, uint32_t seed)
+{
+  auto series = std::make_shared<OHLCTimeSeries<DecimalType>>(TimeFrame::DAILY, TradingVolume::SHARES, numBars);
+  boost::gregorian::date day(2020, 1, 2);
+  generateRandomWalk(numBars, seed, [&series, &day](const DecimalType& open, const DecimalType& high, const DecimalType& low, const DecimalType& close)
+  {
+    series->addEntry(OHLCTimeSeriesEntry<DecimalType>(day, open, high, low, close, DecimalConstants<DecimalType>::DecimalZero, TimeFrame::DAILY));
+    do
+      day += boost::gregorian::days(1);
+    while (day.day_of_week() == boost::date_time::Saturday || day.day_of_week() == boost::date_time::Sunday);
+  });
+  return series;
+}
+
+std::shared_ptr<ComparisonsGenerator<DecimalType>>
+createRandomWalkComparisons(unsigned int maxLookBack, ComparisonType comparisonType,
+                            unsigned int numBars, uint32_t seed)
+{
+  auto generator = std::make_shared<ComparisonsGenerator<DecimalType>>(maxLookBack, comparisonType);
+  generateRandomWalk(numBars, seed, [&generator](const DecimalType& open, const DecimalType& high, const DecimalType& low, const DecimalType& close)
+  {
+    generator->addNewLastBar(open, high, low, close);
+  });
+  return generator;
+}
+
+OccurrenceBitset createRandomBitset(size_t size, unsigned int percentSet, TestRandom& random)
+{
+  OccurrenceBitset bits(size);
+  for (size_t i = 0; i < size; ++i)
+    if (random.nextBelow(100) < percentSet)
+      bits.set(i);
+  return bits;
+}
+
+std::valarray<DecimalType> toValarray(const OccurrenceBitset& occurrences)
+{
+  std::valarray<DecimalType> values(DecimalConstants<DecimalType>::DecimalZero, occurrences.size());
+  occurrences.forEachSetBit([&values](size_t i) { values[i] = DecimalConstants<DecimalType>::DecimalOne; });
+  return values;
+}
@@ -0,0 +1,64 @@
+#ifndef PASEARCHALGO_TEST_UTILS_H
+#define PASEARCHALGO_TEST_UTILS_H
+
+#include <cstdint>
+#include <memory>
+#include <valarray>
+#include <vector>
+#include "number.h"
+#include "ComparisonsGenerator.h"
+#include "TimeSeries.h"
+#include "OccurrenceBitset.h"
+
+typedef dec::decimal<7> DecimalType;
+
+///
+/// Small linear congruential generator, so the randomized tests see the same
+/// inputs on every platform and standard library
+///
+class TestRandom
+{
+public:
+  explicit TestRandom(uint32_t seed):
+    mState(seed)
+  {}
+
+  /// uniform in [0, bound)
+  uint32_t nextBelow(uint32_t bound)
+  {
+    mState = mState * 1664525u + 1013904223u;
+    return (mState >> 16) % bound;
+  }
+
+private:
+  uint32_t mState;
+};
+
+///
+/// Backtest result base of numDates dates: about half the dates are trades (winners and
+/// losers in random order) and the rest have a zero result. Bars in position range over
+/// 0..maxBarsInPosition, so some positions reach past the next word of a bitset.
+///
+struct RandomResultBase
+{
+  RandomResultBase(size_t numDates, unsigned int maxBarsInPosition, TestRandom& random);
+
+  std::valarray<DecimalType> mResults;
+  std::valarray<unsigned int> mNumBarsInPosition;
+};
+
+/// random walk of numBars daily bars on consecutive business days from 2020-01-02
+std::shared_ptr<mkc_timeseries::OHLCTimeSeries<DecimalType>> createRandomWalkSeries(unsigned int numBars, uint32_t seed = 12345);
+
+/// random walk of numBars bars, fed to a comparisons generator
+std::shared_ptr<mkc_searchalgo::ComparisonsGenerator<DecimalType>>
+createRandomWalkComparisons(unsigned int maxLookBack, mkc_searchalgo::ComparisonType comparisonType,
+                            unsigned int numBars, uint32_t seed = 12345);
+
+/// bitset of the given size with about percentSet percent of the bits set
+mkc_searchalgo::OccurrenceBitset createRandomBitset(size_t size, unsigned int percentSet, TestRandom& random);
+
+/// the same occurrences as 0/1 decimals, as used by the valarray path
+std::valarray<DecimalType> toValarray(const mkc_searchalgo::OccurrenceBitset& occurrences);
+
+#endif
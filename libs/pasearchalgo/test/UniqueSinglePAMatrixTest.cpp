@@ -0,0 +1,144 @@
+// UniqueSinglePAMatrixTest.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <valarray>
+#include <vector>
+#include "number.h"
+#include "UniqueSinglePAMatrix.h"
+#include "TestUtils.h"
+
+using namespace mkc_searchalgo;
+
+namespace {
+
+  std::vector<bool> toBools(const OccurrenceBitset& bits)
+  {
+    std::vector<bool> bools(bits.size());
+    for (size_t i = 0; i < bits.size(); ++i)
+      bools[i] = bits.test(i);
+    return bools;
+  }
+
+  bool sameOccurrences(const OccurrenceBitset& bits, const std::valarray<DecimalType>& values)
+  {
+    if (bits.size() != values.size())
+      return false;
+    for (size_t i = 0; i < bits.size(); ++i)
+      if (bits.test(i) != (values[i] == DecimalConstants<DecimalType>::DecimalOne))
+        return false;
+    return true;
+  }
+}
+
+TEST_CASE ("OccurrenceBitset matches a vector of bools", "[OccurrenceBitset]")
+{
+  TestRandom random(7);
+
+  for (size_t size: {1, 63, 64, 65, 127, 130, 201})
+    {
+      const OccurrenceBitset lhs = createRandomBitset(size, 40, random);
+      const OccurrenceBitset rhs = createRandomBitset(size, 60, random);
+      const std::vector<bool> lhsBools = toBools(lhs);
+      const std::vector<bool> rhsBools = toBools(rhs);
+
+      size_t lhsCount = 0, intersection = 0, differences = 0;
+      std::vector<size_t> lhsSetBits;
+      for (size_t i = 0; i < size; ++i)
+        {
+          lhsCount += lhsBools[i];
+          intersection += lhsBools[i] && rhsBools[i];
+          differences += lhsBools[i] != rhsBools[i];
+          if (lhsBools[i])
+            lhsSetBits.push_back(i);
+        }
+
+      REQUIRE (lhs.size() == size);
+      REQUIRE (lhs.count() == lhsCount);
+      REQUIRE (lhs.countIntersection(rhs) == intersection);
+      REQUIRE (lhs.countDifferences(rhs) == differences);
+
+      std::vector<size_t> visited;
+      lhs.forEachSetBit([&visited](size_t i) { visited.push_back(i); });
+      REQUIRE (visited == lhsSetBits);
+
+      for (size_t from = 0; from <= size; ++from)
+        {
+          const auto next = std::lower_bound(lhsSetBits.begin(), lhsSetBits.end(), from);
+          REQUIRE (lhs.findNext(from) == (next == lhsSetBits.end() ? size : *next));
+        }
+
+      OccurrenceBitset both = lhs;
+      both &= rhs;
+      REQUIRE (both.count() == intersection);
+      for (size_t i = 0; i < size; ++i)
+        REQUIRE (both.test(i) == (lhsBools[i] && rhsBools[i]));
+
+      // Bits past size() are never set, whichever way the bitset was built
+      const OccurrenceBitset all(size, true);
+      REQUIRE (all.count() == size);
+      const std::vector<uint64_t> fullWords(all.numWords() + 1, ~uint64_t(0));
+      REQUIRE (OccurrenceBitset(size, fullWords.data(), fullWords.size()) == all);
+    }
+
+  REQUIRE_THROWS (OccurrenceBitset(64) &= OccurrenceBitset(65));
+}
+
+TEST_CASE ("UniqueSinglePAMatrix bitsets match the valarray matrix", "[UniqueSinglePAMatrix]")
+{
+  TestRandom random(11);
+
+  for (ComparisonType comparisonType: {ComparisonType::CloseOnly, ComparisonType::HighLow, ComparisonType::Ohlc})
+    for (unsigned int maxLookBack: {2u, 3u, 5u})
+      for (unsigned int numBars: {130u, 201u})
+        {
+          auto generator = createRandomWalkComparisons(maxLookBack, comparisonType, numBars, numBars + maxLookBack);
+          const unsigned int dateCount = generator->getDateIndexCount();
+          REQUIRE (dateCount == numBars);
+
+          UniqueSinglePAMatrix<DecimalType, std::valarray<DecimalType>> valarrayMatrix(generator, dateCount);
+          UniqueSinglePAMatrix<DecimalType, OccurrenceBitset> bitsetMatrix(generator, dateCount);
+
+          REQUIRE (bitsetMatrix.getMapSize() == valarrayMatrix.getMapSize());
+          REQUIRE (bitsetMatrix.getMapSize() > 0);
+          const unsigned int numComparisons = static_cast<unsigned int>(bitsetMatrix.getMapSize());
+
+          for (unsigned int id = 0; id < numComparisons; ++id)
+            {
+              REQUIRE (bitsetMatrix.getUnderlying(id) == valarrayMatrix.getUnderlying(id));
+              REQUIRE (sameOccurrences(bitsetMatrix.getMappedElement(id), valarrayMatrix.getMappedElement(id)));
+            }
+
+          // Combined and extended strategies have the same occurrences
+          OccurrenceBitset bitsetOccurrences;
+          std::valarray<DecimalType> valarrayOccurrences;
+
+          bitsetMatrix.combineElements({}, bitsetOccurrences);
+          valarrayMatrix.combineElements({}, valarrayOccurrences);
+          REQUIRE (bitsetOccurrences.count() == dateCount);
+          REQUIRE (sameOccurrences(bitsetOccurrences, valarrayOccurrences));
+
+          for (unsigned int trial = 0; trial < 50; ++trial)
+            {
+              std::vector<unsigned int> elements;
+              const unsigned int depth = 1 + random.nextBelow(4);
+              for (unsigned int d = 0; d < depth; ++d)
+                elements.push_back(random.nextBelow(numComparisons));
+
+              bitsetMatrix.combineElements(elements, bitsetOccurrences);
+              valarrayMatrix.combineElements(elements, valarrayOccurrences);
+              REQUIRE (sameOccurrences(bitsetOccurrences, valarrayOccurrences));
+
+              const unsigned int extension = random.nextBelow(numComparisons);
+              OccurrenceBitset bitsetExtended;
+              std::valarray<DecimalType> valarrayExtended;
+              bitsetMatrix.extendElements(bitsetOccurrences, extension, bitsetExtended);
+              valarrayMatrix.extendElements(valarrayOccurrences, extension, valarrayExtended);
+              REQUIRE (sameOccurrences(bitsetExtended, valarrayExtended));
+
+              elements.push_back(extension);
+              bitsetMatrix.combineElements(elements, bitsetOccurrences);
+              REQUIRE (bitsetOccurrences == bitsetExtended);
+            }
+        }
+}
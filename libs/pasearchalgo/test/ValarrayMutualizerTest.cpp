@@ -0,0 +1,177 @@
+// ValarrayMutualizerTest.cpp
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <tuple>
+#include <vector>
+#include "ShortcutSearchAlgoBacktester.h"
+#include "BacktestProcessor.h"
+#include "ValarrayMutualizer.h"
+#include "TestUtils.h"
+
+using namespace mkc_searchalgo;
+
+namespace {
+
+  using Backtester = ShortcutSearchAlgoBacktester<DecimalType, ShortcutBacktestMethod::PlainVanilla>;
+  using Processor = BacktestProcessor<DecimalType, Backtester, OccurrenceBitset>;
+  using Matrix = UniqueSinglePAMatrix<DecimalType, OccurrenceBitset>;
+  using Result = std::tuple<ResultStat<DecimalType>, unsigned int, int>;
+
+  const unsigned int SelectCount = 40;
+  const double ActivityMult = 20.0;
+  const double RedundancyMult = 30.0;
+
+  /// the redundancy score of two comparisons, computed as the mutualizer does
+  double pairRedundancy(const Matrix& singlePa, unsigned int i, unsigned int c)
+  {
+    const OccurrenceBitset& lhs = singlePa.getMappedElement(i);
+    DecimalType diffSum(static_cast<unsigned int>(lhs.countDifferences(singlePa.getMappedElement(c))));
+    DecimalType avgDiff(diffSum / DecimalType(static_cast<double>(lhs.size())));
+    return (DecimalConstants<DecimalType>::DecimalOne - avgDiff).getAsDouble();
+  }
+
+  /// brute force: the highest redundancy of any comparison of strat with any comparison of any of the strategies
+  double maxRedundancy(const Matrix& singlePa, const std::vector<StrategyRepresentationType>& strategies, const StrategyRepresentationType& strat)
+  {
+    double maxRed = 0.0;
+    for (const StrategyRepresentationType& selected: strategies)
+      for (unsigned int i: selected)
+        for (unsigned int c: strat)
+          maxRed = std::max(maxRed, pairRedundancy(singlePa, i, c));
+    return maxRed;
+  }
+
+  ///
+  /// The selection loop of getMaxRelMinRed, scoring every candidate it reaches against all the strategies selected so far.
+  /// staleCount counts the candidates reached whose redundancy would miss a selection if only the strategy selected last
+  /// were folded in, as the mutualizer used to do: ones passed over by an early break in a round and reached in a later one.
+  ///
+  std::vector<StrategyRepresentationType> referenceSelection(const Matrix& singlePa, const std::vector<Result>& sortedResults,
+                                                             const std::unordered_map<int, StrategyRepresentationType>& strategiesById,
+                                                             double redundancyFilter, unsigned int& staleCount)
+  {
+    std::vector<StrategyRepresentationType> selected;
+    std::vector<double> lastOnlyMax(sortedResults.size(), 0.0);
+    size_t maxIndexToSearch = sortedResults.size();
+    staleCount = 0;
+    while (selected.size() < SelectCount)
+      {
+        double maxScore = -std::numeric_limits<double>::infinity();
+        bool found = false;
+        StrategyRepresentationType bestStrat;
+        for (size_t index = 0; index < sortedResults.size(); ++index)
+          {
+            const ResultStat<DecimalType>& stat = std::get<0>(sortedResults[index]);
+            if (stat.ProfitFactor == DecimalConstants<DecimalType>::DecimalOneHundred || stat.ProfitFactor == DecimalConstants<DecimalType>::DecimalZero)
+              continue;
+            const StrategyRepresentationType& strat = strategiesById.at(std::get<2>(sortedResults[index]));
+            if (std::find(selected.begin(), selected.end(), strat) != selected.end())
+              continue;
+
+            const double relevance = stat.PALProfitability.getAsDouble();
+            const double activity = (std::get<1>(sortedResults[index]) * ActivityMult) / singlePa.getDateCount();
+            if (maxScore > relevance + ActivityMult * 0.5 || index >= maxIndexToSearch)
+              {
+                if (selected.size() == 1)
+                  maxIndexToSearch = index;
+                break;
+              }
+            if (selected.empty())
+              {
+                bestStrat = strat;
+                found = true;
+                break;
+              }
+
+            const double runningMax = maxRedundancy(singlePa, selected, strat);
+            lastOnlyMax[index] = std::max(lastOnlyMax[index], maxRedundancy(singlePa, {selected.back()}, strat));
+            if (lastOnlyMax[index] != runningMax)
+              staleCount++;
+
+            const double redundancy = runningMax * RedundancyMult;
+            if (redundancy >= redundancyFilter * RedundancyMult)
+              continue;
+            const double score = relevance + activity - redundancy;
+            if (score > maxScore)
+              {
+                found = true;
+                bestStrat = strat;
+                maxScore = score;
+              }
+          }
+        if (!found)
+          break;
+        selected.push_back(bestStrat);
+      }
+    return selected;
+  }
+
+  template <class Executor>
+  std::vector<StrategyRepresentationType> select(const std::shared_ptr<Processor>& processor, const std::shared_ptr<Matrix>& singlePa,
+                                                 const std::vector<Result>& sortedResults, double redundancyFilter)
+  {
+    Executor executor;
+    ValarrayMutualizer<DecimalType, Backtester, OccurrenceBitset, Executor> mutualizer(processor, singlePa, "Test", executor);
+    mutualizer.getMaxRelMinRed(sortedResults, SelectCount, ActivityMult, RedundancyMult, redundancyFilter);
+    return mutualizer.getSelectedStrategies();
+  }
+}
+
+TEST_CASE ("ValarrayMutualizer selects as when scoring candidates against every selected strategy", "[ValarrayMutualizer]")
+{
+  TestRandom random(53);
+  auto generator = createRandomWalkComparisons(4, ComparisonType::Ohlc, 300);
+  auto singlePa = std::make_shared<Matrix>(generator, generator->getDateIndexCount());
+  const unsigned int numComparisons = static_cast<unsigned int>(singlePa->getMapSize());
+
+  auto searchConfiguration = std::make_shared<SearchAlgoConfiguration<DecimalType>>(2, 5, DecimalType("0.5"), 20, DecimalType("1.5"), 4, 1000,
+                                                                                  std::vector<std::pair<DecimalType, DecimalType>>(),
+                                                                                  std::vector<boost::posix_time::time_duration>(),
+                                                                                  std::shared_ptr<OHLCTimeSeries<DecimalType>>(),
+                                                                                  1000, 5, 5, DecimalType("0.8"), DecimalType("1.0"), DecimalType("1.0"));
+  const RandomResultBase base(singlePa->getDateCount(), 4, random);
+  auto backtester = std::make_shared<Backtester>(base.mResults, base.mNumBarsInPosition, 5, true);
+  auto processor = std::make_shared<Processor>(searchConfiguration, backtester, singlePa);
+
+  // 3000 candidates of two or three comparisons, more than one fold block, by descending relevance
+  std::vector<Result> sortedResults;
+  std::set<StrategyRepresentationType> seen;
+  int id = 0;
+  while (sortedResults.size() < 3000)
+    {
+      StrategyRepresentationType strat;
+      const unsigned int depth = 2 + random.nextBelow(2);
+      for (unsigned int d = 0; d < depth; ++d)
+        strat.push_back(random.nextBelow(numComparisons));
+      if (!seen.insert(strat).second)
+        continue;
+
+      // a few candidates with a profit factor of 0 or 100, which are never selected
+      const unsigned int kind = random.nextBelow(50);
+      const DecimalType profitFactor = kind == 0 ? DecimalConstants<DecimalType>::DecimalZero
+        : (kind == 1 ? DecimalConstants<DecimalType>::DecimalOneHundred : DecimalType("1.5"));
+      const DecimalType relevance(90.0 - sortedResults.size() * 0.02 - random.nextBelow(100) * 0.01);
+      const unsigned int trades = 5 + random.nextBelow(60);
+      processor->getStrategyMap()[id] = strat;
+      sortedResults.emplace_back(ResultStat<DecimalType>(profitFactor, DecimalType(1), relevance, DecimalType(50), trades, 2), trades, id);
+      id++;
+    }
+  std::stable_sort(sortedResults.begin(), sortedResults.end(), [](const Result& lhs, const Result& rhs)
+                   { return std::get<0>(lhs).PALProfitability > std::get<0>(rhs).PALProfitability; });
+
+  for (double redundancyFilter: {0.9, 0.75})
+    {
+      unsigned int staleCount = 0;
+      const std::vector<StrategyRepresentationType> expected = referenceSelection(*singlePa, sortedResults, processor->getStrategyMap(),
+                                                                                  redundancyFilter, staleCount);
+      REQUIRE (expected.size() > 2);
+      // scores only fall from round to round, so no round stops before the first one did and no candidate misses a selection
+      REQUIRE (staleCount == 0);
+
+      REQUIRE (select<concurrency::SingleThreadExecutor>(processor, singlePa, sortedResults, redundancyFilter) == expected);
+      REQUIRE (select<concurrency::WorkStealingExecutor<>>(processor, singlePa, sortedResults, redundancyFilter) == expected);
+    }
+}
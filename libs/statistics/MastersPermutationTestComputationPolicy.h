@@ -14,6 +14,7 @@
 #include <atomic>
 #include <thread>
 #include <future>
+#include <type_traits>
 
 // --- Assumed necessary includes from your project ---
 #include "BackTester.h"
@@ -24,6 +25,7 @@
 #include "number.h"
 #include "DecimalConstants.h"
 #include "SyntheticSecurityHelpers.h"
+#include "PalBatchBacktester.h"
 #include "PALMonteCarloTypes.h"
 #include "ParallelExecutors.h"
 #include "ParallelFor.h"
@@ -67,9 +69,9 @@ namespace mkc_timeseries
  * @tparam BaselineStatPolicy Policy class that defines methods to:
  *         - Determine the minimum number of trades required for a valid test.
  *         - Compute the permutation test statistic for a backtest result.
- * @tparam Executor Concurrency executor (defaults to StdAsyncExecutor).
+ * @tparam Executor Concurrency executor (defaults to WorkStealingExecutor).
  */
-  template <class Decimal, class BaselineStatPolicy, class Executor = concurrency::ThreadPoolExecutor<>>
+  template <class Decimal, class BaselineStatPolicy, class Executor = concurrency::WorkStealingExecutor<>>
   class MastersPermutationPolicy
   {
   public:
@@ -123,6 +125,9 @@ namespace mkc_timeseries
       Executor executor{};
       std::atomic<unsigned> count_k{1};
 
+      // Synthetic series generators are reused across permutations, one per running task
+      SyntheticSecurityPool<Decimal> syntheticPool(theSecurity);
+
       // Launch a parallel loop over the range [0 … numPermutations), using our executor.
       // For each index p, invoke the lambda body below.
       //
@@ -138,14 +143,11 @@ namespace mkc_timeseries
       // You get value semantics (thread-safe reads) for everything you only need to read,
       // and reference semantics for that single shared counter you need to update.
       // Define work lambda for a single permutation
-        auto work = [ =, &count_k ]
+        auto work = [ =, &count_k, &syntheticPool ]
         (uint32_t p)
         {
-	  auto syntheticPortfolio = createSyntheticPortfolio<Decimal>
-            (
-	     theSecurity,
-	     basePortfolioPtr
-	     );
+	  auto syntheticGenerator = syntheticPool.acquire();
+	  auto syntheticPortfolio = syntheticGenerator->createSyntheticPortfolio(basePortfolioPtr);
 
 	  // Compute maximum statistic across strategies
 	  Decimal max_stat = std::numeric_limits<Decimal>::lowest();
@@ -191,6 +193,8 @@ namespace mkc_timeseries
 	      max_stat = std::max( max_stat, stat );
             }
 
+	  syntheticPool.release(std::move(syntheticGenerator));
+
 	  // Increment count if statistic exceeds baseline
 	  if ( max_stat >= baselineStat_k )
 	      count_k.fetch_add( 1, std::memory_order_relaxed );
@@ -208,6 +212,21 @@ namespace mkc_timeseries
     }
   }; // End class MastersPermutationPolicy
 
+  /**
+   * @brief Detects whether a BaselineStatPolicy can compute its statistic from a
+   *        BatchStrategyResult, i.e. provides
+   *        `static Decimal getPermutationTestStatistic(const BatchStrategyResult<Decimal>&)`.
+   */
+  template <class BaselineStatPolicy, class Decimal, class = void>
+  struct SupportsBatchPermutationStatistic : std::false_type
+  {};
+
+  template <class BaselineStatPolicy, class Decimal>
+  struct SupportsBatchPermutationStatistic<BaselineStatPolicy, Decimal,
+    std::void_t<decltype(BaselineStatPolicy::getPermutationTestStatistic(std::declval<const BatchStrategyResult<Decimal>&>()))>>
+    : std::true_type
+  {};
+
   /**
    * @class FastMastersPermutationPolicy
    * @brief Computes exceedance counts for all strategies in one parallel sweep.
@@ -217,14 +236,19 @@ namespace mkc_timeseries
    * permuted statistic across all strategies.  This yields a map of counts
    * that can be converted to adjusted p-values in a step-down procedure.
    *
+   * When BaselineStatPolicy can score a BatchStrategyResult and every strategy
+   * and the template backtester can be emulated by PalBatchBacktester, each
+   * permutation is evaluated with a single pass over the synthetic bars for all
+   * strategies instead of one cloned BackTester per strategy.
+   *
    * @tparam Decimal Numeric type for calculations (e.g., double).
    * @tparam BaselineStatPolicy Policy to extract stats and minimum trades.
-   * @tparam Executor Concurrency executor (defaults to StdAsyncExecutor).
+   * @tparam Executor Concurrency executor (defaults to WorkStealingExecutor).
    */
   template<
     class Decimal,
     class BaselineStatPolicy,
-    class Executor = concurrency::ThreadPoolExecutor<>>
+    class Executor = concurrency::WorkStealingExecutor<>>
   class FastMastersPermutationPolicy
   {
   public:
@@ -282,6 +306,15 @@ namespace mkc_timeseries
 				   );
         }
 
+      if constexpr (SupportsBatchPermutationStatistic<BaselineStatPolicy, Decimal>::value)
+	{
+	  if (canUseBatchBacktester(sorted_strategy_data, templateBackTester))
+	    return computeAllPermutationCountsBatched(numPermutations,
+						      sorted_strategy_data,
+						      templateBackTester,
+						      theSecurity);
+	}
+
       // Initialize atomic counters for each strategy (start at 1 for the unpermuted case)
       AtomicCountsMap atomic_counts;
       for (auto const& ctx : sorted_strategy_data)
@@ -291,18 +324,18 @@ namespace mkc_timeseries
 
       Executor executor{};  // default or platform-specific executor
 
+      // Synthetic series generators are reused across permutations, one per running task
+      SyntheticSecurityPool<Decimal> syntheticPool(theSecurity);
+
       // Define work lambda: processes one permutation index 'p'
-      auto work = [=, &atomic_counts]
+      auto work = [=, &atomic_counts, &syntheticPool]
         (
 	 uint32_t p
 	 )
       {
 	// 1) Create synthetic portfolio for this permutation
-	auto syntheticPortfolio = createSyntheticPortfolio<Decimal>
-	  (
-	   theSecurity,
-	   basePortfolioPtr
-	   );
+	auto syntheticGenerator = syntheticPool.acquire();
+	auto syntheticPortfolio = syntheticGenerator->createSyntheticPortfolio(basePortfolioPtr);
 
 	// 2) Compute statistic for each strategy
 	std::map<StrategyPtr, Decimal> stats_this_perm;
@@ -333,6 +366,8 @@ namespace mkc_timeseries
 	    stats_this_perm[strategy] = stat;
 	  }
 
+	syntheticPool.release(std::move(syntheticGenerator));
+
 	// 3) Determine max statistic
 	Decimal max_f = std::numeric_limits<Decimal>::lowest();
 	for (auto const& entry : stats_this_perm)
@@ -367,6 +402,92 @@ namespace mkc_timeseries
 
       return final_counts;
     }
+
+  private:
+    static bool canUseBatchBacktester(const LocalStrategyData& sorted_strategy_data,
+				      const std::shared_ptr<BackTester<Decimal>>& templateBackTester)
+    {
+      if (!PalBatchBacktester<Decimal>::supportsBackTester(templateBackTester))
+	return false;
+
+      for (auto const& ctx : sorted_strategy_data)
+	{
+	  if (!PalBatchBacktester<Decimal>::supportsStrategy(ctx.strategy))
+	    return false;
+	}
+
+      return true;
+    }
+
+    /**
+     * @brief Same counts as the cloned BackTester path, but every permutation backtests
+     *        all strategies in one pass over the synthetic series.
+     */
+    static FinalCountsMap computeAllPermutationCountsBatched
+    (
+     uint32_t                                    numPermutations,
+     const LocalStrategyData&                    sorted_strategy_data,
+     const std::shared_ptr<BackTester<Decimal>>& templateBackTester,
+     const std::shared_ptr<Security<Decimal>>&   theSecurity
+     )
+    {
+      std::vector<StrategyPtr> strategies;
+      std::vector<Decimal> baselineStats;
+      strategies.reserve(sorted_strategy_data.size());
+      baselineStats.reserve(sorted_strategy_data.size());
+      for (auto const& ctx : sorted_strategy_data)
+	{
+	  strategies.push_back(ctx.strategy);
+	  baselineStats.push_back(ctx.baselineStat);
+	}
+
+      const PalBatchBacktester<Decimal> batchBackTester(strategies,
+							templateBackTester->getStartDate(),
+							templateBackTester->getEndDate());
+
+      std::vector<std::atomic<unsigned>> atomic_counts(strategies.size());
+      for (auto& count : atomic_counts)
+	count.store(1);
+
+      Executor executor{};
+      SyntheticSecurityPool<Decimal> syntheticPool(theSecurity);
+
+      auto work = [&](uint32_t p)
+      {
+	auto syntheticGenerator = syntheticPool.acquire();
+
+	std::vector<BatchStrategyResult<Decimal>> results;
+	batchBackTester.backtest(syntheticGenerator->createSyntheticSecurity().get(), results);
+	syntheticPool.release(std::move(syntheticGenerator));
+
+	Decimal max_f = std::numeric_limits<Decimal>::lowest();
+	for (auto const& result : results)
+	  {
+	    // below minimum, count as "no relationship" under the null hypothesis
+	    if (result.getNumClosedTrades() >= BaselineStatPolicy::getMinStrategyTrades())
+	      max_f = std::max(max_f, BaselineStatPolicy::getPermutationTestStatistic(result));
+	  }
+
+	for (size_t i = 0; i < baselineStats.size(); ++i)
+	  {
+	    if (max_f >= baselineStats[i])
+	      atomic_counts[i].fetch_add(1, std::memory_order_relaxed);
+	  }
+      };
+
+      concurrency::parallel_for
+        (
+	 numPermutations,
+	 executor,
+	 work
+	 );
+
+      FinalCountsMap final_counts;
+      for (size_t i = 0; i < strategies.size(); ++i)
+	final_counts[strategies[i]] = atomic_counts[i].load();
+
+      return final_counts;
+    }
   };
 } // namespace mkc_timeseries
 
@@ -114,7 +114,8 @@ namespace mkc_timeseries
       : MonteCarloPermutationTest<Decimal, ReturnType>(),
         mBackTester (backtester),
         mNumPermutations(numPermutations),
-        mBaseLineTestStat(DecimalConstants<Decimal>::DecimalZero)
+        mBaseLineTestStat(DecimalConstants<Decimal>::DecimalZero),
+        mPermutationBank()
     {
       if (numPermutations == 0)
         throw MonteCarloPermutationException("MonteCarloPermuteMarketChanges: num of permuations must be greater than zero");
@@ -129,6 +130,22 @@ namespace mkc_timeseries
         throw MonteCarloPermutationException("MonteCarloPermuteMarketChanges: Only one strategy can be associated with backtester for MCPT");
     }
 
+    /**
+     * Runs one permutation per entry of a shared SyntheticPermutationBank instead of
+     * generating new synthetic series. The bank must be built from the security the
+     * backtester's strategy trades, and _ComputationPolicy must support banks
+     * (see SupportsPermutationBank).
+     */
+    template <class Policy = _ComputationPolicy,
+              typename = std::enable_if_t<SupportsPermutationBank<Policy, Decimal>::value>>
+    MonteCarloPermuteMarketChanges (std::shared_ptr<BackTester<Decimal>> backtester,
+                                    std::shared_ptr<const SyntheticPermutationBank<Decimal>> permutationBank)
+      : MonteCarloPermuteMarketChanges (backtester,
+                                        permutationBank ? permutationBank->getNumPermutations() : 0)
+    {
+      mPermutationBank = permutationBank;
+    }
+
     ~MonteCarloPermuteMarketChanges()
     {}
 
@@ -141,7 +158,7 @@ namespace mkc_timeseries
       this->validateStrategy (aStrategy);
 
       shared_ptr<Security<Decimal>> theSecurity = aStrategy->beginPortfolio()->second;
-      std::shared_ptr<OHLCTimeSeries<Decimal>> theTimeSeries = theSecurity->getTimeSeries();
+      std::shared_ptr<const OHLCTimeSeries<Decimal>> theTimeSeries = theSecurity->getTimeSeries();
 
       //std::cout << "Running MCPT backtest from " << mBackTester->getStartDate() << " to " << mBackTester->getEndDate() << std::endl << std::endl;
       // Run backtest on security with orginal unpermuted time series
@@ -158,6 +175,12 @@ namespace mkc_timeseries
       mBaseLineTestStat = _BackTestResultPolicy<Decimal>::getPermutationTestStatistic(mBackTester);
       //std::cout << "Baseline test stat. for original  strategy equals: " <<  mBaseLineTestStat << ", baseline # trades:" << this->getNumClosedTrades (mBackTester) <<  std::endl << std::endl;
 
+      if constexpr (SupportsPermutationBank<_ComputationPolicy, Decimal>::value)
+        {
+          if (mPermutationBank)
+            return _ComputationPolicy::runPermutationTest (mBackTester, *mPermutationBank, mBaseLineTestStat);
+        }
+
       return _ComputationPolicy::runPermutationTest (mBackTester, mNumPermutations, mBaseLineTestStat);
     }
 
@@ -165,6 +188,7 @@ namespace mkc_timeseries
     std::shared_ptr<BackTester<Decimal>> mBackTester;
     uint32_t mNumPermutations;
     Decimal mBaseLineTestStat;
+    std::shared_ptr<const SyntheticPermutationBank<Decimal>> mPermutationBank;
   };
 
 
@@ -210,7 +234,7 @@ namespace mkc_timeseries
       this->validateStrategy (aStrategy);
 
       shared_ptr<Security<Decimal>> theSecurity = aStrategy->beginPortfolio()->second;
-      std::shared_ptr<OHLCTimeSeries<Decimal>> theTimeSeries = theSecurity->getTimeSeries();
+      std::shared_ptr<const OHLCTimeSeries<Decimal>> theTimeSeries = theSecurity->getTimeSeries();
 
       mBackTester->backtest();
 
@@ -11,6 +11,7 @@
 #include "number.h"
 #include "DecimalConstants.h"
 #include "BackTester.h"
+#include "PalBatchBacktester.h"
 #include "StatUtils.h"
 
 namespace mkc_timeseries
@@ -43,6 +44,14 @@ namespace mkc_timeseries
       return StatUtils<Decimal>::computeLogProfitFactor(barSeries);
     }
 
+    /**
+     * @brief Same statistic computed from a PalBatchBacktester result.
+     */
+    static Decimal getPermutationTestStatistic(const BatchStrategyResult<Decimal>& result)
+    {
+      return StatUtils<Decimal>::computeLogProfitFactor(result.getHighResReturns());
+    }
+
     /// Minimum number of closed trades required to even attempt this test
     static unsigned int getMinStrategyTrades() { return 3; }
   };
@@ -62,6 +71,12 @@ namespace mkc_timeseries
       else
         throw BackTesterException("NonGranularProfitFactorPolicy::getPermutationTestStatistic - number of strategies is not equal to one, equal to "  +std::to_string(aBackTester->getNumStrategies()));
     }
+
+    static Decimal getPermutationTestStatistic(const BatchStrategyResult<Decimal>& result)
+    {
+      return result.getLogProfitFactor();
+    }
+
     static unsigned int getMinStrategyTrades()
     {
       return 3;
@@ -85,6 +100,12 @@ namespace mkc_timeseries
       else
         throw BackTesterException("CumulativeReturnPolicy::getPermutationTestStatistic - number of strategies is not equal to one, equal to "  +std::to_string(aBackTester->getNumStrategies()));
     }
+
+    static Decimal getPermutationTestStatistic(const BatchStrategyResult<Decimal>& result)
+    {
+      return result.getCumulativeReturn();
+    }
+
     static unsigned int getMinStrategyTrades()
     {
       return 3;
@@ -128,7 +128,7 @@ namespace mkc_timeseries
   template <class Decimal,
 	    typename McptType,
             template <typename> class _StrategySelection,
-	    typename Executor = concurrency::StdAsyncExecutor>
+	    typename Executor = concurrency::WorkStealingExecutor<>>
   class PALMonteCarloValidation: public PALMonteCarloValidationBase<Decimal,
 								    McptType,
 								    _StrategySelection>
@@ -143,17 +143,35 @@ namespace mkc_timeseries
 
     PALMonteCarloValidation(std::shared_ptr<McptConfiguration<Decimal>> configuration,
                             unsigned long numPermutations)
-      : PALMonteCarloValidationBase<Decimal,McptType, _StrategySelection>(configuration, numPermutations)
+      : PALMonteCarloValidationBase<Decimal,McptType, _StrategySelection>(configuration, numPermutations),
+        mUsePermutationBank(false)
     {}
 
     PALMonteCarloValidation (const PALMonteCarloValidation<Decimal,
                              McptType, _StrategySelection>& rhs)
-      : PALMonteCarloValidationBase<Decimal,McptType, _StrategySelection>(rhs)
+      : PALMonteCarloValidationBase<Decimal,McptType, _StrategySelection>(rhs),
+        mUsePermutationBank(rhs.getUsePermutationBank())
     {}
 
     ~PALMonteCarloValidation()
     {}
 
+    /**
+     * When enabled, the synthetic series are generated once, into a SyntheticPermutationBank,
+     * and every pattern is tested against that same bank instead of generating its own.
+     * Only takes effect when McptType can be constructed from a bank
+     * (MonteCarloPermuteMarketChanges with a bank-capable computation policy).
+     */
+    void setUsePermutationBank(bool usePermutationBank)
+    {
+      mUsePermutationBank = usePermutationBank;
+    }
+
+    bool getUsePermutationBank() const
+    {
+      return mUsePermutationBank;
+    }
+
     void runPermutationTests() override
     {
       // 1) Prepare data
@@ -185,6 +203,15 @@ namespace mkc_timeseries
       std::mutex               strategyMutex;
       Executor                 executor{};
 
+      std::shared_ptr<const SyntheticPermutationBank<Decimal>> permutationBank;
+      if constexpr (McptSupportsPermutationBank::value)
+        {
+          if (mUsePermutationBank)
+            permutationBank = std::make_shared<const SyntheticPermutationBank<Decimal>>(securityToTest,
+                                                                                        this->mNumPermutations,
+                                                                                        executor);
+        }
+
       concurrency::parallel_for(
         numPatterns,
         executor,
@@ -211,8 +238,7 @@ namespace mkc_timeseries
           bt->addStrategy(strategy);
 
           // run MCPT
-          McptType mcpt(bt, this->mNumPermutations);
-          ResultType result = mcpt.runPermutationTest();
+          ResultType result = runMcpt(bt, this->mNumPermutations, permutationBank);
 
           // record under lock
           std::lock_guard<std::mutex> lock(strategyMutex);
@@ -225,6 +251,28 @@ namespace mkc_timeseries
     }
  
   private:
+    using McptSupportsPermutationBank =
+      std::is_constructible<McptType,
+			    std::shared_ptr<BackTester<Decimal>>,
+			    std::shared_ptr<const SyntheticPermutationBank<Decimal>>>;
+
+    static ResultType runMcpt(const std::shared_ptr<BackTester<Decimal>>& bt,
+			      unsigned long numPermutations,
+			      const std::shared_ptr<const SyntheticPermutationBank<Decimal>>& permutationBank)
+    {
+      if constexpr (McptSupportsPermutationBank::value)
+        {
+          if (permutationBank)
+            {
+              McptType mcpt(bt, permutationBank);
+              return mcpt.runPermutationTest();
+            }
+        }
+
+      McptType mcpt(bt, numPermutations);
+      return mcpt.runPermutationTest();
+    }
+
      /**
       * Construct either a PalLongStrategy or PalShortStrategy based on
       * pattern->isLongPattern(), using the correct prefix + strategyNumber.
@@ -245,7 +293,9 @@ namespace mkc_timeseries
       else
 	return std::make_shared<PalShortStrategy<Decimal>>(name, pattern, aPortfolio);
     }
-    
+
+  private:
+    bool mUsePermutationBank;
   };
 
 
@@ -6,11 +6,15 @@
 #ifndef __PERMUTATION_TEST_COMPUTATION_POLICY_H
 #define __PERMUTATION_TEST_COMPUTATION_POLICY_H 1
 
+#include <cmath>
 #include <exception>
 #include <string>
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
 #include "number.h"
 #include "DecimalConstants.h"
 #include "BackTester.h"
@@ -18,6 +22,7 @@
 #include "MonteCarloTestPolicy.h"
 #include "SyntheticSecurityHelpers.h"
 #include "PermutationTestResultPolicy.h"
+#include "SyntheticPermutationBank.h"
 #include "ParallelExecutors.h"
 #include "ParallelFor.h"
 
@@ -61,13 +66,13 @@ namespace mkc_timeseries
    * - `Decimal getTestStat()`
    * Defaults to `PermutationTestingNullTestStatisticPolicy<Decimal>`.
    * @tparam Executor A policy class that defines the execution model for permutations,
-   * specifically whether concurrency is used. Defaults to `concurrency::StdAsyncExecutor`.
+   * specifically whether concurrency is used. Defaults to `concurrency::WorkStealingExecutor`.
    */
   template <class Decimal,
 	    class BackTestResultPolicy,
 	    typename _PermutationTestResultPolicy = PValueReturnPolicy<Decimal>,
 	    typename _PermutationTestStatisticsCollectionPolicy = PermutationTestingNullTestStatisticPolicy<Decimal>,
-	    typename Executor = concurrency::ThreadPoolExecutor<>>
+	    typename Executor = concurrency::WorkStealingExecutor<>>
   class DefaultPermuteMarketChangesPolicy
   {
     static_assert(has_return_type<_PermutationTestResultPolicy>::value,
@@ -125,9 +130,66 @@ namespace mkc_timeseries
                    uint32_t numPermutations,
                    const Decimal& baseLineTestStat)
     {
-      // Grab the one strategy and its security
-      auto aStrategy   = *(theBackTester->beginStrategies());
-      auto theSecurity = aStrategy->beginPortfolio()->second;
+      // Synthetic series generators are reused across permutations, one per running task
+      auto theSecurity = (*(theBackTester->beginStrategies()))->beginPortfolio()->second;
+      SyntheticSecurityPool<Decimal> syntheticPool(theSecurity);
+
+      return runPermutations(theBackTester, numPermutations, baseLineTestStat, syntheticPool);
+    }
+
+    /**
+     * @brief Executes the permutation test on the pre-generated synthetic markets of a bank.
+     *
+     * Permutation i backtests the strategy on bank.getSyntheticSecurity(i); one permutation is
+     * run per bank entry. The bank must have been generated from the strategy's security.
+     */
+    static ReturnType
+    runPermutationTest(std::shared_ptr<BackTester<Decimal>> theBackTester,
+		       const SyntheticPermutationBank<Decimal>& bank,
+		       const Decimal& baseLineTestStat)
+    {
+      return runPermutations(theBackTester, bank.getNumPermutations(), baseLineTestStat, bank);
+    }
+
+    /**
+     * @brief Computes a bias-corrected Monte Carlo permutation test p-value.
+     *
+     * Applies the “+1” correction often recommended in the permutation-testing literature
+     * (e.g. Good 2005; North et al. 2002) to avoid zero p-values and to yield an unbiased
+     * small-sample estimate.  Given:
+     *   - k = number of permutations whose test statistic ≥ the observed statistic
+     *   - N = total number of permutations run
+     *
+     * this returns
+     * \f[
+     *    p \;=\; \frac{k + 1}{\,N + 1\,}
+     * \f]
+     *
+     * which enforces a minimum p-value of \(1/(N+1)\) when \(k=0\).
+     *
+     * @param k
+     *   Count of “extreme” permutations (i.e. ones at least as good as baseline).
+     * @param N
+     *   Total number of permutations executed.
+     * @return
+     *   A bias-corrected p-value in the interval \([1/(N+1),\,1]\).
+     */
+    static Decimal computePermutationPValue(std::uint32_t k,
+                                            std::uint32_t N)
+    {
+      return Decimal(k + 1) / Decimal(N + 1);
+    }
+
+  private:
+    // SyntheticSource is a SyntheticSecurityPool or a SyntheticPermutationBank
+    template <class SyntheticSource>
+    static ReturnType
+    runPermutations(std::shared_ptr<BackTester<Decimal>> theBackTester,
+		    uint32_t numPermutations,
+		    const Decimal& baseLineTestStat,
+		    SyntheticSource& syntheticSource)
+    {
+      auto aStrategy = *(theBackTester->beginStrategies());
 
       // Minimum trades threshold
       const uint32_t minTrades = BackTestResultPolicy::getMinStrategyTrades();
@@ -140,39 +202,40 @@ namespace mkc_timeseries
       std::mutex                                 testStatMutex;
 
       // Work lambda for one permutation
-      auto work = [=, &validPerms, &extremeCount, &testStatCollector, &testStatMutex]
-	(uint32_t /*permIndex*/)
+      auto work = [=, &validPerms, &extremeCount, &testStatCollector, &testStatMutex, &syntheticSource]
+	(uint32_t permIndex)
       {
-        // 1) Clone & backtest
-        auto clonedStrat = aStrategy->clone(
-					    createSyntheticPortfolio<Decimal>(theSecurity,
-									      aStrategy->getPortfolio()));
-        auto clonedBT = theBackTester->clone();
-        clonedBT->addStrategy(clonedStrat);
-        clonedBT->backtest();
-
-        // 2) Count trades; skip if below threshold
-        uint32_t stratTrades =
-	  BackTesterFactory<Decimal>::getNumClosedTrades(clonedBT);
-        if (stratTrades < minTrades) {
-	  return;  // uninformative — do not increment validPerms
-        }
-
-        // 3) Valid permutation: compute statistic
-        Decimal testStat =
-	  BackTestResultPolicy::getPermutationTestStatistic(clonedBT);
-
-        // 4) Update atomics
-        validPerms.fetch_add(1, std::memory_order_relaxed);
-        if (testStat >= baseLineTestStat) {
-	  extremeCount.fetch_add(1, std::memory_order_relaxed);
-        }
-
-        // 5) Update the summary‐statistic policy under lock
-        {
-	  std::lock_guard<std::mutex> guard(testStatMutex);
-	  testStatCollector.updateTestStatistic(testStat);
-        }
+	syntheticSource.withSyntheticPortfolio(permIndex, aStrategy->getPortfolio(),
+					       [&](const std::shared_ptr<Portfolio<Decimal>>& syntheticPortfolio)
+	{
+	  // 1) Clone & backtest
+	  auto clonedStrat = aStrategy->clone(syntheticPortfolio);
+	  auto clonedBT = theBackTester->clone();
+	  clonedBT->addStrategy(clonedStrat);
+	  clonedBT->backtest();
+
+	  // 2) Count trades; skip if below threshold
+	  uint32_t stratTrades =
+	    BackTesterFactory<Decimal>::getNumClosedTrades(clonedBT);
+	  if (stratTrades < minTrades)
+	    return;  // uninformative — do not increment validPerms
+
+	  // 3) Valid permutation: compute statistic
+	  Decimal testStat =
+	    BackTestResultPolicy::getPermutationTestStatistic(clonedBT);
+
+	  // 4) Update atomics
+	  validPerms.fetch_add(1, std::memory_order_relaxed);
+	  if (testStat >= baseLineTestStat) {
+	    extremeCount.fetch_add(1, std::memory_order_relaxed);
+	  }
+
+	  // 5) Update the summary‐statistic policy under lock
+	  {
+	    std::lock_guard<std::mutex> guard(testStatMutex);
+	    testStatCollector.updateTestStatistic(testStat);
+	  }
+	});
       };
 
       // Execute in parallel
@@ -197,34 +260,247 @@ namespace mkc_timeseries
       return _PermutationTestResultPolicy::createReturnValue(pValue,
 							     summaryTestStat);
     }
+  };
+
+  /**
+   * @brief Detects whether a computation policy can run from a SyntheticPermutationBank, i.e. provides
+   *        `static ReturnType runPermutationTest(std::shared_ptr<BackTester<Decimal>>,
+   *                                              const SyntheticPermutationBank<Decimal>&, const Decimal&)`.
+   */
+  template <class ComputationPolicy, class Decimal, class = void>
+  struct SupportsPermutationBank : std::false_type
+  {};
+
+  template <class ComputationPolicy, class Decimal>
+  struct SupportsPermutationBank<ComputationPolicy, Decimal,
+    std::void_t<decltype(ComputationPolicy::runPermutationTest(std::declval<std::shared_ptr<BackTester<Decimal>>>(),
+							       std::declval<const SyntheticPermutationBank<Decimal>&>(),
+							       std::declval<const Decimal&>()))>>
+    : std::true_type
+  {};
+
+  /**
+   * @class BesagCliffordPermuteMarketChangesPolicy
+   * @brief Monte-Carlo permutation test that stops early once a strategy is clearly not significant.
+   *
+   * Runs the same permutations as DefaultPermuteMarketChangesPolicy (synthetic market, cloned
+   * strategy and backtester, permutations below the minimum trade count are discarded), but
+   * applies the sequential rule of Besag & Clifford (1991):
+   *
+   * - Permutations are taken in index order. Sampling stops as soon as h of them have a test
+   *   statistic greater than or equal to the baseline. If the h-th exceedance happens at valid
+   *   permutation L, the p-value is h / L.
+   * - If fewer than h exceedances occur in all numPermutations permutations, the p-value is
+   *   (k + 1) / (N + 1), exactly as DefaultPermuteMarketChangesPolicy computes it.
+   *
+   * The stopping count depends on the significance level alpha and on numPermutations:
+   * h = max(MinExceedances, floor(alpha * (numPermutations + 1)) + 1) (see getStoppingExceedances).
+   * With that h the early stop never changes a decision at alpha:
+   *
+   * - A strategy whose full-count p-value would be <= alpha has at most alpha * (N + 1) - 1 < h
+   *   exceedances, so it never stops and gets exactly the fixed-count p-value.
+   * - A strategy that stops has p = h / L >= h / numPermutations > alpha.
+   *
+   * Only strategies that are clearly not significant save work: one whose true p-value is p
+   * stops after about h / p permutations. For example, with 5000 permutations and alpha = 0.05,
+   * h is 251 and a strategy with p = 0.5 stops after about 500 permutations. Pass the largest
+   * raw p-value that can still matter to the multiple-testing correction as alpha (e.g. the
+   * false discovery rate for Benjamini-Hochberg selection).
+   *
+   * Permutations run in parallel in blocks of doubling size. The stopping point is found by
+   * scanning each block's results in permutation index order, so the result does not depend on
+   * which thread finished first. The summary statistic is collected over the permutations up
+   * to the stopping point.
+   *
+   * Template parameters are the same as DefaultPermuteMarketChangesPolicy, plus:
+   * @tparam MinExceedances Lower bound on the stopping count h, so a stopped p-value is never
+   *         based on only a handful of exceedances.
+   */
+  template <class Decimal,
+	    class BackTestResultPolicy,
+	    typename _PermutationTestResultPolicy = PValueReturnPolicy<Decimal>,
+	    typename _PermutationTestStatisticsCollectionPolicy = PermutationTestingNullTestStatisticPolicy<Decimal>,
+	    typename Executor = concurrency::WorkStealingExecutor<>,
+	    uint32_t MinExceedances = 10>
+  class BesagCliffordPermuteMarketChangesPolicy
+  {
+    static_assert(has_return_type<_PermutationTestResultPolicy>::value,
+		  "_PermutationTestResultPolicy must define a nested ::ReturnType");
+    static_assert(has_create_return_value<_PermutationTestResultPolicy>::value,
+		  "_PermutationTestResultPolicy must have static createReturnValue(Decimal, Decimal)");
+    static_assert(has_update_test_statistic<_PermutationTestStatisticsCollectionPolicy>::value,
+		  "_PermutationTestStatisticsCollectionPolicy must implement updateTestStatistic(Decimal)");
+    static_assert(has_get_test_stat<_PermutationTestStatisticsCollectionPolicy>::value,
+		  "_PermutationTestStatisticsCollectionPolicy must implement getTestStat()");
+    static_assert(MinExceedances > 0, "MinExceedances must be positive");
+
+  public:
+    using ReturnType = typename _PermutationTestResultPolicy::ReturnType;
+
+    BesagCliffordPermuteMarketChangesPolicy()
+    {}
+
+    ~BesagCliffordPermuteMarketChangesPolicy()
+    {}
+
+    /**
+     * @brief The number of exceedances h after which sampling stops.
+     *
+     * @param numPermutations The maximum number of permutations.
+     * @param alpha The significance level whose decisions the early stop must not change.
+     * @return max(MinExceedances, floor(alpha * (numPermutations + 1)) + 1)
+     */
+    static uint32_t getStoppingExceedances(uint32_t numPermutations, const Decimal& alpha)
+    {
+      const double bound = std::floor(num::to_double(alpha * Decimal(numPermutations + 1)));
+      const uint32_t exceedances = (bound > 0.0) ? static_cast<uint32_t>(bound) + 1 : 1;
+
+      return std::max(MinExceedances, exceedances);
+    }
 
     /**
-     * @brief Computes a bias-corrected Monte Carlo permutation test p-value.
+     * @brief Executes the sequential permutation test for a given trading strategy.
      *
-     * Applies the “+1” correction often recommended in the permutation-testing literature
-     * (e.g. Good 2005; North et al. 2002) to avoid zero p-values and to yield an unbiased
-     * small-sample estimate.  Given:
-     *   - k = number of permutations whose test statistic ≥ the observed statistic
-     *   - N = total number of permutations run
+     * Stops at the significance level DecimalConstants<Decimal>::SignificantPValue.
      *
-     * this returns
-     * \f[
-     *    p \;=\; \frac{k + 1}{\,N + 1\,}
-     * \f]
+     * @param theBackTester A backtester holding the single strategy to test.
+     * @param numPermutations The maximum number of permutations to run.
+     * @param baseLineTestStat The test statistic of the strategy on the original market data.
+     * @return ReturnType The p-value and summary statistic, shaped by `_PermutationTestResultPolicy`.
+     */
+    static ReturnType
+    runPermutationTest(std::shared_ptr<BackTester<Decimal>> theBackTester,
+		       uint32_t numPermutations,
+		       const Decimal& baseLineTestStat)
+    {
+      return runPermutationTest(theBackTester, numPermutations, baseLineTestStat, nullptr);
+    }
+
+    /**
+     * @brief As above, at a given significance level, and reports how many permutations were backtested.
      *
-     * which enforces a minimum p-value of \(1/(N+1)\) when \(k=0\).
+     * @param permutationsRun If not null, receives the number of permutations that were run,
+     * including any that were run in the last block after the stopping point.
+     * @param alpha The significance level used to choose the stopping count (see getStoppingExceedances).
+     */
+    static ReturnType
+    runPermutationTest(std::shared_ptr<BackTester<Decimal>> theBackTester,
+		       uint32_t numPermutations,
+		       const Decimal& baseLineTestStat,
+		       uint32_t* permutationsRun,
+		       const Decimal& alpha = DecimalConstants<Decimal>::SignificantPValue)
+    {
+      auto theSecurity = (*(theBackTester->beginStrategies()))->beginPortfolio()->second;
+      SyntheticSecurityPool<Decimal> syntheticPool(theSecurity);
+
+      return runPermutations(theBackTester, numPermutations, baseLineTestStat, syntheticPool,
+			     permutationsRun, alpha);
+    }
+
+    /**
+     * @brief Executes the sequential test on the pre-generated synthetic markets of a bank.
      *
-     * @param k
-     *   Count of “extreme” permutations (i.e. ones at least as good as baseline).
-     * @param N
-     *   Total number of permutations executed.
-     * @return
-     *   A bias-corrected p-value in the interval \([1/(N+1),\,1]\).
+     * Permutation i uses bank.getSyntheticSecurity(i), so at most bank.getNumPermutations()
+     * permutations are run.
      */
-    static Decimal computePermutationPValue(std::uint32_t k,
-                                            std::uint32_t N)
+    static ReturnType
+    runPermutationTest(std::shared_ptr<BackTester<Decimal>> theBackTester,
+		       const SyntheticPermutationBank<Decimal>& bank,
+		       const Decimal& baseLineTestStat,
+		       uint32_t* permutationsRun = nullptr,
+		       const Decimal& alpha = DecimalConstants<Decimal>::SignificantPValue)
     {
-      return Decimal(k + 1) / Decimal(N + 1);
+      return runPermutations(theBackTester, bank.getNumPermutations(), baseLineTestStat, bank,
+			     permutationsRun, alpha);
+    }
+
+  private:
+    // SyntheticSource is a SyntheticSecurityPool or a SyntheticPermutationBank
+    template <class SyntheticSource>
+    static ReturnType
+    runPermutations(std::shared_ptr<BackTester<Decimal>> theBackTester,
+		    uint32_t numPermutations,
+		    const Decimal& baseLineTestStat,
+		    SyntheticSource& syntheticSource,
+		    uint32_t* permutationsRun,
+		    const Decimal& alpha)
+    {
+      const uint32_t stoppingExceedances = getStoppingExceedances(numPermutations, alpha);
+
+      auto aStrategy = *(theBackTester->beginStrategies());
+
+      const uint32_t minTrades = BackTestResultPolicy::getMinStrategyTrades();
+
+      // Results by permutation index, so the stopping point is independent of thread timing
+      std::vector<char>    validPerm(numPermutations, 0);
+      std::vector<Decimal> permStats(numPermutations);
+
+      auto work = [=, &validPerm, &permStats, &syntheticSource](uint32_t permIndex)
+      {
+	syntheticSource.withSyntheticPortfolio(permIndex, aStrategy->getPortfolio(),
+					       [&](const std::shared_ptr<Portfolio<Decimal>>& syntheticPortfolio)
+	{
+	  auto clonedStrat = aStrategy->clone(syntheticPortfolio);
+	  auto clonedBT = theBackTester->clone();
+	  clonedBT->addStrategy(clonedStrat);
+	  clonedBT->backtest();
+
+	  if (BackTesterFactory<Decimal>::getNumClosedTrades(clonedBT) >= minTrades)
+	    {
+	      permStats[permIndex] = BackTestResultPolicy::getPermutationTestStatistic(clonedBT);
+	      validPerm[permIndex] = 1;
+	    }
+	});
+      };
+
+      _PermutationTestStatisticsCollectionPolicy testStatCollector;
+      Executor executor{};
+
+      uint32_t validPerms = 0;
+      uint32_t extremeCount = 0;
+      uint32_t nextPerm = 0;
+      bool stopped = false;
+
+      const unsigned hw = std::thread::hardware_concurrency();
+      uint32_t blockSize = std::max<uint32_t>(2 * stoppingExceedances, 4 * (hw ? hw : 2));
+
+      while (nextPerm < numPermutations && !stopped)
+	{
+	  const uint32_t blockStart = nextPerm;
+	  const uint32_t blockEnd = blockStart + std::min(blockSize, numPermutations - blockStart);
+
+	  concurrency::parallel_for(blockEnd - blockStart, executor,
+				    [&work, blockStart](uint32_t i) { work(blockStart + i); });
+
+	  for (uint32_t p = blockStart; p < blockEnd && !stopped; ++p)
+	    {
+	      if (!validPerm[p])
+		continue;
+
+	      ++validPerms;
+	      testStatCollector.updateTestStatistic(permStats[p]);
+
+	      if (permStats[p] >= baseLineTestStat)
+		stopped = (++extremeCount == stoppingExceedances);
+	    }
+
+	  nextPerm = blockEnd;
+	  if (blockSize < numPermutations)
+	    blockSize *= 2;
+	}
+
+      if (permutationsRun)
+	*permutationsRun = nextPerm;
+
+      if (validPerms == 0)
+	return _PermutationTestResultPolicy::createReturnValue(Decimal(1), testStatCollector.getTestStat());
+
+      const Decimal pValue = stopped
+	? Decimal(extremeCount) / Decimal(validPerms)
+	: DefaultPermuteMarketChangesPolicy<Decimal, BackTestResultPolicy>::computePermutationPValue(extremeCount,
+												      validPerms);
+
+      return _PermutationTestResultPolicy::createReturnValue(pValue, testStatCollector.getTestStat());
     }
   };
 }
@@ -0,0 +1,148 @@
+// Copyright (C) MKC Associates, LLC - All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+// Written by Michael K. Collison <collison956@gmail.com>, November 2017
+//
+#ifndef __SYNTHETIC_PERMUTATION_BANK_H
+#define __SYNTHETIC_PERMUTATION_BANK_H 1
+
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include "number.h"
+#include "Security.h"
+#include "Portfolio.h"
+#include "TimeSeries.h"
+#include "SyntheticSecurityHelpers.h"
+#include "ParallelExecutors.h"
+#include "ParallelFor.h"
+
+namespace mkc_timeseries
+{
+  /**
+   * @class SyntheticPermutationBank
+   * @brief A fixed set of synthetic securities, generated once and shared read-only between permutation tests.
+   *
+   * When many strategies on the same security are tested, each permutation test would otherwise
+   * shuffle and integrate its own numPermutations synthetic series. The bank generates them once.
+   * Permutation i of every test then uses the same synthetic market, so generation costs
+   * O(permutations) instead of O(strategies x permutations).
+   *
+   * Each synthetic series is an ordinary OHLCTimeSeries, with its column arrays already built,
+   * wrapped in a clone of the real security. Nothing in the bank changes after construction, so
+   * any number of threads may read it concurrently.
+   *
+   * Memory grows with numPermutations x bars. The bank is meant for the out-of-sample ranges
+   * that are validated, not for full multi-decade histories.
+   *
+   * @tparam Decimal The numeric type used for prices.
+   */
+  template <class Decimal>
+  class SyntheticPermutationBank
+  {
+  public:
+    /**
+     * @brief Generates numPermutations synthetic securities from realSecurity in parallel.
+     *
+     * @param realSecurity The security whose series is permuted.
+     * @param numPermutations The number of synthetic securities to generate; must be positive.
+     * @param executor The executor the generation runs on.
+     * @throws std::invalid_argument if numPermutations is zero.
+     */
+    template <class Executor>
+    SyntheticPermutationBank(const std::shared_ptr<Security<Decimal>>& realSecurity,
+			     uint32_t numPermutations,
+			     Executor& executor)
+      : mRealSecurity(realSecurity),
+	mSyntheticSecurities(numPermutations)
+    {
+      generate(executor);
+    }
+
+    /**
+     * @brief Generates numPermutations synthetic securities on a WorkStealingExecutor.
+     */
+    SyntheticPermutationBank(const std::shared_ptr<Security<Decimal>>& realSecurity,
+			     uint32_t numPermutations)
+      : mRealSecurity(realSecurity),
+	mSyntheticSecurities(numPermutations)
+    {
+      concurrency::WorkStealingExecutor<> executor;
+      generate(executor);
+    }
+
+    SyntheticPermutationBank(const SyntheticPermutationBank&) = delete;
+    SyntheticPermutationBank& operator=(const SyntheticPermutationBank&) = delete;
+
+    uint32_t getNumPermutations() const
+    {
+      return static_cast<uint32_t>(mSyntheticSecurities.size());
+    }
+
+    const std::shared_ptr<Security<Decimal>>& getRealSecurity() const
+    {
+      return mRealSecurity;
+    }
+
+    const std::shared_ptr<Security<Decimal>>& getSyntheticSecurity(uint32_t permIndex) const
+    {
+      return mSyntheticSecurities.at(permIndex);
+    }
+
+    /**
+     * @brief Returns a new portfolio, named like realPortfolio, holding synthetic security permIndex.
+     */
+    std::shared_ptr<Portfolio<Decimal>>
+    createSyntheticPortfolio(uint32_t permIndex,
+			     const std::shared_ptr<Portfolio<Decimal>>& realPortfolio) const
+    {
+      std::shared_ptr<Portfolio<Decimal>> syntheticPortfolio = realPortfolio->clone();
+      syntheticPortfolio->addSecurity (getSyntheticSecurity(permIndex));
+
+      return syntheticPortfolio;
+    }
+
+    /**
+     * @brief Calls fn with a synthetic portfolio for permutation permIndex.
+     *
+     * Same interface as SyntheticSecurityPool::withSyntheticPortfolio(), so the permutation
+     * policies can run from either source.
+     */
+    template <class Fn>
+    void withSyntheticPortfolio(uint32_t permIndex,
+				const std::shared_ptr<Portfolio<Decimal>>& realPortfolio,
+				Fn&& fn) const
+    {
+      fn(createSyntheticPortfolio(permIndex, realPortfolio));
+    }
+
+  private:
+    template <class Executor>
+    void generate(Executor& executor)
+    {
+      if (mSyntheticSecurities.empty())
+	throw std::invalid_argument("SyntheticPermutationBank: number of permutations must be positive");
+
+      SyntheticSecurityPool<Decimal> syntheticPool(mRealSecurity);
+
+      concurrency::parallel_for(getNumPermutations(), executor,
+				[this, &syntheticPool](uint32_t permIndex)
+				{
+				  auto syntheticGenerator = syntheticPool.acquire();
+				  auto reusedSecurity = syntheticGenerator->createSyntheticSecurity();
+
+				  // The generator overwrites its series on the next permutation, keep a copy
+				  auto series = std::make_shared<const OHLCTimeSeries<Decimal>>(*reusedSecurity->getTimeSeries());
+				  mSyntheticSecurities[permIndex] = mRealSecurity->clone(series);
+
+				  syntheticPool.release(std::move(syntheticGenerator));
+				});
+    }
+
+  private:
+    std::shared_ptr<Security<Decimal>> mRealSecurity;
+    std::vector<std::shared_ptr<Security<Decimal>>> mSyntheticSecurities;
+  };
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+#include "PalBatchBacktester.h"
+#include "StrategyDataPreparer.h"
+#include "MastersPermutationTestComputationPolicy.h"
+#include "MonteCarloTestPolicy.h"
+#include "TestUtils.h"
+#include "Security.h"
+#include <memory>
+#include <vector>
+
+using namespace mkc_timeseries;
+
+namespace {
+
+  std::shared_ptr<BackTester<DecimalType>>
+  backtestSingleStrategy(const std::shared_ptr<PalStrategy<DecimalType>>& strategy,
+			 const std::shared_ptr<BackTester<DecimalType>>& templateBackTester,
+			 const std::shared_ptr<Portfolio<DecimalType>>& portfolio)
+  {
+    auto bt = templateBackTester->clone();
+    bt->addStrategy(strategy->clone(portfolio));
+    bt->backtest();
+    return bt;
+  }
+}
+
+TEST_CASE("PalBatchBacktester matches BackTester trade by trade", "[PalBatchBacktester]") {
+  auto realSeries = getRandomPriceSeries();
+  REQUIRE(realSeries);
+
+  auto security = std::make_shared<EquitySecurity<DecimalType>>("QQQ", "RandomSecurity", realSeries);
+  auto bt = BackTesterFactory<DecimalType>::getBackTester(realSeries->getTimeFrame(),
+							  realSeries->getFirstDate(),
+							  realSeries->getLastDate());
+  REQUIRE(PalBatchBacktester<DecimalType>::supportsBackTester(bt));
+
+  auto patterns = getRandomPricePatterns();
+  REQUIRE(patterns);
+
+  auto strategyData = StrategyDataPreparer<DecimalType, NonGranularProfitFactorPolicy<DecimalType>>::prepare(bt, security, patterns);
+  REQUIRE(!strategyData.empty());
+
+  std::vector<std::shared_ptr<PalStrategy<DecimalType>>> strategies;
+  for (auto const& ctx : strategyData)
+    {
+      REQUIRE(PalBatchBacktester<DecimalType>::supportsStrategy(ctx.strategy));
+      strategies.push_back(ctx.strategy);
+    }
+
+  PalBatchBacktester<DecimalType> batch(strategies, bt->getStartDate(), bt->getEndDate());
+  REQUIRE(batch.getNumStrategies() == strategies.size());
+
+  std::vector<BatchStrategyResult<DecimalType>> results;
+  batch.backtest(security.get(), results);
+  REQUIRE(results.size() == strategies.size());
+
+  auto portfolio = std::make_shared<Portfolio<DecimalType>>("QQQ Portfolio");
+  portfolio->addSecurity(security);
+
+  for (size_t i = 0; i < strategies.size(); ++i)
+    {
+      auto btStrategy = backtestSingleStrategy(strategies[i], bt, portfolio);
+      auto stratPtr = *(btStrategy->beginStrategies());
+      const auto& closedHistory = stratPtr->getStrategyBroker().getClosedPositionHistory();
+
+      REQUIRE(results[i].getNumClosedTrades() == BackTesterFactory<DecimalType>::getNumClosedTrades(btStrategy));
+      REQUIRE(results[i].getNumWinningTrades() == closedHistory.getNumWinningPositions());
+      REQUIRE(results[i].getLogProfitFactor() == closedHistory.getLogProfitFactor());
+      REQUIRE(results[i].getCumulativeReturn() == closedHistory.getCumulativeReturn());
+      REQUIRE(results[i].getHighResReturns() == btStrategy->getAllHighResReturns(stratPtr.get()));
+      REQUIRE(AllHighResLogPFPolicy<DecimalType>::getPermutationTestStatistic(results[i]) ==
+	      AllHighResLogPFPolicy<DecimalType>::getPermutationTestStatistic(btStrategy));
+    }
+}
+
+TEST_CASE("BatchStrategyResult statistics for empty and one-sided histories", "[PalBatchBacktester]") {
+  BatchStrategyResult<DecimalType> result;
+
+  REQUIRE(result.getNumClosedTrades() == 0);
+  REQUIRE(result.getLogProfitFactor() == DecimalType("0"));
+  REQUIRE(result.getCumulativeReturn() == DecimalType("0"));
+
+  result.addClosedTrade(DecimalType("0.02"), DecimalType("2.0"), DecimalType("0.0198026"));
+  REQUIRE(result.getNumWinningTrades() == 1);
+  REQUIRE(result.getProfitFactor() == DecimalType("100"));
+  REQUIRE(result.getCumulativeReturn() == DecimalType("0.02"));
+
+  result.addClosedTrade(DecimalType("-0.01"), DecimalType("-1.0"), DecimalType("-0.0100503"));
+  REQUIRE(result.getNumLosingTrades() == 1);
+  REQUIRE(result.getProfitFactor() == DecimalType("2"));
+  REQUIRE(result.getCumulativeReturn() == DecimalType("0.0098"));
+
+  result.clear();
+  REQUIRE(result.getNumClosedTrades() == 0);
+  REQUIRE(result.getHighResReturns().empty());
+}
+
+TEST_CASE("FastMastersPermutationPolicy uses the batch backtester for batch capable policies", "[PalBatchBacktester][integration]") {
+  auto realSeries = getRandomPriceSeries();
+  REQUIRE(realSeries);
+
+  auto security = std::make_shared<EquitySecurity<DecimalType>>("QQQ", "RandomSecurity", realSeries);
+  auto bt = BackTesterFactory<DecimalType>::getBackTester(realSeries->getTimeFrame(),
+							  realSeries->getFirstDate(),
+							  realSeries->getLastDate());
+  auto patterns = getRandomPricePatterns();
+  REQUIRE(patterns);
+
+  using StatPolicy = NonGranularProfitFactorPolicy<DecimalType>;
+  REQUIRE(SupportsBatchPermutationStatistic<StatPolicy, DecimalType>::value);
+
+  auto strategyData = StrategyDataPreparer<DecimalType, StatPolicy>::prepare(bt, security, patterns);
+  REQUIRE(!strategyData.empty());
+
+  auto portfolio = std::make_shared<Portfolio<DecimalType>>(security->getName() + " Portfolio");
+  portfolio->addSecurity(security);
+
+  const uint32_t numPermutations = 200;
+  auto counts = FastMastersPermutationPolicy<DecimalType, StatPolicy>::computeAllPermutationCounts(numPermutations,
+												  strategyData,
+												  bt,
+												  security,
+												  portfolio);
+
+  REQUIRE(counts.size() == strategyData.size());
+  for (auto const& ctx : strategyData)
+    {
+      REQUIRE(counts.at(ctx.strategy) >= 1);
+      REQUIRE(counts.at(ctx.strategy) <= numPermutations + 1);
+    }
+}
@@ -2,6 +2,7 @@
 #include <memory>
 #include <vector>
 #include <tuple>
+#include <atomic>
 #include "PermutationTestComputationPolicy.h"
 #include "TestUtils.h"
 #include "Security.h"
@@ -30,6 +31,34 @@ namespace {
     static unsigned int getMinStrategyTrades() { return 0; }
   };
 
+  // Policy that returns a high statistic and counts how many permutations asked for it
+  struct CountingHighStatPolicy {
+    static std::atomic<uint32_t>& numCalls() {
+      static std::atomic<uint32_t> calls{0};
+      return calls;
+    }
+    static DecimalType getPermutationTestStatistic(const std::shared_ptr<BackTester<DecimalType>>&) {
+      numCalls().fetch_add(1);
+      return DecimalType("0.5");
+    }
+    static unsigned int getMinStrategyTrades() { return 0; }
+  };
+
+  // Policy where every Period-th call returns a statistic above the baseline, so a run of
+  // N permutations has exactly N / Period exceedances whatever order the threads finish in
+  template <uint32_t Period>
+  struct PeriodicHighStatPolicy {
+    static std::atomic<uint32_t>& numCalls() {
+      static std::atomic<uint32_t> calls{0};
+      return calls;
+    }
+    static DecimalType getPermutationTestStatistic(const std::shared_ptr<BackTester<DecimalType>>&) {
+      const uint32_t call = numCalls().fetch_add(1) + 1;
+      return (call % Period == 0) ? DecimalType("0.5") : DecimalType("0.1");
+    }
+    static unsigned int getMinStrategyTrades() { return 0; }
+  };
+
   // A minimal BackTester that does nothing
   class DummyBackTester : public BackTester<DecimalType> {
   public:
@@ -164,3 +193,153 @@ TEST_CASE("DefaultPermuteMarketChangesPolicy with max-statistic collection yield
   REQUIRE(maxStat == DecimalType("0.5"));
 }
 
+
+TEST_CASE("BesagCliffordPermuteMarketChangesPolicy stops once the exceedance limit is reached", "[unit]") {
+  auto bt = std::make_shared<DummyBackTester>();
+  auto portfolio = createDummyPortfolio();
+  auto strat = std::make_shared<DummyPalStrategy>(portfolio);
+  bt->addStrategy(strat);
+
+  DecimalType baseline("0.4");
+  uint32_t numPerms = 5000;
+  uint32_t permutationsRun = 0;
+
+  using SequentialPolicy = BesagCliffordPermuteMarketChangesPolicy<
+    DecimalType,
+    CountingHighStatPolicy,
+    PValueAndTestStatisticReturnPolicy<DecimalType>,
+    PermutationTestingMaxTestStatisticPolicy<DecimalType>
+  >;
+
+  CountingHighStatPolicy::numCalls() = 0;
+  auto result = SequentialPolicy::runPermutationTest(bt, numPerms, baseline, &permutationsRun);
+  auto [pValue, maxStat] = result;
+
+  // Every permutation exceeds the baseline: the h-th exceedance is the h-th permutation, p = h/h
+  REQUIRE(pValue == DecimalType("1.0"));
+  REQUIRE(maxStat == DecimalType("0.5"));
+  REQUIRE(permutationsRun < numPerms);
+  REQUIRE(CountingHighStatPolicy::numCalls().load() == permutationsRun);
+}
+
+TEST_CASE("BesagCliffordPermuteMarketChangesPolicy derives the stopping count from alpha", "[unit]") {
+  using SequentialPolicy = BesagCliffordPermuteMarketChangesPolicy<DecimalType, AlwaysLowStatPolicy>;
+
+  // floor(alpha * (N + 1)) + 1
+  REQUIRE(SequentialPolicy::getStoppingExceedances(5000, DecimalType("0.05")) == 251);
+  REQUIRE(SequentialPolicy::getStoppingExceedances(5000, DecimalType("0.01")) == 51);
+  REQUIRE(SequentialPolicy::getStoppingExceedances(99, DecimalType("0.05")) == 10);
+  // Never below MinExceedances
+  REQUIRE(SequentialPolicy::getStoppingExceedances(100, DecimalType("0.01")) == 10);
+  REQUIRE(SequentialPolicy::getStoppingExceedances(5000, DecimalType("0.0")) == 10);
+}
+
+TEST_CASE("BesagCliffordPermuteMarketChangesPolicy keeps the full count near alpha", "[unit]") {
+  auto bt = std::make_shared<DummyBackTester>();
+  auto portfolio = createDummyPortfolio();
+  auto strat = std::make_shared<DummyPalStrategy>(portfolio);
+  bt->addStrategy(strat);
+
+  const DecimalType baseline("0.4");
+  const DecimalType alpha("0.05");
+  const uint32_t numPerms = 1000;
+
+  SECTION("A p-value just below alpha is the fixed-count p-value") {
+    // 40 exceedances in 1000: p = 41/1001, about 0.041. A fixed stop at 10 exceedances
+    // would have ended after about 250 permutations.
+    using NearPolicy = PeriodicHighStatPolicy<25>;
+    uint32_t permutationsRun = 0;
+
+    NearPolicy::numCalls() = 0;
+    auto pValue = BesagCliffordPermuteMarketChangesPolicy<DecimalType, NearPolicy>::runPermutationTest(
+      bt, numPerms, baseline, &permutationsRun, alpha);
+
+    REQUIRE(permutationsRun == numPerms);
+    REQUIRE(pValue == DecimalType(41) / DecimalType(1001));
+    REQUIRE(pValue <= alpha);
+
+    NearPolicy::numCalls() = 0;
+    REQUIRE(pValue == DefaultPermuteMarketChangesPolicy<DecimalType, NearPolicy>::runPermutationTest(
+      bt, numPerms, baseline));
+  }
+
+  SECTION("A p-value well above alpha stops early and stays above alpha") {
+    // True p = 0.2: the 51st exceedance comes after about 255 permutations
+    using FarPolicy = PeriodicHighStatPolicy<5>;
+    uint32_t permutationsRun = 0;
+
+    FarPolicy::numCalls() = 0;
+    auto pValue = BesagCliffordPermuteMarketChangesPolicy<DecimalType, FarPolicy>::runPermutationTest(
+      bt, numPerms, baseline, &permutationsRun, alpha);
+
+    REQUIRE(permutationsRun < numPerms);
+    REQUIRE(pValue > alpha);
+  }
+}
+
+TEST_CASE("BesagCliffordPermuteMarketChangesPolicy runs every permutation when the limit is not reached", "[unit]") {
+  auto bt = std::make_shared<DummyBackTester>();
+  auto portfolio = createDummyPortfolio();
+  auto strat = std::make_shared<DummyPalStrategy>(portfolio);
+  bt->addStrategy(strat);
+
+  DecimalType baseline("0.5");
+  uint32_t numPerms = 99;
+  uint32_t permutationsRun = 0;
+
+  auto pValue = BesagCliffordPermuteMarketChangesPolicy<DecimalType, AlwaysLowStatPolicy>::runPermutationTest(
+    bt, numPerms, baseline, &permutationsRun
+  );
+
+  // Same p-value as the fixed-count policy: (0+1)/(99+1)
+  REQUIRE(permutationsRun == numPerms);
+  REQUIRE(pValue == DecimalType("0.01"));
+  REQUIRE(pValue == DefaultPermuteMarketChangesPolicy<DecimalType, AlwaysLowStatPolicy>::runPermutationTest(
+    bt, numPerms, baseline));
+}
+
+TEST_CASE("Permutation policies run from a shared SyntheticPermutationBank", "[unit]") {
+  auto bt = std::make_shared<DummyBackTester>();
+  auto portfolio = createDummyPortfolio();
+  auto strat = std::make_shared<DummyPalStrategy>(portfolio);
+  bt->addStrategy(strat);
+
+  auto realSecurity = portfolio->beginPortfolio()->second;
+  auto bank = std::make_shared<const SyntheticPermutationBank<DecimalType>>(realSecurity, 20);
+
+  REQUIRE(bank->getNumPermutations() == 20);
+  REQUIRE(bank->getRealSecurity() == realSecurity);
+
+  auto realSeries = realSecurity->getTimeSeries();
+  for (uint32_t i = 0; i < bank->getNumPermutations(); ++i)
+    {
+      auto synthetic = bank->getSyntheticSecurity(i);
+      REQUIRE(synthetic != realSecurity);
+      REQUIRE(synthetic->getSymbol() == realSecurity->getSymbol());
+      REQUIRE(synthetic->getTimeSeries()->getNumEntries() == realSeries->getNumEntries());
+      REQUIRE(synthetic->getTimeSeries()->getFirstDate() == realSeries->getFirstDate());
+      REQUIRE(synthetic->getTimeSeries()->getLastDate() == realSeries->getLastDate());
+    }
+
+  auto syntheticPortfolio = bank->createSyntheticPortfolio(3, portfolio);
+  REQUIRE(syntheticPortfolio->getPortfolioName() == portfolio->getPortfolioName());
+  REQUIRE(syntheticPortfolio->beginPortfolio()->second == bank->getSyntheticSecurity(3));
+
+  DecimalType baseline("0.5");
+
+  auto pValue = DefaultPermuteMarketChangesPolicy<DecimalType, AlwaysLowStatPolicy>::runPermutationTest(
+    bt, *bank, baseline
+  );
+  // (0+1)/(20+1), same as generating the permutations per test
+  REQUIRE(pValue == DefaultPermuteMarketChangesPolicy<DecimalType, AlwaysLowStatPolicy>::runPermutationTest(
+    bt, bank->getNumPermutations(), baseline));
+
+  uint32_t permutationsRun = 0;
+  auto sequentialPValue = BesagCliffordPermuteMarketChangesPolicy<DecimalType, AlwaysLowStatPolicy>::runPermutationTest(
+    bt, *bank, baseline, &permutationsRun
+  );
+  REQUIRE(permutationsRun == bank->getNumPermutations());
+  REQUIRE(sequentialPValue == pValue);
+
+  REQUIRE(SupportsPermutationBank<DefaultPermuteMarketChangesPolicy<DecimalType, AlwaysLowStatPolicy>, DecimalType>::value);
+}
@@ -0,0 +1,85 @@
+// Copyright (C) MKC Associates, LLC - All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+//
+
+#ifndef __BINARY_CACHE_UTILS_H
+#define __BINARY_CACHE_UTILS_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <boost/filesystem.hpp>
+
+namespace mkc_timeseries
+{
+  /**
+   * @brief Helpers shared by the on-disk binary caches (TimeSeriesBinaryCache, BacktestMatrixCache).
+   */
+  namespace binary_cache
+  {
+    constexpr uint64_t FnvOffsetBasis = 14695981039346656037ULL;
+    constexpr uint64_t FnvPrime = 1099511628211ULL;
+
+    /**
+     * @brief 64 bit FNV-1a hash of length bytes, continuing from hash.
+     */
+    inline uint64_t hashBytes(const void *bytes, size_t length, uint64_t hash = FnvOffsetBasis)
+    {
+      const unsigned char *data = static_cast<const unsigned char *>(bytes);
+      for (size_t i = 0; i < length; i++)
+	{
+	  hash ^= data[i];
+	  hash *= FnvPrime;
+	}
+
+      return hash;
+    }
+
+    /**
+     * @brief Writes fileName through writeContents(std::ofstream&) to a temporary file, then renames it into place.
+     *
+     * The temporary name is unique per writer, so a concurrent reader never sees a partial file and
+     * concurrent writers do not interleave. Writing is best effort: on any failure (including an
+     * exception thrown by writeContents) the temporary file is removed and false is returned.
+     *
+     * @return true if fileName was written.
+     */
+    template <class Writer>
+    bool writeFileAtomically(const std::string& fileName, Writer writeContents)
+    {
+      const std::string tempFileName =
+	fileName + "." + boost::filesystem::unique_path("%%%%-%%%%-%%%%").string() + ".tmp";
+
+      try
+	{
+	  std::ofstream out(tempFileName, std::ios::binary | std::ios::trunc);
+	  if (!out)
+	    return false;
+
+	  writeContents(out);
+
+	  out.close();
+	  if (!out)
+	    {
+	      boost::system::error_code ec;
+	      boost::filesystem::remove(tempFileName, ec);
+	      return false;
+	    }
+
+	  boost::filesystem::rename(tempFileName, fileName);
+	  return true;
+	}
+      catch (const std::exception&)
+	{
+	  boost::system::error_code ec;
+	  boost::filesystem::remove(tempFileName, ec);
+	  return false;
+	}
+    }
+  }
+}
+
+#endif
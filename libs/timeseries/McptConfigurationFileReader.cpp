@@ -11,6 +11,7 @@
 #include "TimeFrameUtility.h"
 #include "TimeSeriesEntry.h"
 #include "TimeSeriesCsvReader.h"
+#include "TimeSeriesBinaryCache.h"
 #include "SecurityAttributes.h"
 #include "SecurityAttributesFactory.h"
 #include <cstdio>
@@ -84,12 +85,12 @@ namespace mkc_timeseries
       fileFormat = "TRADESTATION";
     }
 
-    std::shared_ptr<TimeSeriesCsvReader<Decimal>> reader = getHistoricDataFileReader(
+    std::shared_ptr<TimeSeriesCsvReader<Decimal>> reader = withBinaryCache<Decimal>(getHistoricDataFileReader(
                 dataFilename,
                 fileFormat,
 								backTestingTimeFrame,
 								getVolumeUnit(attributes),
-								attributes->getTick());
+								attributes->getTick()));
     reader->readFile();
 
     //dataSourceReader->destroyFiles(); // TODO: delete temp files
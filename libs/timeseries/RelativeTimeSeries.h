@@ -22,7 +22,7 @@ namespace mkc_timeseries
   class RelativeTimeSeries
   {
   public:
-    typedef vector<Decimal>::const_iterator ConstRelativeTimeSeriesIterator;
+    typedef typename std::vector<Decimal>::const_iterator ConstRelativeTimeSeriesIterator;
     
   public:
     explicit RelativeTimeSeries(const OHLCTimeSeries<Decimal>& aTimeSeries)
@@ -34,62 +34,55 @@ namespace mkc_timeseries
 	mRelativeVolume(),
 	mNumElements (aTimeSeries.getNumEntries())
     {
-      mDateSeries.reserve (aTimeSeries.getNumEntries()),
-      mRelativeOpen.reserve(aTimeSeries.getNumEntries());
-      mRelativeHigh.reserve(aTimeSeries.getNumEntries());
-      mRelativeLow.reserve(aTimeSeries.getNumEntries());
-      mRelativeClose.reserve(aTimeSeries.getNumEntries());
+      mDateSeries.reserve (mNumElements);
+      mRelativeOpen.reserve(mNumElements);
+      mRelativeHigh.reserve(mNumElements);
+      mRelativeLow.reserve(mNumElements);
+      mRelativeClose.reserve(mNumElements);
 
 #ifdef SYNTHETIC_VOLUME
-      mRelativeVolume.reserve(aTimeSeries.getNumEntries());
+      mRelativeVolume.reserve(mNumElements);
 #endif
-      Decimal valueOfOne (DecimalConstants<Decimal>::DecimalOne);
-      Decimal currentOpen (DecimalConstants<Decimal>::DecimalZero);
-
-      typename OHLCTimeSeries<Decimal>::ConstRandomAccessIterator it = aTimeSeries.beginRandomAccess();
+      if (mNumElements == 0)
+	return;
 
-      mRelativeOpen.push_back(valueOfOne);
-#ifdef SYNTHETIC_VOLUME
-      mRelativeVolume.push_back(valueOfOne);
-#endif      
+      // Read the series column by column so each pass is a linear scan
+      // over contiguous values
+      const auto& dates = aTimeSeries.getDateTimeColumn();
+      const auto& opens = aTimeSeries.getOpenColumn();
+      const auto& highs = aTimeSeries.getHighColumn();
+      const auto& lows = aTimeSeries.getLowColumn();
+      const auto& closes = aTimeSeries.getCloseColumn();
 
-      Decimal firstOpen (aTimeSeries.getOpenValue (it, 0));
-      
-#ifdef SYNTHETIC_VOLUME
-      Decimal firstVolume (aTimeSeries.getVolumeValue (it, 0));
-#endif
-      
-      mRelativeHigh.push_back(aTimeSeries.getHighValue (it, 0) / firstOpen);
-      mRelativeLow.push_back(aTimeSeries.getLowValue (it, 0) / firstOpen);
-      mRelativeClose.push_back(aTimeSeries.getCloseValue (it, 0) /firstOpen) ;
-      mDateSeries.push_back (aTimeSeries.getDateValue(it, 0));
+      Decimal valueOfOne (DecimalConstants<Decimal>::DecimalOne);
 
-      it++;
+      mRelativeOpen.push_back(valueOfOne);
+      for (size_t i = 1; i < mNumElements; i++)
+	mRelativeOpen.push_back(opens[i] / closes[i - 1]);
 
-      for (; it != aTimeSeries.endRandomAccess(); it++)
+      for (size_t i = 0; i < mNumElements; i++)
 	{
-	  currentOpen = aTimeSeries.getOpenValue (it, 0);
+	  const Decimal& currentOpen = opens[i];
 
-	  mRelativeOpen.push_back(currentOpen / aTimeSeries.getCloseValue (it, 1));
-	  mRelativeHigh.push_back(aTimeSeries.getHighValue (it, 0) / currentOpen) ;
-	  mRelativeLow.push_back(aTimeSeries.getLowValue (it, 0) / currentOpen) ;
-	  mRelativeClose.push_back(aTimeSeries.getCloseValue (it, 0) / currentOpen) ;
+	  mRelativeHigh.push_back(highs[i] / currentOpen);
+	  mRelativeLow.push_back(lows[i] / currentOpen);
+	  mRelativeClose.push_back(closes[i] / currentOpen);
+	  mDateSeries.push_back (dates[i].date());
+	}
 
 #ifdef SYNTHETIC_VOLUME
-	  if ((aTimeSeries.getVolumeValue (it, 0) > DecimalConstants<Decimal>::DecimalZero) &&
-	      (aTimeSeries.getVolumeValue (it, 1) > DecimalConstants<Decimal>::DecimalZero))
-	    {
-	      mRelativeVolume.push_back (aTimeSeries.getVolumeValue (it, 0) /
-					     aTimeSeries.getVolumeValue (it, 1));
-	    }
+      const auto& volumes = aTimeSeries.getVolumeColumn();
+
+      mRelativeVolume.push_back(valueOfOne);
+      for (size_t i = 1; i < mNumElements; i++)
+	{
+	  if ((volumes[i] > DecimalConstants<Decimal>::DecimalZero) &&
+	      (volumes[i - 1] > DecimalConstants<Decimal>::DecimalZero))
+	    mRelativeVolume.push_back (volumes[i] / volumes[i - 1]);
 	  else
-	    {
-	      mRelativeVolume.push_back (valueOfOne);
-	    }
-#endif
-	  mDateSeries.push_back (aTimeSeries.getDateValue(it,0));
+	    mRelativeVolume.push_back (valueOfOne);
 	}
-
+#endif
     }
 
     unsigned long getNumElements() const
@@ -145,7 +138,7 @@ namespace mkc_timeseries
 
     std::vector<Decimal> getCloseRelativeSeries() const
     {
-      return mRelativeLow;
+      return mRelativeClose;
     }
 
     ConstRelativeTimeSeriesIterator beginCloseRelativeSeries() const
@@ -163,12 +156,12 @@ namespace mkc_timeseries
       return mDateSeries;
     }
     
-    ConstRelativeTimeSeriesIterator beginDateRelativeSeries() const
+    typename std::vector<boost::gregorian::date>::const_iterator beginDateRelativeSeries() const
     {
       return mDateSeries.begin();
     }
 
-    ConstRelativeTimeSeriesIterator endDateRelativeSeries() const
+    typename std::vector<boost::gregorian::date>::const_iterator endDateRelativeSeries() const
     {
       return mDateSeries.end();
     }
@@ -232,7 +225,7 @@ namespace mkc_timeseries
   class SyntheticRelativeTimeSeries
   {
   public:
-    typedef vector<Decimal>::const_iterator ConstRelativeTimeSeriesIterator;
+    typedef typename std::vector<Decimal>::const_iterator ConstRelativeTimeSeriesIterator;
     
   public:
     explicit SyntheticRelativeTimeSeries(const RelativeTimeSeries<Decimal>& aRelativeTimeSeries)
@@ -241,7 +234,7 @@ namespace mkc_timeseries
 	mRelativeLow(aRelativeTimeSeries.getLowRelativeSeries()),
 	mRelativeClose(aRelativeTimeSeries.getCloseRelativeSeries()),
 	mRelativeVolume(),
-	mNumElements(aRelativeTimeSeries.getNumEntries()),
+	mNumElements(aRelativeTimeSeries.getNumElements()),
 	mRandGenerator()
     {
     }
@@ -249,7 +242,7 @@ namespace mkc_timeseries
     void createSyntheticRelativeSeries()
     {
       shuffleOverNightChanges();
-      shuffleTradingDayChanges()
+      shuffleTradingDayChanges();
     }
     
     Decimal getRelativeOpen (unsigned long index) const
@@ -320,7 +313,7 @@ namespace mkc_timeseries
 
     std::vector<Decimal> getCloseRelativeSeries() const
     {
-      return mRelativeLow;
+      return mRelativeClose;
     }
 
     ConstRelativeTimeSeriesIterator beginCloseRelativeSeries() const
@@ -374,6 +367,7 @@ namespace mkc_timeseries
 	std::swap(mRelativeVolume[i], mRelativeVolume[j]);
 #endif
 	}
+    }
 
   private:
     std::vector<Decimal> mRelativeOpen;
@@ -383,5 +377,7 @@ namespace mkc_timeseries
     std::vector<Decimal> mRelativeVolume;
     unsigned long mNumElements;
     RandomMersenne mRandGenerator;
-    };
+  };
 }
+
+#endif
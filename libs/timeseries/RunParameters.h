@@ -26,6 +26,8 @@ namespace mkc_timeseries
             std::string getApiSource() { return mApiSource; }
             bool shouldUseApi() { return mUseApi; }
             TimeFrameCollection getTimeFrames() { return mTimeFrames; }
+            // directory the search caches its backtest matrices in, empty (the default) disables the cache
+            std::string getBacktestCacheDirectory() { return mBacktestCacheDirectory; }
 
             void setUseApi(bool useApi) { mUseApi = useApi; }
             void setConfig1FilePath(std::string filename) { mConfigFile1Path = filename; }
@@ -35,6 +37,7 @@ namespace mkc_timeseries
             void setEodDataFilePath(std::string filename) { mEodDataFilePath = filename; }
             void setApiSource(std::string source) { mApiSource = source; }
             void setTimeFrames(TimeFrameCollection timeFrames) { mTimeFrames = timeFrames; }
+            void setBacktestCacheDirectory(std::string directory) { mBacktestCacheDirectory = directory; }
 
         private:
             bool mUseApi;
@@ -47,6 +50,7 @@ namespace mkc_timeseries
             std::string mHourlyDataFilePath;
             std::string mEodDataFilePath;
             TimeFrameCollection mTimeFrames;
+            std::string mBacktestCacheDirectory;
     };
 }
 
@@ -0,0 +1,237 @@
+// Copyright (C) MKC Associates, LLC - All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+// Written by Michael K. Collison <collison956@gmail.com>, July 2016
+//
+
+#ifndef __SYNTHETIC_INTEGRATION_POLICY_H
+#define __SYNTHETIC_INTEGRATION_POLICY_H 1
+
+#include <vector>
+#include <type_traits>
+#include "number.h"
+#include "TimeSeries.h"
+
+namespace mkc_timeseries
+{
+/**
+ * @class DecimalSyntheticIntegrationPolicy
+ * @brief Integrates shuffled relative factors into OHLC prices using Decimal arithmetic and num::Round2Tick.
+ *
+ * This is the reference path for synthetic series construction. Starting from the first open,
+ * the running price is multiplied by the relative open factor (giving the bar's open) and then by
+ * the relative close factor (giving the bar's close). High and low are the open multiplied by the
+ * relative high and low factors. All four prices are rounded to the tick.
+ *
+ * Works for any Decimal type that num::Round2Tick supports.
+ *
+ * @tparam Decimal The numeric type used to represent prices and relative changes.
+ */
+  template <class Decimal>
+  class DecimalSyntheticIntegrationPolicy
+  {
+  public:
+    /**
+     * @brief Integrates the relative factors and writes the tick rounded prices.
+     *
+     * The relative factor vectors must all have the same size. The output vectors are resized
+     * to that size; their capacity is reused when they are passed in again.
+     */
+    static void integrate(const Decimal& firstOpen,
+			  const std::vector<Decimal>& relativeOpen,
+			  const std::vector<Decimal>& relativeHigh,
+			  const std::vector<Decimal>& relativeLow,
+			  const std::vector<Decimal>& relativeClose,
+			  const Decimal& tick,
+			  const Decimal& tickDiv2,
+			  std::vector<Decimal>& opens,
+			  std::vector<Decimal>& highs,
+			  std::vector<Decimal>& lows,
+			  std::vector<Decimal>& closes)
+    {
+      const size_t numElements = relativeOpen.size();
+
+      opens.resize(numElements);
+      highs.resize(numElements);
+      lows.resize(numElements);
+      closes.resize(numElements);
+
+      Decimal xPrice = firstOpen;
+
+      for (size_t i = 0; i < numElements; i++)
+	{
+	  xPrice *= relativeOpen[i];
+	  const Decimal syntheticOpen = xPrice;
+
+	  xPrice *= relativeClose[i];
+
+	  opens[i] = num::Round2Tick (syntheticOpen, tick, tickDiv2);
+	  highs[i] = num::Round2Tick (syntheticOpen * relativeHigh[i], tick, tickDiv2);
+	  lows[i] = num::Round2Tick (syntheticOpen * relativeLow[i], tick, tickDiv2);
+	  closes[i] = num::Round2Tick (xPrice, tick, tickDiv2);
+	}
+    }
+  };
+
+#ifndef USE_BLOOMBERG_DECIMALS
+
+/**
+ * @class FixedPointSyntheticIntegrationPolicy
+ * @brief Produces the same prices as DecimalSyntheticIntegrationPolicy, with tick rounding done on raw int64 values.
+ *
+ * num::Round2Tick computes price % tick with a decimal division, a truncation, a conversion
+ * back to decimal and a decimal multiply. It is called four times per bar. This policy splits
+ * integration into two passes over the bar array:
+ *
+ * - The running price is integrated with ordinary Decimal multiplication. The unrounded open,
+ *   high, low and close are stored.
+ * - Each price column is then snapped to the tick in a flat loop over the scaled int64
+ *   representation (see TickRounder).
+ *
+ * Every step reproduces the integer arithmetic of the decimal operators, so the results are
+ * bit-identical to num::Round2Tick. Floating point is never used: a double kernel with a final
+ * tick snap can land on the other side of a half tick and would not be bit-identical.
+ *
+ * @tparam Decimal Must be num::DefaultNumber, the only type num::Round2Tick is defined for.
+ */
+  template <class Decimal>
+  class FixedPointSyntheticIntegrationPolicy
+  {
+    static_assert(std::is_same<Decimal, num::DefaultNumber>::value,
+		  "FixedPointSyntheticIntegrationPolicy requires num::DefaultNumber");
+
+  public:
+    /**
+     * @class TickRounder
+     * @brief Rounds scaled int64 prices to a tick exactly like num::Round2Tick.
+     *
+     * Round2Tick computes mod = price - int(trunc(price / tick)) * tick and returns
+     * price - mod + (mod < tickDiv2 ? 0 : tick). The decimal division rounds its quotient to
+     * the decimal precision before it is truncated. When the tick evenly divides the precision
+     * factor (0.01, 0.05, 0.25, 1/32, ...) that quotient is exact, and the truncated quotient is
+     * plain int64 division of the scaled values. For any other tick the rounded quotient is
+     * taken from the same dec_utils::multDiv routine the decimal operator uses.
+     */
+    class TickRounder
+    {
+    public:
+      TickRounder(const Decimal& tick, const Decimal& tickDiv2)
+	: mTick(tick.getUnbiased()),
+	  mTickDiv2(tickDiv2.getUnbiased()),
+	  mExactQuotient(false)
+      {
+	if (mTick <= 0)
+	  throw TimeSeriesException("TickRounder: tick must be positive");
+
+	mExactQuotient = (Decimal::getPrecFactor() % mTick) == 0;
+      }
+
+      int64_t operator()(int64_t price) const
+      {
+	const int64_t mod = price - static_cast<int64_t>(truncatedQuotient(price)) * mTick;
+	return price - mod + ((mod < mTickDiv2) ? 0 : mTick);
+      }
+
+      Decimal operator()(const Decimal& price) const
+      {
+	Decimal result;
+	result.setUnbiased((*this)(price.getUnbiased()));
+	return result;
+      }
+
+      /**
+       * @brief Rounds every value of a column in place.
+       */
+      void roundColumn(std::vector<Decimal>& column) const
+      {
+	for (Decimal& value : column)
+	  value.setUnbiased((*this)(value.getUnbiased()));
+      }
+
+    private:
+      // Round2Tick keeps the truncated quotient in an int, so narrow it the same way
+      int truncatedQuotient(int64_t price) const
+      {
+	if (mExactQuotient)
+	  return static_cast<int>(price / mTick);
+
+	const int64_t roundedQuotient =
+	  dec::dec_utils<dec::def_round_policy>::multDiv(price, Decimal::getPrecFactor(), mTick);
+
+	return static_cast<int>(roundedQuotient / Decimal::getPrecFactor());
+      }
+
+    private:
+      int64_t mTick;
+      int64_t mTickDiv2;
+      bool mExactQuotient;
+    };
+
+    /**
+     * @brief Integrates the relative factors and writes the tick rounded prices.
+     *
+     * Same contract and same results as DecimalSyntheticIntegrationPolicy::integrate().
+     */
+    static void integrate(const Decimal& firstOpen,
+			  const std::vector<Decimal>& relativeOpen,
+			  const std::vector<Decimal>& relativeHigh,
+			  const std::vector<Decimal>& relativeLow,
+			  const std::vector<Decimal>& relativeClose,
+			  const Decimal& tick,
+			  const Decimal& tickDiv2,
+			  std::vector<Decimal>& opens,
+			  std::vector<Decimal>& highs,
+			  std::vector<Decimal>& lows,
+			  std::vector<Decimal>& closes)
+    {
+      const TickRounder rounder(tick, tickDiv2);
+      const size_t numElements = relativeOpen.size();
+
+      opens.resize(numElements);
+      highs.resize(numElements);
+      lows.resize(numElements);
+      closes.resize(numElements);
+
+      Decimal xPrice = firstOpen;
+
+      for (size_t i = 0; i < numElements; i++)
+	{
+	  xPrice *= relativeOpen[i];
+	  opens[i] = xPrice;
+	  highs[i] = xPrice * relativeHigh[i];
+	  lows[i] = xPrice * relativeLow[i];
+
+	  xPrice *= relativeClose[i];
+	  closes[i] = xPrice;
+	}
+
+      rounder.roundColumn(opens);
+      rounder.roundColumn(highs);
+      rounder.roundColumn(lows);
+      rounder.roundColumn(closes);
+    }
+  };
+
+#endif
+
+/**
+ * @brief Selects the integration policy used by the synthetic series classes by default.
+ *
+ * num::DefaultNumber uses FixedPointSyntheticIntegrationPolicy. Every other Decimal type uses
+ * DecimalSyntheticIntegrationPolicy.
+ */
+  template <class Decimal>
+  struct DefaultSyntheticIntegrationPolicy
+  {
+    using type = DecimalSyntheticIntegrationPolicy<Decimal>;
+  };
+
+#ifndef USE_BLOOMBERG_DECIMALS
+  template <>
+  struct DefaultSyntheticIntegrationPolicy<num::DefaultNumber>
+  {
+    using type = FixedPointSyntheticIntegrationPolicy<num::DefaultNumber>;
+  };
+#endif
+}
+#endif
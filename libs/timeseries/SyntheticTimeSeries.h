@@ -17,6 +17,7 @@
 #include <fstream>
 #include "TimeSeriesCsvWriter.h"
 #include "DecimalConstants.h"
+#include "SyntheticIntegrationPolicy.h"
 
 namespace mkc_timeseries
 {
@@ -38,8 +39,10 @@ namespace mkc_timeseries
  * cumulative product, which determines the final closing price, is invariant under a permutation of its factors.
  *
  * @tparam Decimal The numeric type used to represent prices and relative changes.
+ * @tparam IntegrationPolicy Integrates the factors and rounds to the tick (see SyntheticIntegrationPolicy.h).
  */
-  template <class Decimal>
+  template <class Decimal,
+	    class IntegrationPolicy = typename DefaultSyntheticIntegrationPolicy<Decimal>::type>
   class SyntheticTimeSeries
   {
   public:
@@ -204,29 +207,23 @@ namespace mkc_timeseries
 
       // Shuffle is done. Integrate to recreate the market
 
-      Decimal xPrice = mFirstOpen;
+      std::vector<Decimal> syntheticOpen, syntheticHigh;
+      std::vector<Decimal> syntheticLow, syntheticClose;
+
+      IntegrationPolicy::integrate(mFirstOpen,
+				   mRelativeOpen, mRelativeHigh, mRelativeLow, mRelativeClose,
+				   getTick(), getTickDiv2(),
+				   syntheticOpen, syntheticHigh, syntheticLow, syntheticClose);
 
 #ifdef SYNTHETIC_VOLUME
       Decimal xVolume = mFirstVolume;
 #endif
-      Decimal syntheticOpen, syntheticHigh;
-      Decimal syntheticClose, syntheticLow;
 
       std::vector<OHLCTimeSeriesEntry<Decimal>> bars;
       bars.reserve(mTimeSeries.getNumEntries());
       
       for (unsigned long i = 0; i < getNumElements(); i++)
 	{
-	  xPrice *= mRelativeOpen[i];
-	  //xPrice = num::Round2Tick (xPrice, getTick(), getTickDiv2());
-	  syntheticOpen = xPrice;
-
-	  xPrice *= mRelativeClose[i];
-	  //xPrice = num::Round2Tick (xPrice, getTick(), getTickDiv2());
-	  syntheticClose = xPrice;
-
-	  syntheticHigh = num::Round2Tick (syntheticOpen * mRelativeHigh[i], getTick(), getTickDiv2());
-	  syntheticLow = num::Round2Tick (syntheticOpen * mRelativeLow[i], getTick(), getTickDiv2());
 #ifdef SYNTHETIC_VOLUME
 	  xVolume *= mRelativeVolume[i];
 #endif
@@ -234,10 +231,10 @@ namespace mkc_timeseries
 	  try
 	    {
 	      OHLCTimeSeriesEntry<Decimal> entry (mDateSeries.getDate(i),
-						  num::Round2Tick (syntheticOpen, getTick(), getTickDiv2()),
-						  syntheticHigh,
-						  syntheticLow,
-						  num::Round2Tick (syntheticClose, getTick(), getTickDiv2()),
+						  syntheticOpen[i],
+						  syntheticHigh[i],
+						  syntheticLow[i],
+						  syntheticClose[i],
 #ifdef SYNTHETIC_VOLUME
 						  xVolume,
 #else
@@ -246,17 +243,16 @@ namespace mkc_timeseries
 						  mSyntheticTimeSeries->getTimeFrame());
 
 	      bars.emplace_back(entry);
-	      //mSyntheticTimeSeries->addEntry(std::move(entry));
 	    }
 	  catch (const TimeSeriesEntryException& e)
 	    {
 	      std::cout << "TimeSeriesEntryException found with relative OHLC = ";
 	      std::cout << mRelativeOpen[i] << ", " << mRelativeHigh[i] << ", ";
 	      std::cout << mRelativeLow[i] << ", " << mRelativeClose[i] << std::endl;
-	      std::cout << "synthetic OHLC = " << syntheticOpen << ", ";
-	      std::cout <<  num::Round2Tick (syntheticOpen * mRelativeHigh[i], getTick(), getTickDiv2()) << ", ";
-	      std::cout <<  num::Round2Tick (syntheticOpen * mRelativeLow[i], getTick(), getTickDiv2())  << ", ";
-	      std::cout << syntheticClose << std::endl;
+	      std::cout << "synthetic OHLC = " << syntheticOpen[i] << ", ";
+	      std::cout << syntheticHigh[i] << ", ";
+	      std::cout << syntheticLow[i] << ", ";
+	      std::cout << syntheticClose[i] << std::endl;
 
 	      std::cout << "First open = " << mFirstOpen << std::endl;
 	      std::cout << "Index = " << i << std::endl;
@@ -475,5 +471,250 @@ namespace mkc_timeseries
     mutable boost::mutex mMutex;    
   };
 
+/**
+ * @class ReusableSyntheticTimeSeries
+ * @brief Regenerates a synthetic OHLC series in place, one permutation after another.
+ *
+ * Produces the same kind of series as SyntheticTimeSeries (shuffled overnight
+ * and trading day relative changes, integrated from the first open and
+ * rounded to the tick). Intended for permutation workers that need a new
+ * synthetic market for every permutation:
+ *
+ * - The relative factors are computed once, when the object is constructed.
+ * - The synthetic series is allocated once. Each call to createSyntheticSeries()
+ *   reshuffles the factors and overwrites the bars of that same series. It
+ *   does not allocate.
+ *
+ * Because the output is overwritten, a series returned by getSyntheticTimeSeries()
+ * is only valid until the next createSyntheticSeries() call. One instance must
+ * therefore not be shared between threads; give each worker its own.
+ *
+ * @tparam Decimal The numeric type used to represent prices and relative changes.
+ * @tparam IntegrationPolicy Integrates the factors and rounds to the tick (see SyntheticIntegrationPolicy.h).
+ */
+  template <class Decimal,
+	    class IntegrationPolicy = typename DefaultSyntheticIntegrationPolicy<Decimal>::type>
+  class ReusableSyntheticTimeSeries
+  {
+  public:
+    /**
+     * @brief Computes the relative factors of a series and allocates the output series.
+     *
+     * @param aTimeSeries The original OHLC time series; must not be empty.
+     * @param minimumTick The minimum tick size used for rounding prices.
+     * @param minimumTickDiv2 Half of the minimum tick size used for rounding.
+     * @throws TimeSeriesException if aTimeSeries is empty.
+     */
+    ReusableSyntheticTimeSeries(const OHLCTimeSeries<Decimal>& aTimeSeries,
+				const Decimal& minimumTick,
+				const Decimal& minimumTickDiv2)
+      : mDateTimes(aTimeSeries.getDateTimeColumn()),
+	mRelativeOpen(),
+	mRelativeHigh(),
+	mRelativeLow(),
+	mRelativeClose(),
+	mRelativeVolume(),
+	mFirstOpen(),
+	mFirstVolume(),
+	mRandGenerator(),
+	mSyntheticTimeSeries(std::make_shared<OHLCTimeSeries<Decimal>>(aTimeSeries)),
+	mMinimumTick(minimumTick),
+	mMinimumTickDiv2(minimumTickDiv2),
+	mSyntheticOpen(),
+	mSyntheticHigh(),
+	mSyntheticLow(),
+	mSyntheticClose()
+    {
+      const size_t numElements = aTimeSeries.getNumEntries();
+      if (numElements == 0)
+	throw TimeSeriesException("ReusableSyntheticTimeSeries: time series is empty");
+
+      const auto& opens = aTimeSeries.getOpenColumn();
+      const auto& highs = aTimeSeries.getHighColumn();
+      const auto& lows = aTimeSeries.getLowColumn();
+      const auto& closes = aTimeSeries.getCloseColumn();
+
+      mRelativeOpen.reserve(numElements);
+      mRelativeHigh.reserve(numElements);
+      mRelativeLow.reserve(numElements);
+      mRelativeClose.reserve(numElements);
+
+      mFirstOpen = opens[0];
+      mRelativeOpen.push_back(DecimalConstants<Decimal>::DecimalOne);
+
+      for (size_t i = 0; i < numElements; i++)
+	{
+	  if (i > 0)
+	    mRelativeOpen.push_back(opens[i] / closes[i - 1]);
+
+	  mRelativeHigh.push_back(highs[i] / opens[i]);
+	  mRelativeLow.push_back(lows[i] / opens[i]);
+	  mRelativeClose.push_back(closes[i] / opens[i]);
+	}
+
+#ifdef SYNTHETIC_VOLUME
+      const auto& volumes = aTimeSeries.getVolumeColumn();
+
+      mRelativeVolume.reserve(numElements);
+      mRelativeVolume.push_back(DecimalConstants<Decimal>::DecimalOne);
+      mFirstVolume = volumes[0];
+      for (size_t i = 1; i < numElements; i++)
+	{
+	  if ((volumes[i] > DecimalConstants<Decimal>::DecimalZero) &&
+	      (volumes[i - 1] > DecimalConstants<Decimal>::DecimalZero))
+	    mRelativeVolume.push_back(volumes[i] / volumes[i - 1]);
+	  else
+	    mRelativeVolume.push_back(DecimalConstants<Decimal>::DecimalOne);
+	}
+#endif
+    }
+
+    ReusableSyntheticTimeSeries(const ReusableSyntheticTimeSeries&) = delete;
+    ReusableSyntheticTimeSeries& operator=(const ReusableSyntheticTimeSeries&) = delete;
+
+    /**
+     * @brief Shuffles the relative factors and overwrites the synthetic series with the new permutation.
+     *
+     * Integration and rounding are identical to SyntheticTimeSeries::createSyntheticSeries().
+     *
+     * @exception TimeSeriesEntryException Thrown if an inconsistency is encountered when creating an OHLC entry.
+     */
+    void createSyntheticSeries()
+    {
+      shuffleOverNightChanges();
+      shuffleTradingDayChanges();
+
+      IntegrationPolicy::integrate(mFirstOpen,
+				   mRelativeOpen, mRelativeHigh, mRelativeLow, mRelativeClose,
+				   getTick(), getTickDiv2(),
+				   mSyntheticOpen, mSyntheticHigh, mSyntheticLow, mSyntheticClose);
+
+#ifdef SYNTHETIC_VOLUME
+      Decimal xVolume = mFirstVolume;
+#endif
+      const TimeFrame::Duration timeFrame = mSyntheticTimeSeries->getTimeFrame();
+
+      for (size_t i = 0; i < getNumElements(); i++)
+	{
+#ifdef SYNTHETIC_VOLUME
+	  xVolume *= mRelativeVolume[i];
+#endif
+	  OHLCTimeSeriesEntry<Decimal> entry (mDateTimes[i],
+					      mSyntheticOpen[i],
+					      mSyntheticHigh[i],
+					      mSyntheticLow[i],
+					      mSyntheticClose[i],
+#ifdef SYNTHETIC_VOLUME
+					      xVolume,
+#else
+					      DecimalConstants<Decimal>::DecimalZero,
+#endif
+					      timeFrame);
+
+	  mSyntheticTimeSeries->replaceEntry(i, entry);
+	}
+    }
+
+    /**
+     * @brief The synthetic series; the same object for the lifetime of this instance.
+     */
+    std::shared_ptr<const OHLCTimeSeries<Decimal>> getSyntheticTimeSeries() const
+    {
+      return mSyntheticTimeSeries;
+    }
+
+    Decimal getFirstOpen () const
+    {
+      return mFirstOpen;
+    }
+
+    const Decimal& getTick() const
+    {
+      return mMinimumTick;
+    }
+
+    const Decimal& getTickDiv2() const
+    {
+      return mMinimumTickDiv2;
+    }
+
+    unsigned long getNumElements() const
+    {
+      return mDateTimes.size();
+    }
+
+    const std::vector<Decimal>& getRelativeOpen() const
+    {
+      return mRelativeOpen;
+    }
+
+    const std::vector<Decimal>& getRelativeHigh() const
+    {
+      return mRelativeHigh;
+    }
+
+    const std::vector<Decimal>& getRelativeLow() const
+    {
+      return mRelativeLow;
+    }
+
+    const std::vector<Decimal>& getRelativeClose() const
+    {
+      return mRelativeClose;
+    }
+
+  private:
+    void shuffleOverNightChanges()
+    {
+      unsigned long i = getNumElements();
+      unsigned long j;
+
+      while (i > 1)
+	{
+	  j = mRandGenerator.DrawNumberExclusive (i);
+	  i = i - 1;
+
+	  std::swap(mRelativeOpen[i], mRelativeOpen[j]);
+	}
+    }
+
+    void shuffleTradingDayChanges()
+    {
+      unsigned long i = getNumElements();
+      unsigned long j;
+
+      while (i > 1)
+	{
+	  j = mRandGenerator.DrawNumberExclusive (i);
+	  i = i - 1;
+
+	  std::swap(mRelativeHigh[i], mRelativeHigh[j]);
+	  std::swap(mRelativeLow[i], mRelativeLow[j]);
+	  std::swap(mRelativeClose[i], mRelativeClose[j]);
+#ifdef SYNTHETIC_VOLUME
+	  std::swap(mRelativeVolume[i], mRelativeVolume[j]);
+#endif
+	}
+    }
+
+  private:
+    std::vector<boost::posix_time::ptime> mDateTimes;
+    std::vector<Decimal> mRelativeOpen;
+    std::vector<Decimal> mRelativeHigh;
+    std::vector<Decimal> mRelativeLow;
+    std::vector<Decimal> mRelativeClose;
+    std::vector<Decimal> mRelativeVolume;
+    Decimal mFirstOpen;
+    Decimal mFirstVolume;
+    RandomMersenne mRandGenerator;
+    std::shared_ptr<OHLCTimeSeries<Decimal>> mSyntheticTimeSeries;
+    Decimal mMinimumTick;
+    Decimal mMinimumTickDiv2;
+    std::vector<Decimal> mSyntheticOpen;
+    std::vector<Decimal> mSyntheticHigh;
+    std::vector<Decimal> mSyntheticLow;
+    std::vector<Decimal> mSyntheticClose;
+  };
+
 }
 #endif
@@ -489,6 +489,12 @@ namespace mkc_timeseries
    * - Insertion via `addEntry(...)` keeps the data sorted (binary search + insert).
    * - Rejects duplicate timestamps.
    * - Offers both sorted and random access without any synchronization or finalize steps.
+   *
+   * Alongside the entries the series keeps contiguous columns (date/time, open, high,
+   * low, close, volume) that are updated by every mutator. The iterator/offset value
+   * accessors and date lookups read the columns, so per-bar hot loops touch one
+   * densely packed array instead of striding over whole entries. Callers that work
+   * with bar indices can read the columns directly (see getIndex / get*Column).
    */
   template <class Decimal>
   class OHLCTimeSeries
@@ -511,7 +517,13 @@ namespace mkc_timeseries
       : mData(),
 	mTimeFrame(timeFrame),
 	mUnitsOfVolume(unitsOfVolume),
-	mIndex()
+	mIndex(),
+	mDateTimeColumn(),
+	mOpenColumn(),
+	mHighColumn(),
+	mLowColumn(),
+	mCloseColumn(),
+	mVolumeColumn()
     {}
 
     /**
@@ -526,9 +538,16 @@ namespace mkc_timeseries
       : mData(),
 	mTimeFrame(timeFrame),
 	mUnitsOfVolume(unitsOfVolume),
-	mIndex()
+	mIndex(),
+	mDateTimeColumn(),
+	mOpenColumn(),
+	mHighColumn(),
+	mLowColumn(),
+	mCloseColumn(),
+	mVolumeColumn()
     {
       mData.reserve(reserveCount);
+      reserveColumns(reserveCount);
     }
 
     /**
@@ -557,7 +576,13 @@ namespace mkc_timeseries
       : mData(first, last),
 	mTimeFrame(tf),
 	mUnitsOfVolume(units),
-	mIndex()
+	mIndex(),
+	mDateTimeColumn(),
+	mOpenColumn(),
+	mHighColumn(),
+	mLowColumn(),
+	mCloseColumn(),
+	mVolumeColumn()
     {
       // 1) Optional: verify every entry has the correct timeFrame
       for (auto& e : mData) {
@@ -570,6 +595,8 @@ namespace mkc_timeseries
 		{
 		  return a.getDateTime() < b.getDateTime();
 		});
+
+      rebuildColumns();
     }
 
     /** @brief Default copy constructor. */
@@ -633,11 +660,41 @@ namespace mkc_timeseries
       if (it != mData.end() && it->getDateTime() == entry.getDateTime())
 	throw std::domain_error("addEntry: duplicate timestamp");
 
+      insertColumns(getIndex(it), entry);
       mData.insert(it, std::move(entry));
       if (!mIndex.empty())
         mIndex.clear();
     }
 
+    /**
+     * @brief Overwrites the bar at an index with an entry for the same timestamp.
+     *
+     * Size, order and timestamps are unchanged, so iterators and the ptime
+     * index stay valid. Used to regenerate a series in place without
+     * reallocating it.
+     *
+     * @param index Bar index (0 is the oldest bar).
+     * @param entry Replacement entry; must have the timestamp and time frame of the bar it replaces.
+     * @throws TimeSeriesException If index is out of range.
+     * @throws std::domain_error If the timestamp or time frame differs.
+     */
+    void replaceEntry(size_t index, const Entry& entry)
+    {
+      ValidateVectorOffset(index);
+      if (entry.getTimeFrame() != getTimeFrame())
+	throw std::domain_error("replaceEntry: time frame mismatch");
+
+      if (entry.getDateTime() != mDateTimeColumn[index])
+	throw std::domain_error("replaceEntry: timestamp mismatch");
+
+      mData[index] = entry;
+      mOpenColumn[index] = entry.getOpenValue();
+      mHighColumn[index] = entry.getHighValue();
+      mLowColumn[index] = entry.getLowValue();
+      mCloseColumn[index] = entry.getCloseValue();
+      mVolumeColumn[index] = entry.getVolumeValue();
+    }
+
     /**
      * @brief Creates a NumericTimeSeries containing only the Open prices from this series.
      * @return A new NumericTimeSeries object holding the Open prices and corresponding timestamps.
@@ -734,11 +791,11 @@ namespace mkc_timeseries
        return mData.begin() + it->second;  */
       
       
-       auto it = std::lower_bound(
-				 mData.begin(), mData.end(), dt,
-				 [](auto const& e, auto const& t){ return e.getDateTime() < t; });
-      return (it != mData.end() && it->getDateTime() == dt)
-      ? it : mData.end();
+      auto colIt = std::lower_bound(mDateTimeColumn.begin(), mDateTimeColumn.end(), dt);
+      if (colIt == mDateTimeColumn.end() || *colIt != dt)
+	return mData.end();
+
+      return mData.begin() + std::distance(mDateTimeColumn.begin(), colIt);
     }
 
     /** @name Random-access iteration (by index) */
@@ -807,7 +864,7 @@ namespace mkc_timeseries
     const Decimal& getOpenValue(const ConstRandomAccessIterator& it,
 				unsigned long offset) const
     {
-      return getTimeSeriesEntry(it, offset).getOpenValue();
+      return mOpenColumn[getIndexWithOffset(it, offset)];
     }
 
     /**
@@ -816,7 +873,7 @@ namespace mkc_timeseries
     const Decimal& getHighValue(const ConstRandomAccessIterator& it,
 				unsigned long offset) const
     {
-      return getTimeSeriesEntry(it, offset).getHighValue();
+      return mHighColumn[getIndexWithOffset(it, offset)];
     }
 
     /**
@@ -825,7 +882,7 @@ namespace mkc_timeseries
     const Decimal& getLowValue(const ConstRandomAccessIterator& it,
 			       unsigned long offset) const
     {
-      return getTimeSeriesEntry(it, offset).getLowValue();
+      return mLowColumn[getIndexWithOffset(it, offset)];
     }
 
     /**
@@ -834,7 +891,7 @@ namespace mkc_timeseries
     const Decimal& getCloseValue(const ConstRandomAccessIterator& it,
 				 unsigned long offset) const
     {
-      return getTimeSeriesEntry(it, offset).getCloseValue();
+      return mCloseColumn[getIndexWithOffset(it, offset)];
     }
 
     /**
@@ -843,9 +900,38 @@ namespace mkc_timeseries
     const Decimal& getVolumeValue(const ConstRandomAccessIterator& it,
 				  unsigned long offset) const
     {
-      return getTimeSeriesEntry(it, offset).getVolumeValue();
+      return mVolumeColumn[getIndexWithOffset(it, offset)];
     }
 
+    /** @name Columnar access (by bar index) */
+    ///@{
+
+    /**
+     * @brief Bar index of a random-access iterator (0 is the oldest bar).
+     */
+    size_t getIndex(const ConstRandomAccessIterator& it) const
+    {
+      return static_cast<size_t>(std::distance(mData.begin(), it));
+    }
+
+    /**
+     * @brief Random-access iterator for a bar index.
+     * @throws TimeSeriesException if index is past the last bar.
+     */
+    ConstRandomAccessIterator getRandomAccessIterator(size_t index) const
+    {
+      ValidateVectorOffset(index);
+      return mData.begin() + index;
+    }
+
+    const std::vector<boost::posix_time::ptime>& getDateTimeColumn() const { return mDateTimeColumn; }
+    const std::vector<Decimal>& getOpenColumn()   const { return mOpenColumn; }
+    const std::vector<Decimal>& getHighColumn()   const { return mHighColumn; }
+    const std::vector<Decimal>& getLowColumn()    const { return mLowColumn; }
+    const std::vector<Decimal>& getCloseColumn()  const { return mCloseColumn; }
+    const std::vector<Decimal>& getVolumeColumn() const { return mVolumeColumn; }
+    ///@}
+
     /**
      * @brief Check if a date exists in series.
      */
@@ -864,6 +950,7 @@ namespace mkc_timeseries
 				 [&](auto const& e){ return e.getDateTime().date() == d; }),
 		  mData.end());
 
+      rebuildColumns();
       if (!mIndex.empty())
 	mIndex.clear();
     }
@@ -876,6 +963,48 @@ namespace mkc_timeseries
 	mIndex[mData[i].getDateTime()] = i;
     }
 
+    void reserveColumns(size_t count)
+    {
+      mDateTimeColumn.reserve(count);
+      mOpenColumn.reserve(count);
+      mHighColumn.reserve(count);
+      mLowColumn.reserve(count);
+      mCloseColumn.reserve(count);
+      mVolumeColumn.reserve(count);
+    }
+
+    void insertColumns(size_t pos, const Entry& entry)
+    {
+      mDateTimeColumn.insert(mDateTimeColumn.begin() + pos, entry.getDateTime());
+      mOpenColumn.insert(mOpenColumn.begin() + pos, entry.getOpenValue());
+      mHighColumn.insert(mHighColumn.begin() + pos, entry.getHighValue());
+      mLowColumn.insert(mLowColumn.begin() + pos, entry.getLowValue());
+      mCloseColumn.insert(mCloseColumn.begin() + pos, entry.getCloseValue());
+      mVolumeColumn.insert(mVolumeColumn.begin() + pos, entry.getVolumeValue());
+    }
+
+    void rebuildColumns()
+    {
+      mDateTimeColumn.clear();
+      mOpenColumn.clear();
+      mHighColumn.clear();
+      mLowColumn.clear();
+      mCloseColumn.clear();
+      mVolumeColumn.clear();
+      reserveColumns(mData.size());
+
+      for (const auto& entry : mData)
+	insertColumns(mDateTimeColumn.size(), entry);
+    }
+
+    // Validate an iterator-based offset and return the bar index it refers to.
+    size_t getIndexWithOffset(const ConstRandomAccessIterator& it,
+			      unsigned long offset) const
+    {
+      ValidateVectorOffset(it, offset);
+      return getIndex(it) - offset;
+    }
+
     // Validate iterator-based offset.
     void ValidateVectorOffset(const ConstRandomAccessIterator& it,
 			      unsigned long offset) const
@@ -899,6 +1028,14 @@ namespace mkc_timeseries
     TimeFrame::Duration        mTimeFrame;
     TradingVolume::VolumeUnit  mUnitsOfVolume;
     mutable std::unordered_map<ptime,size_t> mIndex;
+
+    // Columnar copies of mData, same order and size
+    std::vector<boost::posix_time::ptime> mDateTimeColumn;
+    std::vector<Decimal>       mOpenColumn;
+    std::vector<Decimal>       mHighColumn;
+    std::vector<Decimal>       mLowColumn;
+    std::vector<Decimal>       mCloseColumn;
+    std::vector<Decimal>       mVolumeColumn;
   };
   
    /**
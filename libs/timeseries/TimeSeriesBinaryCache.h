@@ -0,0 +1,390 @@
+// Copyright (C) MKC Associates, LLC - All Rights Reserved
+// Unauthorized copying of this file, via any medium is strictly prohibited
+// Proprietary and confidential
+// Written by Michael K. Collison <collison956@gmail.com>, July 2016
+//
+
+#ifndef __TIME_SERIES_BINARY_CACHE_H
+#define __TIME_SERIES_BINARY_CACHE_H 1
+
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <type_traits>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "number.h"
+#include "BinaryCacheUtils.h"
+#include "TimeSeries.h"
+#include "TimeSeriesCsvReader.h"
+
+namespace mkc_timeseries
+{
+#ifndef USE_BLOOMBERG_DECIMALS
+
+  /**
+   * @class TimeSeriesBinaryCache
+   * @brief Versioned binary columnar copy of a parsed data file, loaded through a memory mapping.
+   *
+   * The cache for "data.txt" is written to "data.txt.palcache". It holds a fixed size header
+   * followed by six int64 columns: the timestamp in microseconds since 1970-01-01, then the
+   * scaled (unbiased) open, high, low, close and volume values.
+   *
+   * A cache is only used when its header matches the current request: format version,
+   * decimal precision, time frame, volume units, tick, the reader class that parsed the source,
+   * and the source file's size, modification time and FNV-1a hash. The hash is checked last,
+   * since it is the only check that reads the source file: every load maps and hashes the
+   * whole source file, so a cached read still costs one pass over the raw bytes (but no parsing).
+   *
+   * Prices are stored exactly as the reader produced them, so a loaded series compares equal to
+   * a freshly parsed one.
+   *
+   * @tparam Decimal Must be num::DefaultNumber; the columns hold its scaled int64 values.
+   */
+  template <class Decimal>
+  class TimeSeriesBinaryCache
+  {
+    static_assert(std::is_same<Decimal, num::DefaultNumber>::value,
+		  "TimeSeriesBinaryCache requires num::DefaultNumber");
+
+  public:
+    static constexpr uint32_t FormatVersion = 1;
+
+    static std::string getCacheFileName(const std::string& sourceFileName)
+    {
+      return sourceFileName + ".palcache";
+    }
+
+    /**
+     * @brief Identifies the reader class that produced a series.
+     *
+     * Different readers can parse the same file differently (for example only some of them
+     * round prices to the tick), so the reader is part of the cache key.
+     */
+    static uint64_t getReaderId(const TimeSeriesCsvReader<Decimal>& reader)
+    {
+      const char *name = typeid(reader).name();
+      return binary_cache::hashBytes(name, std::strlen(name));
+    }
+
+    /**
+     * @brief Loads the cached series for sourceFileName.
+     *
+     * @return The series, or nullptr when there is no cache or it does not match the request.
+     */
+    static std::shared_ptr<OHLCTimeSeries<Decimal>> load(const std::string& sourceFileName,
+							 TimeFrame::Duration timeFrame,
+							 TradingVolume::VolumeUnit unitsOfVolume,
+							 const Decimal& tick,
+							 uint64_t readerId)
+    {
+      namespace bip = boost::interprocess;
+
+      const std::string cacheFileName = getCacheFileName(sourceFileName);
+      boost::system::error_code ec;
+      if (!boost::filesystem::is_regular_file(cacheFileName, ec))
+	return nullptr;
+
+      try
+	{
+	  bip::file_mapping cacheMapping(cacheFileName.c_str(), bip::read_only);
+	  bip::mapped_region cacheRegion(cacheMapping, bip::read_only);
+
+	  if (cacheRegion.get_size() < sizeof(Header))
+	    return nullptr;
+
+	  Header header;
+	  std::memcpy(&header, cacheRegion.get_address(), sizeof(Header));
+
+	  const SourceInfo source = getSourceInfo(sourceFileName);
+	  if (!matches(header, timeFrame, unitsOfVolume, tick, readerId, source))
+	    return nullptr;
+
+	  const uint64_t numBars = header.mNumBars;
+	  if (cacheRegion.get_size() != sizeof(Header) + NumColumns * numBars * sizeof(int64_t))
+	    return nullptr;
+
+	  if (header.mSourceHash != hashFile(sourceFileName, source.mSize))
+	    return nullptr;
+
+	  const int64_t *columns =
+	    reinterpret_cast<const int64_t *>(static_cast<const char *>(cacheRegion.get_address()) + sizeof(Header));
+	  const int64_t *dateTimes = columns;
+	  const int64_t *opens = columns + numBars;
+	  const int64_t *highs = columns + 2 * numBars;
+	  const int64_t *lows = columns + 3 * numBars;
+	  const int64_t *closes = columns + 4 * numBars;
+	  const int64_t *volumes = columns + 5 * numBars;
+
+	  // The bars were stored in order, so each one is appended to the reserved entries and columns
+	  auto series = std::make_shared<OHLCTimeSeries<Decimal>>(timeFrame, unitsOfVolume,
+								   static_cast<unsigned long>(numBars));
+	  for (uint64_t i = 0; i < numBars; i++)
+	    series->addEntry(OHLCTimeSeriesEntry<Decimal>(getEpoch() + boost::posix_time::microseconds(dateTimes[i]),
+							  fromUnbiased(opens[i]),
+							  fromUnbiased(highs[i]),
+							  fromUnbiased(lows[i]),
+							  fromUnbiased(closes[i]),
+							  fromUnbiased(volumes[i]),
+							  timeFrame));
+
+	  return series;
+	}
+      catch (const std::exception&)
+	{
+	  // A cache that cannot be mapped or decoded is treated as missing
+	  return nullptr;
+	}
+    }
+
+    /**
+     * @brief Writes the cache for sourceFileName.
+     *
+     * The cache is written to a temporary file and renamed into place, so a concurrent
+     * reader never maps a partial file and concurrent writers do not interleave. Caching is best effort: when the directory is not
+     * writable the series is simply not cached.
+     *
+     * @return true if the cache was written.
+     */
+    static bool store(const std::string& sourceFileName,
+		      const OHLCTimeSeries<Decimal>& series,
+		      const Decimal& tick,
+		      uint64_t readerId)
+    {
+      return binary_cache::writeFileAtomically(getCacheFileName(sourceFileName),
+					       [&](std::ofstream& out)
+	{
+	  const SourceInfo source = getSourceInfo(sourceFileName);
+	  const uint64_t numBars = series.getNumEntries();
+
+	  Header header;
+	  std::memset(&header, 0, sizeof(Header));
+	  std::memcpy(header.mMagic, Magic, sizeof(header.mMagic));
+	  header.mVersion = FormatVersion;
+	  header.mHeaderSize = sizeof(Header);
+	  header.mPrecFactor = Decimal::getPrecFactor();
+	  header.mTimeFrame = static_cast<int32_t>(series.getTimeFrame());
+	  header.mVolumeUnits = static_cast<int32_t>(series.getVolumeUnits());
+	  header.mTick = tick.getUnbiased();
+	  header.mReaderId = readerId;
+	  header.mSourceSize = source.mSize;
+	  header.mSourceModificationTime = source.mModificationTime;
+	  header.mSourceHash = hashFile(sourceFileName, source.mSize);
+	  header.mNumBars = numBars;
+
+	  std::vector<int64_t> column(numBars);
+
+	  out.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+
+	  const auto& dateTimes = series.getDateTimeColumn();
+	  for (uint64_t i = 0; i < numBars; i++)
+	    column[i] = (dateTimes[i] - getEpoch()).total_microseconds();
+	  writeColumn(out, column);
+
+	  writeDecimalColumn(out, series.getOpenColumn(), column);
+	  writeDecimalColumn(out, series.getHighColumn(), column);
+	  writeDecimalColumn(out, series.getLowColumn(), column);
+	  writeDecimalColumn(out, series.getCloseColumn(), column);
+	  writeDecimalColumn(out, series.getVolumeColumn(), column);
+	});
+    }
+
+  private:
+    static constexpr char Magic[8] = {'P', 'A', 'L', 'T', 'S', 'B', 'C', '\0'};
+    static constexpr uint64_t NumColumns = 6;
+
+    // Fixed layout, 96 bytes, so the columns that follow are 8 byte aligned
+    struct Header
+    {
+      char mMagic[8];
+      uint32_t mVersion;
+      uint32_t mHeaderSize;
+      int64_t mPrecFactor;
+      int32_t mTimeFrame;
+      int32_t mVolumeUnits;
+      int64_t mTick;
+      uint64_t mReaderId;
+      uint64_t mSourceSize;
+      int64_t mSourceModificationTime;
+      uint64_t mSourceHash;
+      uint64_t mNumBars;
+      uint64_t mReserved[2];
+    };
+
+    static_assert(sizeof(Header) == 96, "TimeSeriesBinaryCache header must stay 96 bytes");
+
+    struct SourceInfo
+    {
+      uint64_t mSize;
+      int64_t mModificationTime;
+    };
+
+    static SourceInfo getSourceInfo(const std::string& sourceFileName)
+    {
+      SourceInfo info;
+      info.mSize = static_cast<uint64_t>(boost::filesystem::file_size(sourceFileName));
+      info.mModificationTime = static_cast<int64_t>(boost::filesystem::last_write_time(sourceFileName));
+      return info;
+    }
+
+    static bool matches(const Header& header,
+			TimeFrame::Duration timeFrame,
+			TradingVolume::VolumeUnit unitsOfVolume,
+			const Decimal& tick,
+			uint64_t readerId,
+			const SourceInfo& source)
+    {
+      return (std::memcmp(header.mMagic, Magic, sizeof(header.mMagic)) == 0) &&
+	(header.mVersion == FormatVersion) &&
+	(header.mHeaderSize == sizeof(Header)) &&
+	(header.mPrecFactor == Decimal::getPrecFactor()) &&
+	(header.mTimeFrame == static_cast<int32_t>(timeFrame)) &&
+	(header.mVolumeUnits == static_cast<int32_t>(unitsOfVolume)) &&
+	(header.mTick == tick.getUnbiased()) &&
+	(header.mReaderId == readerId) &&
+	(header.mSourceSize == source.mSize) &&
+	(header.mSourceModificationTime == source.mModificationTime);
+    }
+
+    static uint64_t hashFile(const std::string& fileName, uint64_t fileSize)
+    {
+      namespace bip = boost::interprocess;
+
+      if (fileSize == 0)
+	return binary_cache::FnvOffsetBasis;
+
+      bip::file_mapping sourceMapping(fileName.c_str(), bip::read_only);
+      bip::mapped_region sourceRegion(sourceMapping, bip::read_only);
+
+      return binary_cache::hashBytes(sourceRegion.get_address(), sourceRegion.get_size());
+    }
+
+    static const boost::posix_time::ptime& getEpoch()
+    {
+      static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+      return epoch;
+    }
+
+    static Decimal fromUnbiased(int64_t value)
+    {
+      Decimal result;
+      result.setUnbiased(value);
+      return result;
+    }
+
+    static void writeColumn(std::ofstream& out, const std::vector<int64_t>& column)
+    {
+      out.write(reinterpret_cast<const char *>(column.data()),
+		static_cast<std::streamsize>(column.size() * sizeof(int64_t)));
+    }
+
+    static void writeDecimalColumn(std::ofstream& out,
+				   const std::vector<Decimal>& values,
+				   std::vector<int64_t>& scratch)
+    {
+      for (size_t i = 0; i < values.size(); i++)
+	scratch[i] = values[i].getUnbiased();
+      writeColumn(out, scratch);
+    }
+  };
+
+  /**
+   * @class CachedTimeSeriesCsvReader
+   * @brief Wraps a TimeSeriesCsvReader and serves repeat reads of the same file from a TimeSeriesBinaryCache.
+   *
+   * On the first read the wrapped reader parses the file and the result is cached next to it.
+   * Later reads of the unchanged file map the cache instead of parsing the text.
+   */
+  template <class Decimal>
+  class CachedTimeSeriesCsvReader : public TimeSeriesCsvReader<Decimal>
+  {
+  public:
+    explicit CachedTimeSeriesCsvReader (std::shared_ptr<TimeSeriesCsvReader<Decimal>> reader)
+      : TimeSeriesCsvReader<Decimal> (reader->getFileName(), reader->getTimeFrame(),
+				      reader->getTimeSeries()->getVolumeUnits(), reader->getTick()),
+	mReader(reader),
+	mLoadedFromCache(false)
+    {}
+
+    CachedTimeSeriesCsvReader(const CachedTimeSeriesCsvReader& rhs)
+      : TimeSeriesCsvReader<Decimal>(rhs),
+	mReader(rhs.mReader),
+	mLoadedFromCache(rhs.mLoadedFromCache)
+    {}
+
+    CachedTimeSeriesCsvReader&
+    operator=(const CachedTimeSeriesCsvReader &rhs)
+    {
+      if (this == &rhs)
+	return *this;
+
+      TimeSeriesCsvReader<Decimal>::operator=(rhs);
+      mReader = rhs.mReader;
+      mLoadedFromCache = rhs.mLoadedFromCache;
+
+      return *this;
+    }
+
+    ~CachedTimeSeriesCsvReader()
+    {}
+
+    void readFile()
+    {
+      using Cache = TimeSeriesBinaryCache<Decimal>;
+
+      const uint64_t readerId = Cache::getReaderId(*mReader);
+      std::shared_ptr<OHLCTimeSeries<Decimal>> series =
+	Cache::load(this->getFileName(), this->getTimeFrame(),
+		    mReader->getTimeSeries()->getVolumeUnits(), this->getTick(), readerId);
+
+      mLoadedFromCache = (series != nullptr);
+      if (!mLoadedFromCache)
+	{
+	  mReader->readFile();
+	  series = mReader->getTimeSeries();
+	  Cache::store(this->getFileName(), *series, this->getTick(), readerId);
+	}
+
+      this->setTimeSeries(series);
+    }
+
+    /**
+     * @brief True if the last readFile() was served from the cache.
+     */
+    bool isLoadedFromCache() const
+    {
+      return mLoadedFromCache;
+    }
+
+  private:
+    std::shared_ptr<TimeSeriesCsvReader<Decimal>> mReader;
+    bool mLoadedFromCache;
+  };
+
+#endif
+
+  /**
+   * @brief Returns a reader that uses the binary cache when the Decimal type supports it.
+   *
+   * With num::DefaultNumber the reader is wrapped in a CachedTimeSeriesCsvReader; otherwise it
+   * is returned unchanged.
+   */
+  template <class Decimal>
+  std::shared_ptr<TimeSeriesCsvReader<Decimal>>
+  withBinaryCache(std::shared_ptr<TimeSeriesCsvReader<Decimal>> reader)
+  {
+#ifndef USE_BLOOMBERG_DECIMALS
+    if constexpr (std::is_same<Decimal, num::DefaultNumber>::value)
+      return std::make_shared<CachedTimeSeriesCsvReader<Decimal>>(reader);
+#endif
+    return reader;
+  }
+}
+
+#endif
@@ -91,6 +91,12 @@ namespace mkc_timeseries
     virtual void readFile() = 0;
 
   protected:
+    // Lets readers that do not parse the file themselves (see CachedTimeSeriesCsvReader) publish a series
+    void setTimeSeries (std::shared_ptr<OHLCTimeSeries<Decimal>> timeSeries)
+    {
+      mTimeSeries = timeSeries;
+    }
+
     Decimal DecimalRound (const Decimal& price)
     {
       //return price;
@@ -0,0 +1,301 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include "number.h"
+#include "TimeSeries.h"
+#include "TimeSeriesCsvReader.h"
+#include "SyntheticTimeSeries.h"
+#include "DecimalConstants.h"
+#include "TestUtils.h"
+
+using namespace mkc_timeseries;
+using namespace boost::gregorian;
+
+namespace  {
+
+OHLCTimeSeriesEntry<DecimalType>
+    createEquityEntry (const std::string& dateString,
+		       const std::string& openPrice,
+		       const std::string& highPrice,
+		       const std::string& lowPrice,
+		       const std::string& closePrice,
+		       volume_t vol)
+  {
+    return *createTimeSeriesEntry(dateString, openPrice, highPrice, lowPrice, closePrice, vol);
+  }
+
+  OHLCTimeSeries<DecimalType> createSpySeries()
+  {
+    OHLCTimeSeries<DecimalType> spySeries(TimeFrame::DAILY, TradingVolume::SHARES);
+
+    spySeries.addEntry (createEquityEntry ("20160106", "198.34", "200.06", "197.60","198.82", 142662900));
+    spySeries.addEntry (createEquityEntry ("20160105", "201.40", "201.90", "200.05","201.36", 105999900));
+    spySeries.addEntry (createEquityEntry ("20160104", "200.49", "201.03", "198.59","201.02", 222353400));
+    spySeries.addEntry (createEquityEntry ("20151231", "205.13", "205.89", "203.87","203.87", 114877900));
+    spySeries.addEntry (createEquityEntry ("20151230", "207.11", "207.21", "205.76","205.93", 63317700));
+    spySeries.addEntry (createEquityEntry ("20151229", "206.51", "207.79", "206.47","207.40", 92640700));
+    spySeries.addEntry (createEquityEntry ("20151228", "204.86", "205.26", "203.94","205.21", 65899900));
+    spySeries.addEntry (createEquityEntry ("20160107", "195.33", "197.44", "193.59","194.05", 207229000));
+    spySeries.addEntry (createEquityEntry ("20151224", "205.72", "206.33", "205.42","205.68", 48542200));
+    spySeries.addEntry (createEquityEntry ("20151223", "204.69", "206.07", "204.58","206.02", 110987200));
+    spySeries.addEntry (createEquityEntry ("20151222", "202.72", "203.85", "201.55","203.50", 110026200));
+    spySeries.addEntry (createEquityEntry ("20151221", "201.41", "201.88", "200.09","201.67", 99094300));
+    spySeries.addEntry (createEquityEntry ("20151218", "202.77", "202.93", "199.83","200.02", 251393500));
+    spySeries.addEntry (createEquityEntry ("20151217", "208.40", "208.48", "204.84","204.86", 173092500));
+    spySeries.addEntry (createEquityEntry ("20151216", "206.37", "208.39", "204.80","208.03", 197017000));
+    spySeries.addEntry (createEquityEntry ("20151215", "204.70", "206.11", "202.87","205.03", 154069600));
+    spySeries.addEntry (createEquityEntry ("20151214", "202.07", "203.05", "199.95","202.90", 182385200));
+    spySeries.addEntry (createEquityEntry ("20151211", "203.35", "204.14", "201.51","201.88", 211173300));
+    spySeries.addEntry (createEquityEntry ("20151210", "205.42", "207.43", "205.14","205.87", 116128900));
+    spySeries.addEntry (createEquityEntry ("20151209", "206.19", "208.68", "204.18","205.34", 162401500));
+
+    return spySeries;
+  }
+
+  std::vector<DecimalType> sorted(std::vector<DecimalType> values)
+  {
+    std::sort(values.begin(), values.end());
+    return values;
+  }
+
+  std::shared_ptr<OHLCTimeSeries<DecimalType>> readMsftHourlySeries()
+  {
+    TradeStationFormatCsvReader<DecimalType> reader ("MSFT_RAD_Hourly.txt", TimeFrame::INTRADAY,
+						     TradingVolume::SHARES,
+						     DecimalConstants<DecimalType>::EquityTick);
+    reader.readFile();
+    return reader.getTimeSeries();
+  }
+
+  using DecimalPolicy = DecimalSyntheticIntegrationPolicy<DecimalType>;
+  using FixedPointPolicy = FixedPointSyntheticIntegrationPolicy<DecimalType>;
+
+  struct IntegratedPrices
+  {
+    std::vector<DecimalType> open, high, low, close;
+  };
+
+  template <class IntegrationPolicy, class SyntheticSeries>
+  IntegratedPrices integrateWith (const SyntheticSeries& series)
+  {
+    IntegratedPrices prices;
+    IntegrationPolicy::integrate (series.getFirstOpen(),
+				  series.getRelativeOpen(), series.getRelativeHigh(),
+				  series.getRelativeLow(), series.getRelativeClose(),
+				  series.getTick(), series.getTickDiv2(),
+				  prices.open, prices.high, prices.low, prices.close);
+    return prices;
+  }
+
+  void requireSamePrices (const IntegratedPrices& fixedPoint, const IntegratedPrices& reference)
+  {
+    REQUIRE (fixedPoint.open == reference.open);
+    REQUIRE (fixedPoint.high == reference.high);
+    REQUIRE (fixedPoint.low == reference.low);
+    REQUIRE (fixedPoint.close == reference.close);
+  }
+}
+
+TEST_CASE ("ReusableSyntheticTimeSeries operations", "[SyntheticTimeSeries]")
+{
+  OHLCTimeSeries<DecimalType> spySeries (createSpySeries());
+  const DecimalType tick (DecimalConstants<DecimalType>::EquityTick);
+  const DecimalType tickDiv2 (tick / DecimalConstants<DecimalType>::DecimalTwo);
+
+  ReusableSyntheticTimeSeries<DecimalType> syntheticSpySeries (spySeries, tick, tickDiv2);
+  SyntheticTimeSeries<DecimalType> referenceSpySeries (spySeries, tick, tickDiv2);
+
+  REQUIRE (syntheticSpySeries.getNumElements() == spySeries.getNumEntries());
+  REQUIRE (syntheticSpySeries.getFirstOpen() == spySeries.beginRandomAccess()->getOpenValue());
+
+  SECTION ("ReusableSyntheticTimeSeries relative factors match SyntheticTimeSeries", "[SyntheticTimeSeries]")
+    {
+      REQUIRE (syntheticSpySeries.getRelativeOpen() == referenceSpySeries.getRelativeOpen());
+      REQUIRE (syntheticSpySeries.getRelativeHigh() == referenceSpySeries.getRelativeHigh());
+      REQUIRE (syntheticSpySeries.getRelativeLow() == referenceSpySeries.getRelativeLow());
+      REQUIRE (syntheticSpySeries.getRelativeClose() == referenceSpySeries.getRelativeClose());
+    }
+
+  SECTION ("ReusableSyntheticTimeSeries regenerates the same series object", "[SyntheticTimeSeries]")
+    {
+      auto p = syntheticSpySeries.getSyntheticTimeSeries();
+      const auto originalOpens = sorted (syntheticSpySeries.getRelativeOpen());
+
+      for (int i = 0; i < 10; i++)
+	{
+	  syntheticSpySeries.createSyntheticSeries();
+
+	  REQUIRE (syntheticSpySeries.getSyntheticTimeSeries() == p);
+	  REQUIRE (p->getNumEntries() == spySeries.getNumEntries());
+	  REQUIRE (p->getFirstDate() == spySeries.getFirstDate());
+	  REQUIRE (p->getLastDate() == spySeries.getLastDate());
+	  REQUIRE (p->getTimeFrame() == spySeries.getTimeFrame());
+	  REQUIRE (p->getDateTimeColumn() == spySeries.getDateTimeColumn());
+
+	  // A permutation only reorders the factors
+	  REQUIRE (sorted (syntheticSpySeries.getRelativeOpen()) == originalOpens);
+	}
+    }
+
+  SECTION ("ReusableSyntheticTimeSeries bars integrate the shuffled factors", "[SyntheticTimeSeries]")
+    {
+      syntheticSpySeries.createSyntheticSeries();
+      auto p = syntheticSpySeries.getSyntheticTimeSeries();
+
+      const auto& relOpen = syntheticSpySeries.getRelativeOpen();
+      const auto& relHigh = syntheticSpySeries.getRelativeHigh();
+      const auto& relLow = syntheticSpySeries.getRelativeLow();
+      const auto& relClose = syntheticSpySeries.getRelativeClose();
+
+      DecimalType xPrice (syntheticSpySeries.getFirstOpen());
+      for (size_t i = 0; i < p->getNumEntries(); i++)
+	{
+	  xPrice *= relOpen[i];
+	  DecimalType open (xPrice);
+	  xPrice *= relClose[i];
+
+	  REQUIRE (p->getOpenColumn()[i] == num::Round2Tick (open, tick, tickDiv2));
+	  REQUIRE (p->getHighColumn()[i] == num::Round2Tick (open * relHigh[i], tick, tickDiv2));
+	  REQUIRE (p->getLowColumn()[i] == num::Round2Tick (open * relLow[i], tick, tickDiv2));
+	  REQUIRE (p->getCloseColumn()[i] == num::Round2Tick (xPrice, tick, tickDiv2));
+
+	  auto it = p->beginRandomAccess() + i;
+	  REQUIRE (it->getCloseValue() == p->getCloseColumn()[i]);
+	}
+    }
+
+  SECTION ("OHLCTimeSeries replaceEntry", "[TimeSeries]")
+    {
+      OHLCTimeSeries<DecimalType> series (spySeries);
+      auto replacement = createEquityEntry ("20151210", "1.00", "3.00", "0.50","2.00", 1);
+
+      series.replaceEntry (1, replacement);
+      REQUIRE (*(series.beginRandomAccess() + 1) == replacement);
+      REQUIRE (series.getCloseColumn()[1] == replacement.getCloseValue());
+      REQUIRE (series.getTimeSeriesEntry (date (2015, Dec, 10))->getOpenValue() == replacement.getOpenValue());
+
+      REQUIRE_THROWS (series.replaceEntry (0, replacement));
+      REQUIRE_THROWS (series.replaceEntry (series.getNumEntries(), replacement));
+    }
+}
+
+TEST_CASE ("FixedPointSyntheticIntegrationPolicy matches the decimal path", "[SyntheticTimeSeries]")
+{
+  const DecimalType tick (DecimalConstants<DecimalType>::EquityTick);
+  const DecimalType tickDiv2 (tick / DecimalConstants<DecimalType>::DecimalTwo);
+
+  SECTION ("TickRounder matches Round2Tick", "[SyntheticTimeSeries]")
+    {
+      // Ticks that divide the decimal precision factor and ticks that do not
+      const std::vector<std::string> ticks = { "0.01", "0.05", "0.25", "0.03125", "1", "0.003", "0.0007", "0.0000003" };
+      RandomMersenne randGenerator;
+
+      for (const auto& tickString : ticks)
+	{
+	  const DecimalType aTick (tickString);
+	  const DecimalType aTickDiv2 (aTick / DecimalConstants<DecimalType>::DecimalTwo);
+	  const FixedPointPolicy::TickRounder rounder (aTick, aTickDiv2);
+
+	  for (int i = 0; i < 20000; i++)
+	    {
+	      // Prices around multiples of the tick, half ticks included, in both signs
+	      const int64_t multiple = static_cast<int64_t>(randGenerator.DrawNumber (0, 100000)) - 1000;
+	      const int64_t offset = static_cast<int64_t>(randGenerator.DrawNumber (0, 20)) - 10;
+	      DecimalType price;
+	      price.setUnbiased (multiple * aTick.getUnbiased() + (i % 2 ? aTickDiv2.getUnbiased() : 0) + offset);
+
+	      REQUIRE (rounder (price) == num::Round2Tick (price, aTick, aTickDiv2));
+	    }
+	}
+
+      REQUIRE_THROWS (FixedPointPolicy::TickRounder (DecimalConstants<DecimalType>::DecimalZero, tickDiv2));
+    }
+
+  SECTION ("Integrated prices match on the SPY fixture", "[SyntheticTimeSeries]")
+    {
+      ReusableSyntheticTimeSeries<DecimalType, DecimalPolicy> spySeries (createSpySeries(), tick, tickDiv2);
+
+      for (int i = 0; i < 50; i++)
+	{
+	  spySeries.createSyntheticSeries();
+	  requireSamePrices (integrateWith<FixedPointPolicy> (spySeries), integrateWith<DecimalPolicy> (spySeries));
+	}
+
+      ReusableSyntheticTimeSeries<DecimalType, FixedPointPolicy> fixedPointSeries (createSpySeries(), tick, tickDiv2);
+      for (int i = 0; i < 10; i++)
+	{
+	  fixedPointSeries.createSyntheticSeries();
+	  auto p = fixedPointSeries.getSyntheticTimeSeries();
+	  const auto reference = integrateWith<DecimalPolicy> (fixedPointSeries);
+
+	  REQUIRE (p->getOpenColumn() == reference.open);
+	  REQUIRE (p->getHighColumn() == reference.high);
+	  REQUIRE (p->getLowColumn() == reference.low);
+	  REQUIRE (p->getCloseColumn() == reference.close);
+	}
+    }
+
+  SECTION ("Integrated prices match on an hourly series", "[SyntheticTimeSeries]")
+    {
+      auto msftSeries = readMsftHourlySeries();
+      ReusableSyntheticTimeSeries<DecimalType, DecimalPolicy> syntheticSeries (*msftSeries, tick, tickDiv2);
+
+      for (int i = 0; i < 5; i++)
+	{
+	  syntheticSeries.createSyntheticSeries();
+	  requireSamePrices (integrateWith<FixedPointPolicy> (syntheticSeries),
+			     integrateWith<DecimalPolicy> (syntheticSeries));
+	}
+    }
+}
+
+TEST_CASE ("Synthetic series integration benchmark", "[.][benchmark][SyntheticTimeSeries]")
+{
+  const DecimalType tick (DecimalConstants<DecimalType>::EquityTick);
+  const DecimalType tickDiv2 (tick / DecimalConstants<DecimalType>::DecimalTwo);
+
+  ReusableSyntheticTimeSeries<DecimalType> spySeries (createSpySeries(), tick, tickDiv2);
+  auto msftSeries = readMsftHourlySeries();
+  ReusableSyntheticTimeSeries<DecimalType> msftSyntheticSeries (*msftSeries, tick, tickDiv2);
+
+  spySeries.createSyntheticSeries();
+  msftSyntheticSeries.createSyntheticSeries();
+
+  IntegratedPrices prices;
+  auto integrate = [&prices] (auto policy, const auto& series)
+    {
+      using Policy = decltype(policy);
+      Policy::integrate (series.getFirstOpen(),
+			 series.getRelativeOpen(), series.getRelativeHigh(),
+			 series.getRelativeLow(), series.getRelativeClose(),
+			 series.getTick(), series.getTickDiv2(),
+			 prices.open, prices.high, prices.low, prices.close);
+      return prices.close.back();
+    };
+
+  BENCHMARK ("SPY decimal integration")
+    {
+      return integrate (DecimalPolicy(), spySeries);
+    };
+
+  BENCHMARK ("SPY fixed point integration")
+    {
+      return integrate (FixedPointPolicy(), spySeries);
+    };
+
+  BENCHMARK ("MSFT hourly decimal integration")
+    {
+      return integrate (DecimalPolicy(), msftSyntheticSeries);
+    };
+
+  BENCHMARK ("MSFT hourly fixed point integration")
+    {
+      return integrate (FixedPointPolicy(), msftSyntheticSeries);
+    };
+
+  BENCHMARK ("MSFT hourly createSyntheticSeries")
+    {
+      msftSyntheticSeries.createSyntheticSeries();
+      return msftSyntheticSeries.getSyntheticTimeSeries()->getNumEntries();
+    };
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch_test_macros.hpp>
+#include <fstream>
+#include <string>
+#include <boost/filesystem.hpp>
+#include "TimeSeriesBinaryCache.h"
+#include "TestUtils.h"
+
+using namespace mkc_timeseries;
+namespace fs = boost::filesystem;
+
+namespace
+{
+  void writePalFile(const fs::path& path, const std::string& lastRow)
+  {
+    std::ofstream out(path.string());
+    out << "20200102,100.00,101.50,99.25,101.00\n"
+	<< "20200103,101.00,102.00,100.50,101.75\n"
+	<< "20200106,101.75,103.25,101.00,102.50\n"
+	<< lastRow << "\n";
+  }
+
+  std::shared_ptr<CachedTimeSeriesCsvReader<DecimalType>> makeCachedReader(const fs::path& path)
+  {
+    return std::make_shared<CachedTimeSeriesCsvReader<DecimalType>>(
+      std::make_shared<PALFormatCsvReader<DecimalType>>(path.string()));
+  }
+}
+
+TEST_CASE("CachedTimeSeriesCsvReader parses once and maps the cache on later reads", "[csv][cache]")
+{
+  const fs::path dir = fs::temp_directory_path() / fs::unique_path("palcache-%%%%-%%%%");
+  fs::create_directories(dir);
+  const fs::path dataFile = dir / "data.txt";
+  writePalFile(dataFile, "20200107,102.50,102.75,101.50,102.00");
+
+  PALFormatCsvReader<DecimalType> plainReader(dataFile.string());
+  plainReader.readFile();
+
+  auto firstReader = makeCachedReader(dataFile);
+  firstReader->readFile();
+  REQUIRE_FALSE(firstReader->isLoadedFromCache());
+  REQUIRE(fs::exists(TimeSeriesBinaryCache<DecimalType>::getCacheFileName(dataFile.string())));
+  REQUIRE(*firstReader->getTimeSeries() == *plainReader.getTimeSeries());
+
+  auto secondReader = makeCachedReader(dataFile);
+  secondReader->readFile();
+  REQUIRE(secondReader->isLoadedFromCache());
+  REQUIRE(*secondReader->getTimeSeries() == *plainReader.getTimeSeries());
+  REQUIRE(secondReader->getTimeSeries()->getCloseColumn() == plainReader.getTimeSeries()->getCloseColumn());
+
+  SECTION("a changed source file is parsed again")
+    {
+      writePalFile(dataFile, "20200107,102.50,104.00,101.50,103.75");
+
+      auto changedReader = makeCachedReader(dataFile);
+      changedReader->readFile();
+      REQUIRE_FALSE(changedReader->isLoadedFromCache());
+      REQUIRE(changedReader->getTimeSeries()->getCloseValue(changedReader->getTimeSeries()->endRandomAccess() - 1, 0)
+	      == createDecimal("103.75"));
+    }
+
+  SECTION("a different tick does not use the cache")
+    {
+      auto tickReader = std::make_shared<CachedTimeSeriesCsvReader<DecimalType>>(
+	std::make_shared<PALFormatCsvReader<DecimalType>>(dataFile.string(), TimeFrame::DAILY,
+							  TradingVolume::SHARES, createDecimal("0.25")));
+      tickReader->readFile();
+      REQUIRE_FALSE(tickReader->isLoadedFromCache());
+    }
+
+  SECTION("a corrupt cache file is ignored")
+    {
+      std::ofstream(TimeSeriesBinaryCache<DecimalType>::getCacheFileName(dataFile.string()),
+		    std::ios::binary | std::ios::trunc) << "garbage";
+
+      auto corruptReader = makeCachedReader(dataFile);
+      corruptReader->readFile();
+      REQUIRE_FALSE(corruptReader->isLoadedFromCache());
+      REQUIRE(*corruptReader->getTimeSeries() == *plainReader.getTimeSeries());
+    }
+
+  fs::remove_all(dir);
+}
@@ -486,6 +486,40 @@ SECTION ("Timeseries Value OHLC test", "[TimeSeries]")
     }
 
 
+ SECTION ("Timeseries columnar access test", "[TimeSeries]")
+    {
+      const auto& closes = spySeries.getCloseColumn();
+      REQUIRE (closes.size() == spySeries.getNumEntries());
+      REQUIRE (spySeries.getDateTimeColumn().size() == spySeries.getNumEntries());
+
+      size_t index = 0;
+      for (auto it = spySeries.beginRandomAccess(); it != spySeries.endRandomAccess(); it++, index++)
+	{
+	  REQUIRE (spySeries.getIndex (it) == index);
+	  REQUIRE (spySeries.getRandomAccessIterator (index) == it);
+	  REQUIRE (spySeries.getDateTimeColumn()[index] == it->getDateTime());
+	  REQUIRE (spySeries.getOpenColumn()[index] == it->getOpenValue());
+	  REQUIRE (spySeries.getHighColumn()[index] == it->getHighValue());
+	  REQUIRE (spySeries.getLowColumn()[index] == it->getLowValue());
+	  REQUIRE (closes[index] == it->getCloseValue());
+	  REQUIRE (spySeries.getVolumeColumn()[index] == it->getVolumeValue());
+	}
+
+      REQUIRE_THROWS (spySeries.getRandomAccessIterator (spySeries.getNumEntries()));
+
+      spySeries.deleteEntryByDate (date (2015, Dec, 31));
+      REQUIRE (spySeries.getCloseColumn().size() == 6);
+      REQUIRE (spySeries.getCloseColumn()[3] == entry2.getCloseValue());
+
+      auto it = spySeries.getRandomAccessIterator (date (2016, Jan, 5));
+      REQUIRE (spySeries.getCloseValue (it, 1) == entry2.getCloseValue());
+      REQUIRE (spySeries.getCloseValue (it, 2) == entry4.getCloseValue());
+
+      auto intradayIt = ssoSeries.getTimeSeriesEntry (intraday_entry10->getDateTime());
+      REQUIRE (ssoSeries.getIndex (intradayIt) == 9);
+      REQUIRE (ssoSeries.getOpenColumn()[9] == intraday_entry10->getOpenValue());
+    }
+
  SECTION("TimeSeries copy construction equality", "[TimeSeries]")
    {
      OHLCTimeSeries<DecimalType> spySeries2(spySeries);
@@ -44,7 +44,7 @@ static int usage_error(const std::vector<std::string>& args)
   for (auto arg: args)
     std::cout << arg << ".";
   std::cout << std::endl;
-  std::cout << "Correct usage is:... [configFileName] [searchConfigFileName] [longonly/shortonly/longshort] [IS/OOS/ISOOS] [PATTERN_SEARCH_TYPE] [MODE] [--LOCAL/API:{SOURCE}] [[API Config file] OR [Daily File] [Hourly File]]" << std::endl << std::endl;
+  std::cout << "Correct usage is:... [configFileName] [searchConfigFileName] [longonly/shortonly/longshort] [IS/OOS/ISOOS] [PATTERN_SEARCH_TYPE] [MODE] [--LOCAL/API:{SOURCE}] [[API Config file] OR [Daily File] [Hourly File]] [cache:{DIRECTORY}]" << std::endl << std::endl;
   std::cout << "  Where a typical run could be something like: "<< std::endl;
   std::cout << "     ./PalValidator %config1.txt %conig2.txt longshortIS 4 threads:8 --api:finnhub api.config" << std::endl << std::endl;
 
@@ -74,6 +74,10 @@ static int usage_error(const std::vector<std::string>& args)
   std::cout << "  --LOCAL: " << std::endl;
   std::cout << "  * Instructs the program to get hourly and EOD data from local files. " << std::endl;
   std::cout << "  * If --local is specified the next two parameters are the daily file and hourly file. " << std::endl;
+
+  std::cout << "  cache:DIRECTORY (optional): " << std::endl;
+  std::cout << "  * Caches the backtest matrices of the search in DIRECTORY, so reruns with the same targets and stops skip the simulation. " << std::endl;
+  std::cout << "  * Without it nothing is cached. " << std::endl;
   
   return 2;
 }
@@ -117,10 +121,21 @@ int main(int argc, char **argv)
       }
       else
       {
+        if (argc < 10)
+          return usage_error(v);
         parameters->setEodDataFilePath(v[8]);
         parameters->setHourlyDataFilePath(v[9]);
       }
 
+      //optional trailing argument: cache:directory enables the backtest matrix cache
+      const size_t firstOptionalArg = parameters->shouldUseApi() ? 9 : 10;
+      for (size_t i = firstOptionalArg; i < v.size(); ++i)
+        {
+          if (v[i].rfind("cache:", 0) != 0 || v[i].size() == std::string("cache:").size())
+            return usage_error(v);
+          parameters->setBacktestCacheDirectory(v[i].substr(std::string("cache:").size()));
+        }
+
       std::string longorshort = v[3];
       SideToRun sideToRun;
       if (longorshort == "longonly")